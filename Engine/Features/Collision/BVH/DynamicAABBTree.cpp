@@ -0,0 +1,414 @@
+#include "DynamicAABBTree.h"
+
+#include <algorithm>
+
+
+namespace Engine {
+
+namespace {
+
+AABB Union(const AABB& _a, const AABB& _b)
+{
+    AABB result;
+    result.min = Vector3(std::min(_a.min.x, _b.min.x), std::min(_a.min.y, _b.min.y), std::min(_a.min.z, _b.min.z));
+    result.max = Vector3(std::max(_a.max.x, _b.max.x), std::max(_a.max.y, _b.max.y), std::max(_a.max.z, _b.max.z));
+    return result;
+}
+
+// 挿入先を選ぶコスト 表面積
+float SurfaceArea(const AABB& _aabb)
+{
+    Vector3 d = _aabb.max - _aabb.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+bool Contains(const AABB& _outer, const AABB& _inner)
+{
+    return _outer.min.x <= _inner.min.x && _outer.min.y <= _inner.min.y && _outer.min.z <= _inner.min.z &&
+        _inner.max.x <= _outer.max.x && _inner.max.y <= _outer.max.y && _inner.max.z <= _outer.max.z;
+}
+
+AABB Expand(const AABB& _aabb, float _margin)
+{
+    Vector3 margin(_margin, _margin, _margin);
+    return AABB(_aabb.min - margin, _aabb.max + margin);
+}
+
+} // namespace
+
+DynamicAABBTree::DynamicAABBTree(float _margin)
+    : margin_(_margin)
+{
+}
+
+int32_t DynamicAABBTree::CreateProxy(const AABB& _bounds, Collider* _collider)
+{
+    int32_t proxyId = AllocateNode();
+
+    Node& node = nodes_[proxyId];
+    node.bounds = _bounds;
+    node.fatBounds = Expand(_bounds, margin_);
+    node.collider = _collider;
+    node.height = 0;
+
+    InsertLeaf(proxyId);
+    ++proxyCount_;
+
+    return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t _proxyId)
+{
+    if (_proxyId < 0 || _proxyId >= static_cast<int32_t>(nodes_.size()) || !nodes_[_proxyId].IsLeaf() || nodes_[_proxyId].height != 0)
+        return;
+
+    RemoveLeaf(_proxyId);
+    FreeNode(_proxyId);
+    --proxyCount_;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t _proxyId, const AABB& _bounds)
+{
+    Node& node = nodes_[_proxyId];
+    node.bounds = _bounds;
+
+    // 膨らませた範囲に収まっていれば組み替えない
+    if (Contains(node.fatBounds, _bounds))
+        return false;
+
+    RemoveLeaf(_proxyId);
+    nodes_[_proxyId].fatBounds = Expand(_bounds, margin_);
+    InsertLeaf(_proxyId);
+
+    return true;
+}
+
+void DynamicAABBTree::Clear()
+{
+    nodes_.clear();
+    root_ = kNullNode;
+    freeList_ = kNullNode;
+    nodeCount_ = 0;
+    proxyCount_ = 0;
+}
+
+void DynamicAABBTree::GetCollisionPair(std::vector<std::pair<Collider*, Collider*>>& _pair) const
+{
+    for (int32_t index = 0; index < static_cast<int32_t>(nodes_.size()); ++index)
+    {
+        const Node& node = nodes_[index];
+        if (node.height != 0)
+            continue;
+
+        // 同じペアを二重に出さないようにIDの大きい相手だけ採用
+        Query(node.bounds, [&](int32_t _other) {
+            if (_other > index)
+                _pair.emplace_back(node.collider, nodes_[_other].collider);
+            return true;
+        });
+    }
+}
+
+void DynamicAABBTree::GetCollisionPair(const DynamicAABBTree& _other, std::vector<std::pair<Collider*, Collider*>>& _pair) const
+{
+    if (_other.root_ == kNullNode)
+        return;
+
+    for (const Node& node : nodes_)
+    {
+        if (node.height != 0)
+            continue;
+
+        _other.Query(node.bounds, [&](int32_t _otherId) {
+            _pair.emplace_back(node.collider, _other.nodes_[_otherId].collider);
+            return true;
+        });
+    }
+}
+
+bool DynamicAABBTree::IntersectRay(const AABB& _bounds, const Vector3& _origin, const Vector3& _invDirection, float _maxDistance, float& _enter)
+{
+    float enter = 0.0f;
+    float exit = _maxDistance;
+
+    // 軸に平行なレイで0*infがNaNになった軸は、std::min/maxの引数の順番で無視される
+    const float origin[3] = { _origin.x, _origin.y, _origin.z };
+    const float invDirection[3] = { _invDirection.x, _invDirection.y, _invDirection.z };
+    const float boundsMin[3] = { _bounds.min.x, _bounds.min.y, _bounds.min.z };
+    const float boundsMax[3] = { _bounds.max.x, _bounds.max.y, _bounds.max.z };
+
+    for (int32_t axis = 0; axis < 3; ++axis)
+    {
+        float t1 = (boundsMin[axis] - origin[axis]) * invDirection[axis];
+        float t2 = (boundsMax[axis] - origin[axis]) * invDirection[axis];
+
+        enter = std::max(enter, std::min(t1, t2));
+        exit = std::min(exit, std::max(t1, t2));
+    }
+
+    _enter = enter;
+    return enter <= exit;
+}
+
+int32_t DynamicAABBTree::AllocateNode()
+{
+    int32_t index = kNullNode;
+    if (freeList_ != kNullNode)
+    {
+        index = freeList_;
+        freeList_ = nodes_[index].parent;
+    }
+    else
+    {
+        index = static_cast<int32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    nodes_[index] = Node();
+    ++nodeCount_;
+    return index;
+}
+
+void DynamicAABBTree::FreeNode(int32_t _node)
+{
+    nodes_[_node] = Node();
+    nodes_[_node].parent = freeList_;
+    freeList_ = _node;
+    --nodeCount_;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t _leaf)
+{
+    if (root_ == kNullNode)
+    {
+        root_ = _leaf;
+        nodes_[root_].parent = kNullNode;
+        return;
+    }
+
+    // 表面積の増加が最も小さくなる兄弟を探す
+    AABB leafBounds = nodes_[_leaf].fatBounds;
+    int32_t index = root_;
+    while (!nodes_[index].IsLeaf())
+    {
+        const Node& node = nodes_[index];
+        int32_t child1 = node.child1;
+        int32_t child2 = node.child2;
+
+        float area = SurfaceArea(node.fatBounds);
+        float combinedArea = SurfaceArea(Union(node.fatBounds, leafBounds));
+
+        // ここに新しい親を作るコスト
+        float cost = 2.0f * combinedArea;
+        // 下に降りる場合に祖先が負担する増加分
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t _child) {
+            const Node& child = nodes_[_child];
+            float newArea = SurfaceArea(Union(leafBounds, child.fatBounds));
+            if (child.IsLeaf())
+                return newArea + inheritanceCost;
+            return newArea - SurfaceArea(child.fatBounds) + inheritanceCost;
+        };
+
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int32_t sibling = index;
+
+    // 兄弟と新しい葉をまとめる親を作る
+    int32_t oldParent = nodes_[sibling].parent;
+    int32_t newParent = AllocateNode();
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].fatBounds = Union(leafBounds, nodes_[sibling].fatBounds);
+    nodes_[newParent].height = nodes_[sibling].height + 1;
+    nodes_[newParent].child1 = sibling;
+    nodes_[newParent].child2 = _leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[_leaf].parent = newParent;
+
+    if (oldParent != kNullNode)
+    {
+        if (nodes_[oldParent].child1 == sibling)
+            nodes_[oldParent].child1 = newParent;
+        else
+            nodes_[oldParent].child2 = newParent;
+    }
+    else
+    {
+        root_ = newParent;
+    }
+
+    Refit(nodes_[_leaf].parent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t _leaf)
+{
+    if (_leaf == root_)
+    {
+        root_ = kNullNode;
+        return;
+    }
+
+    int32_t parent = nodes_[_leaf].parent;
+    int32_t grandParent = nodes_[parent].parent;
+    int32_t sibling = nodes_[parent].child1 == _leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    if (grandParent != kNullNode)
+    {
+        // 親を消して兄弟を祖父につなぐ
+        if (nodes_[grandParent].child1 == parent)
+            nodes_[grandParent].child1 = sibling;
+        else
+            nodes_[grandParent].child2 = sibling;
+        nodes_[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        Refit(grandParent);
+    }
+    else
+    {
+        root_ = sibling;
+        nodes_[sibling].parent = kNullNode;
+        FreeNode(parent);
+    }
+
+    nodes_[_leaf].parent = kNullNode;
+}
+
+void DynamicAABBTree::Refit(int32_t _index)
+{
+    while (_index != kNullNode)
+    {
+        _index = Balance(_index);
+
+        Node& node = nodes_[_index];
+        const Node& child1 = nodes_[node.child1];
+        const Node& child2 = nodes_[node.child2];
+
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.fatBounds = Union(child1.fatBounds, child2.fatBounds);
+
+        _index = node.parent;
+    }
+}
+
+int32_t DynamicAABBTree::Balance(int32_t _iA)
+{
+    Node& a = nodes_[_iA];
+    if (a.IsLeaf() || a.height < 2)
+        return _iA;
+
+    int32_t iB = a.child1;
+    int32_t iC = a.child2;
+    Node& b = nodes_[iB];
+    Node& c = nodes_[iC];
+
+    int32_t balance = c.height - b.height;
+
+    // Cを持ち上げる
+    if (balance > 1)
+    {
+        int32_t iF = c.child1;
+        int32_t iG = c.child2;
+        Node& f = nodes_[iF];
+        Node& g = nodes_[iG];
+
+        c.child1 = _iA;
+        c.parent = a.parent;
+        a.parent = iC;
+
+        if (c.parent != kNullNode)
+        {
+            if (nodes_[c.parent].child1 == _iA)
+                nodes_[c.parent].child1 = iC;
+            else
+                nodes_[c.parent].child2 = iC;
+        }
+        else
+        {
+            root_ = iC;
+        }
+
+        if (f.height > g.height)
+        {
+            c.child2 = iF;
+            a.child2 = iG;
+            g.parent = _iA;
+            a.fatBounds = Union(b.fatBounds, g.fatBounds);
+            c.fatBounds = Union(a.fatBounds, f.fatBounds);
+            a.height = 1 + std::max(b.height, g.height);
+            c.height = 1 + std::max(a.height, f.height);
+        }
+        else
+        {
+            c.child2 = iG;
+            a.child2 = iF;
+            f.parent = _iA;
+            a.fatBounds = Union(b.fatBounds, f.fatBounds);
+            c.fatBounds = Union(a.fatBounds, g.fatBounds);
+            a.height = 1 + std::max(b.height, f.height);
+            c.height = 1 + std::max(a.height, g.height);
+        }
+
+        return iC;
+    }
+
+    // Bを持ち上げる
+    if (balance < -1)
+    {
+        int32_t iD = b.child1;
+        int32_t iE = b.child2;
+        Node& d = nodes_[iD];
+        Node& e = nodes_[iE];
+
+        b.child1 = _iA;
+        b.parent = a.parent;
+        a.parent = iB;
+
+        if (b.parent != kNullNode)
+        {
+            if (nodes_[b.parent].child1 == _iA)
+                nodes_[b.parent].child1 = iB;
+            else
+                nodes_[b.parent].child2 = iB;
+        }
+        else
+        {
+            root_ = iB;
+        }
+
+        if (d.height > e.height)
+        {
+            b.child2 = iD;
+            a.child1 = iE;
+            e.parent = _iA;
+            a.fatBounds = Union(c.fatBounds, e.fatBounds);
+            b.fatBounds = Union(a.fatBounds, d.fatBounds);
+            a.height = 1 + std::max(c.height, e.height);
+            b.height = 1 + std::max(a.height, d.height);
+        }
+        else
+        {
+            b.child2 = iE;
+            a.child1 = iD;
+            d.parent = _iA;
+            a.fatBounds = Union(c.fatBounds, d.fatBounds);
+            b.fatBounds = Union(a.fatBounds, e.fatBounds);
+            a.height = 1 + std::max(c.height, d.height);
+            b.height = 1 + std::max(a.height, e.height);
+        }
+
+        return iB;
+    }
+
+    return _iA;
+}
+
+} // namespace Engine
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <Features/Collision/Collider/Collider.h>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace Engine {
+
+/// <summary>
+/// 動的AABB木（BVH）
+/// 葉は少し膨らませたAABB(fat AABB)を持ち、その中に収まる移動では木を組み替えない
+/// 組み替え時は回転でバランスを保つ
+/// </summary>
+class DynamicAABBTree
+{
+public:
+    static constexpr int32_t kNullNode = -1;
+
+    explicit DynamicAABBTree(float _margin = 0.1f);
+    ~DynamicAABBTree() = default;
+
+    // 葉を追加する 戻り値は葉のID
+    int32_t CreateProxy(const AABB& _bounds, Collider* _collider);
+
+    // 葉を削除する
+    void DestroyProxy(int32_t _proxyId);
+
+    /// <summary>
+    /// 葉の範囲を更新する
+    /// </summary>
+    /// <returns> fat AABBからはみ出して木を組み替えた場合true </returns>
+    bool MoveProxy(int32_t _proxyId, const AABB& _bounds);
+
+    // 全て削除する
+    void Clear();
+
+    // 葉のコライダーを取得
+    Collider* GetCollider(int32_t _proxyId) const { return nodes_[_proxyId].collider; }
+
+    // 葉の範囲を取得
+    const AABB& GetBounds(int32_t _proxyId) const { return nodes_[_proxyId].bounds; }
+
+    // 葉の膨らませた範囲を取得
+    const AABB& GetFatBounds(int32_t _proxyId) const { return nodes_[_proxyId].fatBounds; }
+
+    /// <summary>
+    /// _boundsと重なる葉を列挙する
+    /// _funcは bool(int32_t _proxyId) falseを返すと列挙を打ち切る
+    /// 作業領域はスタック上に取るため、複数スレッドから同時に呼んでよい
+    /// </summary>
+    template<typename Func>
+    void Query(const AABB& _bounds, Func&& _func) const;
+
+    /// <summary>
+    /// レイと範囲が交差する葉を、節の近い方から列挙する
+    /// _funcは float(int32_t _proxyId, float _maxDistance) 戻り値がそれ以降に探索する距離になる
+    /// 全て列挙する場合は_maxDistanceをそのまま、最も近いものだけ欲しい場合はヒットした距離を返す（0未満で打ち切り）
+    /// 作業領域はスタック上に取るため、複数スレッドから同時に呼んでよい
+    /// </summary>
+    template<typename Func>
+    void RayCast(const Vector3& _origin, const Vector3& _direction, float _maxDistance, Func&& _func) const;
+
+    // 木の中で範囲が重なる葉のペアを全て取得する（追記）
+    void GetCollisionPair(std::vector<std::pair<Collider*, Collider*>>& _pair) const;
+
+    // 別の木の葉と範囲が重なるペアを取得する（追記 firstがこちらの木）
+    void GetCollisionPair(const DynamicAABBTree& _other, std::vector<std::pair<Collider*, Collider*>>& _pair) const;
+
+    // 木の高さ
+    int32_t GetHeight() const { return root_ == kNullNode ? 0 : nodes_[root_].height; }
+
+    // 葉の数
+    uint32_t GetProxyCount() const { return proxyCount_; }
+
+    // 使用中のノード数
+    uint32_t GetNodeCount() const { return nodeCount_; }
+
+private:
+    struct Node
+    {
+        AABB fatBounds;                 // 葉: 膨らませた範囲 内部: 子の範囲の和
+        AABB bounds;                    // 葉: 実際の範囲
+        Collider* collider = nullptr;
+        int32_t parent = kNullNode;     // 未使用時は次の空きノード
+        int32_t child1 = kNullNode;
+        int32_t child2 = kNullNode;
+        int32_t height = -1;            // 葉は0 未使用は-1
+
+        bool IsLeaf() const { return child1 == kNullNode; }
+    };
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t _node);
+
+    void InsertLeaf(int32_t _leaf);
+    void RemoveLeaf(int32_t _leaf);
+
+    // 親をたどって範囲と高さを更新する
+    void Refit(int32_t _index);
+
+    // 回転でバランスを取る 戻り値は部分木の新しい根
+    int32_t Balance(int32_t _index);
+
+    // レイとAABBの交差判定（スラブ法） _enterに入る距離を返す
+    static bool IntersectRay(const AABB& _bounds, const Vector3& _origin, const Vector3& _invDirection, float _maxDistance, float& _enter);
+
+    // 走査用スタックの深さ（AVLの高さ制限から十分な値）
+    static constexpr size_t kQueryStackSize = 256;
+
+    std::vector<Node> nodes_;
+    int32_t root_ = kNullNode;
+    int32_t freeList_ = kNullNode;
+    uint32_t nodeCount_ = 0;
+    uint32_t proxyCount_ = 0;
+    float margin_ = 0.1f;
+};
+
+template<typename Func>
+void DynamicAABBTree::Query(const AABB& _bounds, Func&& _func) const
+{
+    if (root_ == kNullNode)
+        return;
+
+    std::array<int32_t, kQueryStackSize> stack;
+    size_t top = 0;
+    stack[top++] = root_;
+
+    while (top > 0)
+    {
+        int32_t index = stack[--top];
+        const Node& node = nodes_[index];
+
+        if (!node.fatBounds.Intersect(_bounds))
+            continue;
+
+        if (node.IsLeaf())
+        {
+            if (node.bounds.Intersect(_bounds))
+            {
+                if (!_func(index))
+                    return;
+            }
+        }
+        else
+        {
+            assert(top + 2 <= kQueryStackSize);
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+}
+
+template<typename Func>
+void DynamicAABBTree::RayCast(const Vector3& _origin, const Vector3& _direction, float _maxDistance, Func&& _func) const
+{
+    if (root_ == kNullNode)
+        return;
+
+    Vector3 invDirection(1.0f / _direction.x, 1.0f / _direction.y, 1.0f / _direction.z);
+    float maxDistance = _maxDistance;
+
+    float rootEnter = 0.0f;
+    if (!IntersectRay(nodes_[root_].fatBounds, _origin, invDirection, maxDistance, rootEnter))
+        return;
+
+    // 節と、その節に入る距離
+    struct StackEntry
+    {
+        int32_t index;
+        float enter;
+    };
+    std::array<StackEntry, kQueryStackSize> stack;
+    size_t top = 0;
+    stack[top++] = { root_, rootEnter };
+
+    while (top > 0)
+    {
+        StackEntry entry = stack[--top];
+
+        // 積んだ後に探索距離が縮んでいれば飛ばす
+        if (entry.enter > maxDistance)
+            continue;
+
+        const Node& node = nodes_[entry.index];
+
+        if (node.IsLeaf())
+        {
+            float enter = 0.0f;
+            if (!IntersectRay(node.bounds, _origin, invDirection, maxDistance, enter))
+                continue;
+
+            maxDistance = _func(entry.index, maxDistance);
+            if (maxDistance < 0.0f)
+                return;
+            continue;
+        }
+
+        float enter1 = 0.0f;
+        float enter2 = 0.0f;
+        bool isHit1 = IntersectRay(nodes_[node.child1].fatBounds, _origin, invDirection, maxDistance, enter1);
+        bool isHit2 = IntersectRay(nodes_[node.child2].fatBounds, _origin, invDirection, maxDistance, enter2);
+
+        assert(top + 2 <= kQueryStackSize);
+
+        // 近い方を後に積んで先に調べる
+        if (isHit1 && isHit2)
+        {
+            if (enter1 <= enter2)
+            {
+                stack[top++] = { node.child2, enter2 };
+                stack[top++] = { node.child1, enter1 };
+            }
+            else
+            {
+                stack[top++] = { node.child1, enter1 };
+                stack[top++] = { node.child2, enter2 };
+            }
+        }
+        else if (isHit1)
+        {
+            stack[top++] = { node.child1, enter1 };
+        }
+        else if (isHit2)
+        {
+            stack[top++] = { node.child2, enter2 };
+        }
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,523 @@
+#include "CollisionBenchmark.h"
+
+#include <Features/Collision/Collider/Collider.h>
+#include <Features/Collision/Tree/QuadTree.h>
+#include <Features/Collision/SpiralHashGird/SpatialHashGrid.h>
+#include <Features/Collision/BroadPhase/ColliderPairSet.h>
+#include <Features/Collision/Detector/CollisionDetector.h>
+#include <Features/Collision/Detector/BatchCollisionDetector.h>
+#include <Math/Matrix/MatrixFunction.h>
+#include <Debug/Debug.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+
+namespace Engine {
+
+namespace {
+
+// 計測用のコライダー群
+struct BenchmarkScene
+{
+    std::vector<WorldTransform> transforms;
+    std::vector<std::unique_ptr<SphereCollider>> colliders;
+    float fieldSize = 0.0f;
+};
+
+constexpr int32_t kBenchmarkTreeLevel = 6;
+constexpr float kBenchmarkRadius = 0.5f;
+
+void SetPosition(WorldTransform& _transform, const Vector3& _position)
+{
+    _transform.transform_ = _position;
+    _transform.matWorld_ = MakeTranslateMatrix(_position);
+    _transform.MarkDirty();
+}
+
+// コライダー1つあたり一定の面積になるようにフィールド全体へ散らす
+void CreateScene(BenchmarkScene& _scene, uint32_t _colliderCount)
+{
+    _scene.fieldSize = std::sqrt(static_cast<float>(_colliderCount)) * 4.0f;
+    _scene.transforms.resize(_colliderCount);
+    _scene.colliders.resize(_colliderCount);
+
+    for (uint32_t i = 0; i < _colliderCount; ++i)
+    {
+        _scene.colliders[i] = std::make_unique<SphereCollider>(true);
+        _scene.colliders[i]->SetRadius(kBenchmarkRadius);
+        _scene.colliders[i]->SetWorldTransform(&_scene.transforms[i]);
+    }
+}
+
+// 初期配置に戻す 同じシードなら同じ配置になる
+void ScatterScene(BenchmarkScene& _scene, uint32_t _seed)
+{
+    std::mt19937 engine(_seed);
+    float half = _scene.fieldSize * 0.5f - 1.0f;
+    std::uniform_real_distribution<float> dist(-half, half);
+
+    for (auto& transform : _scene.transforms)
+    {
+        SetPosition(transform, Vector3(dist(engine), 0.0f, dist(engine)));
+    }
+}
+
+// 一部のコライダーを少しだけ動かす
+void MoveColliders(BenchmarkScene& _scene, std::mt19937& _engine, uint32_t _movingCount)
+{
+    uint32_t colliderCount = static_cast<uint32_t>(_scene.colliders.size());
+    float half = _scene.fieldSize * 0.5f - 1.0f;
+    std::uniform_int_distribution<uint32_t> indexDist(0, colliderCount - 1);
+    std::uniform_real_distribution<float> moveDist(-0.5f, 0.5f);
+
+    for (uint32_t i = 0; i < _movingCount; ++i)
+    {
+        WorldTransform& transform = _scene.transforms[indexDist(_engine)];
+        Vector3 position = transform.transform_;
+        position.x = std::clamp(position.x + moveDist(_engine), -half, half);
+        position.z = std::clamp(position.z + moveDist(_engine), -half, half);
+        SetPosition(transform, position);
+    }
+}
+
+// 向きを無視したペアの組み合わせが一致するか
+bool IsSamePairSet(std::vector<std::pair<Collider*, Collider*>> _a, std::vector<std::pair<Collider*, Collider*>> _b)
+{
+    if (_a.size() != _b.size())
+        return false;
+
+    auto normalize = [](std::vector<std::pair<Collider*, Collider*>>& _pairs) {
+        for (auto& pair : _pairs)
+        {
+            if (std::less<Collider*>()(pair.second, pair.first))
+                std::swap(pair.first, pair.second);
+        }
+        std::sort(_pairs.begin(), _pairs.end());
+    };
+
+    normalize(_a);
+    normalize(_b);
+    return _a == _b;
+}
+
+// 動的コライダーごとに検索結果をsetでまとめ、既存のペアを線形走査して重複を除く（以前の方式）
+void CollectStaticPairsLegacy(const SpatialHashGrid& _grid, const std::vector<Collider*>& _dynamics,
+    std::vector<std::pair<Collider*, Collider*>>& _pairs)
+{
+    for (Collider* dynamicCollider : _dynamics)
+    {
+        std::vector<Collider*> candidates;
+        _grid.Query(dynamicCollider->GetBounds(), dynamicCollider, candidates);
+        std::set<Collider*> result(candidates.begin(), candidates.end());
+        std::vector<Collider*> nearbyStaticColliders(result.begin(), result.end());
+
+        for (Collider* staticCollider : nearbyStaticColliders)
+        {
+            bool alreadyExists = false;
+            for (const auto& existingPair : _pairs)
+            {
+                if ((existingPair.first == dynamicCollider && existingPair.second == staticCollider) ||
+                    (existingPair.first == staticCollider && existingPair.second == dynamicCollider))
+                {
+                    alreadyExists = true;
+                    break;
+                }
+            }
+
+            if (!alreadyExists)
+                _pairs.emplace_back(dynamicCollider, staticCollider);
+        }
+    }
+}
+
+// 検索結果の配列とペアのハッシュセットを使い回す（CollisionManager::UpdateBroadPhaseと同じ方式）
+void CollectStaticPairsHashed(const SpatialHashGrid& _grid, const std::vector<Collider*>& _dynamics,
+    std::vector<std::pair<Collider*, Collider*>>& _pairs, ColliderPairSet& _pairSet, std::vector<Collider*>& _queryResult)
+{
+    _pairSet.Clear();
+    _pairSet.Reserve(_pairs.size() + _dynamics.size());
+    for (const auto& pair : _pairs)
+    {
+        _pairSet.Insert(pair.first, pair.second);
+    }
+
+    for (Collider* dynamicCollider : _dynamics)
+    {
+        _queryResult.clear();
+        _grid.Query(dynamicCollider->GetBounds(), dynamicCollider, _queryResult);
+
+        for (Collider* staticCollider : _queryResult)
+        {
+            if (_pairSet.Insert(dynamicCollider, staticCollider))
+                _pairs.emplace_back(dynamicCollider, staticCollider);
+        }
+    }
+}
+
+// 衝突情報がビット単位で一致するか
+bool IsSameContacts(const std::vector<CollisionPair>& _a, const std::vector<CollisionPair>& _b)
+{
+    if (_a.size() != _b.size())
+        return false;
+
+    for (size_t i = 0; i < _a.size(); ++i)
+    {
+        const ColliderInfo& infoA = _a[i].info;
+        const ColliderInfo& infoB = _b[i].info;
+        if (_a[i].colliderA != _b[i].colliderA || _a[i].colliderB != _b[i].colliderB ||
+            std::memcmp(&infoA.contactPoint, &infoB.contactPoint, sizeof(Vector3)) != 0 ||
+            std::memcmp(&infoA.contactNormal, &infoB.contactNormal, sizeof(Vector3)) != 0 ||
+            std::memcmp(&infoA.penetration, &infoB.penetration, sizeof(float)) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+double ElapsedMs(std::chrono::high_resolution_clock::time_point _start)
+{
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - _start).count();
+}
+
+} // namespace
+
+BroadPhaseBenchmarkResult CollisionBenchmark::RunBroadPhase(uint32_t _colliderCount, uint32_t _frameCount, float _movingRatio)
+{
+    BroadPhaseBenchmarkResult result;
+    result.colliderCount = _colliderCount;
+    result.frameCount = _frameCount;
+
+    if (_colliderCount == 0 || _frameCount == 0)
+        return result;
+
+    constexpr uint32_t kSeed = 12345;
+    uint32_t movingCount = static_cast<uint32_t>(static_cast<float>(_colliderCount) * _movingRatio);
+
+    BenchmarkScene scene;
+    CreateScene(scene, _colliderCount);
+    ScatterScene(scene, kSeed);
+
+    Vector2 fieldSize(scene.fieldSize, scene.fieldSize);
+    Vector2 leftBottom(-scene.fieldSize * 0.5f, -scene.fieldSize * 0.5f);
+
+    std::vector<std::pair<Collider*, Collider*>> pairs;
+    std::list<Collider*> stack;
+
+    // 毎フレーム再構築（CollisionManager::RegisterColliderと同じ重複チェック込み）
+    {
+        QuadTree tree;
+        tree.Initialize(fieldSize, kBenchmarkTreeLevel, leftBottom);
+
+        std::vector<Collider*> registered;
+        std::mt19937 engine(kSeed);
+        double totalMs = 0.0;
+
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            MoveColliders(scene, engine, movingCount);
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+            registered.clear();
+            for (auto& collider : scene.colliders)
+            {
+                if (std::find(registered.begin(), registered.end(), collider.get()) == registered.end())
+                    registered.push_back(collider.get());
+            }
+            for (Collider* collider : registered)
+            {
+                tree.RegisterObj(collider);
+            }
+
+            pairs.clear();
+            tree.GetCollisionPair(0, pairs, stack);
+            tree.Reset();
+
+            totalMs += ElapsedMs(start);
+        }
+
+        result.rebuildMs = totalMs / _frameCount;
+        result.rebuildPairs = pairs.size();
+    }
+
+    std::vector<std::pair<Collider*, Collider*>> rebuildPairs = pairs;
+
+    // 同じ動きを再現するため初期配置に戻す
+    ScatterScene(scene, kSeed);
+
+    // 常駐登録（移動して所属空間が変わったものだけ付け替え）
+    {
+        QuadTree tree;
+        tree.Initialize(fieldSize, kBenchmarkTreeLevel, leftBottom);
+
+        for (auto& collider : scene.colliders)
+        {
+            tree.RegisterPersistentObj(collider.get());
+        }
+
+        std::mt19937 engine(kSeed);
+        double totalMs = 0.0;
+
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            MoveColliders(scene, engine, movingCount);
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+            tree.UpdatePersistentObjs();
+
+            pairs.clear();
+            tree.GetCollisionPair(0, pairs, stack);
+
+            totalMs += ElapsedMs(start);
+        }
+
+        result.persistentMs = totalMs / _frameCount;
+        result.persistentPairs = pairs.size();
+    }
+
+    ScatterScene(scene, kSeed);
+
+    // 線形四分木（モートン順ソート + 連続範囲の走査）
+    {
+        QuadTree tree;
+        tree.Initialize(fieldSize, kBenchmarkTreeLevel, leftBottom);
+
+        std::vector<Collider*> colliders;
+        colliders.reserve(scene.colliders.size());
+        for (auto& collider : scene.colliders)
+        {
+            colliders.push_back(collider.get());
+        }
+
+        std::mt19937 engine(kSeed);
+        double totalMs = 0.0;
+
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            MoveColliders(scene, engine, movingCount);
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+            pairs.clear();
+            tree.GetCollisionPairLinear(colliders, pairs);
+
+            totalMs += ElapsedMs(start);
+        }
+
+        result.linearMs = totalMs / _frameCount;
+        result.linearPairs = pairs.size();
+        result.isLinearPairSetEqual = IsSamePairSet(rebuildPairs, pairs);
+    }
+
+    return result;
+}
+
+void CollisionBenchmark::RunBroadPhaseSuite()
+{
+    for (uint32_t count : { 1000u, 10000u, 50000u })
+    {
+        BroadPhaseBenchmarkResult result = RunBroadPhase(count);
+        Debug::Log(std::format("[BroadPhase] colliders: {} rebuild: {:.3f} ms ({} pairs) persistent: {:.3f} ms ({} pairs) linear: {:.3f} ms ({} pairs, {})\n",
+            result.colliderCount, result.rebuildMs, result.rebuildPairs, result.persistentMs, result.persistentPairs,
+            result.linearMs, result.linearPairs, result.isLinearPairSetEqual ? "match" : "MISMATCH"));
+    }
+
+    for (uint32_t count : { 1000u, 5000u })
+    {
+        NarrowPhaseBenchmarkResult narrowResult = RunNarrowPhase(count);
+        Debug::Log(std::format("[NarrowPhase] spheres: {} pairs: {} scalar: {:.3f} ms ({} hits) batch: {:.3f} ms ({} hits, {})\n",
+            narrowResult.colliderCount, narrowResult.pairCount, narrowResult.scalarMs, narrowResult.scalarHits,
+            narrowResult.batchMs, narrowResult.batchHits, narrowResult.isContactEqual ? "match" : "MISMATCH"));
+    }
+
+    StaticBroadPhaseBenchmarkResult staticResult = RunStaticBroadPhase();
+    Debug::Log(std::format("[BroadPhase] statics: {} dynamics: {} legacy: {:.3f} ms ({} pairs) hashed: {:.3f} ms ({} pairs, {})\n",
+        staticResult.staticCount, staticResult.dynamicCount, staticResult.legacyMs, staticResult.legacyPairs,
+        staticResult.hashedMs, staticResult.hashedPairs, staticResult.isPairSetEqual ? "match" : "MISMATCH"));
+}
+
+NarrowPhaseBenchmarkResult CollisionBenchmark::RunNarrowPhase(uint32_t _colliderCount, uint32_t _frameCount)
+{
+    NarrowPhaseBenchmarkResult result;
+    result.colliderCount = _colliderCount;
+
+    if (_colliderCount == 0 || _frameCount == 0)
+        return result;
+
+    constexpr uint32_t kSeed = 12345;
+
+    // 弾幕を想定して通常の倍の密度で散らす
+    BenchmarkScene scene;
+    CreateScene(scene, _colliderCount);
+    scene.fieldSize *= 0.5f;
+    ScatterScene(scene, kSeed);
+
+    std::vector<Collider*> colliders;
+    colliders.reserve(scene.colliders.size());
+    for (auto& collider : scene.colliders)
+    {
+        colliders.push_back(collider.get());
+    }
+
+    Vector2 fieldSize(scene.fieldSize, scene.fieldSize);
+    Vector2 leftBottom(-scene.fieldSize * 0.5f, -scene.fieldSize * 0.5f);
+    QuadTree tree;
+    tree.Initialize(fieldSize, kBenchmarkTreeLevel, leftBottom);
+
+    std::vector<std::pair<Collider*, Collider*>> pairs;
+    tree.GetCollisionPairLinear(colliders, pairs);
+    result.pairCount = pairs.size();
+
+    // 1ペアずつ判定
+    std::vector<CollisionPair> scalarContacts;
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            scalarContacts.clear();
+            for (const auto& pair : pairs)
+            {
+                CollisionPair collisionPair;
+                if (CollisionDetector::DetectCollision(pair.first, pair.second, collisionPair.info))
+                {
+                    collisionPair.colliderA = pair.first;
+                    collisionPair.colliderB = pair.second;
+                    scalarContacts.push_back(collisionPair);
+                }
+            }
+        }
+        result.scalarMs = ElapsedMs(start) / _frameCount;
+        result.scalarHits = scalarContacts.size();
+    }
+
+    // まとめて判定
+    std::vector<CollisionPair> batchContacts;
+    {
+        BatchCollisionDetector detector;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            batchContacts.clear();
+            for (const auto& pair : pairs)
+            {
+                detector.AddPair(pair.first, pair.second);
+            }
+            detector.Execute(batchContacts);
+        }
+        result.batchMs = ElapsedMs(start) / _frameCount;
+        result.batchHits = batchContacts.size();
+    }
+
+    result.isContactEqual = IsSameContacts(scalarContacts, batchContacts);
+    return result;
+}
+
+StaticBroadPhaseBenchmarkResult CollisionBenchmark::RunStaticBroadPhase(uint32_t _staticCount, uint32_t _dynamicCount, uint32_t _frameCount)
+{
+    StaticBroadPhaseBenchmarkResult result;
+    result.staticCount = _staticCount;
+    result.dynamicCount = _dynamicCount;
+    result.frameCount = _frameCount;
+
+    if (_staticCount == 0 || _dynamicCount == 0 || _frameCount == 0)
+        return result;
+
+    constexpr uint32_t kStaticSeed = 54321;
+    constexpr uint32_t kDynamicSeed = 12345;
+    constexpr float kGridSize = 2.0f;
+
+    // 静的コライダーでレベルを埋め、動的コライダーを同じ範囲に散らす
+    BenchmarkScene staticScene;
+    CreateScene(staticScene, _staticCount);
+    ScatterScene(staticScene, kStaticSeed);
+
+    BenchmarkScene dynamicScene;
+    CreateScene(dynamicScene, _dynamicCount);
+    dynamicScene.fieldSize = staticScene.fieldSize;
+
+    SpatialHashGrid grid(kGridSize);
+    for (auto& collider : staticScene.colliders)
+    {
+        grid.AddCollider(collider.get());
+    }
+
+    std::vector<Collider*> dynamics;
+    dynamics.reserve(dynamicScene.colliders.size());
+    for (auto& collider : dynamicScene.colliders)
+    {
+        dynamics.push_back(collider.get());
+    }
+
+    Vector2 fieldSize(staticScene.fieldSize, staticScene.fieldSize);
+    Vector2 leftBottom(-staticScene.fieldSize * 0.5f, -staticScene.fieldSize * 0.5f);
+    QuadTree tree;
+    tree.Initialize(fieldSize, kBenchmarkTreeLevel, leftBottom);
+
+    uint32_t movingCount = _dynamicCount / 2;
+    std::vector<std::pair<Collider*, Collider*>> pairs;
+
+    // 旧方式
+    std::vector<std::pair<Collider*, Collider*>> legacyPairs;
+    {
+        ScatterScene(dynamicScene, kDynamicSeed);
+        std::mt19937 engine(kDynamicSeed);
+        double totalMs = 0.0;
+
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            MoveColliders(dynamicScene, engine, movingCount);
+
+            pairs.clear();
+            tree.GetCollisionPairLinear(dynamics, pairs);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            CollectStaticPairsLegacy(grid, dynamics, pairs);
+            totalMs += ElapsedMs(start);
+        }
+
+        result.legacyMs = totalMs / _frameCount;
+        result.legacyPairs = pairs.size();
+        legacyPairs = pairs;
+    }
+
+    // 新方式
+    {
+        ScatterScene(dynamicScene, kDynamicSeed);
+        std::mt19937 engine(kDynamicSeed);
+        ColliderPairSet pairSet;
+        std::vector<Collider*> queryResult;
+        double totalMs = 0.0;
+
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            MoveColliders(dynamicScene, engine, movingCount);
+
+            pairs.clear();
+            tree.GetCollisionPairLinear(dynamics, pairs);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            CollectStaticPairsHashed(grid, dynamics, pairs, pairSet, queryResult);
+            totalMs += ElapsedMs(start);
+        }
+
+        result.hashedMs = totalMs / _frameCount;
+        result.hashedPairs = pairs.size();
+        result.isPairSetEqual = IsSamePairSet(legacyPairs, pairs);
+    }
+
+    return result;
+}
+
+} // namespace Engine
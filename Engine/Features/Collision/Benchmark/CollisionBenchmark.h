@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+
+namespace Engine {
+
+// ブロードフェーズのベンチマーク結果
+struct BroadPhaseBenchmarkResult
+{
+    uint32_t colliderCount = 0;     // コライダーの数
+    uint32_t frameCount = 0;        // 計測したフレーム数
+    double rebuildMs = 0.0;         // 毎フレーム再構築の1フレーム平均(ms)
+    double persistentMs = 0.0;      // 常駐登録の1フレーム平均(ms)
+    size_t rebuildPairs = 0;        // 毎フレーム再構築で得たペア数（最終フレーム）
+    size_t persistentPairs = 0;     // 常駐登録で得たペア数（最終フレーム）
+    double linearMs = 0.0;          // 線形四分木の1フレーム平均(ms)
+    size_t linearPairs = 0;         // 線形四分木で得たペア数（最終フレーム）
+    bool isLinearPairSetEqual = false; // 線形四分木のペアの組み合わせが再構築と一致したか
+};
+
+// 静的コライダーとのブロードフェーズのベンチマーク結果
+struct StaticBroadPhaseBenchmarkResult
+{
+    uint32_t staticCount = 0;       // 静的コライダーの数
+    uint32_t dynamicCount = 0;      // 動的コライダーの数
+    uint32_t frameCount = 0;        // 計測したフレーム数
+    double legacyMs = 0.0;          // 検索毎にsetとvectorを生成し、ペア配列を線形走査する方式の1フレーム平均(ms)
+    double hashedMs = 0.0;          // 使い回しの検索結果とペアのハッシュセットを使う方式の1フレーム平均(ms)
+    size_t legacyPairs = 0;         // 旧方式で得たペア数（最終フレーム）
+    size_t hashedPairs = 0;         // 新方式で得たペア数（最終フレーム）
+    bool isPairSetEqual = false;    // ペアの組み合わせが一致したか
+};
+
+// 狭域判定のベンチマーク結果
+struct NarrowPhaseBenchmarkResult
+{
+    uint32_t colliderCount = 0;     // コライダーの数
+    size_t pairCount = 0;           // 判定したペア数
+    double scalarMs = 0.0;          // CollisionDetector::DetectCollisionで1ペアずつ判定した時間(ms)
+    double batchMs = 0.0;           // BatchCollisionDetectorでまとめて判定した時間(ms)
+    size_t scalarHits = 0;          // 1ペアずつ判定した場合の衝突数
+    size_t batchHits = 0;           // まとめて判定した場合の衝突数
+    bool isContactEqual = false;    // 衝突情報が全て一致したか
+};
+
+// 衝突判定まわりの処理時間を計測する
+class CollisionBenchmark
+{
+public:
+    /// <summary>
+    /// 毎フレーム再構築・常駐登録・線形四分木のブロードフェーズを比較する
+    /// </summary>
+    /// <param name="_colliderCount">コライダーの数</param>
+    /// <param name="_frameCount">計測するフレーム数</param>
+    /// <param name="_movingRatio">毎フレーム移動するコライダーの割合</param>
+    static BroadPhaseBenchmarkResult RunBroadPhase(uint32_t _colliderCount, uint32_t _frameCount = 10, float _movingRatio = 0.1f);
+
+    // 1k, 10k, 50kで計測してログに出力する
+    static void RunBroadPhaseSuite();
+
+    /// <summary>
+    /// 静的コライダーが多いレベルで、動的 vs 静的のペア収集を比較する
+    /// 動的同士のペアは計測外で求め、そこへ静的とのペアを重複なく追加する時間を計る
+    /// </summary>
+    /// <param name="_staticCount">静的コライダーの数</param>
+    /// <param name="_dynamicCount">動的コライダーの数</param>
+    /// <param name="_frameCount">計測するフレーム数</param>
+    static StaticBroadPhaseBenchmarkResult RunStaticBroadPhase(uint32_t _staticCount = 20000, uint32_t _dynamicCount = 2000, uint32_t _frameCount = 10);
+
+    /// <summary>
+    /// 球が密集した弾幕のような場面で、狭域判定を1ペアずつ行う場合とまとめて行う場合を比較する
+    /// </summary>
+    /// <param name="_colliderCount">球の数</param>
+    /// <param name="_frameCount">計測するフレーム数</param>
+    static NarrowPhaseBenchmarkResult RunNarrowPhase(uint32_t _colliderCount, uint32_t _frameCount = 10);
+};
+
+} // namespace Engine
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+namespace Engine {
+
+class Collider;
+
+/// <summary>
+/// コライダーのペアの重複チェック用ハッシュセット（向きは区別しない）
+/// オープンアドレス法で、Clearは世代番号を進めるだけなので容量を確保した後は確保なしで使い回せる
+/// </summary>
+class ColliderPairSet
+{
+public:
+    ColliderPairSet() = default;
+    ~ColliderPairSet() = default;
+
+    // 全て削除する（容量は保持）
+    void Clear()
+    {
+        count_ = 0;
+        ++generation_;
+
+        // 世代番号が一周したら古いエントリと区別できなくなるので埋め直す
+        if (generation_ == 0)
+        {
+            for (Entry& entry : entries_)
+                entry.generation = 0;
+            generation_ = 1;
+        }
+    }
+
+    // _count個のペアを再ハッシュなしで追加できるようにする
+    void Reserve(size_t _count)
+    {
+        size_t capacity = entries_.empty() ? kMinCapacity : entries_.size();
+        while (capacity < _count * 2)
+            capacity *= 2;
+
+        if (capacity != entries_.size())
+            Rehash(capacity);
+    }
+
+    /// <summary>
+    /// ペアを追加する
+    /// </summary>
+    /// <returns>新しく追加された場合はtrue すでにあった場合はfalse</returns>
+    bool Insert(const Collider* _a, const Collider* _b)
+    {
+        if ((count_ + 1) * 2 > entries_.size())
+            Rehash(entries_.empty() ? kMinCapacity : entries_.size() * 2);
+
+        Normalize(_a, _b);
+        return InsertNormalized(_a, _b);
+    }
+
+    // ペアが含まれているか
+    bool Contains(const Collider* _a, const Collider* _b) const
+    {
+        if (entries_.empty())
+            return false;
+
+        Normalize(_a, _b);
+        size_t mask = entries_.size() - 1;
+        for (size_t index = Hash(_a, _b) & mask; ; index = (index + 1) & mask)
+        {
+            const Entry& entry = entries_[index];
+            if (entry.generation != generation_)
+                return false;
+            if (entry.a == _a && entry.b == _b)
+                return true;
+        }
+    }
+
+    size_t GetCount() const { return count_; }
+    size_t GetCapacity() const { return entries_.size(); }
+
+private:
+    struct Entry
+    {
+        const Collider* a = nullptr;
+        const Collider* b = nullptr;
+        uint32_t generation = 0; // generation_と一致する場合のみ有効
+    };
+
+    static constexpr size_t kMinCapacity = 64;
+
+    // アドレスの小さい方をaにする
+    static void Normalize(const Collider*& _a, const Collider*& _b)
+    {
+        if (std::less<const Collider*>()(_b, _a))
+            std::swap(_a, _b);
+    }
+
+    static size_t Hash(const Collider* _a, const Collider* _b)
+    {
+        uint64_t h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(_a)) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(_b)) + 0x7F4A7C159E3779B9ull + (h << 6) + (h >> 2);
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+
+    bool InsertNormalized(const Collider* _a, const Collider* _b)
+    {
+        size_t mask = entries_.size() - 1;
+        for (size_t index = Hash(_a, _b) & mask; ; index = (index + 1) & mask)
+        {
+            Entry& entry = entries_[index];
+            if (entry.generation != generation_)
+            {
+                entry.a = _a;
+                entry.b = _b;
+                entry.generation = generation_;
+                ++count_;
+                return true;
+            }
+            if (entry.a == _a && entry.b == _b)
+                return false;
+        }
+    }
+
+    void Rehash(size_t _capacity)
+    {
+        std::vector<Entry> oldEntries;
+        oldEntries.swap(entries_);
+        uint32_t oldGeneration = generation_;
+
+        entries_.assign(_capacity, Entry());
+        count_ = 0;
+        generation_ = 1;
+
+        for (const Entry& entry : oldEntries)
+        {
+            if (entry.generation == oldGeneration)
+                InsertNormalized(entry.a, entry.b);
+        }
+    }
+
+private:
+    std::vector<Entry> entries_;
+    size_t count_ = 0;
+    uint32_t generation_ = 1;
+};
+
+} // namespace Engine
@@ -3,15 +3,19 @@
 #include <Math/Vector/VectorFunction.h>
 
 #include <Features/Collision/Manager/CollisionManager.h>
+#include <Features/Collision/RayCast/RayCollisionManager.h>
 #include <Features/LineDrawer/LineDrawer.h>
 
 #include <Debug/ImGuiDebugManager.h>
 
+#include <algorithm>
 #include <numbers>
 
 
 namespace Engine {
 
+std::atomic<uint64_t> Collider::nextId_ = 0;
+
 void Collider::Initialize()
 {
     if (isInitialized_)
@@ -23,7 +27,14 @@ void Collider::Initialize()
 
 Collider::~Collider()
 {
+    UnsubscribeWorldTransform();
+
+    // 一時コライダーは登録されていないので何もしない（ワーカースレッドで破棄されることがある）
+    if (isTemporary_)
+        return;
+
     CollisionManager::GetInstance()->UnregisterCollider(this);
+    RayCollisionManager::GetInstance()->UnregisterCollider(this);
 
 #ifdef _DEBUG
     ImGuiDebugManager::GetInstance()->RemoveDebugWindow(name_);
@@ -40,32 +51,13 @@ void Collider::OnCollision(Collider* _other, const ColliderInfo& _info)
 
 bool Collider::IsCollidingWith(Collider* _other) const
 {
-    std::lock_guard<std::mutex> lock(collisionMutex_);
-    auto it = collisionMap_.find(_other);
-    if (it != collisionMap_.end()) {
-        return it->second.isColliding;
-    }
-    return false;
+    CollisionState state = CollisionManager::GetInstance()->GetContactCache().GetState(this, _other);
+    return state == CollisionState::Enter || state == CollisionState::Stay;
 }
 
 CollisionState Collider::GetCollisionState(Collider* _other) const
 {
-    auto it = collisionMap_.find(_other);
-    if (it != collisionMap_.end()) {
-        const CollisionData& data = it->second;
-
-        if (data.isColliding && !data.wasColliding) {
-            return CollisionState::Enter; // 衝突開始
-        }
-        else if (data.isColliding && data.wasColliding) {
-            return CollisionState::Stay;  // 衝突中
-        }
-        else if (!data.isColliding && data.wasColliding) {
-            return CollisionState::Exit;  // 衝突終了
-        }
-    }
-
-    return CollisionState::None; // 衝突なし
+    return CollisionManager::GetInstance()->GetContactCache().GetState(this, _other);
 }
 
 WorldTransform* Collider::GetWorldTransform()
@@ -89,6 +81,51 @@ const WorldTransform* Collider::GetWorldTransform() const
     return worldTransform_;
 }
 
+void Collider::SetWorldTransform(WorldTransform* _worldTransform)
+{
+    // 購読先を新しいワールドトランスフォームに付け替える
+    bool isSubscribed = transformListenerId_ != 0;
+    UnsubscribeWorldTransform();
+    worldTransform_ = _worldTransform;
+    if (isSubscribed)
+        SubscribeWorldTransform();
+
+    MarkBoundsDirty();
+}
+
+uint32_t Collider::AddMoveListener(ChangeNotifier::Listener _listener)
+{
+    if (moveNotifier_.IsEmpty())
+        SubscribeWorldTransform();
+
+    return moveNotifier_.Add(std::move(_listener));
+}
+
+void Collider::RemoveMoveListener(uint32_t _id)
+{
+    moveNotifier_.Remove(_id);
+
+    if (moveNotifier_.IsEmpty())
+        UnsubscribeWorldTransform();
+}
+
+void Collider::SubscribeWorldTransform()
+{
+    std::shared_ptr<ChangeNotifier> notifier = GetWorldTransform()->GetVersionNotifier();
+    transformListenerId_ = notifier->Add([this]() { moveNotifier_.Notify(); });
+    transformNotifier_ = notifier;
+}
+
+void Collider::UnsubscribeWorldTransform()
+{
+    // ワールドトランスフォームが先に破棄されていれば解除するものはない
+    if (std::shared_ptr<ChangeNotifier> notifier = transformNotifier_.lock())
+        notifier->Remove(transformListenerId_);
+
+    transformNotifier_.reset();
+    transformListenerId_ = 0;
+}
+
 Vector3 Collider::GetSize() const
 {
     Vector3 scale;
@@ -109,28 +146,51 @@ Vector3 Collider::GetSize() const
     };
 }
 
-void Collider::AddCurrentCollision(Collider* _other, const ColliderInfo& _info)
+void Collider::SetContinuous(bool _isContinuous)
 {
-    std::lock_guard<std::mutex> lock(collisionMutex_);
+    isContinuous_ = _isContinuous;
 
-    // 現在のフレームでの衝突を記録
-    currentCollisions_.push_back(_other);
+    // 有効にした直後のフレームは掃引しない
+    hasPreviousPosition_ = false;
+    MarkBoundsDirty();
+}
 
-    // 衝突マップに追加または更新
-    auto it = collisionMap_.find(_other);
-    if (it != collisionMap_.end()) {
-        // 既存のエントリを更新
-        it->second.info = _info;
-        it->second.isColliding = true;
-    }
-    else {
-        // 新しいエントリを追加
-        CollisionData data;
-        data.info = _info;
-        data.isColliding = true;
-        data.wasColliding = false;
-        collisionMap_[_other] = data;
-    }
+Vector3 Collider::GetSweepDisplacement() const
+{
+    if (!isContinuous_ || !hasPreviousPosition_)
+        return Vector3(0.0f, 0.0f, 0.0f);
+
+    return GetWorldTransform()->GetWorldPosition() - previousPosition_;
+}
+
+AABB Collider::GetSweptBounds() const
+{
+    AABB bounds = GetBounds();
+
+    Vector3 displacement = GetSweepDisplacement();
+    if (displacement.x == 0.0f && displacement.y == 0.0f && displacement.z == 0.0f)
+        return bounds;
+
+    // 前フレームの位置のAABBと合わせる
+    Vector3 previousMin = bounds.min - displacement;
+    Vector3 previousMax = bounds.max - displacement;
+    bounds.min = Vector3(std::min(bounds.min.x, previousMin.x), std::min(bounds.min.y, previousMin.y), std::min(bounds.min.z, previousMin.z));
+    bounds.max = Vector3(std::max(bounds.max.x, previousMax.x), std::max(bounds.max.y, previousMax.y), std::max(bounds.max.z, previousMax.z));
+    return bounds;
+}
+
+void Collider::UpdatePreviousPosition()
+{
+    if (!isContinuous_)
+        return;
+
+    // 掃引範囲が変わるので、動いていれば範囲が変わったものとする
+    Vector3 position = GetWorldTransform()->GetWorldPosition();
+    if (!hasPreviousPosition_ || position.x != previousPosition_.x || position.y != previousPosition_.y || position.z != previousPosition_.z)
+        MarkBoundsDirty();
+
+    previousPosition_ = position;
+    hasPreviousPosition_ = true;
 }
 
 bool Collider::InitJsonBinder(const std::string& _name, const std::string& _folderPath)
@@ -141,11 +201,13 @@ bool Collider::InitJsonBinder(const std::string& _name, const std::string& _fold
 
         collisionLayer_.RegisterLayer(jsonBinder_);
         jsonBinder_->RegisterVariable("isStatic", &isStatic_);
+        jsonBinder_->RegisterVariable("isContinuous", &isContinuous_);
         jsonBinder_->RegisterVariable("boundingBox", reinterpret_cast<uint32_t*>(&boundingBox_));
         jsonBinder_->RegisterVariable("transform", &defaultTransform_.transform_);
         jsonBinder_->RegisterVariable("scale", &defaultTransform_.scale_);
         jsonBinder_->RegisterVariable("quaternion", &defaultTransform_.quaternion_);
 
+        MarkBoundsDirty();
         return true;
     }
 
@@ -156,74 +218,55 @@ void Collider::ImGui()
 {
 #ifdef _DEBUG
 
+    bool isChanged = false;
     if (worldTransform_ == nullptr)
     {
-        ImGui::DragFloat3("Position", &defaultTransform_.transform_.x, 0.01f);
-        ImGui::DragFloat3("Scale", &defaultTransform_.scale_.x, 0.01f);
-        ImGui::DragFloat4("Quaternion", &defaultTransform_.quaternion_.x, 0.01f);
+        isChanged |= ImGui::DragFloat3("Position", &defaultTransform_.transform_.x, 0.01f);
+        isChanged |= ImGui::DragFloat3("Scale", &defaultTransform_.scale_.x, 0.01f);
+        isChanged |= ImGui::DragFloat4("Quaternion", &defaultTransform_.quaternion_.x, 0.01f);
     }
 
-    ImGui::DragFloat3("Offset", &offset_.x, 0.01f);
+    isChanged |= ImGui::DragFloat3("Offset", &offset_.x, 0.01f);
+    if (isChanged)
+        MarkBoundsDirty();
     ImGui::Text("Layer      : %x", collisionLayer_.GetLayer());
     ImGui::Text("LayerMask  : %x", collisionLayer_.GetLayerMask());
     ImGui::Text("BoundingBox: %s", ToString(boundingBox_).c_str());
     ImGui::Checkbox("Draw", &isDraw_);
+    if (ImGui::Checkbox("Continuous", &isContinuous_))
+    {
+        hasPreviousPosition_ = false;
+        MarkBoundsDirty();
+    }
 
 #endif // _DEBUG
 }
 
-void Collider::UpdateCollisionState()
+void Collider::OnCollisionState(Collider* _other, const ColliderInfo& _info)
 {
-    std::lock_guard<std::mutex> lock(collisionMutex_);
-
-    // すべてのマップエントリについて、現在衝突していないとマーク
-    for (auto& pair : collisionMap_) {
-        pair.second.isColliding = false;
-    }
-
-    // 現在のフレームでの衝突を設定
-    for (Collider* other : currentCollisions_) {
-        auto it = collisionMap_.find(other);
-        if (it != collisionMap_.end()) {
-            it->second.isColliding = true;
-        }
-    }
-
-    // 状態の変化をチェックし、必要に応じてコールバックを実行
-    for (auto& pair : collisionMap_) {
-        Collider* other = pair.first;
-        CollisionData& data = pair.second;
-
-        ColliderInfo info = data.info;
-
-        if (data.isColliding && !data.wasColliding) {
-            // 衝突開始
-            info.state = CollisionState::Enter;
-            if (fOnCollisionEnter_) {
-                fOnCollisionEnter_(other, info);
-            }
+    switch (_info.state)
+    {
+    case CollisionState::Enter:
+        // 衝突開始
+        if (fOnCollisionEnter_) {
+            fOnCollisionEnter_(_other, _info);
         }
-        else if (data.isColliding && data.wasColliding) {
-            // 衝突中
-            info.state = CollisionState::Stay;
-            if (fOnCollisionStay_) {
-                fOnCollisionStay_(other, info);
-            }
+        break;
+    case CollisionState::Stay:
+        // 衝突中
+        if (fOnCollisionStay_) {
+            fOnCollisionStay_(_other, _info);
         }
-        else if (!data.isColliding && data.wasColliding) {
-            // 衝突終了
-            info.state = CollisionState::Exit;
-            if (fOnCollisionExit_) {
-                fOnCollisionExit_(other, info);
-            }
+        break;
+    case CollisionState::Exit:
+        // 衝突終了
+        if (fOnCollisionExit_) {
+            fOnCollisionExit_(_other, _info);
         }
-
-        // 現在の状態を前フレームの状態として保存
-        data.wasColliding = data.isColliding;
+        break;
+    default:
+        break;
     }
-
-    // 現在のフレームでの衝突リストをクリア
-    currentCollisions_.clear();
 }
 
 SphereCollider::SphereCollider([[maybe_unused]]const char* _name) : Collider()
@@ -272,6 +315,7 @@ void SphereCollider::SetRadius(float _radius)
 {
     radius_ = _radius;
     size_ = Vector3(_radius, _radius, _radius);
+    MarkBoundsDirty();
 }
 
 bool SphereCollider::Contains(const Vector3& _point)
@@ -328,9 +372,10 @@ void SphereCollider::ImGui()
 #endif // _DEBUG
 }
 
- SphereCollider::SphereCollider([[maybe_unused]] bool _isTemporary) : Collider()
+ SphereCollider::SphereCollider(bool _isTemporary) : Collider()
 {
     SetBoundingBox(BoundingBox::Sphere_3D);
+    isTemporary_ = _isTemporary;
 }
 
  AABBCollider::AABBCollider([[maybe_unused]]const char* _name) : Collider()
@@ -395,6 +440,7 @@ void AABBCollider::SetMinMax(const Vector3& _min, const Vector3& _max)
     max_ = _max;
     // サイズを更新
     size_ = max_ - min_;
+    MarkBoundsDirty();
 }
 
 bool AABBCollider::Contains(const Vector3& _point)
@@ -459,9 +505,10 @@ void AABBCollider::ImGui()
 #endif // _DEBUG
 }
 
-AABBCollider::AABBCollider([[maybe_unused]] bool _isTemporary) : Collider()
+AABBCollider::AABBCollider(bool _isTemporary) : Collider()
 {
     SetBoundingBox(BoundingBox::AABB_3D);
+    isTemporary_ = _isTemporary;
 }
 
 OBBCollider::OBBCollider([[maybe_unused]] const char* _name) : Collider()
@@ -517,6 +564,7 @@ void OBBCollider::SetHalfExtents(const Vector3& _halfExtents)
 {
     halfExtents_ = _halfExtents;
     size_ = halfExtents_ * 2.0f; // サイズは半分の大きさの2倍
+    MarkBoundsDirty();
 }
 
 bool OBBCollider::Contains(const Vector3& _point)
@@ -639,9 +687,10 @@ void OBBCollider::ImGui()
 #endif // _DEBUG
 }
 
-OBBCollider::OBBCollider([[maybe_unused]] bool _isTemporary) : Collider()
+OBBCollider::OBBCollider(bool _isTemporary) : Collider()
 {
     SetBoundingBox(BoundingBox::OBB_3D);
+    isTemporary_ = _isTemporary;
 }
 
  CapsuleCollider::CapsuleCollider([[maybe_unused]] const char* _name) : Collider()
@@ -790,6 +839,7 @@ void CapsuleCollider::SetRadius(float _radius)
 {
     radius_ = _radius;
     size_ = GetCapsuleAABBSize();
+    MarkBoundsDirty();
 }
 
 void CapsuleCollider::SetHeight(float _height)
@@ -797,6 +847,7 @@ void CapsuleCollider::SetHeight(float _height)
     height_ = _height;
     // サイズは半径の2倍と高さ
     size_ = GetCapsuleAABBSize();
+    MarkBoundsDirty();
 }
 
 bool CapsuleCollider::Contains(const Vector3& _point)
@@ -929,9 +980,10 @@ Vector3 CapsuleCollider::GetCapsuleAABBSize()
     return max - min;
 }
 
-CapsuleCollider::CapsuleCollider([[maybe_unused]] bool _isTemporary) : Collider()
+CapsuleCollider::CapsuleCollider(bool _isTemporary) : Collider()
 {
     SetBoundingBox(BoundingBox::Capsule_3D);
+    isTemporary_ = _isTemporary;
 }
 
 AABB CapsuleCollider::GetBounds() const
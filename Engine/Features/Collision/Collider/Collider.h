@@ -13,7 +13,7 @@
 #include <functional>
 #include <variant>
 #include <cassert>
-#include <mutex>
+#include <atomic>
 
 
 namespace Engine {
@@ -34,6 +34,7 @@ struct ColliderInfo
     Vector3 contactPoint;           // 衝突点
     Vector3 contactNormal;          // 衝突面の法線
     float penetration = 0.0f;       // めりこみ量
+    float timeOfImpact = 1.0f;      // 前フレームの位置からの移動のうち最初に接触した割合(0~1) CCD無効時は1
     CollisionState state = CollisionState::None; // 衝突状態
 
     ColliderInfo() = default;
@@ -100,17 +101,20 @@ public:
     // 衝突イベント処理（CollisionManagerから呼ばれる）
     void OnCollision(Collider* _other, const ColliderInfo& _info);
 
-    // 衝突状態を更新（CollisionManagerから呼ばれる）
-    void UpdateCollisionState();
+    // 衝突状態の変化の通知（CollisionManagerから呼ばれる 状態はColliderInfoのstateフィールド）
+    void OnCollisionState(Collider* _other, const ColliderInfo& _info);
 
     // 特定のコライダーとの衝突状態を取得
     CollisionState GetCollisionState(Collider* _other) const;
 
     // 任意のコライダーと衝突しているかどうか
-    bool IsColliding() const {
-        std::lock_guard<std::mutex> lock(collisionMutex_);
-        return !currentCollisions_.empty();
-    }
+    bool IsColliding() const { return contactCount_ > 0; }
+
+    // 衝突しているコライダーの数を設定（ContactCacheから呼ばれる）
+    void SetContactCount(uint32_t _count) { contactCount_ = _count; }
+
+    // 衝突しているコライダーの数を取得
+    uint32_t GetContactCount() const { return contactCount_; }
 
     // 特定のコライダーと衝突しているかどうか
     bool IsCollidingWith(Collider* _other) const;
@@ -162,14 +166,14 @@ public:
     void SetBoundingBox(BoundingBox _boundingBox) { boundingBox_ = _boundingBox; }
 
     // ワールドトランスフォームを設定する
-    void SetWorldTransform(WorldTransform* _worldTransform) { worldTransform_ = _worldTransform; }
+    void SetWorldTransform(WorldTransform* _worldTransform);
 
     // ワールドトランスフォームを取得する
     WorldTransform* GetWorldTransform();
 
     const  WorldTransform* GetWorldTransform() const;
     // コライダーのオフセットを設定する
-    void SetOffset(const Vector3& _offset) { offset_ = _offset; }
+    void SetOffset(const Vector3& _offset) { offset_ = _offset; MarkBoundsDirty(); }
 
     // コライダーのオフセットを取得する
     Vector3 GetOffset() const { return offset_; }
@@ -185,11 +189,36 @@ public:
     // _pointから最も近い点を求める
     virtual Vector3 GetClosestPoint(const Vector3& _point) = 0;
 
-    // 現在衝突中のコライダーを追加（CollisionManagerから呼ばれる）- スレッドセーフ版
-    void AddCurrentCollision(Collider* _other, const ColliderInfo& _info);
-
     std::string GetName() const { return name_; }
 
+    // 連続衝突判定（CCD）の有効/無効を設定する
+    // 有効にすると前フレームの位置から現在の位置までの移動を掃引して判定する（高速な弾など）
+    void SetContinuous(bool _isContinuous);
+
+    // 連続衝突判定が有効かどうか
+    bool IsContinuous() const { return isContinuous_; }
+
+    // 前フレームの位置からの移動量（CCD無効時はゼロ）
+    Vector3 GetSweepDisplacement() const;
+
+    // 前フレームの位置から現在の位置までを覆うAABB（CCD無効時はGetBoundsと同じ）
+    AABB GetSweptBounds() const;
+
+    // 現在の位置を前フレームの位置として記録する（CollisionManagerから呼ばれる）
+    void UpdatePreviousPosition();
+
+    // 作られた順に振られる番号 アドレスと違い実行毎に同じになるので、並び順を決めるのに使う
+    uint64_t GetId() const { return id_; }
+
+    // 形状・オフセット・ワールドトランスフォームの設定が変わるたびに増える
+    // ワールドトランスフォーム自体の移動はWorldTransform::GetVersionで判定する
+    uint32_t GetBoundsVersion() const { return boundsVersion_; }
+
+    // ワールドトランスフォームの移動か範囲の変更があったときに呼ばれる処理を登録する
+    // 常駐コライダーのブロードフェーズが、動いたものだけを処理するのに使う 戻り値は解除に使うID
+    uint32_t AddMoveListener(ChangeNotifier::Listener _listener);
+    void RemoveMoveListener(uint32_t _id);
+
     // Drawフラグを取得
     bool GetDrawFlag() const { return isDraw_; }
 
@@ -202,6 +231,9 @@ protected:
 
     void ImGui();
 
+    // 範囲に関わる設定を変えたときに呼ぶ
+    void MarkBoundsDirty() { ++boundsVersion_; moveNotifier_.Notify(); }
+
     JsonBinder* jsonBinder_ = nullptr;
 
     std::string name_;
@@ -210,28 +242,33 @@ protected:
 
     bool isDraw_ = true;
 
+    // 判定用に一時的に作られたコライダーかどうか（マネージャーへの登録や解除を行わない）
+    bool isTemporary_ = false;
+
     Vector3 offset_ = Vector3(0.0f, 0.0f, 0.0f); // コライダーのオフセット
 
 private:
-    // 衝突状態の管理
-    struct CollisionData
-    {
-        ColliderInfo info;
-        bool wasColliding = false;
-        bool isColliding = false;
-    };
-
     bool isStatic_ = false; // 静的かどうか 動かない物体
+    bool isContinuous_ = false; // 連続衝突判定を行うかどうか
+    bool hasPreviousPosition_ = false; // 前フレームの位置が記録されているか
+    Vector3 previousPosition_; // 前フレームのワールド座標
     CollisionLayer collisionLayer_; // 衝突判定の属性
     BoundingBox boundingBox_ = BoundingBox::NONE; // 衝突判定の形状
     WorldTransform* worldTransform_ = nullptr; // ワールド行列
+    uint64_t id_ = nextId_.fetch_add(1, std::memory_order_relaxed); // 作られた順の番号（一時コライダーはワーカースレッドで作られることがある）
+    static std::atomic<uint64_t> nextId_;
+    uint32_t boundsVersion_ = 0; // 範囲に関わる設定の変更回数
+
+    ChangeNotifier moveNotifier_; // 動いたときの通知先
+    std::weak_ptr<ChangeNotifier> transformNotifier_; // 購読中のWorldTransformの通知 先に破棄されることがある
+    uint32_t transformListenerId_ = 0;
 
-    // 衝突状態の記録（スレッドセーフにするためのミューテックス）
-    mutable std::mutex collisionMutex_;
-    std::unordered_map<Collider*, CollisionData> collisionMap_;
+    // 通知先がいる間だけワールドトランスフォームの移動を購読する
+    void SubscribeWorldTransform();
+    void UnsubscribeWorldTransform();
 
-    // 現在のフレームで衝突しているコライダーのリスト（UpdateCollisionStateで使用）
-    std::vector<Collider*> currentCollisions_;
+    // 衝突しているコライダーの数（衝突状態そのものはCollisionManagerのContactCacheが持つ）
+    uint32_t contactCount_ = 0;
 
     // 衝突コールバック関数
     CollisionCallBack fOnCollision_;
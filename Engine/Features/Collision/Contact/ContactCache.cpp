@@ -0,0 +1,158 @@
+#include "ContactCache.h"
+
+#include <algorithm>
+
+
+namespace Engine {
+
+void ContactCache::Add(Collider* _colliderA, Collider* _colliderB, const ColliderInfo& _info)
+{
+    Contact contact;
+    contact.colliderA = _colliderA;
+    contact.colliderB = _colliderB;
+    contact.info = _info;
+
+    // GetIdの小さい方をAにそろえる 法線はAから見た向きにする
+    if (IsColliderLess(_colliderB, _colliderA))
+    {
+        std::swap(contact.colliderA, contact.colliderB);
+        contact.info.contactNormal = -_info.contactNormal;
+    }
+
+    pending_.push_back(contact);
+}
+
+void ContactCache::Update()
+{
+    ++generation_;
+
+    // 前回のペアのコライダーの衝突数をリセット
+    for (const Contact& contact : contacts_)
+    {
+        contact.colliderA->SetContactCount(0);
+        contact.colliderB->SetContactCount(0);
+    }
+
+    // 同じペアは追加された順に並ぶので、先頭だけ残す
+    std::stable_sort(pending_.begin(), pending_.end(), IsLess);
+    pending_.erase(std::unique(pending_.begin(), pending_.end(), [](const Contact& _lhs, const Contact& _rhs) {
+        return _lhs.colliderA == _rhs.colliderA && _lhs.colliderB == _rhs.colliderB;
+        }), pending_.end());
+
+    // 前回と今回をマージして状態を決める
+    merged_.clear();
+    merged_.reserve(contacts_.size() + pending_.size());
+
+    auto previous = contacts_.begin();
+    auto current = pending_.begin();
+    while (previous != contacts_.end() || current != pending_.end())
+    {
+        bool hasPrevious = previous != contacts_.end();
+        bool hasCurrent = current != pending_.end();
+
+        if (hasPrevious && (!hasCurrent || IsLess(*previous, *current)))
+        {
+            // 今回衝突していない 前回Exitならここで削除
+            if (previous->info.state != CollisionState::Exit)
+            {
+                Contact& contact = merged_.emplace_back(*previous);
+                contact.info.state = CollisionState::Exit;
+            }
+            ++previous;
+        }
+        else if (hasCurrent && (!hasPrevious || IsLess(*current, *previous)))
+        {
+            // 今回から衝突した
+            Contact& contact = merged_.emplace_back(*current);
+            contact.info.state = CollisionState::Enter;
+            ++current;
+        }
+        else
+        {
+            // 前回も今回も衝突している（前回Exitなら入り直し）
+            bool wasColliding = previous->info.state != CollisionState::Exit;
+            Contact& contact = merged_.emplace_back(*current);
+            contact.info.state = wasColliding ? CollisionState::Stay : CollisionState::Enter;
+            ++previous;
+            ++current;
+        }
+    }
+
+    contacts_.swap(merged_);
+    pending_.clear();
+
+    // 衝突中のペアの数を数える
+    for (const Contact& contact : contacts_)
+    {
+        if (contact.info.state == CollisionState::Exit)
+            continue;
+
+        contact.colliderA->SetContactCount(contact.colliderA->GetContactCount() + 1);
+        contact.colliderB->SetContactCount(contact.colliderB->GetContactCount() + 1);
+    }
+}
+
+void ContactCache::RemoveCollider(const Collider* _collider)
+{
+    auto containsCollider = [_collider](const Contact& _contact) {
+        return _contact.colliderA == _collider || _contact.colliderB == _collider;
+        };
+
+    // 相手側の衝突数から除く
+    for (const Contact& contact : contacts_)
+    {
+        if (!containsCollider(contact) || contact.info.state == CollisionState::Exit)
+            continue;
+
+        Collider* other = contact.colliderA == _collider ? contact.colliderB : contact.colliderA;
+        other->SetContactCount(other->GetContactCount() - 1);
+    }
+
+    contacts_.erase(std::remove_if(contacts_.begin(), contacts_.end(), containsCollider), contacts_.end());
+    pending_.erase(std::remove_if(pending_.begin(), pending_.end(), containsCollider), pending_.end());
+}
+
+void ContactCache::Clear()
+{
+    contacts_.clear();
+    pending_.clear();
+    merged_.clear();
+}
+
+const ContactCache::Contact* ContactCache::Find(const Collider* _colliderA, const Collider* _colliderB) const
+{
+    Contact key;
+    key.colliderA = const_cast<Collider*>(_colliderA);
+    key.colliderB = const_cast<Collider*>(_colliderB);
+    if (IsColliderLess(_colliderB, _colliderA))
+        std::swap(key.colliderA, key.colliderB);
+
+    auto it = std::lower_bound(contacts_.begin(), contacts_.end(), key, IsLess);
+    if (it == contacts_.end() || it->colliderA != key.colliderA || it->colliderB != key.colliderB)
+        return nullptr;
+
+    return &*it;
+}
+
+CollisionState ContactCache::GetState(const Collider* _colliderA, const Collider* _colliderB) const
+{
+    const Contact* contact = Find(_colliderA, _colliderB);
+    if (contact == nullptr)
+        return CollisionState::None;
+
+    return contact->info.state;
+}
+
+bool ContactCache::IsLess(const Contact& _lhs, const Contact& _rhs)
+{
+    if (_lhs.colliderA != _rhs.colliderA)
+        return IsColliderLess(_lhs.colliderA, _rhs.colliderA);
+    return IsColliderLess(_lhs.colliderB, _rhs.colliderB);
+}
+
+bool ContactCache::IsColliderLess(const Collider* _lhs, const Collider* _rhs)
+{
+    return _lhs->GetId() < _rhs->GetId();
+}
+
+} // namespace Engine
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Features/Collision/Collider/Collider.h>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace Engine {
+
+/// <summary>
+/// 衝突しているコライダーのペアを保持し、前フレームとの差分からEnter/Stay/Exitを求める
+/// ペアはCollider::GetIdの小さい方をcolliderAとした順でソートした配列で持ち、
+/// 毎フレーム今回の衝突をソートして前回の配列とマージするだけで状態が決まる
+/// 並びはコライダーを作った順で決まるので、Enter/Stay/Exitの通知順は実行毎に同じになる
+/// 更新はメインスレッドでのみ行い、更新以外の間は読み取りのみなのでロックは不要
+/// </summary>
+class ContactCache
+{
+public:
+    struct Contact
+    {
+        Collider* colliderA = nullptr;  // GetIdの小さい方
+        Collider* colliderB = nullptr;
+        ColliderInfo info;              // colliderAから見た衝突情報（Exitの場合は最後に衝突したときのもの）
+    };
+
+public:
+    ContactCache() = default;
+    ~ContactCache() = default;
+
+    // 今回のフレームで衝突したペアを追加する（同じペアが複数回追加された場合は最初のものを使う）
+    void Add(Collider* _colliderA, Collider* _colliderB, const ColliderInfo& _info);
+
+    /// <summary>
+    /// 世代を進めて、追加されたペアと前回のペアの差分から状態を決める
+    /// 状態はinfo.stateに入る 前回Exitだったペアはここで削除される
+    /// 各コライダーの衝突数（Collider::IsColliding用）もここで更新する
+    /// </summary>
+    void Update();
+
+    // コライダーを含むペアを削除する（コライダーの破棄時）
+    void RemoveCollider(const Collider* _collider);
+
+    // 全て削除する
+    void Clear();
+
+    // ペアを取得する 見つからなければnullptr（info.contactNormalはcolliderAから見た向き）
+    const Contact* Find(const Collider* _colliderA, const Collider* _colliderB) const;
+
+    // 2つのコライダーの衝突状態を取得する
+    CollisionState GetState(const Collider* _colliderA, const Collider* _colliderB) const;
+
+    // 現在のペアの一覧（ソート済み Exitのペアも含む）
+    const std::vector<Contact>& GetContacts() const { return contacts_; }
+
+    // 現在の世代
+    uint64_t GetGeneration() const { return generation_; }
+
+private:
+    // ペアの並び順
+    static bool IsLess(const Contact& _lhs, const Contact& _rhs);
+    // コライダーの並び順 GetIdで比べる
+    static bool IsColliderLess(const Collider* _lhs, const Collider* _rhs);
+
+private:
+    std::vector<Contact> contacts_;     // 前回の更新で決まったペア
+    std::vector<Contact> pending_;      // 今回のフレームで追加されたペア
+    std::vector<Contact> merged_;       // マージ用の作業領域
+    uint64_t generation_ = 0;
+};
+
+} // namespace Engine
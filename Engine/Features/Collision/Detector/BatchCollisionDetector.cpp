@@ -0,0 +1,701 @@
+#include "BatchCollisionDetector.h"
+
+#include <Features/Collision/Detector/CollisionDetector.h>
+#include <Math/Matrix/MatrixFunction.h>
+#include <Math/Vector/VectorFunction.h>
+
+#include <immintrin.h>
+#include <algorithm>
+#include <cmath>
+
+
+namespace Engine {
+
+namespace {
+
+constexpr size_t kLaneCount = 4;
+constexpr float kEpsilon = 0.0001f;
+
+// _mask ? _a : _b
+inline __m128 Select(__m128 _mask, __m128 _a, __m128 _b)
+{
+    return _mm_or_ps(_mm_and_ps(_mask, _a), _mm_andnot_ps(_mask, _b));
+}
+
+// std::min(_a, _b)と同じ結果 (_b < _a ? _b : _a)
+inline __m128 Min(__m128 _a, __m128 _b)
+{
+    return _mm_min_ps(_b, _a);
+}
+
+// std::max(_a, _b)と同じ結果 (_a < _b ? _b : _a)
+inline __m128 Max(__m128 _a, __m128 _b)
+{
+    return _mm_max_ps(_b, _a);
+}
+
+// std::clamp(_v, _lo, _hi)と同じ結果
+inline __m128 Clamp(__m128 _v, __m128 _lo, __m128 _hi)
+{
+    __m128 upper = Select(_mm_cmplt_ps(_hi, _v), _hi, _v);
+    return Select(_mm_cmplt_ps(_v, _lo), _lo, upper);
+}
+
+// Vector3::LengthSquaredと同じ順序で加算する
+inline __m128 Dot3(__m128 _ax, __m128 _ay, __m128 _az, __m128 _bx, __m128 _by, __m128 _bz)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(_ax, _bx), _mm_mul_ps(_ay, _by)), _mm_mul_ps(_az, _bz));
+}
+
+inline __m128 Load(const std::vector<float>& _lanes, size_t _index)
+{
+    return _mm_loadu_ps(_lanes.data() + _index);
+}
+
+// ヒットしたレーンの結果を書き込む
+struct LaneResult
+{
+    alignas(16) float px[kLaneCount], py[kLaneCount], pz[kLaneCount];
+    alignas(16) float nx[kLaneCount], ny[kLaneCount], nz[kLaneCount];
+    alignas(16) float penetration[kLaneCount];
+
+    void Store(__m128 _px, __m128 _py, __m128 _pz, __m128 _nx, __m128 _ny, __m128 _nz, __m128 _penetration)
+    {
+        _mm_store_ps(px, _px);
+        _mm_store_ps(py, _py);
+        _mm_store_ps(pz, _pz);
+        _mm_store_ps(nx, _nx);
+        _mm_store_ps(ny, _ny);
+        _mm_store_ps(nz, _nz);
+        _mm_store_ps(penetration, _penetration);
+    }
+
+    void Write(size_t _lane, ColliderInfo& _info) const
+    {
+        _info.hasCollision = true;
+        _info.contactPoint = Vector3(px[_lane], py[_lane], pz[_lane]);
+        _info.contactNormal = Vector3(nx[_lane], ny[_lane], nz[_lane]);
+        _info.penetration = penetration[_lane];
+    }
+};
+
+inline size_t HashPointer(const void* _pointer)
+{
+    uint64_t h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(_pointer));
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+}
+
+// 有効なレーンのビット
+inline int ValidLaneMask(size_t _index, size_t _count)
+{
+    size_t rest = _count - _index;
+    return rest >= kLaneCount ? 0xF : (1 << rest) - 1;
+}
+
+} // namespace
+
+void BatchCollisionDetector::SphereSphereBatch::Clear()
+{
+    center1.Clear();
+    center2.Clear();
+    radius1.clear();
+    radius2.clear();
+    baseRadius1.clear();
+    outIndex.clear();
+}
+
+void BatchCollisionDetector::SphereAABBBatch::Clear()
+{
+    center.Clear();
+    radius.clear();
+    boxMin.Clear();
+    boxMax.Clear();
+    isFlipped.clear();
+    outIndex.clear();
+}
+
+void BatchCollisionDetector::AABBAABBBatch::Clear()
+{
+    min1.Clear();
+    max1.Clear();
+    center1.Clear();
+    min2.Clear();
+    max2.Clear();
+    center2.Clear();
+    outIndex.clear();
+}
+
+void BatchCollisionDetector::CapsuleCapsuleBatch::Clear()
+{
+    start1.Clear();
+    end1.Clear();
+    start2.Clear();
+    end2.Clear();
+    radius1.clear();
+    radius2.clear();
+    outIndex.clear();
+}
+
+void BatchCollisionDetector::AddPair(Collider* _colliderA, Collider* _colliderB)
+{
+    pairs_.emplace_back(_colliderA, _colliderB);
+}
+
+void BatchCollisionDetector::Execute(std::vector<CollisionPair>& _contacts)
+{
+    if (pairs_.empty())
+        return;
+
+    sphereSphere_.Clear();
+    sphereAABB_.Clear();
+    aabbAABB_.Clear();
+    capsuleCapsule_.Clear();
+    scalarPairs_.clear();
+    contacts_.clear();
+
+    // 形状のキャッシュをクリア
+    shapes_.clear();
+    shapeOwners_.clear();
+    ++shapeGeneration_;
+    if (shapeGeneration_ == 0)
+    {
+        for (ShapeSlot& slot : shapeSlots_)
+            slot.generation = 0;
+        shapeGeneration_ = 1;
+    }
+
+    // 形状の組み合わせ毎に振り分けて、判定に必要な値を詰める
+    for (uint32_t i = 0; i < static_cast<uint32_t>(pairs_.size()); ++i)
+    {
+        Collider* colliderA = pairs_[i].first;
+        Collider* colliderB = pairs_[i].second;
+        BoundingBox typeA = colliderA->GetBoundingBox();
+        BoundingBox typeB = colliderB->GetBoundingBox();
+
+        // 掃引判定が必要なペアはスカラー版で判定する
+        if (CollisionDetector::IsSweepRequired(colliderA, colliderB))
+        {
+            scalarPairs_.push_back(i);
+            continue;
+        }
+
+        if (typeA == BoundingBox::Sphere_3D && typeB == BoundingBox::Sphere_3D)
+        {
+            uint32_t sphere1Index = GetShapeIndex(colliderA);
+            uint32_t sphere2Index = GetShapeIndex(colliderB);
+            const ShapeCache& sphere1 = shapes_[sphere1Index];
+            const ShapeCache& sphere2 = shapes_[sphere2Index];
+
+            sphereSphere_.center1.Push(sphere1.center);
+            sphereSphere_.center2.Push(sphere2.center);
+            sphereSphere_.radius1.push_back(sphere1.radius);
+            sphereSphere_.radius2.push_back(sphere2.radius);
+            sphereSphere_.baseRadius1.push_back(sphere1.baseRadius);
+            sphereSphere_.outIndex.push_back(i);
+        }
+        else if ((typeA == BoundingBox::Sphere_3D && typeB == BoundingBox::AABB_3D) ||
+            (typeA == BoundingBox::AABB_3D && typeB == BoundingBox::Sphere_3D))
+        {
+            bool isFlipped = typeA == BoundingBox::AABB_3D;
+            uint32_t sphereIndex = GetShapeIndex(isFlipped ? colliderB : colliderA);
+            uint32_t aabbIndex = GetShapeIndex(isFlipped ? colliderA : colliderB);
+            const ShapeCache& sphere = shapes_[sphereIndex];
+            const ShapeCache& aabb = shapes_[aabbIndex];
+
+            sphereAABB_.center.Push(sphere.center);
+            sphereAABB_.radius.push_back(sphere.radius);
+            sphereAABB_.boxMin.Push(aabb.worldMin);
+            sphereAABB_.boxMax.Push(aabb.worldMax);
+            sphereAABB_.isFlipped.push_back(isFlipped ? 1 : 0);
+            sphereAABB_.outIndex.push_back(i);
+        }
+        else if (typeA == BoundingBox::AABB_3D && typeB == BoundingBox::AABB_3D)
+        {
+            uint32_t aabb1Index = GetShapeIndex(colliderA);
+            uint32_t aabb2Index = GetShapeIndex(colliderB);
+            const ShapeCache& aabb1 = shapes_[aabb1Index];
+            const ShapeCache& aabb2 = shapes_[aabb2Index];
+
+            aabbAABB_.min1.Push(aabb1.min);
+            aabbAABB_.max1.Push(aabb1.max);
+            aabbAABB_.center1.Push(aabb1.center);
+            aabbAABB_.min2.Push(aabb2.min);
+            aabbAABB_.max2.Push(aabb2.max);
+            aabbAABB_.center2.Push(aabb2.center);
+            aabbAABB_.outIndex.push_back(i);
+        }
+        else if (typeA == BoundingBox::Capsule_3D && typeB == BoundingBox::Capsule_3D)
+        {
+            uint32_t capsule1Index = GetShapeIndex(colliderA);
+            uint32_t capsule2Index = GetShapeIndex(colliderB);
+            const ShapeCache& capsule1 = shapes_[capsule1Index];
+            const ShapeCache& capsule2 = shapes_[capsule2Index];
+
+            capsuleCapsule_.start1.Push(capsule1.start);
+            capsuleCapsule_.end1.Push(capsule1.end);
+            capsuleCapsule_.start2.Push(capsule2.start);
+            capsuleCapsule_.end2.Push(capsule2.end);
+            capsuleCapsule_.radius1.push_back(capsule1.radius);
+            capsuleCapsule_.radius2.push_back(capsule2.radius);
+            capsuleCapsule_.outIndex.push_back(i);
+        }
+        else
+        {
+            scalarPairs_.push_back(i);
+        }
+    }
+
+    // 4レーン単位で読めるように末尾を埋める
+    PadLanes(sphereSphere_.center1);
+    PadLanes(sphereSphere_.center2);
+    PadLanes(sphereSphere_.radius1);
+    PadLanes(sphereSphere_.radius2);
+    PadLanes(sphereSphere_.baseRadius1);
+
+    PadLanes(sphereAABB_.center);
+    PadLanes(sphereAABB_.radius);
+    PadLanes(sphereAABB_.boxMin);
+    PadLanes(sphereAABB_.boxMax);
+
+    PadLanes(aabbAABB_.min1);
+    PadLanes(aabbAABB_.max1);
+    PadLanes(aabbAABB_.center1);
+    PadLanes(aabbAABB_.min2);
+    PadLanes(aabbAABB_.max2);
+    PadLanes(aabbAABB_.center2);
+
+    PadLanes(capsuleCapsule_.start1);
+    PadLanes(capsuleCapsule_.end1);
+    PadLanes(capsuleCapsule_.start2);
+    PadLanes(capsuleCapsule_.end2);
+    PadLanes(capsuleCapsule_.radius1);
+    PadLanes(capsuleCapsule_.radius2);
+
+    IntersectSphereSphere(sphereSphere_, contacts_);
+    IntersectSphereAABB(sphereAABB_, contacts_);
+    IntersectAABBAABB(aabbAABB_, contacts_);
+    IntersectCapsuleCapsule(capsuleCapsule_, contacts_);
+
+    for (uint32_t index : scalarPairs_)
+    {
+        Contact contact;
+        contact.pairIndex = index;
+        if (CollisionDetector::DetectCollision(pairs_[index].first, pairs_[index].second, contact.info))
+            contacts_.push_back(contact);
+    }
+
+    // 追加された順に結果を並べる（衝突したペアだけなので数は少ない）
+    std::sort(contacts_.begin(), contacts_.end(),
+        [](const Contact& _a, const Contact& _b) { return _a.pairIndex < _b.pairIndex; });
+
+    for (const Contact& contact : contacts_)
+    {
+        CollisionPair collisionPair;
+        collisionPair.colliderA = pairs_[contact.pairIndex].first;
+        collisionPair.colliderB = pairs_[contact.pairIndex].second;
+        collisionPair.info = contact.info;
+        _contacts.push_back(collisionPair);
+    }
+
+    pairs_.clear();
+}
+
+uint32_t BatchCollisionDetector::GetShapeIndex(Collider* _collider)
+{
+    // 使用率が半分を超えたら広げる
+    if ((shapes_.size() + 1) * 2 > shapeSlots_.size())
+    {
+        size_t capacity = std::max<size_t>(shapeSlots_.size() * 2, 256);
+        shapeSlots_.assign(capacity, ShapeSlot());
+        shapeGeneration_ = 1;
+
+        // 登録済みの形状を入れ直す
+        size_t mask = capacity - 1;
+        for (uint32_t index = 0; index < static_cast<uint32_t>(shapes_.size()); ++index)
+        {
+            const Collider* collider = shapeOwners_[index];
+            size_t slot = HashPointer(collider) & mask;
+            while (shapeSlots_[slot].generation == shapeGeneration_)
+                slot = (slot + 1) & mask;
+            shapeSlots_[slot] = { collider, index, shapeGeneration_ };
+        }
+    }
+
+    size_t mask = shapeSlots_.size() - 1;
+    size_t slot = HashPointer(_collider) & mask;
+    while (shapeSlots_[slot].generation == shapeGeneration_)
+    {
+        if (shapeSlots_[slot].collider == _collider)
+            return shapeSlots_[slot].index;
+        slot = (slot + 1) & mask;
+    }
+
+    uint32_t index = static_cast<uint32_t>(shapes_.size());
+    shapeSlots_[slot] = { _collider, index, shapeGeneration_ };
+    shapeOwners_.push_back(_collider);
+    ShapeCache& shape = shapes_.emplace_back();
+
+    // 値の求め方はCollisionDetectorの各関数と同じ
+    switch (_collider->GetBoundingBox())
+    {
+    case BoundingBox::Sphere_3D:
+    {
+        SphereCollider* sphere = static_cast<SphereCollider*>(_collider);
+        const WorldTransform* transform = sphere->GetWorldTransform();
+        Vector3 worldOffset = Transform(sphere->GetOffset(), transform->quaternion_.ToMatrix());
+
+        shape.center = transform->GetWorldPosition() + worldOffset;
+        shape.radius = sphere->GetRadius() * transform->scale_.x;
+        shape.baseRadius = sphere->GetRadius();
+        break;
+    }
+    case BoundingBox::AABB_3D:
+    {
+        AABBCollider* aabb = static_cast<AABBCollider*>(_collider);
+        const WorldTransform* transform = aabb->GetWorldTransform();
+        Vector3 offset = Transform(aabb->GetOffset(), transform->quaternion_.ToMatrix());
+
+        shape.min = aabb->GetMin() * transform->scale_ + transform->transform_ + offset;
+        shape.max = aabb->GetMax() * transform->scale_ + transform->transform_ + offset;
+        shape.center = transform->transform_ + offset;
+        shape.worldMin = aabb->GetMin() * transform->scale_ + transform->GetWorldPosition() + offset;
+        shape.worldMax = aabb->GetMax() * transform->scale_ + transform->GetWorldPosition() + offset;
+        break;
+    }
+    case BoundingBox::Capsule_3D:
+    {
+        CapsuleCollider* capsule = static_cast<CapsuleCollider*>(_collider);
+        capsule->GetCapsuleSegment(shape.start, shape.end);
+        shape.radius = capsule->GetRadius();
+        shape.baseRadius = capsule->GetRadius();
+        break;
+    }
+    default:
+        break;
+    }
+
+    return index;
+}
+
+void BatchCollisionDetector::IntersectSphereSphere(const SphereSphereBatch& _batch, std::vector<Contact>& _contacts)
+{
+    const size_t count = _batch.Size();
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 epsilon = _mm_set1_ps(kEpsilon);
+    LaneResult result;
+
+    for (size_t i = 0; i < count; i += kLaneCount)
+    {
+        __m128 radius1 = Load(_batch.radius1, i);
+        __m128 radiusSum = _mm_add_ps(radius1, Load(_batch.radius2, i));
+
+        // 2つの球の中心間の距離
+        __m128 c1x = Load(_batch.center1.x, i);
+        __m128 c1y = Load(_batch.center1.y, i);
+        __m128 c1z = Load(_batch.center1.z, i);
+        __m128 dx = _mm_sub_ps(Load(_batch.center2.x, i), c1x);
+        __m128 dy = _mm_sub_ps(Load(_batch.center2.y, i), c1y);
+        __m128 dz = _mm_sub_ps(Load(_batch.center2.z, i), c1z);
+        __m128 distance = _mm_sqrt_ps(Dot3(dx, dy, dz, dx, dy, dz));
+
+        // 距離が半径の和より大きくなければ衝突
+        __m128 hit = _mm_cmpngt_ps(_mm_mul_ps(distance, distance), _mm_mul_ps(radiusSum, radiusSum));
+        int hitMask = _mm_movemask_ps(hit) & ValidLaneMask(i, count);
+        if (hitMask == 0)
+            continue;
+
+        // 方向ベクトルの正規化（ゼロベクトルの場合は上向き）
+        __m128 isValid = _mm_cmpgt_ps(distance, epsilon);
+        __m128 nx = Select(isValid, _mm_div_ps(dx, distance), zero);
+        __m128 ny = Select(isValid, _mm_div_ps(dy, distance), one);
+        __m128 nz = Select(isValid, _mm_div_ps(dz, distance), zero);
+
+        // 衝突点（球1の中心から球2方向へ球1の半径分移動した点）
+        __m128 baseRadius = Load(_batch.baseRadius1, i);
+        result.Store(
+            _mm_add_ps(c1x, _mm_mul_ps(nx, baseRadius)),
+            _mm_add_ps(c1y, _mm_mul_ps(ny, baseRadius)),
+            _mm_add_ps(c1z, _mm_mul_ps(nz, baseRadius)),
+            nx, ny, nz,
+            _mm_sub_ps(radiusSum, distance));
+
+        for (size_t lane = 0; lane < kLaneCount; ++lane)
+        {
+            if ((hitMask & (1 << lane)) == 0)
+                continue;
+
+            Contact& contact = _contacts.emplace_back();
+            contact.pairIndex = _batch.outIndex[i + lane];
+            result.Write(lane, contact.info);
+        }
+    }
+}
+
+void BatchCollisionDetector::IntersectSphereAABB(const SphereAABBBatch& _batch, std::vector<Contact>& _contacts)
+{
+    const size_t count = _batch.Size();
+    const __m128 epsilon = _mm_set1_ps(kEpsilon);
+    LaneResult result;
+
+    for (size_t i = 0; i < count; i += kLaneCount)
+    {
+        __m128 cx = Load(_batch.center.x, i);
+        __m128 cy = Load(_batch.center.y, i);
+        __m128 cz = Load(_batch.center.z, i);
+        __m128 radius = Load(_batch.radius, i);
+
+        // 球の中心からAABBへの最近接点
+        __m128 px = Clamp(cx, Load(_batch.boxMin.x, i), Load(_batch.boxMax.x, i));
+        __m128 py = Clamp(cy, Load(_batch.boxMin.y, i), Load(_batch.boxMax.y, i));
+        __m128 pz = Clamp(cz, Load(_batch.boxMin.z, i), Load(_batch.boxMax.z, i));
+
+        __m128 dx = _mm_sub_ps(cx, px);
+        __m128 dy = _mm_sub_ps(cy, py);
+        __m128 dz = _mm_sub_ps(cz, pz);
+        __m128 length = _mm_sqrt_ps(Dot3(dx, dy, dz, dx, dy, dz));
+
+        // 距離が半径より大きくなければ衝突
+        __m128 hit = _mm_cmpngt_ps(_mm_mul_ps(length, length), _mm_mul_ps(radius, radius));
+        int hitMask = _mm_movemask_ps(hit) & ValidLaneMask(i, count);
+        if (hitMask == 0)
+            continue;
+
+        int validMask = _mm_movemask_ps(_mm_cmpgt_ps(length, epsilon));
+
+        result.Store(px, py, pz,
+            _mm_div_ps(dx, length), _mm_div_ps(dy, length), _mm_div_ps(dz, length),
+            _mm_sub_ps(radius, length));
+
+        for (size_t lane = 0; lane < kLaneCount; ++lane)
+        {
+            if ((hitMask & (1 << lane)) == 0)
+                continue;
+
+            size_t batchIndex = i + lane;
+            Contact& contact = _contacts.emplace_back();
+            contact.pairIndex = _batch.outIndex[batchIndex];
+            ColliderInfo& info = contact.info;
+            result.Write(lane, info);
+
+            // 球の中心がAABB内部にある場合は最も近い面の法線を使用（稀なのでスカラーで求める）
+            if ((validMask & (1 << lane)) == 0)
+            {
+                Vector3 sphereCenter(_batch.center.x[batchIndex], _batch.center.y[batchIndex], _batch.center.z[batchIndex]);
+                Vector3 aabbMin(_batch.boxMin.x[batchIndex], _batch.boxMin.y[batchIndex], _batch.boxMin.z[batchIndex]);
+                Vector3 aabbMax(_batch.boxMax.x[batchIndex], _batch.boxMax.y[batchIndex], _batch.boxMax.z[batchIndex]);
+
+                Vector3 center = (aabbMin + aabbMax) * 0.5f;
+                Vector3 extents = aabbMax - center;
+
+                Vector3 diff = sphereCenter - center;
+                Vector3 absDiff(std::abs(diff.x), std::abs(diff.y), std::abs(diff.z));
+                Vector3 relDiff = absDiff / extents;
+
+                if (relDiff.x > relDiff.y && relDiff.x > relDiff.z)
+                {
+                    info.contactNormal = Vector3(diff.x > 0.0f ? 1.0f : -1.0f, 0.0f, 0.0f);
+                }
+                else if (relDiff.y > relDiff.x && relDiff.y > relDiff.z)
+                {
+                    info.contactNormal = Vector3(0.0f, diff.y > 0.0f ? 1.0f : -1.0f, 0.0f);
+                }
+                else
+                {
+                    info.contactNormal = Vector3(0.0f, 0.0f, diff.z > 0.0f ? 1.0f : -1.0f);
+                }
+            }
+
+            // AABB vs 球の順で渡された場合は法線方向を反転
+            if (_batch.isFlipped[batchIndex])
+            {
+                info.contactNormal = -info.contactNormal;
+            }
+        }
+    }
+}
+
+void BatchCollisionDetector::IntersectAABBAABB(const AABBAABBBatch& _batch, std::vector<Contact>& _contacts)
+{
+    const size_t count = _batch.Size();
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    LaneResult result;
+
+    for (size_t i = 0; i < count; i += kLaneCount)
+    {
+        __m128 min1x = Load(_batch.min1.x, i), min1y = Load(_batch.min1.y, i), min1z = Load(_batch.min1.z, i);
+        __m128 max1x = Load(_batch.max1.x, i), max1y = Load(_batch.max1.y, i), max1z = Load(_batch.max1.z, i);
+        __m128 min2x = Load(_batch.min2.x, i), min2y = Load(_batch.min2.y, i), min2z = Load(_batch.min2.z, i);
+        __m128 max2x = Load(_batch.max2.x, i), max2y = Load(_batch.max2.y, i), max2z = Load(_batch.max2.z, i);
+
+        // 各軸で重なりを確認
+        __m128 separated = _mm_or_ps(
+            _mm_or_ps(
+                _mm_or_ps(_mm_cmplt_ps(max1x, min2x), _mm_cmpgt_ps(min1x, max2x)),
+                _mm_or_ps(_mm_cmplt_ps(max1y, min2y), _mm_cmpgt_ps(min1y, max2y))),
+            _mm_or_ps(_mm_cmplt_ps(max1z, min2z), _mm_cmpgt_ps(min1z, max2z)));
+
+        int hitMask = ~_mm_movemask_ps(separated) & ValidLaneMask(i, count);
+        if (hitMask == 0)
+            continue;
+
+        // めり込みが最も小さい軸を見つける
+        __m128 overlapX = _mm_sub_ps(Min(max1x, max2x), Max(min1x, min2x));
+        __m128 overlapY = _mm_sub_ps(Min(max1y, max2y), Max(min1y, min2y));
+        __m128 overlapZ = _mm_sub_ps(Min(max1z, max2z), Max(min1z, min2z));
+
+        __m128 selectX = _mm_and_ps(_mm_cmple_ps(overlapX, overlapY), _mm_cmple_ps(overlapX, overlapZ));
+        __m128 selectY = _mm_andnot_ps(selectX, _mm_and_ps(_mm_cmple_ps(overlapY, overlapX), _mm_cmple_ps(overlapY, overlapZ)));
+        __m128 selectZ = _mm_andnot_ps(_mm_or_ps(selectX, selectY), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+
+        __m128 penetration = Select(selectX, overlapX, Select(selectY, overlapY, overlapZ));
+
+        // 中心位置の大小で法線の向きを決める
+        __m128 signX = Select(_mm_cmplt_ps(Load(_batch.center1.x, i), Load(_batch.center2.x, i)), minusOne, one);
+        __m128 signY = Select(_mm_cmplt_ps(Load(_batch.center1.y, i), Load(_batch.center2.y, i)), minusOne, one);
+        __m128 signZ = Select(_mm_cmplt_ps(Load(_batch.center1.z, i), Load(_batch.center2.z, i)), minusOne, one);
+        __m128 nx = Select(selectX, signX, zero);
+        __m128 ny = Select(selectY, signY, zero);
+        __m128 nz = Select(selectZ, signZ, zero);
+
+        // 衝突点（AABB1の中心からめり込みの半分だけ戻した点）
+        __m128 halfPenetration = _mm_mul_ps(penetration, half);
+        __m128 px = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(min1x, max1x), half), _mm_mul_ps(nx, halfPenetration));
+        __m128 py = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(min1y, max1y), half), _mm_mul_ps(ny, halfPenetration));
+        __m128 pz = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(min1z, max1z), half), _mm_mul_ps(nz, halfPenetration));
+
+        result.Store(px, py, pz, nx, ny, nz, penetration);
+
+        for (size_t lane = 0; lane < kLaneCount; ++lane)
+        {
+            if ((hitMask & (1 << lane)) == 0)
+                continue;
+
+            Contact& contact = _contacts.emplace_back();
+            contact.pairIndex = _batch.outIndex[i + lane];
+            result.Write(lane, contact.info);
+        }
+    }
+}
+
+void BatchCollisionDetector::IntersectCapsuleCapsule(const CapsuleCapsuleBatch& _batch, std::vector<Contact>& _contacts)
+{
+    const size_t count = _batch.Size();
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 epsilon = _mm_set1_ps(kEpsilon);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    LaneResult result;
+
+    for (size_t i = 0; i < count; i += kLaneCount)
+    {
+        __m128 s1x = Load(_batch.start1.x, i), s1y = Load(_batch.start1.y, i), s1z = Load(_batch.start1.z, i);
+        __m128 s2x = Load(_batch.start2.x, i), s2y = Load(_batch.start2.y, i), s2z = Load(_batch.start2.z, i);
+
+        // 線分間の最短距離（CollisionDetector::SegmentSegmentDistanceの全分岐をマスクで選ぶ）
+        __m128 d1x = _mm_sub_ps(Load(_batch.end1.x, i), s1x);
+        __m128 d1y = _mm_sub_ps(Load(_batch.end1.y, i), s1y);
+        __m128 d1z = _mm_sub_ps(Load(_batch.end1.z, i), s1z);
+        __m128 d2x = _mm_sub_ps(Load(_batch.end2.x, i), s2x);
+        __m128 d2y = _mm_sub_ps(Load(_batch.end2.y, i), s2y);
+        __m128 d2z = _mm_sub_ps(Load(_batch.end2.z, i), s2z);
+        __m128 rx = _mm_sub_ps(s1x, s2x);
+        __m128 ry = _mm_sub_ps(s1y, s2y);
+        __m128 rz = _mm_sub_ps(s1z, s2z);
+
+        __m128 a = Dot3(d1x, d1y, d1z, d1x, d1y, d1z);
+        __m128 e = Dot3(d2x, d2y, d2z, d2x, d2y, d2z);
+        __m128 f = Dot3(d2x, d2y, d2z, rx, ry, rz);
+        __m128 c = Dot3(d1x, d1y, d1z, rx, ry, rz);
+        __m128 b = Dot3(d1x, d1y, d1z, d2x, d2y, d2z);
+
+        __m128 isPointA = _mm_cmple_ps(a, epsilon);
+        __m128 isPointB = _mm_cmple_ps(e, epsilon);
+        __m128 isPointBoth = _mm_and_ps(isPointA, isPointB);
+
+        // -c / a
+        __m128 sFromStart = Clamp(_mm_div_ps(_mm_xor_ps(c, signMask), a), zero, one);
+        // (b - c) / a
+        __m128 sFromEnd = Clamp(_mm_div_ps(_mm_sub_ps(b, c), a), zero, one);
+
+        // 一般的な場合
+        __m128 denom = _mm_sub_ps(_mm_mul_ps(a, e), _mm_mul_ps(b, b));
+        __m128 sGeneral = Select(_mm_cmpneq_ps(denom, zero),
+            Clamp(_mm_div_ps(_mm_sub_ps(_mm_mul_ps(b, f), _mm_mul_ps(c, e)), denom), zero, one), zero);
+        __m128 tGeneral = _mm_div_ps(_mm_add_ps(_mm_mul_ps(b, sGeneral), f), e);
+        __m128 tBelow = _mm_cmplt_ps(tGeneral, zero);
+        __m128 tAbove = _mm_cmpgt_ps(tGeneral, one);
+        sGeneral = Select(tBelow, sFromStart, Select(tAbove, sFromEnd, sGeneral));
+        tGeneral = Select(tBelow, zero, Select(tAbove, one, tGeneral));
+
+        // 線分1が点に縮退 / 線分2が点に縮退 / 両方が点に縮退
+        __m128 s = Select(isPointA, zero, Select(isPointB, sFromStart, sGeneral));
+        __m128 t = Select(isPointA, Select(isPointBoth, zero, Clamp(_mm_div_ps(f, e), zero, one)),
+            Select(isPointB, zero, tGeneral));
+
+        // 最近接点 両方が点に縮退している場合は始点そのもの
+        __m128 p1x = Select(isPointBoth, s1x, _mm_add_ps(s1x, _mm_mul_ps(d1x, s)));
+        __m128 p1y = Select(isPointBoth, s1y, _mm_add_ps(s1y, _mm_mul_ps(d1y, s)));
+        __m128 p1z = Select(isPointBoth, s1z, _mm_add_ps(s1z, _mm_mul_ps(d1z, s)));
+        __m128 p2x = Select(isPointBoth, s2x, _mm_add_ps(s2x, _mm_mul_ps(d2x, t)));
+        __m128 p2y = Select(isPointBoth, s2y, _mm_add_ps(s2y, _mm_mul_ps(d2y, t)));
+        __m128 p2z = Select(isPointBoth, s2z, _mm_add_ps(s2z, _mm_mul_ps(d2z, t)));
+
+        __m128 nx = _mm_sub_ps(p2x, p1x);
+        __m128 ny = _mm_sub_ps(p2y, p1y);
+        __m128 nz = _mm_sub_ps(p2z, p1z);
+        __m128 length = _mm_sqrt_ps(Dot3(nx, ny, nz, nx, ny, nz));
+
+        __m128 radius1 = Load(_batch.radius1, i);
+        __m128 radiusSum = _mm_add_ps(radius1, Load(_batch.radius2, i));
+
+        // 距離が半径の和以上でなければ衝突
+        int hitMask = _mm_movemask_ps(_mm_cmpnge_ps(length, radiusSum)) & ValidLaneMask(i, count);
+        if (hitMask == 0)
+            continue;
+
+        // 接触法線 中心線が一致した場合は上向き
+        __m128 isValid = _mm_cmpgt_ps(length, epsilon);
+        nx = Select(isValid, _mm_div_ps(nx, length), zero);
+        ny = Select(isValid, _mm_div_ps(ny, length), one);
+        nz = Select(isValid, _mm_div_ps(nz, length), zero);
+
+        result.Store(
+            _mm_add_ps(p1x, _mm_mul_ps(nx, radius1)),
+            _mm_add_ps(p1y, _mm_mul_ps(ny, radius1)),
+            _mm_add_ps(p1z, _mm_mul_ps(nz, radius1)),
+            nx, ny, nz,
+            _mm_sub_ps(radiusSum, length));
+
+        for (size_t lane = 0; lane < kLaneCount; ++lane)
+        {
+            if ((hitMask & (1 << lane)) == 0)
+                continue;
+
+            Contact& contact = _contacts.emplace_back();
+            contact.pairIndex = _batch.outIndex[i + lane];
+            result.Write(lane, contact.info);
+        }
+    }
+}
+
+void BatchCollisionDetector::PadLanes(std::vector<float>& _lanes)
+{
+    while (_lanes.size() % kLaneCount != 0)
+        _lanes.push_back(0.0f);
+}
+
+void BatchCollisionDetector::PadLanes(Lanes3& _lanes)
+{
+    PadLanes(_lanes.x);
+    PadLanes(_lanes.y);
+    PadLanes(_lanes.z);
+}
+
+} // namespace Engine
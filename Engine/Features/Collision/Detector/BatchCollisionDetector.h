@@ -0,0 +1,150 @@
+#pragma once
+
+#include <Features/Collision/Collider/Collider.h>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace Engine {
+
+/// <summary>
+/// 衝突判定をまとめて行うクラス
+/// 球-球、球-AABB、AABB-AABB、カプセル-カプセルのペアは形状の組み合わせ毎にSoAへ詰め替え、SSEで4ペアずつ判定する
+/// それ以外の組み合わせと掃引判定（CCD）が必要なペアはCollisionDetector::DetectCollisionで判定する
+/// 演算の順序はスカラー版と揃えてあるので、得られるColliderInfoはDetectCollisionと同じになる
+/// 内部のバッファを使い回すため、スレッド毎に別のインスタンスを使うこと
+/// </summary>
+class BatchCollisionDetector
+{
+public:
+    // 3要素のSoA
+    struct Lanes3
+    {
+        std::vector<float> x, y, z;
+
+        void Clear() { x.clear(); y.clear(); z.clear(); }
+        void Push(const Vector3& _v) { x.push_back(_v.x); y.push_back(_v.y); z.push_back(_v.z); }
+    };
+
+    // 球-球
+    struct SphereSphereBatch
+    {
+        Lanes3 center1, center2;
+        std::vector<float> radius1, radius2;    // スケール適用後の半径
+        std::vector<float> baseRadius1;         // 衝突点の計算に使うスケール適用前の半径
+        std::vector<uint32_t> outIndex;         // 結果の書き込み先
+
+        void Clear();
+        size_t Size() const { return outIndex.size(); }
+    };
+
+    // 球-AABB
+    struct SphereAABBBatch
+    {
+        Lanes3 center;
+        std::vector<float> radius;              // スケール適用後の半径
+        Lanes3 boxMin, boxMax;
+        std::vector<uint8_t> isFlipped;         // AABB vs 球の順で渡されたペア（法線を反転する）
+        std::vector<uint32_t> outIndex;
+
+        void Clear();
+        size_t Size() const { return outIndex.size(); }
+    };
+
+    // AABB-AABB
+    struct AABBAABBBatch
+    {
+        Lanes3 min1, max1, center1;
+        Lanes3 min2, max2, center2;
+        std::vector<uint32_t> outIndex;
+
+        void Clear();
+        size_t Size() const { return outIndex.size(); }
+    };
+
+    // カプセル-カプセル
+    struct CapsuleCapsuleBatch
+    {
+        Lanes3 start1, end1, start2, end2;
+        std::vector<float> radius1, radius2;
+        std::vector<uint32_t> outIndex;
+
+        void Clear();
+        size_t Size() const { return outIndex.size(); }
+    };
+
+    // カーネルの判定結果
+    struct Contact
+    {
+        uint32_t pairIndex = 0;     // AddPairで追加した順番
+        ColliderInfo info;
+    };
+
+public:
+    BatchCollisionDetector() = default;
+    ~BatchCollisionDetector() = default;
+
+    // 判定するペアを追加する
+    void AddPair(Collider* _colliderA, Collider* _colliderB);
+
+    /// <summary>
+    /// 追加されたペアを判定し、衝突したものを追加した順に_contactsの末尾へ追加する
+    /// 追加されたペアはクリアされる
+    /// </summary>
+    void Execute(std::vector<CollisionPair>& _contacts);
+
+    // 追加されているペアの数
+    size_t GetPairCount() const { return pairs_.size(); }
+
+    // 各組み合わせのカーネル 衝突したペアをoutIndexの昇順で_contactsの末尾に追加する
+    static void IntersectSphereSphere(const SphereSphereBatch& _batch, std::vector<Contact>& _contacts);
+    static void IntersectSphereAABB(const SphereAABBBatch& _batch, std::vector<Contact>& _contacts);
+    static void IntersectAABBAABB(const AABBAABBBatch& _batch, std::vector<Contact>& _contacts);
+    static void IntersectCapsuleCapsule(const CapsuleCapsuleBatch& _batch, std::vector<Contact>& _contacts);
+
+private:
+    // コライダー毎のワールド空間の形状 同じコライダーが複数のペアに含まれるので1回だけ求める
+    struct ShapeCache
+    {
+        Vector3 center;                 // 球の中心 / AABBの位置+オフセット
+        Vector3 min, max;               // AABB（transform_基準 AABB同士の判定用）
+        Vector3 worldMin, worldMax;     // AABB（ワールド行列の位置基準 球との判定用）
+        Vector3 start, end;             // カプセルの線分
+        float radius = 0.0f;            // スケール適用後の半径（カプセルは適用前）
+        float baseRadius = 0.0f;        // スケール適用前の半径
+    };
+
+    // コライダーの形状の添え字を取得する（なければ求めて登録する）
+    uint32_t GetShapeIndex(Collider* _collider);
+
+private:
+    // 4の倍数になるように末尾を埋める
+    static void PadLanes(std::vector<float>& _lanes);
+    static void PadLanes(Lanes3& _lanes);
+
+private:
+    std::vector<std::pair<Collider*, Collider*>> pairs_;
+    std::vector<uint32_t> scalarPairs_; // バッチ非対応の組み合わせ
+
+    SphereSphereBatch sphereSphere_;
+    SphereAABBBatch sphereAABB_;
+    AABBAABBBatch aabbAABB_;
+    CapsuleCapsuleBatch capsuleCapsule_;
+
+    // コライダー -> shapes_の添え字（オープンアドレス法 世代番号でクリアする）
+    struct ShapeSlot
+    {
+        const Collider* collider = nullptr;
+        uint32_t index = 0;
+        uint32_t generation = 0;
+    };
+    std::vector<ShapeSlot> shapeSlots_;
+    std::vector<ShapeCache> shapes_;
+    std::vector<const Collider*> shapeOwners_; // shapes_と同じ並びのコライダー（再ハッシュ用）
+    uint32_t shapeGeneration_ = 0;
+
+    std::vector<Contact> contacts_;
+};
+
+} // namespace Engine
@@ -2,16 +2,62 @@
 #include <Math/Matrix/MatrixFunction.h>
 #include <Math/Vector/VectorFunction.h>
 
+#include <algorithm>
+#include <limits>
+
 
 
 namespace Engine {
 
+namespace {
+
+// 掃引判定で接触とみなす表面間の距離
+constexpr float kSweepTolerance = 0.001f;
+// 掃引判定の最大反復回数
+constexpr uint32_t kSweepMaxIterations = 32;
+// カプセルとAABB/OBBの掃引で線分上に並べる球の最大数
+constexpr uint32_t kSweepMaxSegmentSamples = 16;
+
+} // namespace
+
 bool CollisionDetector::DetectCollision(Collider* _colliderA, Collider* _colliderB, ColliderInfo& _info)
 {
     // nullチェック
     if (_colliderA == nullptr || _colliderB == nullptr)
         return false;
 
+    bool result = DetectDiscreteCollision(_colliderA, _colliderB, _info);
+
+    if (!IsSweepRequired(_colliderA, _colliderB))
+        return result;
+
+    ColliderInfo sweptInfo;
+    if (!DetectSweptCollision(_colliderA, _colliderB, sweptInfo))
+        return result;
+
+    // 現在の位置でも衝突している場合は接触した時刻だけ設定する
+    if (result)
+    {
+        _info.timeOfImpact = sweptInfo.timeOfImpact;
+        return true;
+    }
+
+    // すり抜けた場合は掃引の結果を使う
+    _info = sweptInfo;
+    return true;
+}
+
+bool CollisionDetector::IsSweepRequired(const Collider* _colliderA, const Collider* _colliderB)
+{
+    if (!_colliderA->IsContinuous() && !_colliderB->IsContinuous())
+        return false;
+
+    Vector3 displacement = _colliderA->GetSweepDisplacement() - _colliderB->GetSweepDisplacement();
+    return displacement.LengthSquared() > 0.0f;
+}
+
+bool CollisionDetector::DetectDiscreteCollision(Collider* _colliderA, Collider* _colliderB, ColliderInfo& _info)
+{
     // バウンディングボックスの種類を取得
     BoundingBox typeA = _colliderA->GetBoundingBox();
     BoundingBox typeB = _colliderB->GetBoundingBox();
@@ -1012,6 +1058,192 @@ bool CollisionDetector::IntersectRotatedRect_vs_AxisAlignedRect(const Vector2& _
 }
 
 
+bool CollisionDetector::DetectSweptCollision(Collider* _colliderA, Collider* _colliderB, ColliderInfo& _info)
+{
+    BoundingBox typeA = _colliderA->GetBoundingBox();
+    BoundingBox typeB = _colliderB->GetBoundingBox();
+
+    auto isRound = [](BoundingBox _type) { return _type == BoundingBox::Sphere_3D || _type == BoundingBox::Capsule_3D; };
+
+    // Bを止めてAを相対移動量で動かす 球かカプセルを動かす側にする
+    Collider* mover = _colliderA;
+    Collider* other = _colliderB;
+    Vector3 displacement = _colliderA->GetSweepDisplacement() - _colliderB->GetSweepDisplacement();
+    bool isFlipped = false;
+
+    if (!isRound(typeA))
+    {
+        // AABB/OBB同士は掃引しない
+        if (!isRound(typeB))
+            return false;
+
+        std::swap(mover, other);
+        displacement = -displacement;
+        isFlipped = true;
+    }
+
+    float length = displacement.Length();
+    if (length <= 0.0f)
+        return false;
+
+    SweepShape moverShape = MakeSweepShape(mover);
+    SweepShape otherShape = MakeSweepShape(other);
+
+    // 前フレームの位置(t = 0)から、表面間の距離だけ進めても接触しないことが保証される分ずつ時刻を進める
+    float time = 0.0f;
+    Vector3 closestMover, closestOther;
+    float distance = 0.0f;
+    bool isHit = false;
+    for (uint32_t i = 0; i < kSweepMaxIterations; ++i)
+    {
+        Vector3 offset = displacement * (time - 1.0f);
+        distance = SweepShapeDistance(moverShape, offset, otherShape, closestMover, closestOther);
+        if (distance <= kSweepTolerance)
+        {
+            isHit = true;
+            break;
+        }
+
+        time += distance / length;
+        if (time > 1.0f)
+            return false;
+    }
+
+    if (!isHit)
+        return false;
+
+    _info.hasCollision = true;
+    _info.timeOfImpact = time;
+    _info.penetration = std::max(0.0f, -distance);
+
+    // 法線はAからBへ向ける
+    Vector3 normal = closestOther - closestMover;
+    float normalLength = normal.Length();
+    if (normalLength > 0.0001f)
+        normal = normal / normalLength;
+    else
+        normal = displacement / length;
+    _info.contactNormal = isFlipped ? -normal : normal;
+
+    // 接触した時刻での相手側の表面上の点
+    _info.contactPoint = closestOther + other->GetSweepDisplacement() * (time - 1.0f);
+
+    return true;
+}
+
+CollisionDetector::SweepShape CollisionDetector::MakeSweepShape(Collider* _collider)
+{
+    SweepShape shape;
+    shape.type = _collider->GetBoundingBox();
+
+    const WorldTransform* transform = _collider->GetWorldTransform();
+
+    switch (shape.type)
+    {
+    case BoundingBox::Sphere_3D:
+    {
+        SphereCollider* sphere = static_cast<SphereCollider*>(_collider);
+        Vector3 worldOffset = Transform(sphere->GetOffset(), transform->quaternion_.ToMatrix());
+        shape.start = transform->GetWorldPosition() + worldOffset;
+        shape.end = shape.start;
+        shape.radius = sphere->GetRadius() * transform->scale_.x;
+        break;
+    }
+
+    case BoundingBox::Capsule_3D:
+    {
+        CapsuleCollider* capsule = static_cast<CapsuleCollider*>(_collider);
+        capsule->GetCapsuleSegment(shape.start, shape.end);
+        shape.radius = capsule->GetRadius();
+        break;
+    }
+
+    case BoundingBox::AABB_3D:
+    {
+        AABBCollider* aabb = static_cast<AABBCollider*>(_collider);
+        Vector3 aabbOffset = Transform(aabb->GetOffset(), transform->quaternion_.ToMatrix());
+        shape.boxMin = aabb->GetMin() * transform->scale_ + transform->GetWorldPosition() + aabbOffset;
+        shape.boxMax = aabb->GetMax() * transform->scale_ + transform->GetWorldPosition() + aabbOffset;
+        break;
+    }
+
+    case BoundingBox::OBB_3D:
+        shape.obb = static_cast<OBBCollider*>(_collider);
+        break;
+
+    default:
+        break;
+    }
+
+    return shape;
+}
+
+float CollisionDetector::SweepShapeDistance(const SweepShape& _mover, const Vector3& _offset, const SweepShape& _other,
+    Vector3& _closestMover, Vector3& _closestOther)
+{
+    Vector3 start = _mover.start + _offset;
+    Vector3 end = _mover.end + _offset;
+
+    // 球・カプセル同士は線分間の距離から求める
+    if (_other.type == BoundingBox::Sphere_3D || _other.type == BoundingBox::Capsule_3D)
+    {
+        Vector3 point1, point2;
+        float distance = SegmentSegmentDistance(start, end, _other.start, _other.end, point1, point2);
+
+        Vector3 direction = distance > 0.0001f ? (point2 - point1) / distance : Vector3(0, 1, 0);
+        _closestMover = point1 + direction * _mover.radius;
+        _closestOther = point2 - direction * _other.radius;
+        return distance - _mover.radius - _other.radius;
+    }
+
+    // AABB/OBBは線分上に半径間隔で並べた球で近似する（球の場合は1つ）
+    float segmentLength = (end - start).Length();
+    uint32_t sampleCount = 1;
+    if (segmentLength > 0.0f && _mover.radius > 0.0f)
+        sampleCount = std::min(static_cast<uint32_t>(std::ceil(segmentLength / _mover.radius)) + 1, kSweepMaxSegmentSamples);
+
+    float minDistance = std::numeric_limits<float>::max();
+    for (uint32_t i = 0; i < sampleCount; ++i)
+    {
+        float t = sampleCount > 1 ? static_cast<float>(i) / static_cast<float>(sampleCount - 1) : 0.0f;
+        Vector3 point = start + (end - start) * t;
+
+        Vector3 closestPoint;
+        if (_other.type == BoundingBox::AABB_3D)
+        {
+            closestPoint = Vector3(
+                std::clamp(point.x, _other.boxMin.x, _other.boxMax.x),
+                std::clamp(point.y, _other.boxMin.y, _other.boxMax.y),
+                std::clamp(point.z, _other.boxMin.z, _other.boxMax.z)
+            );
+        }
+        else if (_other.type == BoundingBox::OBB_3D)
+        {
+            closestPoint = _other.obb->GetClosestPoint(point);
+        }
+        else
+        {
+            return std::numeric_limits<float>::max();
+        }
+
+        float distance = (closestPoint - point).Length() - _mover.radius;
+        if (distance < minDistance)
+        {
+            minDistance = distance;
+            _closestOther = closestPoint;
+            _closestMover = point;
+        }
+    }
+
+    // 動かす側の表面上の点にする
+    Vector3 direction = _closestOther - _closestMover;
+    float length = direction.Length();
+    if (length > 0.0001f)
+        _closestMover = _closestMover + direction / length * _mover.radius;
+
+    return minDistance;
+}
+
 float CollisionDetector::SegmentSegmentDistance(const Vector3& _start1, const Vector3& _end1, const Vector3& _start2, const Vector3& _end2, Vector3& _closestPoint1, Vector3& _closestPoint2)
 {
     Vector3 d1 = _end1 - _start1;
@@ -10,9 +10,37 @@ class CollisionDetector
 {
 public:
     // 各コライダー同士の衝突判定
+    // どちらかがCCD有効で移動している場合は前フレームの位置からの掃引も判定し、_info.timeOfImpactに接触した時刻を設定する
     static bool DetectCollision(Collider* _colliderA, Collider* _colliderB, ColliderInfo& _info);
 
+    // 掃引判定が必要なペアかどうか（どちらかがCCD有効で相対的に移動している）
+    static bool IsSweepRequired(const Collider* _colliderA, const Collider* _colliderB);
+
 private:
+    // 現在の位置での衝突判定
+    static bool DetectDiscreteCollision(Collider* _colliderA, Collider* _colliderB, ColliderInfo& _info);
+
+    // 前フレームの位置から現在の位置までの掃引判定
+    // 球かカプセルを相対移動量で動かし、相手との距離分ずつ時刻を進めて最初に接触する時刻を求める（Conservative Advancement）
+    // AABB/OBB同士は対象外
+    static bool DetectSweptCollision(Collider* _colliderA, Collider* _colliderB, ColliderInfo& _info);
+
+    // 掃引判定用の形状
+    struct SweepShape
+    {
+        BoundingBox type = BoundingBox::NONE;
+        Vector3 start, end;             // 球の中心（start == end）/ カプセルの線分
+        float radius = 0.0f;
+        Vector3 boxMin, boxMax;         // AABB
+        OBBCollider* obb = nullptr;     // OBB
+    };
+
+    static SweepShape MakeSweepShape(Collider* _collider);
+
+    // _moverを_offsetだけ動かしたときの_otherとの表面間の距離（めり込んでいる場合は負）
+    static float SweepShapeDistance(const SweepShape& _mover, const Vector3& _offset, const SweepShape& _other,
+        Vector3& _closestMover, Vector3& _closestOther);
+
     // 球と球の衝突判定
     static bool IntersectSphereSphere(SphereCollider* _sphere1, SphereCollider* _sphere2, ColliderInfo& _info);
 
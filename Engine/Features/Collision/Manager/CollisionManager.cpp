@@ -2,6 +2,10 @@
 #include <Features/LineDrawer/LineDrawer.h>
 #include <Debug/ImGuiDebugManager.h>
 #include <Features/Collision/CollisionLayer/CollisionLayerManager.h>
+#include <Features/Collision/Benchmark/CollisionBenchmark.h>
+#include <Features/Collision/Detector/BatchCollisionDetector.h>
+#include <Features/Collision/RayCast/RayCollisionManager.h>
+#include <System/Job/JobSystem.h>
 #include <algorithm>
 
 
@@ -13,8 +17,10 @@ CollisionManager* CollisionManager::GetInstance()
     return &instance;
 }
 
-void CollisionManager::Initialize(const Vector2& _fieldSize, uint32_t _level, const Vector2& _leftBotom, float _gridSize)
+void CollisionManager::Initialize(const Vector2& _fieldSize, uint32_t _level, const Vector2& _leftBotom, float _gridSize, BroadPhaseType _broadPhaseType)
 {
+    broadPhaseType_ = _broadPhaseType;
+
     colliders_.clear();
     collisionPairs_.clear();
 
@@ -22,15 +28,63 @@ void CollisionManager::Initialize(const Vector2& _fieldSize, uint32_t _level, co
     quadTree_ = std::make_unique<QuadTree>();
     quadTree_->Initialize(_fieldSize, _level, _leftBotom);
 
+    // 常駐コライダーを新しい木に登録し直す
+    for (ColliderHandle handle : persistentHandles_)
+    {
+        PersistentSlot& slot = persistentSlots_[handle];
+        slot.treeId = quadTree_->RegisterPersistentObj(slot.collider);
+    }
+
     // スパイラルハッシュグリッドの初期化
     spiralHashGrid_ = std::make_unique<SpatialHashGrid>(_gridSize);
     spiralHashGrid_->Clear();
+
+    // 動的AABB木の初期化 常駐コライダーの葉は次の更新で作り直す
+    dynamicTree_ = std::make_unique<DynamicAABBTree>();
+    staticTree_ = std::make_unique<DynamicAABBTree>(0.0f);
+    frameProxies_.clear();
+    staticProxies_.clear();
+    for (ColliderHandle handle : persistentHandles_)
+    {
+        persistentSlots_[handle].bvhProxyId = DynamicAABBTree::kNullNode;
+        QueuePersistentCollider(handle);
+    }
+
+    // 登録済みの静的コライダーを登録し直す
+    for (auto collider : staticColliders_)
+    {
+        spiralHashGrid_->AddCollider(collider);
+        staticProxies_[collider] = staticTree_->CreateProxy(collider->GetBounds(), collider);
+    }
 }
 
 void CollisionManager::Finalize()
 {
     colliders_.clear();
     collisionPairs_.clear();
+    contactCache_.Clear();
+
+    for (ColliderHandle handle : persistentHandles_)
+    {
+        PersistentSlot& slot = persistentSlots_[handle];
+        slot.collider->RemoveMoveListener(slot.listenerId);
+    }
+    dirtyPersistentHandles_.clear();
+
+    persistentColliders_.clear();
+    persistentHandles_.clear();
+    persistentSlots_.clear();
+    freePersistentHandles_.clear();
+    persistentHandleMap_.clear();
+    if (quadTree_)
+        quadTree_->Clear();
+
+    frameProxies_.clear();
+    staticProxies_.clear();
+    if (dynamicTree_)
+        dynamicTree_->Clear();
+    if (staticTree_)
+        staticTree_->Clear();
 }
 
 void CollisionManager::Update()
@@ -49,15 +103,29 @@ void CollisionManager::Update()
 
     DrawColliders();
 
+    // ブロードフェーズなしで判定した場合のペア数（除外率の表示用）
+    size_t dynamicCount = colliders_.size() + persistentColliders_.size();
+    bruteForcePairCount_ = dynamicCount * (dynamicCount - 1) / 2 + dynamicCount * staticColliders_.size();
+
 #ifdef _DEBUG
-    colliderCount_ = static_cast<int32_t>(colliders_.size());
+    colliderCount_ = static_cast<int32_t>(colliders_.size() + persistentColliders_.size());
     collisionPairCount_ = static_cast<int32_t>(collisionPairs_.size());
 #endif // _DEBUG
 
-    // 全てのコライダーをクリア（次のフレームのために）
+    // CCD用に現在の位置を記録する
+    for (const std::vector<Collider*>* dynamicList : { &colliders_, &persistentColliders_ })
+    {
+        for (auto collider : *dynamicList)
+            collider->UpdatePreviousPosition();
+    }
+
+    // 全てのコライダーをクリア（次のフレームのために） 常駐コライダーは残す
     colliders_.clear();
     collisionPairs_.clear();
 
+    // レイ判定用の登録も同じタイミングでクリアする
+    RayCollisionManager::GetInstance()->ClearColliders();
+
     quadTree_->Reset();
 }
 
@@ -91,6 +159,77 @@ void CollisionManager::RegisterStaticCollider(Collider* _collider)
     staticColliders_.push_back(_collider);
 
     spiralHashGrid_->AddCollider(_collider);
+    staticProxies_[_collider] = staticTree_->CreateProxy(_collider->GetBounds(), _collider);
+}
+
+ColliderHandle CollisionManager::RegisterPersistentCollider(Collider* _collider)
+{
+    // nullチェック
+    if (_collider == nullptr)
+        return kInvalidColliderHandle;
+
+    // 既に登録されている場合は同じハンドルを返す
+    auto it = persistentHandleMap_.find(_collider);
+    if (it != persistentHandleMap_.end())
+        return it->second;
+
+    ColliderHandle handle = kInvalidColliderHandle;
+    if (!freePersistentHandles_.empty())
+    {
+        handle = freePersistentHandles_.back();
+        freePersistentHandles_.pop_back();
+    }
+    else
+    {
+        handle = static_cast<ColliderHandle>(persistentSlots_.size());
+        persistentSlots_.emplace_back();
+    }
+
+    PersistentSlot& slot = persistentSlots_[handle];
+    slot.collider = _collider;
+    slot.denseIndex = static_cast<uint32_t>(persistentColliders_.size());
+    slot.treeId = quadTree_ ? quadTree_->RegisterPersistentObj(_collider) : UINT32_MAX;
+    slot.isQueued = false;
+    slot.listenerId = _collider->AddMoveListener([this, handle]() { QueuePersistentCollider(handle); });
+
+    persistentColliders_.push_back(_collider);
+    persistentHandles_.push_back(handle);
+    persistentHandleMap_[_collider] = handle;
+
+    // 動的AABB木の葉は次の更新で作る
+    QueuePersistentCollider(handle);
+
+    return handle;
+}
+
+void CollisionManager::UnregisterPersistentCollider(ColliderHandle _handle)
+{
+    if (_handle >= persistentSlots_.size() || persistentSlots_[_handle].collider == nullptr)
+        return;
+
+    PersistentSlot& slot = persistentSlots_[_handle];
+    slot.collider->RemoveMoveListener(slot.listenerId);
+
+    if (quadTree_)
+        quadTree_->RemovePersistentObj(slot.treeId);
+    if (dynamicTree_ && slot.bvhProxyId != DynamicAABBTree::kNullNode)
+        dynamicTree_->DestroyProxy(slot.bvhProxyId);
+
+    // 末尾と入れ替えて削除
+    uint32_t index = slot.denseIndex;
+    uint32_t lastIndex = static_cast<uint32_t>(persistentColliders_.size() - 1);
+    if (index != lastIndex)
+    {
+        persistentColliders_[index] = persistentColliders_[lastIndex];
+        persistentHandles_[index] = persistentHandles_[lastIndex];
+        persistentSlots_[persistentHandles_[index]].denseIndex = index;
+    }
+    persistentColliders_.pop_back();
+    persistentHandles_.pop_back();
+
+    persistentHandleMap_.erase(slot.collider);
+    slot = PersistentSlot();
+    freePersistentHandles_.push_back(_handle);
 }
 
 void CollisionManager::CheckCollisionsWithBroadPhase()
@@ -109,12 +248,18 @@ void CollisionManager::CheckCollisions()
 {
     potentialCollisions_.clear();
 
-    for (size_t i = 0; i < colliders_.size(); ++i)
+    // 毎フレーム登録分と常駐分をまとめて総当たり
+    std::vector<Collider*> dynamicColliders;
+    dynamicColliders.reserve(colliders_.size() + persistentColliders_.size());
+    dynamicColliders.insert(dynamicColliders.end(), colliders_.begin(), colliders_.end());
+    dynamicColliders.insert(dynamicColliders.end(), persistentColliders_.begin(), persistentColliders_.end());
+
+    for (size_t i = 0; i < dynamicColliders.size(); ++i)
     {
-        Collider* colliderA = colliders_[i];
-        for (size_t j = i + 1; j < colliders_.size(); ++j)
+        Collider* colliderA = dynamicColliders[i];
+        for (size_t j = i + 1; j < dynamicColliders.size(); ++j)
         {
-            Collider* colliderB = colliders_[j];
+            Collider* colliderB = dynamicColliders[j];
             potentialCollisions_.emplace_back(colliderA, colliderB);
         }
         for (auto& staticCollider : staticColliders_)
@@ -134,65 +279,166 @@ void CollisionManager::CheckCollisions()
 
 void CollisionManager::CheckCollisionsRange()
 {
+    if (enableParallelNarrowPhase_ && potentialCollisions_.size() >= kNarrowPhaseChunkSize)
+    {
+        CheckCollisionsRangeParallel();
+        return;
+    }
+
+    // まとめて判定してからペア順にコールバックを呼ぶ
+    if (enableBatchNarrowPhase_)
+    {
+        if (narrowPhaseBuffers_.empty())
+            narrowPhaseBuffers_.resize(1);
+
+        std::vector<CollisionPair>& contacts = narrowPhaseBuffers_[0];
+        CollectContacts(0, static_cast<uint32_t>(potentialCollisions_.size()), contacts);
+        for (const CollisionPair& collisionPair : contacts)
+        {
+            DispatchCollision(collisionPair.colliderA, collisionPair.colliderB, collisionPair.info);
+        }
+        contacts.clear();
+        return;
+    }
+
     for (size_t i = 0; i < potentialCollisions_.size(); ++i)
     {
         const auto& pair = potentialCollisions_[i];
         Collider* colliderA = pair.first;
         Collider* colliderB = pair.second;
 
-        // レイヤーマスクでフィルタリング
-        if ((colliderA->GetLayer() & colliderB->GetLayerMask()) != 0 ||
-            (colliderB->GetLayer() & colliderA->GetLayerMask()) != 0)
+        ColliderInfo info;
+        if (DetectCollisionPair(colliderA, colliderB, info))
         {
-            continue; // 衝突しないように設定されている
+            DispatchCollision(colliderA, colliderB, info);
         }
+    }
+}
 
-        ColliderInfo info;
+void CollisionManager::CheckCollisionsRangeParallel()
+{
+    // ワールド行列が未設定のコライダーは初回アクセス時に初期化（リソース生成）されるため
+    // ワーカーに渡す前にメインスレッドで済ませておく
+    for (const auto& pair : potentialCollisions_)
+    {
+        pair.first->GetWorldTransform();
+        pair.second->GetWorldTransform();
+    }
 
-#ifdef _DEBUG
-        /*std::string layerA = CollisionLayerManager::GetInstance()->GetLayerStr(colliderA->GetLayer());
-        std::string layerB = CollisionLayerManager::GetInstance()->GetLayerStr(colliderB->GetLayer());
-        Debug::Log("Checking collision between " + layerA + " and " + layerB + "\n");
-        std::string nameA = colliderA->GetName();
-        std::string nameB = colliderB->GetName();*/
-        //Debug::Log("Checking collision between " + nameA + " and " + nameB + "\n");
-#endif // _DEBUG
+    // チャンクの区切りはペア数だけで決まるので、ワーカー数に関係なく同じ順序で結果が並ぶ
+    uint32_t pairCount = static_cast<uint32_t>(potentialCollisions_.size());
+    uint32_t chunkCount = JobSystem::GetChunkCount(pairCount, kNarrowPhaseChunkSize);
+    if (narrowPhaseBuffers_.size() < chunkCount)
+        narrowPhaseBuffers_.resize(chunkCount);
 
-        // CollisionDetectorを使用して衝突判定を実行
-        if (CollisionDetector::DetectCollision(colliderA, colliderB, info))
+    // 判定だけを並列に行い、結果はチャンク毎のバッファに書き出す
+    JobSystem::GetInstance()->ParallelFor(pairCount, kNarrowPhaseChunkSize,
+        [this](uint32_t _begin, uint32_t _end)
         {
-            // 衝突情報を保存
-            CollisionPair collisionPair;
-            collisionPair.colliderA = colliderA;
-            collisionPair.colliderB = colliderB;
-            collisionPair.info = info;
-            collisionPairs_.push_back(collisionPair);
+            std::vector<CollisionPair>& buffer = narrowPhaseBuffers_[_begin / kNarrowPhaseChunkSize];
+            buffer.clear();
+            CollectContacts(_begin, _end, buffer);
+        });
 
-            // OnCollision呼び出し（直接実行）
-            colliderA->OnCollision(colliderB, info);
+    // コールバックはメインスレッドでペア順に呼ぶ（逐次処理と同じ順序）
+    for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        for (const CollisionPair& collisionPair : narrowPhaseBuffers_[chunk])
+        {
+            DispatchCollision(collisionPair.colliderA, collisionPair.colliderB, collisionPair.info);
+        }
+        narrowPhaseBuffers_[chunk].clear();
+    }
+}
 
-            // 衝突情報を反転して相手側の呼び出し
-            ColliderInfo reversedInfo = info;
-            reversedInfo.contactNormal = -info.contactNormal;
-            colliderB->OnCollision(colliderA, reversedInfo);
+void CollisionManager::CollectContacts(uint32_t _begin, uint32_t _end, std::vector<CollisionPair>& _contacts) const
+{
+    if (enableBatchNarrowPhase_)
+    {
+        // SoAのバッファを使い回すためスレッド毎に持つ
+        static thread_local BatchCollisionDetector batchDetector;
 
-            // 各コライダーに現在の衝突を記録
-            colliderA->AddCurrentCollision(colliderB, info);
-            colliderB->AddCurrentCollision(colliderA, reversedInfo);
+        for (uint32_t i = _begin; i < _end; ++i)
+        {
+            Collider* colliderA = potentialCollisions_[i].first;
+            Collider* colliderB = potentialCollisions_[i].second;
+
+            if (IsCollisionEnabled(colliderA, colliderB))
+                batchDetector.AddPair(colliderA, colliderB);
+        }
+
+        batchDetector.Execute(_contacts);
+        return;
+    }
 
-            //Debug::Log("Checking collision between\t" + nameA + "\tand " + nameB + "\tHit\n");
+    for (uint32_t i = _begin; i < _end; ++i)
+    {
+        Collider* colliderA = potentialCollisions_[i].first;
+        Collider* colliderB = potentialCollisions_[i].second;
+
+        CollisionPair collisionPair;
+        if (DetectCollisionPair(colliderA, colliderB, collisionPair.info))
+        {
+            collisionPair.colliderA = colliderA;
+            collisionPair.colliderB = colliderB;
+            _contacts.push_back(collisionPair);
         }
-        //else
-            //Debug::Log( nameA + "\tand " + nameB + "\t----------\n");
     }
 }
 
+bool CollisionManager::IsCollisionEnabled(Collider* _colliderA, Collider* _colliderB) const
+{
+    // レイヤーマスクでフィルタリング
+    return (_colliderA->GetLayer() & _colliderB->GetLayerMask()) == 0 &&
+        (_colliderB->GetLayer() & _colliderA->GetLayerMask()) == 0;
+}
+
+bool CollisionManager::DetectCollisionPair(Collider* _colliderA, Collider* _colliderB, ColliderInfo& _info) const
+{
+    if (!IsCollisionEnabled(_colliderA, _colliderB))
+    {
+        return false; // 衝突しないように設定されている
+    }
+
+    // CollisionDetectorを使用して衝突判定を実行
+    return CollisionDetector::DetectCollision(_colliderA, _colliderB, _info);
+}
+
+void CollisionManager::DispatchCollision(Collider* _colliderA, Collider* _colliderB, const ColliderInfo& _info)
+{
+    // 衝突情報を保存
+    CollisionPair collisionPair;
+    collisionPair.colliderA = _colliderA;
+    collisionPair.colliderB = _colliderB;
+    collisionPair.info = _info;
+    collisionPairs_.push_back(collisionPair);
+
+    // OnCollision呼び出し（直接実行）
+    _colliderA->OnCollision(_colliderB, _info);
+
+    // 衝突情報を反転して相手側の呼び出し
+    ColliderInfo reversedInfo = _info;
+    reversedInfo.contactNormal = -_info.contactNormal;
+    _colliderB->OnCollision(_colliderA, reversedInfo);
+
+    // 衝突状態の判定用に記録
+    contactCache_.Add(_colliderA, _colliderB, _info);
+}
+
 void CollisionManager::UnregisterCollider(Collider* _collider)
 {
     if (_collider == nullptr)
         return;
 
     RemoveColliderImmediate(_collider);
+
+    // 衝突状態からも削除（破棄されたコライダーのExitは通知しない）
+    contactCache_.RemoveCollider(_collider);
+
+    // 常駐登録されていればそちらも解除
+    auto it = persistentHandleMap_.find(_collider);
+    if (it != persistentHandleMap_.end())
+        UnregisterPersistentCollider(it->second);
 }
 
 void CollisionManager::RemoveColliderImmediate(Collider* _collider)
@@ -209,6 +455,19 @@ void CollisionManager::RemoveColliderImmediate(Collider* _collider)
         spiralHashGrid_->RemoveCollider(_collider); // スパイラルハッシュグリッドからも削除
     }
 
+    // 動的AABB木の葉を削除
+    auto staticProxyIt = staticProxies_.find(_collider);
+    if (staticProxyIt != staticProxies_.end()) {
+        staticTree_->DestroyProxy(staticProxyIt->second);
+        staticProxies_.erase(staticProxyIt);
+    }
+
+    auto frameProxyIt = frameProxies_.find(_collider);
+    if (frameProxyIt != frameProxies_.end()) {
+        dynamicTree_->DestroyProxy(frameProxyIt->second.proxyId);
+        frameProxies_.erase(frameProxyIt);
+    }
+
     // 衝突ペアからも削除
     if (!collisionPairs_.empty()) {
         collisionPairs_.erase(
@@ -231,16 +490,18 @@ void CollisionManager::ResolveCollisions()
 
 void CollisionManager::UpdateCollisionStates()
 {
-    // 全てのコライダーの衝突状態を更新
-    for (auto collider : colliders_)
-    {
-        collider->UpdateCollisionState();
-    }
+    // 前フレームとの差分から衝突状態を決める
+    contactCache_.Update();
 
-    // 全ての静的コライダーの衝突状態を更新
-    for (auto collider : staticColliders_)
+    // ペア順に両方のコライダーへ通知する
+    for (const ContactCache::Contact& contact : contactCache_.GetContacts())
     {
-        collider->UpdateCollisionState();
+        contact.colliderA->OnCollisionState(contact.colliderB, contact.info);
+
+        // 衝突情報を反転して相手側の呼び出し
+        ColliderInfo reversedInfo = contact.info;
+        reversedInfo.contactNormal = -contact.info.contactNormal;
+        contact.colliderB->OnCollisionState(contact.colliderA, reversedInfo);
     }
 }
 
@@ -250,43 +511,37 @@ void CollisionManager::DrawColliders()
     if (!isDrawEnabled_)
         return;
 
-    // 衝突中のコライダーを赤色で描画
-    std::vector<Collider*> collidingColliders;
-
-    // 衝突中のコライダーを抽出
-    for (const auto& pair : collisionPairs_)
+    // 衝突中のコライダーを赤色で描画（衝突状態はUpdateCollisionStatesで更新済み）
+    // 全てのコライダーを描画（毎フレーム登録分と常駐分）
+    for (const std::vector<Collider*>* dynamicList : { &colliders_, &persistentColliders_ })
     {
-        collidingColliders.push_back(pair.colliderA);
-        collidingColliders.push_back(pair.colliderB);
-    }
+        for (auto collider : *dynamicList)
+        {
+            // コライダーが衝突中か判定
+            bool isColliding = collider->IsColliding();
 
-    // 全てのコライダーを描画
-    for (auto collider : colliders_)
-    {
-        // コライダーが衝突中か判定
-        bool isColliding = std::find(collidingColliders.begin(), collidingColliders.end(), collider) != collidingColliders.end();
+            // 衝突状態に応じて色を設定
+            if (isColliding)
+            {
+                // 衝突中は赤色
+                LineDrawer::GetInstance()->SetColor({ 1.0f, 0.0f, 0.0f, 1.0f });
+            }
+            else
+            {
+                // 通常時は緑色
+                LineDrawer::GetInstance()->SetColor({ 0.0f, 1.0f, 0.0f, 1.0f });
+            }
 
-        // 衝突状態に応じて色を設定
-        if (isColliding)
-        {
-            // 衝突中は赤色
-            LineDrawer::GetInstance()->SetColor({ 1.0f, 0.0f, 0.0f, 1.0f });
+            // コライダーを描画
+            collider->Draw();
         }
-        else
-        {
-            // 通常時は緑色
-            LineDrawer::GetInstance()->SetColor({ 0.0f, 1.0f, 0.0f, 1.0f });
-        }
-
-        // コライダーを描画
-        collider->Draw();
     }
 
     // 静的コライダーを描画
     for (auto collider : staticColliders_)
     {
         // コライダーが衝突中か判定
-        bool isColliding = std::find(collidingColliders.begin(), collidingColliders.end(), collider) != collidingColliders.end();
+        bool isColliding = collider->IsColliding();
 
         // 衝突状態に応じて色を設定
         if (isColliding)
@@ -329,11 +584,47 @@ void CollisionManager::ImGui([[maybe_unused]] bool* _open)
 
     // 統計情報表示
     ImGui::Text("Registered Colliders: %d", colliderCount_); // 登録されたコライダーの数
+    ImGui::Text("Persistent Colliders: %zu (dirty: %u, moved: %u)", persistentColliders_.size(),
+        quadTree_ ? quadTree_->GetDirtyPersistentCount() : 0u, movedPersistentCount_); // 常駐コライダーの数
     ImGui::Text("Static Colliders: %zu", staticColliders_.size()); // 静的コライダーの数
     ImGui::Text("Potential Collisions: %zu", potentialCollisions_.size()); // 衝突の可能性があるペアの数
+    ImGui::SameLine();
+    // ブロードフェーズで除外できたペアの割合
+    float culledRatio = bruteForcePairCount_ > 0 ?
+        1.0f - static_cast<float>(potentialCollisions_.size()) / static_cast<float>(bruteForcePairCount_) : 0.0f;
+    ImGui::Text("(culled: %.2f%%)", culledRatio * 100.0f);
     ImGui::Text("Active Collisions: %d", collisionPairCount_); // 現在の衝突ペアの数
 
     ImGui::Checkbox("Enable Broad Phase", &enableBroadPhase_);
+    ImGui::Checkbox("Batch Narrow Phase (SIMD)", &enableBatchNarrowPhase_);
+    ImGui::Checkbox("Parallel Narrow Phase", &enableParallelNarrowPhase_);
+    ImGui::SameLine();
+    ImGui::Text("(%u threads)", JobSystem::GetInstance()->GetConcurrency());
+
+    const char* broadPhaseTypes[] = { "QuadTree", "LinearQuadTree", "DynamicAABBTree" };
+    int broadPhaseType = static_cast<int>(broadPhaseType_);
+    if (ImGui::Combo("Broad Phase Type", &broadPhaseType, broadPhaseTypes, IM_ARRAYSIZE(broadPhaseTypes)))
+    {
+        broadPhaseType_ = static_cast<BroadPhaseType>(broadPhaseType);
+    }
+
+    if (ImGui::CollapsingHeader("Broad Phase Stats"))
+    {
+        ImGui::Text("Brute Force Pairs: %zu", bruteForcePairCount_);
+        ImGui::Text("Culled Ratio: %.2f%%", culledRatio * 100.0f);
+        if (dynamicTree_ && staticTree_)
+        {
+            ImGui::Text("Dynamic Tree: %u proxies, height %d", dynamicTree_->GetProxyCount(), dynamicTree_->GetHeight());
+            ImGui::Text("Static Tree : %u proxies, height %d", staticTree_->GetProxyCount(), staticTree_->GetHeight());
+            ImGui::Text("Reinserted Proxies: %u", reinsertedProxyCount_);
+        }
+    }
+
+    // ブロードフェーズのベンチマーク（毎フレーム再構築 vs 常駐）
+    if (ImGui::Button("Run BroadPhase Benchmark"))
+    {
+        CollisionBenchmark::RunBroadPhaseSuite();
+    }
 
     ImGui::PopID();
 
@@ -359,47 +650,165 @@ void CollisionManager::ResolveCollision(const CollisionPair& _pair)
 
 void CollisionManager::UpdateBroadPhase()
 {
-    // 空間分割などの最適化を行う場合はここに実装
-    for (auto& collider : colliders_)
+    potentialCollisions_.clear();
+
+    switch (broadPhaseType_)
+    {
+    case BroadPhaseType::QuadTree:
+    {
+        // 空間分割などの最適化を行う場合はここに実装
+        for (auto& collider : colliders_)
+        {
+            quadTree_->RegisterObj(collider);
+        }
+
+        // 常駐コライダーは所属空間が変わったものだけ付け替える
+        movedPersistentCount_ = quadTree_->UpdatePersistentObjs();
+
+        std::list<Collider*> stack;
+
+        if (!colliders_.empty() || !persistentColliders_.empty())
+            // QuadTreeを使用して衝突ペアを取得
+            quadTree_->GetCollisionPair(0, potentialCollisions_, stack);
+        break;
+    }
+    case BroadPhaseType::LinearQuadTree:
     {
-        quadTree_->RegisterObj(collider);
+        broadPhaseColliders_.clear();
+        broadPhaseColliders_.insert(broadPhaseColliders_.end(), colliders_.begin(), colliders_.end());
+        broadPhaseColliders_.insert(broadPhaseColliders_.end(), persistentColliders_.begin(), persistentColliders_.end());
+
+        // セルへの登録を行わずに配列上で衝突ペアを取得
+        quadTree_->GetCollisionPairLinear(broadPhaseColliders_, potentialCollisions_);
+        break;
     }
+    case BroadPhaseType::DynamicAABBTree:
+    {
+        UpdateDynamicTree();
 
-    potentialCollisions_.clear();
+        // 動的コライダー同士 と 動的コライダー vs 静的コライダー
+        dynamicTree_->GetCollisionPair(potentialCollisions_);
+        dynamicTree_->GetCollisionPair(*staticTree_, potentialCollisions_);
 
-    std::list<Collider*> stack;
+        // 静的コライダーとのペアは重複しないのでハッシュグリッドは使わない
+        return;
+    }
+    default:
+        break;
+    }
 
-    if (!colliders_.empty())
-        // QuadTreeを使用して衝突ペアを取得
-        quadTree_->GetCollisionPair(0, potentialCollisions_, stack);
+    if (staticColliders_.empty())
+        return;
 
-    for (auto dynamicCollider : colliders_)
+    // 静的コライダーが動的側にも登録されていると動的同士のペアと重複しうるので、既存のペアも登録しておく
+    staticPairSet_.Clear();
+    staticPairSet_.Reserve(potentialCollisions_.size() + colliders_.size() + persistentColliders_.size());
+    for (const auto& pair : potentialCollisions_)
     {
-        // SpiralHashGridを使用して動的コライダーと衝突する可能性がある静的コライダーを取得
-        std::vector<Collider*> nearbyStaticColliders = spiralHashGrid_->CheckCollision(dynamicCollider);
+        staticPairSet_.Insert(pair.first, pair.second);
+    }
 
-        for (auto staticCollider : nearbyStaticColliders)
+    for (const std::vector<Collider*>* dynamicList : { &colliders_, &persistentColliders_ })
+    {
+        for (auto dynamicCollider : *dynamicList)
         {
-            // 重複チェック（同じペアが既に存在しないか）
-            bool alreadyExists = false;
-            for (const auto& existingPair : potentialCollisions_)
+            AABB bounds = dynamicCollider->GetSweptBounds();
+
+#ifdef _DEBUG
+            if (isDrawEnabled_)
+                spiralHashGrid_->DrawQueryBounds(bounds);
+#endif // _DEBUG
+
+            // SpiralHashGridを使用して動的コライダーと衝突する可能性がある静的コライダーを取得
+            staticQueryResult_.clear();
+            spiralHashGrid_->Query(bounds, dynamicCollider, staticQueryResult_);
+
+            for (auto staticCollider : staticQueryResult_)
             {
-                if ((existingPair.first == dynamicCollider && existingPair.second == staticCollider) ||
-                    (existingPair.first == staticCollider && existingPair.second == dynamicCollider))
+                // 重複チェック（同じペアが既に存在しないか）
+                if (staticPairSet_.Insert(dynamicCollider, staticCollider))
                 {
-                    alreadyExists = true;
-                    break;
+                    potentialCollisions_.emplace_back(dynamicCollider, staticCollider);
                 }
             }
+        }
+    }
+}
+
+void CollisionManager::UpdateDynamicTree()
+{
+    ++broadPhaseFrame_;
+    reinsertedProxyCount_ = 0;
+
+    // 常駐コライダー 動いたと通知されたものだけ葉を動かす 葉がなければ作る
+    for (ColliderHandle handle : dirtyPersistentHandles_)
+    {
+        PersistentSlot& slot = persistentSlots_[handle];
+        // 積まれた後に解除されたものは飛ばす
+        if (slot.collider == nullptr)
+            continue;
+
+        slot.isQueued = false;
+        AABB bounds = slot.collider->GetSweptBounds();
 
-            if (!alreadyExists)
+        if (slot.bvhProxyId == DynamicAABBTree::kNullNode)
+        {
+            slot.bvhProxyId = dynamicTree_->CreateProxy(bounds, slot.collider);
+            ++reinsertedProxyCount_;
+        }
+        else if (dynamicTree_->MoveProxy(slot.bvhProxyId, bounds))
+        {
+            ++reinsertedProxyCount_;
+        }
+    }
+    dirtyPersistentHandles_.clear();
+
+    // 毎フレーム登録されるコライダーも葉を使い回す
+    for (auto collider : colliders_)
+    {
+        AABB bounds = collider->GetSweptBounds();
+
+        auto [it, inserted] = frameProxies_.try_emplace(collider);
+        if (inserted)
+        {
+            it->second.proxyId = dynamicTree_->CreateProxy(bounds, collider);
+            ++reinsertedProxyCount_;
+        }
+        else if (dynamicTree_->MoveProxy(it->second.proxyId, bounds))
+        {
+            ++reinsertedProxyCount_;
+        }
+        it->second.lastFrame = broadPhaseFrame_;
+    }
+
+    // 今フレーム登録されなかったものは葉を削除
+    if (frameProxies_.size() != colliders_.size())
+    {
+        for (auto it = frameProxies_.begin(); it != frameProxies_.end();)
+        {
+            if (it->second.lastFrame != broadPhaseFrame_)
+            {
+                dynamicTree_->DestroyProxy(it->second.proxyId);
+                it = frameProxies_.erase(it);
+            }
+            else
             {
-                potentialCollisions_.emplace_back(dynamicCollider, staticCollider);
+                ++it;
             }
         }
     }
 }
 
+void CollisionManager::QueuePersistentCollider(ColliderHandle _handle)
+{
+    PersistentSlot& slot = persistentSlots_[_handle];
+    if (slot.collider == nullptr || slot.isQueued)
+        return;
+
+    slot.isQueued = true;
+    dirtyPersistentHandles_.push_back(_handle);
+}
+
 CollisionManager::CollisionManager()
     : isDrawEnabled_(true)
 {
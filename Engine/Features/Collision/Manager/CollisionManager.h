@@ -3,6 +3,9 @@
 #include <Features/Collision/Detector/CollisionDetector.h>
 #include <Features/Collision/Tree/QuadTree.h>
 #include <Features/Collision/SpiralHashGird/SpatialHashGrid.h>
+#include <Features/Collision/BVH/DynamicAABBTree.h>
+#include <Features/Collision/BroadPhase/ColliderPairSet.h>
+#include <Features/Collision/Contact/ContactCache.h>
 #include <vector>
 #include <unordered_map>
 #include <functional>
@@ -10,6 +13,18 @@
 
 namespace Engine {
 
+// 常駐登録したコライダーのハンドル
+using ColliderHandle = uint32_t;
+static constexpr ColliderHandle kInvalidColliderHandle = UINT32_MAX;
+
+// ブロードフェーズの方式
+enum class BroadPhaseType
+{
+    QuadTree,           // セル毎にリストを持つ四分木
+    LinearQuadTree,     // モートン順にソートした配列を走査する四分木（確保なし）
+    DynamicAABBTree,    // 高さも考慮する動的AABB木 静的コライダーも別の木で判定する
+};
+
 class CollisionManager
 {
 public:
@@ -17,7 +32,8 @@ public:
     static CollisionManager* GetInstance();
 
     // 初期化
-    void Initialize(const Vector2& _fieldSize, uint32_t _level, const Vector2& _leftBottom, float _gridSize = 1.0f);
+    void Initialize(const Vector2& _fieldSize, uint32_t _level, const Vector2& _leftBottom, float _gridSize = 1.0f,
+        BroadPhaseType _broadPhaseType = BroadPhaseType::QuadTree);
 
     // 終了処理
     void Finalize();
@@ -31,6 +47,12 @@ public:
     // コライダーを登録する（静的コライダー用 地形など)
     void RegisterStaticCollider(Collider* _collider);
 
+    // コライダーを常駐登録する（毎フレームの登録が不要 移動したものだけ空間を更新する）
+    ColliderHandle RegisterPersistentCollider(Collider* _collider);
+
+    // 常駐登録したコライダーの登録解除
+    void UnregisterPersistentCollider(ColliderHandle _handle);
+
     // 衝突判定を実行する
     void CheckCollisionsWithBroadPhase();
 
@@ -55,6 +77,28 @@ public:
     // コライダーの登録解除
     void UnregisterCollider(Collider* _collider);
 
+    // ブロードフェーズの方式を設定
+    void SetBroadPhaseType(BroadPhaseType _type) { broadPhaseType_ = _type; }
+
+    // ブロードフェーズの方式を取得
+    BroadPhaseType GetBroadPhaseType() const { return broadPhaseType_; }
+
+    // 狭域判定のバッチ化（形状の組み合わせ毎にSIMDでまとめて判定）の有効/無効を設定
+    void SetBatchNarrowPhaseEnabled(bool _enabled) { enableBatchNarrowPhase_ = _enabled; }
+
+    // 狭域判定のバッチ化の有効/無効を取得
+    bool IsBatchNarrowPhaseEnabled() const { return enableBatchNarrowPhase_; }
+
+    // 狭域判定の並列化の有効/無効を設定
+    // 判定だけをワーカーで行い、OnCollisionはメインスレッドでペア順に呼ばれる
+    void SetParallelNarrowPhaseEnabled(bool _enabled) { enableParallelNarrowPhase_ = _enabled; }
+
+    // 狭域判定の並列化の有効/無効を取得
+    bool IsParallelNarrowPhaseEnabled() const { return enableParallelNarrowPhase_; }
+
+    // 衝突状態（Enter/Stay/Exit）を保持するキャッシュを取得
+    const ContactCache& GetContactCache() const { return contactCache_; }
+
     // デバッグUI
     void ImGui(bool* _oopen);
 
@@ -68,17 +112,68 @@ private:
     // 衝突判定の範囲処理
     void CheckCollisionsRange();
 
+    // 衝突判定の範囲処理（並列）
+    void CheckCollisionsRangeParallel();
+
+    // [_begin, _end)のペアを判定し、衝突したものをペア順に_contactsへ追加する（コールバックは呼ばない）
+    void CollectContacts(uint32_t _begin, uint32_t _end, std::vector<CollisionPair>& _contacts) const;
+
+    // レイヤーの設定で判定対象になるかどうか
+    bool IsCollisionEnabled(Collider* _colliderA, Collider* _colliderB) const;
+
+    // レイヤーを考慮して1ペアの衝突判定を行う（コールバックは呼ばない）
+    bool DetectCollisionPair(Collider* _colliderA, Collider* _colliderB, ColliderInfo& _info) const;
+
+    // 衝突ペアを記録してコールバックを呼ぶ
+    void DispatchCollision(Collider* _colliderA, Collider* _colliderB, const ColliderInfo& _info);
+
     // 即座削除の内部メソッド
     void RemoveColliderImmediate(Collider* _collider);
 
+    // 動的AABB木を今フレームの位置に合わせる
+    void UpdateDynamicTree();
+
+    // 動いたと通知された常駐コライダーを動的AABB木の更新待ちに積む
+    void QueuePersistentCollider(ColliderHandle _handle);
+
+private:
+    // 常駐コライダーのハンドルが指す先
+    struct PersistentSlot
+    {
+        Collider* collider = nullptr;
+        uint32_t denseIndex = 0; // persistentColliders_内の位置
+        uint32_t treeId = UINT32_MAX; // QuadTreeの常駐オブジェクトID
+        int32_t bvhProxyId = DynamicAABBTree::kNullNode; // 動的AABB木の葉ID
+        uint32_t listenerId = 0; // Collider::AddMoveListenerのID
+        bool isQueued = false; // dirtyPersistentHandles_に積まれているか
+    };
+
+    // 毎フレーム登録されるコライダーの動的AABB木の葉
+    struct FrameProxy
+    {
+        int32_t proxyId = DynamicAABBTree::kNullNode;
+        uint64_t lastFrame = 0; // 最後に登録されたフレーム
+    };
+
 private:
     // コライダーのリスト
     std::vector<Collider*> colliders_;
     std::vector<Collider*> staticColliders_; // 静的コライダーのリスト
 
+    // 常駐コライダーのリスト（毎フレームクリアしない）
+    std::vector<Collider*> persistentColliders_;
+    std::vector<ColliderHandle> persistentHandles_; // persistentColliders_と同じ並びのハンドル
+    std::vector<PersistentSlot> persistentSlots_;
+    std::vector<ColliderHandle> freePersistentHandles_;
+    std::unordered_map<Collider*, ColliderHandle> persistentHandleMap_;
+    std::vector<ColliderHandle> dirtyPersistentHandles_; // 動的AABB木で葉を動かす常駐コライダー
+
     // 衝突ペアのリスト
     std::vector<CollisionPair> collisionPairs_;
 
+    // 衝突しているペアの状態（前フレームとの差分でEnter/Stay/Exitを求める）
+    ContactCache contactCache_;
+
     // デバッグ描画の有効/無効
     bool isDrawEnabled_;
 
@@ -91,12 +186,44 @@ private:
     // スパイラルハッシュグリッド
     std::unique_ptr<SpatialHashGrid> spiralHashGrid_;
 
+    // 動的AABB木 動的コライダー用と静的コライダー用
+    std::unique_ptr<DynamicAABBTree> dynamicTree_;
+    std::unique_ptr<DynamicAABBTree> staticTree_;
+    std::unordered_map<Collider*, FrameProxy> frameProxies_;
+    std::unordered_map<Collider*, int32_t> staticProxies_;
+    uint64_t broadPhaseFrame_ = 0;
+
 #ifdef _DEBUG
     // デバッグ用の衝突検出器
     int32_t colliderCount_ = 0; // 登録されたコライダーの数
     int32_t collisionPairCount_ = 0; // 衝突ペアの数
 #endif // _DEBUG
+    uint32_t movedPersistentCount_ = 0; // 空間を付け替えた常駐コライダーの数
+    uint32_t reinsertedProxyCount_ = 0; // 動的AABB木で組み替えた葉の数
+    size_t bruteForcePairCount_ = 0; // ブロードフェーズなしの場合のペア数
     bool enableBroadPhase_ = true; // ブロードフェーズを使用するかどうか
+    BroadPhaseType broadPhaseType_ = BroadPhaseType::QuadTree; // ブロードフェーズの方式
+
+    // 狭域判定をまとめて行うかどうか
+    bool enableBatchNarrowPhase_ = true;
+
+    // 狭域判定を並列で行うかどうか
+    bool enableParallelNarrowPhase_ = true;
+
+    // 並列狭域判定の1ジョブあたりのペア数
+    static constexpr uint32_t kNarrowPhaseChunkSize = 256;
+
+    // 並列狭域判定のチャンク毎の結果 容量は使い回す
+    std::vector<std::vector<CollisionPair>> narrowPhaseBuffers_;
+
+    // 静的コライダーとのペアの重複チェック用 容量は使い回す
+    ColliderPairSet staticPairSet_;
+
+    // ハッシュグリッドの検索結果 容量は使い回す
+    std::vector<Collider*> staticQueryResult_;
+
+    // 線形四分木に渡すコライダー（毎フレーム登録分 + 常駐分） 容量は使い回す
+    std::vector<Collider*> broadPhaseColliders_;
 
 private:
     // コンストラクタ
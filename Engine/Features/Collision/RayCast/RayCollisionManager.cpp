@@ -3,6 +3,10 @@
 
 #include <Math/Vector/VectorFunction.h>
 #include <Math/Matrix/MatrixFunction.h>
+#include <System/Job/JobSystem.h>
+
+#include <algorithm>
+#include <cassert>
 
 
 namespace Engine {
@@ -13,6 +17,11 @@ RayCollisionManager* RayCollisionManager::GetInstance()
     return &instance;
 }
 
+RayCollisionManager::RayCollisionManager()
+{
+    tree_ = std::make_unique<DynamicAABBTree>();
+}
+
 bool RayCollisionManager::RayCast(const Ray& _ray, Collider* _other, RayCastHit& _hit)
 {
     if (_other == nullptr)
@@ -38,46 +47,57 @@ bool RayCollisionManager::RayCast(const Ray& _ray, Collider* _other, RayCastHit&
 
 void RayCollisionManager::RayCastAll(const Ray& _ray, std::vector<RayCastHit>& _hits, uint32_t _layerMask)
 {
-    for (auto collider : colliders_)
-    {
-        if (collider == nullptr)
-        {
-            continue;
-        }
-        // レイとコライダーの衝突判定
+    UpdateTree();
+
+    size_t firstHit = _hits.size();
+
+    // 探索距離は縮めずに、レイと範囲が交差する葉を全て調べる
+    tree_->RayCast(_ray.GetOrigin(), _ray.GetDirection(), _ray.GetLength(), [&](int32_t _proxyId, float _maxDistance) {
         RayCastHit hit;
-        if (collider->GetLayer() & _layerMask)
+        if (RayCastProxy(_ray, _proxyId, _layerMask, hit))
         {
-            switch (collider->GetBoundingBox())
-            {
-            case BoundingBox::Sphere_3D:
-                RayCastSphere(_ray, static_cast<SphereCollider*>(collider), hit);
-                break;
-            case BoundingBox::AABB_3D:
-                RayCastAABB(_ray, static_cast<AABBCollider*>(collider), hit);
-                break;
-            case BoundingBox::OBB_3D:
-                RayCastOBB(_ray, static_cast<OBBCollider*>(collider), hit);
-                break;
-            case BoundingBox::Capsule_3D:
-                RayCastCapsule(_ray, static_cast<CapsuleCollider*>(collider), hit);
-                break;
-            default:
-                break;
-            }
-            if (hit.hit && hit.distance <= _ray.GetLength())
-            {
-                _hits.push_back(hit);
-            }
+            _hits.push_back(hit);
         }
-    }
+        return _maxDistance;
+        });
 
     // 距離でソート
-    std::sort(_hits.begin(), _hits.end(), [](const RayCastHit& _a, const RayCastHit& _b) {
+    std::sort(_hits.begin() + firstHit, _hits.end(), [](const RayCastHit& _a, const RayCastHit& _b) {
         return _a.distance < _b.distance;
         });
+}
+
+bool RayCollisionManager::RayCastClosest(const Ray& _ray, RayCastHit& _hit, uint32_t _layerMask)
+{
+    UpdateTree();
+
+    return RayCastClosestInTree(_ray, _hit, _layerMask);
+}
+
+void RayCollisionManager::RayCastMany(std::span<const Ray> _rays, std::span<RayCastHit> _hits, uint32_t _layerMask)
+{
+    assert(_rays.size() == _hits.size());
+
+    // 木の更新とトランスフォームの準備はメインスレッドで済ませる
+    UpdateTree();
+
+    uint32_t rayCount = static_cast<uint32_t>((std::min)(_rays.size(), _hits.size()));
+
+    // 木は読み取りのみなので、レイ毎に別スレッドで探索してよい
+    JobSystem::GetInstance()->ParallelFor(rayCount, kRayChunkSize, [&](uint32_t _begin, uint32_t _end) {
+        for (uint32_t i = _begin; i < _end; ++i)
+        {
+            _hits[i] = RayCastHit();
+            RayCastClosestInTree(_rays[i], _hits[i], _layerMask);
+        }
+        });
+}
 
-    ClearColliders();
+void RayCollisionManager::ClearColliders()
+{
+    colliders_.clear();
+    ++frame_;
+    isTreeDirty_ = true;
 }
 
 void RayCollisionManager::RegisterCollider(Collider* _collider)
@@ -87,19 +107,141 @@ void RayCollisionManager::RegisterCollider(Collider* _collider)
         return;
     }
 
-    // 重複登録を避ける
-    auto it = std::find(colliders_.begin(), colliders_.end(), _collider);
-    if (it == colliders_.end())
+    // ワールド行列の初期化を済ませておく（並列の探索中に初期化されないように）
+    _collider->GetWorldTransform();
+
+    // 重複登録を避ける 登録済みでも動いていれば木を更新し直す
+    auto [it, inserted] = proxies_.try_emplace(_collider);
+    if (!inserted && it->second.lastFrame == frame_)
+    {
+        if (IsProxyMoved(it->second, _collider))
+            isTreeDirty_ = true;
+        return;
+    }
+
+    it->second.lastFrame = frame_;
+    colliders_.push_back(_collider);
+    isTreeDirty_ = true;
+}
+
+void RayCollisionManager::UnregisterCollider(Collider* _collider)
+{
+    auto it = proxies_.find(_collider);
+    if (it == proxies_.end())
+        return;
+
+    // 木の葉を消す 次のUpdateTreeを待つと破棄されたコライダーを参照してしまう
+    if (it->second.proxyId != DynamicAABBTree::kNullNode)
+        tree_->DestroyProxy(it->second.proxyId);
+
+    if (it->second.lastFrame == frame_)
+        std::erase(colliders_, _collider);
+
+    proxies_.erase(it);
+}
+
+void RayCollisionManager::UpdateTree()
+{
+    if (!isTreeDirty_)
+        return;
+
+    for (auto collider : colliders_)
+    {
+        RayProxy& proxy = proxies_[collider];
+        if (proxy.proxyId != DynamicAABBTree::kNullNode && !IsProxyMoved(proxy, collider))
+            continue;
+
+        AABB bounds = collider->GetBounds();
+        if (proxy.proxyId == DynamicAABBTree::kNullNode)
+            proxy.proxyId = tree_->CreateProxy(bounds, collider);
+        else
+            tree_->MoveProxy(proxy.proxyId, bounds);
+
+        proxy.transformVersion = collider->GetWorldTransform()->GetVersion();
+        proxy.boundsVersion = collider->GetBoundsVersion();
+    }
+
+    // 今のフレームで登録されなかったコライダーの葉を消す
+    if (proxies_.size() != colliders_.size())
+    {
+        for (auto it = proxies_.begin(); it != proxies_.end();)
+        {
+            if (it->second.lastFrame != frame_)
+            {
+                if (it->second.proxyId != DynamicAABBTree::kNullNode)
+                    tree_->DestroyProxy(it->second.proxyId);
+                it = proxies_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    isTreeDirty_ = false;
+}
+
+bool RayCollisionManager::IsProxyMoved(const RayProxy& _proxy, const Collider* _collider)
+{
+    return _proxy.transformVersion != _collider->GetWorldTransform()->GetVersion() ||
+        _proxy.boundsVersion != _collider->GetBoundsVersion();
+}
+
+bool RayCollisionManager::RayCastProxy(const Ray& _ray, int32_t _proxyId, uint32_t _layerMask, RayCastHit& _hit) const
+{
+    Collider* collider = tree_->GetCollider(_proxyId);
+    if (collider == nullptr || (collider->GetLayer() & _layerMask) == 0)
+        return false;
+
+    // レイとコライダーの衝突判定
+    bool isHit = false;
+    switch (collider->GetBoundingBox())
     {
-        colliders_.push_back(_collider);
+    case BoundingBox::Sphere_3D:
+        isHit = RayCastSphere(_ray, static_cast<SphereCollider*>(collider), _hit);
+        break;
+    case BoundingBox::AABB_3D:
+        isHit = RayCastAABB(_ray, static_cast<AABBCollider*>(collider), _hit);
+        break;
+    case BoundingBox::OBB_3D:
+        isHit = RayCastOBB(_ray, static_cast<OBBCollider*>(collider), _hit);
+        break;
+    case BoundingBox::Capsule_3D:
+        isHit = RayCastCapsule(_ray, static_cast<CapsuleCollider*>(collider), _hit);
+        break;
+    default:
+        break;
     }
 
+    return isHit && _hit.distance <= _ray.GetLength();
+}
+
+bool RayCollisionManager::RayCastClosestInTree(const Ray& _ray, RayCastHit& _hit, uint32_t _layerMask) const
+{
+    _hit.hit = false;
+
+    // ヒットしたら探索距離をその距離まで縮める
+    tree_->RayCast(_ray.GetOrigin(), _ray.GetDirection(), _ray.GetLength(), [&](int32_t _proxyId, float _maxDistance) {
+        RayCastHit hit;
+        if (RayCastProxy(_ray, _proxyId, _layerMask, hit) && (!_hit.hit || hit.distance < _maxDistance))
+        {
+            _hit = hit;
+            return hit.distance;
+        }
+        return _maxDistance;
+        });
+
+    return _hit.hit;
 }
 
 bool RayCollisionManager::RayCastSphere(const Ray& _ray, SphereCollider* _collider, RayCastHit& _hit)
 {
-    Vector3 sphereCenter = _collider->GetWorldTransform()->GetWorldPosition();
-    float sphereRadius = _collider->GetRadius();
+    // 木の葉の範囲(GetBounds)と合わせてオフセットとスケールを適用する
+    const WorldTransform* transform = _collider->GetWorldTransform();
+    Vector3 worldOffset = Transform(_collider->GetOffset(), transform->quaternion_.ToMatrix());
+    Vector3 sphereCenter = transform->GetWorldPosition() + worldOffset;
+    float sphereRadius = _collider->GetRadius() * transform->scale_.x;
 
     // レイの原点から球の中心へのベクトル
     Vector3 m = _ray.GetOrigin() - sphereCenter;
@@ -140,10 +282,13 @@ bool RayCollisionManager::RayCastSphere(const Ray& _ray, SphereCollider* _collid
 
 bool RayCollisionManager::RayCastAABB(const Ray& _ray, AABBCollider* _collider, RayCastHit& _hit)
 {
-    Vector3 AABBpos = _collider->GetWorldTransform()->GetWorldPosition();
+    // 木の葉の範囲(GetBounds)と合わせてオフセットとスケールを適用する
+    const WorldTransform* transform = _collider->GetWorldTransform();
+    Vector3 worldOffset = Transform(_collider->GetOffset(), transform->quaternion_.ToMatrix());
+    Vector3 AABBpos = transform->GetWorldPosition() + worldOffset;
 
-    Vector3 min = AABBpos + _collider->GetMin();
-    Vector3 max = AABBpos + _collider->GetMax();
+    Vector3 min = AABBpos + _collider->GetMin() * transform->scale_;
+    Vector3 max = AABBpos + _collider->GetMax() * transform->scale_;
 
     Vector3 invDir = Vector3(1.0f / _ray.GetDirection().x, 1.0f / _ray.GetDirection().y, 1.0f / _ray.GetDirection().z);
 
@@ -176,7 +321,7 @@ bool RayCollisionManager::RayCastAABB(const Ray& _ray, AABBCollider* _collider,
     _hit.point = _ray.GetPoint(t);
 
     // 法線を計算
-    Vector3 hitLocal = _hit.point - _collider->GetWorldTransform()->transform_;
+    Vector3 hitLocal = _hit.point - AABBpos;
     Vector3 absDistToSides = Vector3(
         std::abs(max.x - _hit.point.x),
         std::abs(max.y - _hit.point.y),
@@ -204,7 +349,7 @@ bool RayCollisionManager::RayCastOBB(const Ray& _ray, OBBCollider* _collider, Ra
     Matrix4x4 invRotMat = Inverse(rotMat);
 
     // OBBの半分の大きさを取得
-    Vector3 halfExtents = _collider->GetHalfExtents();
+    Vector3 halfExtents = _collider->GetHalfExtents() * transform.scale_;
 
     // レイの始点と方向をOBBのローカル座標系に変換
     Vector3 rayOriginLocal = Transform(_ray.GetOrigin() - obbCenter, invRotMat);
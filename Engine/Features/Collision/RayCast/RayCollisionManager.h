@@ -4,6 +4,12 @@
 #include <Math/Matrix/Matrix4x4.h>
 #include <Features/Collision/Collider/Collider.h>
 #include <Features/Collision/RayCast/Ray.h>
+#include <Features/Collision/BVH/DynamicAABBTree.h>
+
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
 
 // レイとの衝突結果
 
@@ -19,6 +25,13 @@ struct RayCastHit
 };
 
 
+/// <summary>
+/// レイとコライダーの衝突判定
+/// 登録されたコライダーのGetBounds()で動的AABB木を作り、同じフレームの全てのレイで使い回す
+/// 毎フレームコライダーを登録してからレイを飛ばす 登録はCollisionManager::Updateの最後にClearCollidersでクリアされる
+/// 登録済みのコライダーはトランスフォームか形状のバージョンが変わったものだけ木の葉を動かす
+/// 破棄されたコライダーはCollider::~ColliderからUnregisterColliderで木から外される
+/// </summary>
 class RayCollisionManager
 {
 public:
@@ -28,26 +41,72 @@ public:
 
     bool RayCast(const Ray& _ray, Collider* _other, RayCastHit& _hit);
 
-    // 全コライダーとの衝突判定
+    // 全コライダーとの衝突判定 ヒットしたものを近い順に_hitsに追加する
     void RayCastAll(const Ray& _ray, std::vector<RayCastHit>& _hits, uint32_t _layerMask);
 
-    void ClearColliders() { colliders_.clear(); }
+    // 最も近いコライダーとの衝突判定 ヒットしたより遠い節は調べない
+    bool RayCastClosest(const Ray& _ray, RayCastHit& _hit, uint32_t _layerMask);
+
+    /// <summary>
+    /// 複数のレイの最も近いヒットをまとめて求める
+    /// JobSystemでレイを分割して並列に処理する _hitsは_raysと同じ数で、同じ順番に結果が入る
+    /// </summary>
+    void RayCastMany(std::span<const Ray> _rays, std::span<RayCastHit> _hits, uint32_t _layerMask);
+
+    // 登録されているコライダーをクリアする（CollisionManager::Updateから毎フレーム呼ばれる）
+    // 木の葉は次のフレームで再登録されたコライダーに使い回す
+    void ClearColliders();
 
     void RegisterCollider(Collider* _collider);
 
+    // コライダーを登録と木から外す（コライダーの破棄時）
+    void UnregisterCollider(Collider* _collider);
+
 
 private:
 
+    RayCollisionManager();
+    ~RayCollisionManager() = default;
+
+    // 登録されたコライダーで木を更新する（登録に変更があった場合のみ）
+    void UpdateTree();
+
+    // 木の葉とレイの判定
+    bool RayCastProxy(const Ray& _ray, int32_t _proxyId, uint32_t _layerMask, RayCastHit& _hit) const;
+
+    // 最も近いヒットを求める（UpdateTree済みであること）
+    bool RayCastClosestInTree(const Ray& _ray, RayCastHit& _hit, uint32_t _layerMask) const;
+
     std::vector<Collider*> colliders_; // コライダーのリスト
 
+    // コライダー毎の木の葉
+    struct RayProxy
+    {
+        int32_t proxyId = DynamicAABBTree::kNullNode;
+        uint64_t lastFrame = 0; // 最後に登録されたフレーム
+        uint32_t transformVersion = 0; // 葉を更新した時のWorldTransform::GetVersion
+        uint32_t boundsVersion = 0;    // 葉を更新した時のCollider::GetBoundsVersion
+    };
+    std::unordered_map<Collider*, RayProxy> proxies_;
+
+    // 葉を更新した時からコライダーが動いたか
+    static bool IsProxyMoved(const RayProxy& _proxy, const Collider* _collider);
+
+    std::unique_ptr<DynamicAABBTree> tree_;
+    uint64_t frame_ = 0;
+    bool isTreeDirty_ = false;
+
+    // RayCastManyで1回に処理するレイの数
+    static constexpr uint32_t kRayChunkSize = 32;
+
     // 各コライダーとの衝突判定
-    bool RayCastSphere(const Ray& _ray, SphereCollider* _collider, RayCastHit& _hit);
+    static bool RayCastSphere(const Ray& _ray, SphereCollider* _collider, RayCastHit& _hit);
 
-    bool RayCastAABB(const Ray& _ray, AABBCollider* _collider, RayCastHit& _hit);
+    static bool RayCastAABB(const Ray& _ray, AABBCollider* _collider, RayCastHit& _hit);
 
-    bool RayCastOBB(const Ray& _ray, OBBCollider* _collider, RayCastHit& _hit);
+    static bool RayCastOBB(const Ray& _ray, OBBCollider* _collider, RayCastHit& _hit);
 
-    bool RayCastCapsule(const Ray& _ray, CapsuleCollider* _collider, RayCastHit& _hit);
+    static bool RayCastCapsule(const Ray& _ray, CapsuleCollider* _collider, RayCastHit& _hit);
 
 
 };
@@ -1,7 +1,8 @@
 #include "SpatialHashGrid.h"
 
-#include <set>
+#include <algorithm>
 #include <array>
+#include <functional>
 #include <Features/LineDrawer/LineDrawer.h>
 
 
@@ -48,29 +49,22 @@ void SpatialHashGrid::RemoveCollider(Collider* _collider)
 
 std::vector<Collider*> SpatialHashGrid::CheckCollision(Collider* _col) const
 {
-    std::set<Collider*> result;
-
     AABB bounds = _col->GetBounds();
 
 #ifdef _DEBUG
-    std::array<Vector3,8> vertices;
-    vertices[0] = bounds.min;
-    vertices[1]=Vector3(bounds.max.x, bounds.min.y, bounds.min.z);
-    vertices[2]=Vector3(bounds.max.x, bounds.min.y, bounds.max.z);
-    vertices[3]=Vector3(bounds.min.x, bounds.min.y, bounds.max.z);
-    vertices[4]=Vector3(bounds.min.x, bounds.max.y, bounds.min.z);
-    vertices[5]=Vector3(bounds.max.x, bounds.max.y, bounds.min.z);
-    vertices[6]=Vector3(bounds.max.x, bounds.max.y, bounds.max.z);
-    vertices[7]=Vector3(bounds.min.x, bounds.max.y, bounds.max.z);
-
-    // デバッグ用にAABBの頂点を描画
-    LineDrawer::GetInstance()->SetColor({ 1.0f, 1.0f, 1.0f, 1.0f });
-    LineDrawer::GetInstance()->DrawOBB(vertices);
-    //(vertices, Matrix4x4::Identity());
+    DrawQueryBounds(bounds);
 #endif
 
+    std::vector<Collider*> result;
+    Query(bounds, _col, result);
+    return result;
+}
+
+size_t SpatialHashGrid::Query(const AABB& _bounds, const Collider* _exclude, std::vector<Collider*>& _out) const
+{
+    size_t begin = _out.size();
 
-    std::array<int32_t, 4> cellIndices = GetCellIndices(bounds);
+    std::array<int32_t, 4> cellIndices = GetCellIndices(_bounds);
 
     for (int32_t x = cellIndices[0]; x <= cellIndices[1]; ++x)
     {
@@ -83,12 +77,12 @@ std::vector<Collider*> SpatialHashGrid::CheckCollision(Collider* _col) const
                 for (Collider* collider : it->second)
                 {
                     // 同じコライダーは除外
-                    if (collider != _col)
+                    if (collider != _exclude)
                     {
                         // 衝突判定を行う
-                        if (collider->GetBounds().Intersect(bounds))
+                        if (collider->GetBounds().Intersect(_bounds))
                         {
-                            result.insert(collider);
+                            _out.push_back(collider);
                         }
                     }
                 }
@@ -96,7 +90,29 @@ std::vector<Collider*> SpatialHashGrid::CheckCollision(Collider* _col) const
         }
     }
 
-    return std::vector<Collider*>(result.begin(), result.end());
+    // 複数のセルにまたがるコライダーの重複を除く
+    auto first = _out.begin() + begin;
+    std::sort(first, _out.end(), std::less<Collider*>());
+    _out.erase(std::unique(first, _out.end()), _out.end());
+
+    return _out.size() - begin;
+}
+
+void SpatialHashGrid::DrawQueryBounds(const AABB& _bounds) const
+{
+    std::array<Vector3, 8> vertices;
+    vertices[0] = _bounds.min;
+    vertices[1] = Vector3(_bounds.max.x, _bounds.min.y, _bounds.min.z);
+    vertices[2] = Vector3(_bounds.max.x, _bounds.min.y, _bounds.max.z);
+    vertices[3] = Vector3(_bounds.min.x, _bounds.min.y, _bounds.max.z);
+    vertices[4] = Vector3(_bounds.min.x, _bounds.max.y, _bounds.min.z);
+    vertices[5] = Vector3(_bounds.max.x, _bounds.max.y, _bounds.min.z);
+    vertices[6] = Vector3(_bounds.max.x, _bounds.max.y, _bounds.max.z);
+    vertices[7] = Vector3(_bounds.min.x, _bounds.max.y, _bounds.max.z);
+
+    // デバッグ用にAABBの頂点を描画
+    LineDrawer::GetInstance()->SetColor({ 1.0f, 1.0f, 1.0f, 1.0f });
+    LineDrawer::GetInstance()->DrawOBB(vertices);
 }
 
 uint64_t SpatialHashGrid::GetHashKey(const Vector2& _position) const
@@ -24,6 +24,19 @@ public:
 
     std::vector<Collider*> CheckCollision(Collider* _col) const;
 
+    /// <summary>
+    /// _boundsと重なるコライダーを_outの末尾に追加する（_outはクリアしない）
+    /// 追加分は重複を除いてアドレス順に並ぶ _outの容量が足りていれば確保は発生しない
+    /// </summary>
+    /// <param name="_bounds">検索範囲</param>
+    /// <param name="_exclude">除外するコライダー（自身）</param>
+    /// <param name="_out">結果の書き込み先</param>
+    /// <returns>追加した数</returns>
+    size_t Query(const AABB& _bounds, const Collider* _exclude, std::vector<Collider*>& _out) const;
+
+    // 検索範囲をデバッグ描画する
+    void DrawQueryBounds(const AABB& _bounds) const;
+
 private:
 
     uint64_t GetHashKey(const Vector2& _position) const;
@@ -3,6 +3,8 @@
 #include <Debug/Debug.h>
 #include <Math/Vector/VectorFunction.h>
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <cmath>
 #include <list>
@@ -12,6 +14,8 @@ namespace Engine {
 
 QuadTree::~QuadTree()
 {
+    RemovePersistentListeners();
+
     for (auto& cell : cells_)
     {
         delete cell;
@@ -60,28 +64,10 @@ void QuadTree::RegisterObj(Collider* _obj)
     auto oft = std::make_shared<ObjectForTree>();
     oft->SetData(_obj);
 
-    Vector2 pos(_obj->GetWorldTransform()->GetWorldPosition().x, _obj->GetWorldTransform()->GetWorldPosition().z);
-    Vector3 offset = _obj->GetOffset();
-    Vector3 worldOffset = Transform(offset, _obj->GetWorldTransform()->quaternion_.ToMatrix());
-    pos += Vector2(worldOffset.x, worldOffset.z);
-    Vector2 size(_obj->GetSize().x, _obj->GetSize().z);
-
-    MortonResult result = CalculateObjectMortonNumberAndLevel(pos, size);
-    uint32_t belongingSpaceIndex = CalculateLinearIndexFromLevelAndNumber(result);
+    uint32_t belongingSpaceIndex = CalculateBelongingSpaceIndex(_obj);
+    RegisterToCell(belongingSpaceIndex, oft);
 
-    if (belongingSpaceIndex < cellCount_)
-    {
-        if (!cells_[belongingSpaceIndex])
-        {
-            CreateCell(belongingSpaceIndex);
-        }
-        cells_[belongingSpaceIndex]->RegisterData(oft);
-    }
-
-    std::cout << "belongingSpace Level: " << result.level << "\n";
-    std::cout << "mortonNumber: " << result.mortonNumber << "\n";
-    std::cout << "registed index: " << belongingSpaceIndex << "\n";
-    std::cout << "----------------------------------------\n";
+    frameObjects_.push_back(oft);
 }
 
 void QuadTree::GetCollisionPair(uint32_t _index, std::vector<std::pair<Collider*, Collider*>>& _pair, std::list<Collider*>& _stac)
@@ -138,7 +124,228 @@ void QuadTree::GetCollisionPair(uint32_t _index, std::vector<std::pair<Collider*
     }
 }
 
+void QuadTree::GetCollisionPairLinear(const std::vector<Collider*>& _objs, std::vector<std::pair<Collider*, Collider*>>& _pair)
+{
+    if (linearRanges_.size() != cellCount_)
+        linearRanges_.assign(cellCount_, LinearRange());
+
+    // 所属セルを計算 範囲外のものはRegisterToCellと同様にルートに入れる
+    linearEntries_.clear();
+    for (Collider* obj : _objs)
+    {
+        if (!obj) continue;
+
+        uint32_t index = CalculateBelongingSpaceIndex(obj);
+        linearEntries_.push_back({ index < cellCount_ ? index : 0, obj });
+    }
+
+    if (linearEntries_.empty())
+        return;
+
+    // セル番号で安定ソート（同じセル内は登録順のまま）
+    RadixSortLinearEntries();
+
+    // セル毎の範囲を記録
+    linearUsedCells_.clear();
+    uint32_t entryCount = static_cast<uint32_t>(linearEntries_.size());
+    for (uint32_t begin = 0; begin < entryCount;)
+    {
+        uint32_t cellIndex = linearEntries_[begin].cellIndex;
+        uint32_t end = begin + 1;
+        while (end < entryCount && linearEntries_[end].cellIndex == cellIndex)
+            ++end;
+
+        linearRanges_[cellIndex] = { begin, end };
+        linearUsedCells_.push_back(cellIndex);
+        begin = end;
+    }
+
+    for (uint32_t cellIndex : linearUsedCells_)
+    {
+        const LinearRange& range = linearRanges_[cellIndex];
+
+        // 同じセル内のペア セルのリストは後から登録したものが先頭に来るため向きを合わせる
+        for (uint32_t i = range.begin; i < range.end; ++i)
+        {
+            for (uint32_t j = i + 1; j < range.end; ++j)
+            {
+                _pair.emplace_back(linearEntries_[j].obj, linearEntries_[i].obj);
+            }
+        }
+
+        // 祖先セルとのペア
+        uint32_t ancestor = cellIndex;
+        while (ancestor != 0)
+        {
+            ancestor = (ancestor - 1) >> 2;
+
+            const LinearRange& ancestorRange = linearRanges_[ancestor];
+            for (uint32_t i = range.begin; i < range.end; ++i)
+            {
+                for (uint32_t j = ancestorRange.begin; j < ancestorRange.end; ++j)
+                {
+                    _pair.emplace_back(linearEntries_[i].obj, linearEntries_[j].obj);
+                }
+            }
+        }
+    }
+
+    // 使用したセルの範囲だけ戻す
+    for (uint32_t cellIndex : linearUsedCells_)
+    {
+        linearRanges_[cellIndex] = LinearRange();
+    }
+}
+
+void QuadTree::RadixSortLinearEntries()
+{
+    constexpr uint32_t kRadixBits = 8;
+    constexpr uint32_t kRadixSize = 1u << kRadixBits;
+
+    // セル番号に必要なビット数だけパスを回す
+    uint32_t keyBits = 0;
+    while (keyBits < 32 && (cellCount_ >> keyBits) != 0)
+        ++keyBits;
+
+    linearSortBuffer_.resize(linearEntries_.size());
+
+    std::array<uint32_t, kRadixSize> counts{};
+    for (uint32_t shift = 0; shift < keyBits; shift += kRadixBits)
+    {
+        counts.fill(0);
+        for (const LinearEntry& entry : linearEntries_)
+        {
+            ++counts[(entry.cellIndex >> shift) & (kRadixSize - 1)];
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t& count : counts)
+        {
+            uint32_t c = count;
+            count = offset;
+            offset += c;
+        }
+
+        for (const LinearEntry& entry : linearEntries_)
+        {
+            linearSortBuffer_[counts[(entry.cellIndex >> shift) & (kRadixSize - 1)]++] = entry;
+        }
+
+        linearEntries_.swap(linearSortBuffer_);
+    }
+}
+
+uint32_t QuadTree::RegisterPersistentObj(Collider* _obj)
+{
+    if (!_obj) return UINT32_MAX;
+
+    uint32_t id = 0;
+    if (!freePersistentIds_.empty())
+    {
+        id = freePersistentIds_.back();
+        freePersistentIds_.pop_back();
+    }
+    else
+    {
+        id = static_cast<uint32_t>(persistentObjs_.size());
+        persistentObjs_.emplace_back();
+    }
+
+    PersistentObj& persistent = persistentObjs_[id];
+    persistent.obj = std::make_shared<ObjectForTree>();
+    persistent.obj->SetData(_obj);
+    persistent.cellIndex = CalculateBelongingSpaceIndex(_obj);
+    persistent.isActive = true;
+    persistent.isQueued = false;
+    persistent.listenerId = _obj->AddMoveListener([this, id]() { QueuePersistentObj(id); });
+
+    RegisterToCell(persistent.cellIndex, persistent.obj);
+
+    return id;
+}
+
+void QuadTree::RemovePersistentObj(uint32_t _id)
+{
+    if (_id >= persistentObjs_.size() || !persistentObjs_[_id].isActive)
+        return;
+
+    PersistentObj& persistent = persistentObjs_[_id];
+    persistent.obj->GetData()->RemoveMoveListener(persistent.listenerId);
+    persistent.obj->Remove();
+    persistent.obj.reset();
+    persistent.isActive = false;
+
+    freePersistentIds_.push_back(_id);
+}
+
+bool QuadTree::UpdatePersistentObj(uint32_t _id)
+{
+    if (_id >= persistentObjs_.size() || !persistentObjs_[_id].isActive)
+        return false;
+
+    PersistentObj& persistent = persistentObjs_[_id];
+    uint32_t newIndex = CalculateBelongingSpaceIndex(persistent.obj->GetData());
+    // 所属空間が変わっていなければ何もしない
+    if (newIndex == persistent.cellIndex && persistent.obj->GetCell() != nullptr)
+        return false;
+
+    persistent.obj->Remove();
+    persistent.cellIndex = newIndex;
+    RegisterToCell(newIndex, persistent.obj);
+
+    return true;
+}
+
+uint32_t QuadTree::UpdatePersistentObjs()
+{
+    // 前回から動いたと通知されたものだけ所属空間を求め直す
+    uint32_t movedCount = 0;
+    for (uint32_t id : dirtyPersistentIds_)
+    {
+        // 積まれた後に削除されたものは飛ばす
+        if (id >= persistentObjs_.size() || !persistentObjs_[id].isActive)
+            continue;
+
+        persistentObjs_[id].isQueued = false;
+        if (UpdatePersistentObj(id))
+            ++movedCount;
+    }
+
+    lastDirtyPersistentCount_ = static_cast<uint32_t>(dirtyPersistentIds_.size());
+    dirtyPersistentIds_.clear();
+    return movedCount;
+}
+
+void QuadTree::QueuePersistentObj(uint32_t _id)
+{
+    PersistentObj& persistent = persistentObjs_[_id];
+    if (!persistent.isActive || persistent.isQueued)
+        return;
+
+    persistent.isQueued = true;
+    dirtyPersistentIds_.push_back(_id);
+}
+
+void QuadTree::RemovePersistentListeners()
+{
+    for (PersistentObj& persistent : persistentObjs_)
+    {
+        if (persistent.isActive)
+            persistent.obj->GetData()->RemoveMoveListener(persistent.listenerId);
+    }
+}
+
 void QuadTree::Reset()
+{
+    // 毎フレーム登録されたものだけを外す 常駐オブジェクトは残す
+    for (auto& obj : frameObjects_)
+    {
+        obj->Remove();
+    }
+    frameObjects_.clear();
+}
+
+void QuadTree::Clear()
 {
     for (auto& cell : cells_)
     {
@@ -147,13 +354,61 @@ void QuadTree::Reset()
             cell->Reset();
         }
     }
+
+    RemovePersistentListeners();
+
+    frameObjects_.clear();
+    persistentObjs_.clear();
+    freePersistentIds_.clear();
+    dirtyPersistentIds_.clear();
+    lastDirtyPersistentCount_ = 0;
+}
+
+uint32_t QuadTree::CalculateBelongingSpaceIndex(Collider* _obj)
+{
+    // CCDが有効な場合は前フレームの位置からの掃引範囲で所属空間を求める
+    if (_obj->IsContinuous())
+    {
+        AABB bounds = _obj->GetSweptBounds();
+        Vector2 sweptPos((bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.z + bounds.max.z) * 0.5f);
+        Vector2 sweptSize(bounds.max.x - bounds.min.x, bounds.max.z - bounds.min.z);
+
+        MortonResult sweptResult = CalculateObjectMortonNumberAndLevel(sweptPos, sweptSize);
+        return CalculateLinearIndexFromLevelAndNumber(sweptResult);
+    }
+
+    Vector2 pos(_obj->GetWorldTransform()->GetWorldPosition().x, _obj->GetWorldTransform()->GetWorldPosition().z);
+    Vector3 offset = _obj->GetOffset();
+    Vector3 worldOffset = Transform(offset, _obj->GetWorldTransform()->quaternion_.ToMatrix());
+    pos += Vector2(worldOffset.x, worldOffset.z);
+    Vector2 size(_obj->GetSize().x, _obj->GetSize().z);
+
+    MortonResult result = CalculateObjectMortonNumberAndLevel(pos, size);
+    return CalculateLinearIndexFromLevelAndNumber(result);
+}
+
+void QuadTree::RegisterToCell(uint32_t _index, const std::shared_ptr<ObjectForTree>& _obj)
+{
+    // 座標はフィールド内に丸めているので範囲外にはならないはず 念のためルートに入れて判定から漏らさない
+    assert(_index < cellCount_);
+    if (_index >= cellCount_)
+        _index = 0;
+
+    if (!cells_[_index])
+    {
+        CreateCell(_index);
+    }
+    cells_[_index]->RegisterData(_obj);
 }
 
 int32_t QuadTree::ConvertPointToMortonCode(const Vector2& _pos) const
 {
     int32_t index = 0;
-    int32_t x = static_cast<int32_t>((_pos.x - leftBottom_.x) / minSpaceSize_.x);
-    int32_t y = static_cast<int32_t>((_pos.y -leftBottom_.y) / minSpaceSize_.y);
+
+    // フィールドの外は端のセルに丸める 丸めないと上位ビットが落ちて別のセルになる
+    float maxCoord = static_cast<float>((1 << level_) - 1);
+    int32_t x = static_cast<int32_t>(std::clamp(std::floor((_pos.x - leftBottom_.x) / minSpaceSize_.x), 0.0f, maxCoord));
+    int32_t y = static_cast<int32_t>(std::clamp(std::floor((_pos.y - leftBottom_.y) / minSpaceSize_.y), 0.0f, maxCoord));
 
     for (int32_t i = 0; i < level_; ++i)
     {
@@ -169,9 +424,6 @@ MortonResult QuadTree::CalculateObjectMortonNumberAndLevel(const Vector2& _pos,
     int32_t lt_index = ConvertPointToMortonCode(_pos - halfSize);
     int32_t rb_index = ConvertPointToMortonCode(_pos + halfSize);
 
-    std::cout << "Left Top Index: " << lt_index << "\n";
-    std::cout << "Right Bottom Index: " << rb_index << "\n";
-
     if (lt_index < 0 || rb_index < 0)
     {
         Debug::Log(std::format("Invalid Morton code: lt_index = {}, rb_index = {}\n", lt_index, rb_index));
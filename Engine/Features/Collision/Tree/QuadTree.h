@@ -26,11 +26,74 @@ public:
     void RegisterObj(Collider* _obj);
     void GetCollisionPair(uint32_t _index, std::vector<std::pair<Collider*, Collider*>>& _pair, std::list<Collider*>& _stac);
 
+    /// <summary>
+    /// セルへの登録を行わず、配列上で衝突ペアを取得する
+    /// モートン番号(線形インデックス)で基数ソートし、セル毎の連続した範囲を走査する
+    /// 得られるペアの組み合わせはRegisterObj + GetCollisionPairと同じ
+    /// </summary>
+    /// <param name="_objs">対象のコライダー</param>
+    /// <param name="_pair">衝突ペアの出力先（追記）</param>
+    void GetCollisionPairLinear(const std::vector<Collider*>& _objs, std::vector<std::pair<Collider*, Collider*>>& _pair);
+
+    // 常駐オブジェクトを登録する（Resetで消えない） 戻り値は常駐オブジェクトのID
+    uint32_t RegisterPersistentObj(Collider* _obj);
+
+    // 常駐オブジェクトを削除する
+    void RemovePersistentObj(uint32_t _id);
+
+    // 常駐オブジェクトの所属空間を更新する 所属空間が変わった場合のみ付け替えてtrueを返す
+    bool UpdatePersistentObj(uint32_t _id);
+
+    // 前回から動いた常駐オブジェクトだけ所属空間を更新する 戻り値は付け替えた数
+    // 動いたものはCollider::AddMoveListenerの通知で積まれるので、常駐オブジェクト全体は走査しない
+    uint32_t UpdatePersistentObjs();
+
+    // 直前のUpdatePersistentObjsで所属空間を求め直した数
+    uint32_t GetDirtyPersistentCount() const { return lastDirtyPersistentCount_; }
+
+    // 毎フレーム登録されたオブジェクトのみを削除する
     void Reset();
 
+    // 常駐オブジェクトも含めて全て削除する
+    void Clear();
+
     std::vector<Cell*> GetCells() { return cells_; }
 
 private:
+    // 常駐オブジェクト
+    struct PersistentObj
+    {
+        std::shared_ptr<ObjectForTree> obj;
+        uint32_t cellIndex = 0;
+        uint32_t listenerId = 0;    // Collider::AddMoveListenerのID
+        bool isQueued = false;      // dirtyPersistentIds_に積まれているか
+        bool isActive = false;
+    };
+
+    // 線形四分木用 セル番号と登録順
+    struct LinearEntry
+    {
+        uint32_t cellIndex;
+        Collider* obj;
+    };
+
+    // 線形四分木用 セルに属する範囲 [begin, end)
+    struct LinearRange
+    {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+    };
+
+    void RadixSortLinearEntries();
+
+    uint32_t CalculateBelongingSpaceIndex(Collider* _obj);
+
+    // 動いたと通知された常駐オブジェクトを積む
+    void QueuePersistentObj(uint32_t _id);
+    // 常駐オブジェクトのコライダーから通知先を外す
+    void RemovePersistentListeners();
+    void RegisterToCell(uint32_t _index, const std::shared_ptr<ObjectForTree>& _obj);
+
     int32_t ConvertPointToMortonCode(const Vector2& _pos) const;
     MortonResult CalculateObjectMortonNumberAndLevel(const Vector2& _pos, const Vector2& _size);
     uint32_t CalculateLinearIndexFromLevelAndNumber(MortonResult _result);
@@ -45,6 +108,20 @@ private:
     int32_t level_ = 3;
     std::vector<Cell*> cells_;
     uint32_t cellCount_ = 0;
+
+    // 毎フレーム登録されたオブジェクト Resetで空間から外す
+    std::vector<std::shared_ptr<ObjectForTree>> frameObjects_;
+
+    std::vector<PersistentObj> persistentObjs_;
+    std::vector<uint32_t> freePersistentIds_;
+    std::vector<uint32_t> dirtyPersistentIds_;  // 次のUpdatePersistentObjsで所属空間を求め直すもの
+    uint32_t lastDirtyPersistentCount_ = 0;
+
+    // 線形四分木用の作業領域 容量は使い回す
+    std::vector<LinearEntry> linearEntries_;
+    std::vector<LinearEntry> linearSortBuffer_;
+    std::vector<LinearRange> linearRanges_;      // セル番号 -> 範囲
+    std::vector<uint32_t> linearUsedCells_;      // 今回使用したセル番号
 };
 
 } // namespace Engine
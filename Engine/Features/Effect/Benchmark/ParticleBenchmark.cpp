@@ -0,0 +1,574 @@
+#include "ParticleBenchmark.h"
+
+#include <Features/Effect/Particle/Particle.h>
+#include <Features/Effect/Particle/ParticlePool.h>
+#include <Features/Effect/Particle/ParticleInstanceBuilder.h>
+#include <Features/Effect/Modifier/ParticleModifier.h>
+#include <Features/Effect/Modifier/Preset/AlphaOverLifetime.h>
+#include <Features/Effect/Modifier/Preset/DecelerationModifier.h>
+#include <Features/Effect/Modifier/Preset/RotationBasedMovementModifier.h>
+#include <Math/Vector/VectorFunction.h>
+#include <Math/Matrix/MatrixFunction.h>
+#include <Math/Easing.h>
+#include <Math/Random/RandomGenerator.h>
+#include <Math/Random/RandomStream.h>
+#include <Features/Effect/Manager/ParticleSystem.h>
+#include <Features/Effect/Manager/EffectTemplateManager.h>
+#include <Features/Effect/Effect/EffectInstance.h>
+#include <System/Time/GameTime.h>
+#include <System/Job/JobSystem.h>
+#include <Debug/Debug.h>
+
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <format>
+#include <list>
+#include <memory>
+#include <random>
+#include <span>
+
+
+namespace Engine {
+
+namespace {
+
+// 旧方式の比較用 ポート前のプリセットと同じ処理を1つずつ行う
+class LegacyAlphaOverLifetime : public ParticleModifier
+{
+public:
+    void Apply(Particle* _particle, [[maybe_unused]] float _deltaTime) override
+    {
+        float alpha = 1.0f - (_particle->GetCurrentTime() / _particle->GetLifeTime());
+        alpha = Easing::Func(AlphaOverLifetime::GetEasingType())(alpha);
+        alpha = std::clamp(alpha, 0.0f, 1.0f);
+
+        Vector4 color = _particle->GetColor();
+        color.w = alpha;
+        _particle->SetColor(color);
+    }
+};
+
+class LegacyDeceleration : public ParticleModifier
+{
+public:
+    void Apply(Particle* _particle, float _deltaTime) override
+    {
+        float speed = _particle->GetSpeed();
+        speed *= (1.0f - DecelerationModifier::GetDeceleration() * _deltaTime);
+        _particle->SetSpeed(speed);
+    }
+};
+
+class LegacyRotationBasedMovement : public ParticleModifier
+{
+public:
+    void Apply(Particle* _particle, [[maybe_unused]] float _deltaTime) override
+    {
+        Vector3 rotVector = Transform(Vector3(0, 1, 0), MakeRotateMatrix(_particle->GetRotation()));
+        _particle->SetDirection(rotVector.Normalize());
+    }
+};
+
+// 旧ParticleSystem::Updateと同じく、リストを値渡しして1つずつ適用する
+void ApplyLegacy(ParticleModifier* _modifier, std::list<Particle*> _particles, float _deltaTime)
+{
+    for (Particle* particle : _particles)
+    {
+        _modifier->Apply(particle, _deltaTime);
+    }
+}
+
+bool CreateModifiers(const std::string& _name, std::unique_ptr<ParticleModifier>& _legacy, std::unique_ptr<ParticleModifier>& _span)
+{
+    if (_name == "AlphaOverLifetime")
+    {
+        _legacy = std::make_unique<LegacyAlphaOverLifetime>();
+        _span = std::make_unique<AlphaOverLifetime>();
+    }
+    else if (_name == "Deceleration")
+    {
+        _legacy = std::make_unique<LegacyDeceleration>();
+        _span = std::make_unique<DecelerationModifier>();
+    }
+    else if (_name == "RotationBasedMovement")
+    {
+        _legacy = std::make_unique<LegacyRotationBasedMovement>();
+        _span = std::make_unique<RotationBasedMovementModifier>();
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// 同じ初期状態のパーティクルをプールに作る
+void CreatePool(ParticlePool& _pool, uint32_t _particleCount, uint32_t _seed)
+{
+    std::mt19937 engine(_seed);
+    std::uniform_real_distribution<float> unitDist(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scaleDist(0.1f, 2.0f);
+
+    _pool.Initialize(_particleCount);
+    for (uint32_t i = 0; i < _particleCount; ++i)
+    {
+        ParticleInitParam param;
+        param.position = Vector3(unitDist(engine), unitDist(engine), unitDist(engine)) * 10.0f;
+        param.rotate = Vector3(unitDist(engine), unitDist(engine), unitDist(engine)) * 3.14f;
+        param.size = Vector3(scaleDist(engine), scaleDist(engine), scaleDist(engine));
+        param.color = Vector4(unitDist(engine), unitDist(engine), unitDist(engine), 1.0f);
+        _pool.Emit(param);
+    }
+}
+
+bool IsEqual(const ParticleForGPU& _a, const ParticleForGPU& _b)
+{
+    for (int32_t row = 0; row < 4; ++row)
+    {
+        for (int32_t column = 0; column < 4; ++column)
+        {
+            if (_a.worldMatrix.m[row][column] != _b.worldMatrix.m[row][column])
+                return false;
+        }
+    }
+    return _a.color.x == _b.color.x && _a.color.y == _b.color.y && _a.color.z == _b.color.z && _a.color.w == _b.color.w;
+}
+
+bool IsEqual(const Vector3& _a, const Vector3& _b)
+{
+    return _a.x == _b.x && _a.y == _b.y && _a.z == _b.z;
+}
+
+double ElapsedMs(std::chrono::high_resolution_clock::time_point _start)
+{
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - _start).count();
+}
+
+} // namespace
+
+ModifierBenchmarkResult ParticleBenchmark::RunModifier(const std::string& _modifierName, uint32_t _particleCount, uint32_t _frameCount)
+{
+    ModifierBenchmarkResult result;
+    result.modifierName = _modifierName;
+    result.particleCount = _particleCount;
+    result.frameCount = _frameCount;
+
+    std::unique_ptr<ParticleModifier> legacyModifier;
+    std::unique_ptr<ParticleModifier> spanModifier;
+    if (_particleCount == 0 || _frameCount == 0 || !CreateModifiers(_modifierName, legacyModifier, spanModifier))
+        return result;
+
+    constexpr uint32_t kSeed = 12345;
+    constexpr float kDeltaTime = 1.0f / 60.0f;
+
+    // 同じ初期状態のパーティクルを両方に作る
+    std::list<std::unique_ptr<Particle>> particles;
+    ParticlePool pool;
+    pool.Initialize(_particleCount);
+
+    std::mt19937 engine(kSeed);
+    std::uniform_real_distribution<float> unitDist(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> lifeDist(1.0f, 3.0f);
+    std::uniform_real_distribution<float> ratioDist(0.0f, 1.0f);
+
+    for (uint32_t i = 0; i < _particleCount; ++i)
+    {
+        ParticleInitParam param;
+        param.lifeTime = lifeDist(engine);
+        param.position = Vector3(unitDist(engine), unitDist(engine), unitDist(engine));
+        param.rotate = Vector3(unitDist(engine), unitDist(engine), unitDist(engine)) * 3.14f;
+        param.direction = Vector3(unitDist(engine), unitDist(engine), unitDist(engine));
+        param.speed = lifeDist(engine);
+        float currentTime = param.lifeTime * ratioDist(engine);
+
+        auto particle = std::make_unique<Particle>();
+        particle->Initialize(param);
+        particle->SetCurrentTime(currentTime);
+        particles.push_back(std::move(particle));
+
+        pool.Emit(param);
+        pool.GetCurrentTime()[i] = currentTime;
+    }
+
+    // 旧方式
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            std::list<Particle*> rawParticles;
+            for (auto& particle : particles)
+            {
+                rawParticles.push_back(particle.get());
+            }
+            ApplyLegacy(legacyModifier.get(), rawParticles, kDeltaTime);
+        }
+        result.legacyMs = ElapsedMs(start) / _frameCount;
+    }
+
+    // ParticleSpan
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            spanModifier->Apply(pool.GetSpan(), kDeltaTime);
+        }
+        result.spanMs = ElapsedMs(start) / _frameCount;
+    }
+
+    // 適用後の属性を比較する
+    ParticleSpan span = pool.GetSpan();
+    result.isResultEqual = true;
+    uint32_t index = 0;
+    for (auto& particle : particles)
+    {
+        bool isEqual =
+            particle->GetColor().w == span.color.w[index] &&
+            particle->GetSpeed() == span.speed[index];
+
+        // 方向は初期値が正規化されていないので、書き換えるモディファイアの場合だけ比較する
+        if (_modifierName == "RotationBasedMovement")
+            isEqual = isEqual && IsEqual(particle->GetDirection(), span.direction.Get(index));
+
+        if (!isEqual)
+        {
+            result.isResultEqual = false;
+            break;
+        }
+        ++index;
+    }
+
+    return result;
+}
+
+InstanceBuildBenchmarkResult ParticleBenchmark::RunInstanceBuild(uint32_t _particleCount, uint32_t _frameCount)
+{
+    InstanceBuildBenchmarkResult result;
+    result.particleCount = _particleCount;
+    result.frameCount = _frameCount;
+
+    if (_particleCount == 0 || _frameCount == 0)
+        return result;
+
+    constexpr uint32_t kSeed = 12345;
+
+    ParticlePool pool;
+    CreatePool(pool, _particleCount, kSeed);
+
+    // Y軸ビルボード
+    Matrix4x4 billboardMatrix = MakeRotateMatrix(Vector3(0.0f, 0.7f, 0.0f));
+
+    std::vector<ParticleForGPU> matrixBuffer(_particleCount);
+    std::vector<ParticleForGPU> scalarBuffer(_particleCount);
+    std::vector<ParticleForGPU> batchBuffer(_particleCount);
+
+    const ParticlePool::Lanes3& position = pool.GetPosition();
+    const ParticlePool::Lanes3& rotation = pool.GetRotation();
+    const ParticlePool::Lanes3& scale = pool.GetScale();
+    const ParticlePool::Lanes4& color = pool.GetColor();
+
+    // 行列積（旧ParticleSystem::Update）
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            for (uint32_t index = 0; index < _particleCount; ++index)
+            {
+                Matrix4x4 affineMatrix =
+                    MakeScaleMatrix(scale.Get(index)) *
+                    MakeRotateMatrix(rotation.Get(index)) *
+                    billboardMatrix *
+                    MakeTranslateMatrix(position.Get(index));
+
+                matrixBuffer[index].worldMatrix = affineMatrix;
+                matrixBuffer[index].color = color.Get(index);
+            }
+        }
+        result.matrixMs = ElapsedMs(start) / _frameCount;
+    }
+
+    // 展開した式で1つずつ
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            for (uint32_t index = 0; index < _particleCount; ++index)
+            {
+                ParticleInstanceBuilder::Build(scale.Get(index), rotation.Get(index), position.Get(index), color.Get(index), billboardMatrix, scalarBuffer[index]);
+            }
+        }
+        result.scalarMs = ElapsedMs(start) / _frameCount;
+    }
+
+    // SSEでまとめて
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            ParticleInstanceBuilder::BuildRange(pool, billboardMatrix, 0, _particleCount, batchBuffer.data());
+        }
+        result.batchMs = ElapsedMs(start) / _frameCount;
+    }
+
+    result.isResultEqual = true;
+    for (uint32_t index = 0; index < _particleCount; ++index)
+    {
+        if (!IsEqual(matrixBuffer[index], scalarBuffer[index]) || !IsEqual(matrixBuffer[index], batchBuffer[index]))
+        {
+            result.isResultEqual = false;
+            break;
+        }
+    }
+
+    return result;
+}
+
+void ParticleBenchmark::RunInstanceBuildSuite()
+{
+    for (uint32_t count : { 1000u, 8192u, 65536u })
+    {
+        InstanceBuildBenchmarkResult result = RunInstanceBuild(count);
+        Debug::Log(std::format("[InstanceBuild] particles: {} matrix: {:.3f} ms scalar: {:.3f} ms batch: {:.3f} ms ({})\n",
+            result.particleCount, result.matrixMs, result.scalarMs, result.batchMs, result.isResultEqual ? "match" : "MISMATCH"));
+    }
+}
+
+RandomBenchmarkResult ParticleBenchmark::RunRandom(uint32_t _particleCount, uint32_t _frameCount)
+{
+    RandomBenchmarkResult result;
+    result.particleCount = _particleCount;
+    result.frameCount = _frameCount;
+
+    if (_particleCount == 0 || _frameCount == 0)
+        return result;
+
+    // 属性毎の出力先
+    struct Attributes
+    {
+        std::vector<Vector3> colorRGB, size, rotation, rotationSpeed, direction;
+        std::vector<float> colorA, lifeTime, speed;
+
+        explicit Attributes(uint32_t _count)
+            : colorRGB(_count), size(_count), rotation(_count), rotationSpeed(_count), direction(_count),
+            colorA(_count), lifeTime(_count), speed(_count) {}
+    };
+
+    const Vector3 zero(0.0f, 0.0f, 0.0f);
+    const Vector3 one(1.0f, 1.0f, 1.0f);
+    const Vector3 angle(6.28318f, 6.28318f, 6.28318f);
+
+    // RandomGenerator
+    {
+        Attributes attributes(_particleCount);
+        RandomGenerator* random = RandomGenerator::GetInstance();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            for (uint32_t i = 0; i < _particleCount; ++i)
+            {
+                attributes.colorRGB[i] = random->GetRandValue(zero, one);
+                attributes.colorA[i] = random->GetRandValue(0.0f, 1.0f);
+                attributes.lifeTime[i] = random->GetRandValue(0.5f, 2.0f);
+                attributes.size[i] = random->GetRandValue(one * 0.5f, one * 2.0f);
+                attributes.rotation[i] = random->GetRandValue(zero, angle);
+                attributes.rotationSpeed[i] = random->GetRandValue(-angle * 0.5f, angle * 0.5f);
+                attributes.speed[i] = random->GetRandValue(0.5f, 2.0f);
+                attributes.direction[i] = random->GetRandValue(-one, one);
+            }
+        }
+        result.legacyMs = ElapsedMs(start) / _frameCount;
+    }
+
+    // RandomStream
+    // [_begin, _end)の範囲を1つの列で埋める
+    auto fillRange = [&](RandomStream& _random, Attributes& _attributes, uint32_t _begin, uint32_t _end) {
+        const size_t count = _end - _begin;
+        _random.Fill(std::span(_attributes.colorRGB).subspan(_begin, count), zero, one);
+        _random.Fill(std::span(_attributes.colorA).subspan(_begin, count), 0.0f, 1.0f);
+        _random.Fill(std::span(_attributes.lifeTime).subspan(_begin, count), 0.5f, 2.0f);
+        _random.Fill(std::span(_attributes.size).subspan(_begin, count), one * 0.5f, one * 2.0f);
+        _random.Fill(std::span(_attributes.rotation).subspan(_begin, count), zero, angle);
+        _random.Fill(std::span(_attributes.rotationSpeed).subspan(_begin, count), -angle * 0.5f, angle * 0.5f);
+        _random.Fill(std::span(_attributes.speed).subspan(_begin, count), 0.5f, 2.0f);
+        _random.Fill(std::span(_attributes.direction).subspan(_begin, count), -one, one);
+    };
+    auto fillStream = [&](RandomStream& _random, Attributes& _attributes) {
+        fillRange(_random, _attributes, 0, _particleCount);
+    };
+
+    constexpr uint64_t kSeed = 12345;
+    Attributes attributes(_particleCount);
+    {
+        RandomStream random(kSeed);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            fillStream(random, attributes);
+        }
+        result.streamMs = ElapsedMs(start) / _frameCount;
+    }
+
+    // チャンク毎にSplitした列を割り当て、JobSystemで並列に埋めた結果と順に埋めた結果が一致するか確かめる
+    {
+        constexpr uint32_t kChunkSize = 256;
+        const uint32_t chunkCount = JobSystem::GetChunkCount(_particleCount, kChunkSize);
+
+        auto createStreams = [&]() {
+            RandomStream root(kSeed);
+            std::vector<RandomStream> streams;
+            streams.reserve(chunkCount);
+            for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                streams.push_back(root.Split());
+            }
+            return streams;
+        };
+
+        std::vector<RandomStream> parallelStreams = createStreams();
+        std::vector<RandomStream> sequentialStreams = createStreams();
+        Attributes parallel(_particleCount);
+        Attributes sequential(_particleCount);
+
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            JobSystem::GetInstance()->ParallelFor(_particleCount, kChunkSize, [&](uint32_t _begin, uint32_t _end) {
+                fillRange(parallelStreams[_begin / kChunkSize], parallel, _begin, _end);
+            });
+
+            for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                const uint32_t begin = chunk * kChunkSize;
+                const uint32_t end = (std::min)(begin + kChunkSize, _particleCount);
+                fillRange(sequentialStreams[chunk], sequential, begin, end);
+            }
+        }
+
+        result.isReproducible =
+            parallel.colorRGB == sequential.colorRGB && parallel.colorA == sequential.colorA &&
+            parallel.lifeTime == sequential.lifeTime && parallel.size == sequential.size &&
+            parallel.rotation == sequential.rotation && parallel.rotationSpeed == sequential.rotationSpeed &&
+            parallel.speed == sequential.speed && parallel.direction == sequential.direction;
+    }
+
+    return result;
+}
+
+void ParticleBenchmark::RunRandomSuite()
+{
+    for (uint32_t count : { 1000u, 10000u })
+    {
+        RandomBenchmarkResult result = RunRandom(count);
+        Debug::Log(std::format("[Random] particles: {} generator: {:.3f} ms stream: {:.3f} ms ({})\n",
+            result.particleCount, result.legacyMs, result.streamMs, result.isReproducible ? "reproducible" : "NOT REPRODUCIBLE"));
+    }
+}
+
+FixedStepCheckResult ParticleBenchmark::RunFixedStep(const std::string& _effectName, uint32_t _stepCount)
+{
+    FixedStepCheckResult result;
+    result.effectName = _effectName;
+
+    std::shared_ptr<const EffectTemplate> effectTemplate = EffectTemplateManager::GetInstance()->Load(_effectName);
+    if (effectTemplate == nullptr)
+        return result;
+
+    // 3ステップずつ進める側と同じ数にそろえる
+    constexpr uint32_t kSlowStepsPerFrame = 3;
+    const uint32_t stepCount = _stepCount / kSlowStepsPerFrame * kSlowStepsPerFrame;
+    result.stepCount = stepCount;
+
+    // 2の累乗分の1にして、フレームの長さを足しても丸め誤差でステップ数が変わらないようにする
+    constexpr float kStep = 1.0f / 64.0f;
+    constexpr uint64_t kSeed = 12345;
+
+    ParticleSystem* particleSystem = ParticleSystem::GetInstance();
+    const bool wasFixedTimeStep = particleSystem->IsFixedTimeStep();
+    const float previousStep = particleSystem->GetFixedTimeStep();
+    const uint32_t previousMaxSteps = particleSystem->GetMaxStepsPerFrame();
+
+    GameTimeChannel& channel = GameTime::GetChannel(effectTemplate->GetTimeChannel());
+
+    // エミッターのグループ（エミッターの名前）の状態をエミッターの順に並べる
+    struct GroupState
+    {
+        uint32_t count = 0;
+        std::vector<float> values;
+
+        bool operator==(const GroupState&) const = default;
+    };
+    auto play = [&](uint32_t _stepsPerFrame) {
+        // 共有テンプレートで再生中の他のエフェクトが同じグループに発生させないように止める
+        EffectTemplateManager::GetInstance()->StopAll();
+        particleSystem->ClearParticles();
+        particleSystem->SetFixedTimeStep(true, kStep, kSlowStepsPerFrame);
+
+        std::unique_ptr<EffectInstance> instance = EffectTemplateManager::GetInstance()->Spawn(effectTemplate);
+        instance->SetRandomSeed(kSeed);
+        instance->Play();
+
+        for (uint32_t frame = 0; frame < stepCount / _stepsPerFrame; ++frame)
+        {
+            channel.Update(kStep * _stepsPerFrame);
+            instance->Update();
+            particleSystem->Update();
+        }
+
+        std::vector<GroupState> states;
+        for (const ParticleEmitter* emitter : effectTemplate->GetEmitters())
+        {
+            GroupState& state = states.emplace_back();
+            const ParticlePool* found = particleSystem->FindGroupPool(emitter->GetName());
+            if (found == nullptr)
+                continue;
+
+            const ParticlePool& pool = *found;
+            state.count = pool.GetCount();
+            for (uint32_t i = 0; i < pool.GetCount(); ++i)
+            {
+                Vector3 position = pool.GetPosition().Get(i);
+                Vector3 rotation = pool.GetRotation().Get(i);
+                Vector4 color = pool.GetColor().Get(i);
+                state.values.insert(state.values.end(), {
+                    position.x, position.y, position.z, rotation.x, rotation.y, rotation.z,
+                    color.x, color.y, color.z, color.w, pool.GetCurrentTime()[i] });
+            }
+        }
+        return states;
+    };
+
+    std::vector<GroupState> fast = play(1);
+    std::vector<GroupState> slow = play(kSlowStepsPerFrame);
+
+    for (const GroupState& state : fast)
+        result.particleCount += state.count;
+    result.isDeterministic = fast == slow;
+
+    particleSystem->ClearParticles();
+    particleSystem->SetFixedTimeStep(wasFixedTimeStep, previousStep, previousMaxSteps);
+    return result;
+}
+
+void ParticleBenchmark::RunFixedStepSuite(const std::string& _effectName)
+{
+    FixedStepCheckResult result = RunFixedStep(_effectName);
+    Debug::Log(std::format("[FixedStep] {} steps: {} particles: {} ({})\n",
+        result.effectName, result.stepCount, result.particleCount, result.isDeterministic ? "deterministic" : "MISMATCH"));
+}
+
+void ParticleBenchmark::RunModifierSuite()
+{
+    for (const char* name : { "AlphaOverLifetime", "Deceleration", "RotationBasedMovement" })
+    {
+        for (uint32_t count : { 1000u, 8192u, 65536u })
+        {
+            ModifierBenchmarkResult result = RunModifier(name, count);
+            Debug::Log(std::format("[Modifier] {} particles: {} legacy: {:.3f} ms span: {:.3f} ms ({})\n",
+                result.modifierName, result.particleCount, result.legacyMs, result.spanMs, result.isResultEqual ? "match" : "MISMATCH"));
+        }
+    }
+}
+
+} // namespace Engine
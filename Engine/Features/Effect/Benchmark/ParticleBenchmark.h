@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+
+namespace Engine {
+
+// モディファイアのベンチマーク結果
+struct ModifierBenchmarkResult
+{
+    std::string modifierName;       // モディファイアの名前
+    uint32_t particleCount = 0;     // パーティクルの数
+    uint32_t frameCount = 0;        // 計測したフレーム数
+    double legacyMs = 0.0;          // 毎フレームstd::list<Particle*>を作り、1つずつ仮想関数で適用する方式の1フレーム平均(ms)
+    double spanMs = 0.0;            // ParticleSpanにまとめて適用する方式の1フレーム平均(ms)
+    bool isResultEqual = false;     // 適用後の属性が全て一致したか
+};
+
+// インスタンス行列生成のベンチマーク結果
+struct InstanceBuildBenchmarkResult
+{
+    uint32_t particleCount = 0;     // パーティクルの数
+    uint32_t frameCount = 0;        // 計測したフレーム数
+    double matrixMs = 0.0;          // Scale * Rotate * Billboard * Translateの行列積で求める方式の1フレーム平均(ms)
+    double scalarMs = 0.0;          // ParticleInstanceBuilder::Buildで1つずつ求める方式の1フレーム平均(ms)
+    double batchMs = 0.0;           // ParticleInstanceBuilder::BuildRangeでまとめて求める方式の1フレーム平均(ms)
+    bool isResultEqual = false;     // 3方式の結果が全て一致したか
+};
+
+// 発生時の乱数生成のベンチマーク結果
+struct RandomBenchmarkResult
+{
+    uint32_t particleCount = 0;     // 1回で発生させるパーティクルの数
+    uint32_t frameCount = 0;        // 計測したフレーム数
+    double legacyMs = 0.0;          // RandomGeneratorで属性毎に1つずつ求める方式の1フレーム平均(ms)
+    double streamMs = 0.0;          // RandomStreamで属性毎にまとめて求める方式の1フレーム平均(ms)
+    bool isReproducible = false;    // Splitした列をJobSystemで並列に埋めた結果が順に埋めた結果と一致したか
+};
+
+// 固定ステップの決定性の確認結果
+struct FixedStepCheckResult
+{
+    std::string effectName;         // 再生したエフェクト
+    uint32_t stepCount = 0;         // 進めた固定ステップ数
+    uint32_t particleCount = 0;     // 最後に生存していたパーティクルの数
+    bool isDeterministic = false;   // 2つのフレームレートで全グループの状態が一致したか
+};
+
+// パーティクルまわりの処理時間を計測する
+class ParticleBenchmark
+{
+public:
+    /// <summary>
+    /// プリセットのモディファイアを旧方式とParticleSpan方式で適用して比較する
+    /// </summary>
+    /// <param name="_modifierName">"AlphaOverLifetime" / "Deceleration" / "RotationBasedMovement"</param>
+    /// <param name="_particleCount">パーティクルの数</param>
+    /// <param name="_frameCount">計測するフレーム数</param>
+    static ModifierBenchmarkResult RunModifier(const std::string& _modifierName, uint32_t _particleCount, uint32_t _frameCount = 10);
+
+    // 各プリセットを1k, 8k, 64kで計測してログに出力する
+    static void RunModifierSuite();
+
+    /// <summary>
+    /// ビルボードありのグループで、インスタンスバッファへの書き込みを行列積と展開した方式で比較する
+    /// </summary>
+    /// <param name="_particleCount">パーティクルの数</param>
+    /// <param name="_frameCount">計測するフレーム数</param>
+    static InstanceBuildBenchmarkResult RunInstanceBuild(uint32_t _particleCount, uint32_t _frameCount = 10);
+
+    // 1k, 8k, 64kで計測してログに出力する
+    static void RunInstanceBuildSuite();
+
+    /// <summary>
+    /// バースト発生で必要になる属性（色・寿命・サイズ・回転・回転速度・速さ・方向）の乱数生成を比較する
+    /// </summary>
+    /// <param name="_particleCount">1回で発生させるパーティクルの数</param>
+    /// <param name="_frameCount">計測するフレーム数</param>
+    static RandomBenchmarkResult RunRandom(uint32_t _particleCount, uint32_t _frameCount = 10);
+
+    // 1k, 10kで計測してログに出力する
+    static void RunRandomSuite();
+
+    /// <summary>
+    /// 同じエフェクトを固定ステップで2つのフレームレート（1フレーム1ステップと3ステップ）で再生し、結果を比べる
+    /// 実際のParticleSystemとEffectTemplateManagerを使うため、再生中のパーティクルは消える デバッグ用
+    /// </summary>
+    /// <param name="_effectName">EffectTemplateManagerで読み込むエフェクトの名前</param>
+    /// <param name="_stepCount">進める固定ステップ数 3の倍数に切り下げる</param>
+    static FixedStepCheckResult RunFixedStep(const std::string& _effectName, uint32_t _stepCount = 192);
+
+    // 確認してログに出力する
+    static void RunFixedStepSuite(const std::string& _effectName);
+};
+
+} // namespace Engine
@@ -2,6 +2,7 @@
 #include <Core/DXCommon/TextureManager/TextureManager.h>
 #include <Features/Model/Manager/ModelManager.h>
 #include <Features/LineDrawer/LineDrawer.h>
+#include <Features/Effect/Manager/EffectTemplateManager.h>
 #include <Debug/ImGuiManager.h>
 #include <System/Time/Time.h>
 #include <algorithm>
@@ -16,6 +17,7 @@ EffectEditorScene::~EffectEditorScene()
 {
 #ifdef _DEBUG
     effects_.clear();
+    EffectTemplateManager::GetInstance()->StopAll();
 #endif
 }
 
@@ -700,6 +702,21 @@ void EffectEditorScene::ImGuiPreviewControls()
         ResetCurrentEffect();
     }
 
+    // 保存済みの設定をテンプレートとして読み直し、共有インスタンスで再生する
+    Effect* effect = GetCurrentEffect();
+    if (effect && ImGui::Button("Play Saved As Instance"))
+    {
+        EffectTemplateManager* templateManager = EffectTemplateManager::GetInstance();
+        templateManager->Reload(effect->GetName());
+        templateManager->Play(effect->GetName(), cameraTargetPosition_);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Stop Instances"))
+    {
+        EffectTemplateManager::GetInstance()->StopAll();
+    }
+    ImGui::Text("Playing Instances: %zu", EffectTemplateManager::GetInstance()->GetPlayingCount());
+
     // 状態表示
     ImGui::Separator();
     ImGui::Text("Status: %s", isPlaying_ ? (isPaused_ ? "Paused" : "Playing") : "Stopped");
@@ -13,6 +13,9 @@ namespace Engine {
 
 Effect::~Effect()
 {
+    if (fixedStepId_ != 0)
+        ParticleSystem::GetInstance()->UnregisterFixedStepCallback(fixedStepId_);
+
     ClearEmitters();
 }
 
@@ -162,15 +165,34 @@ void Effect::Update()
         return;
     }
 
+    // 固定ステップではフレームの経過時間を使わず、ParticleSystemのステップ毎に進める
+    ParticleSystem* particleSystem = ParticleSystem::GetInstance();
+    if (particleSystem->IsFixedTimeStep())
+    {
+        if (fixedStepId_ == 0)
+            fixedStepId_ = particleSystem->RegisterFixedStepCallback(timeChannel_, [this](float _deltaTime) { Step(_deltaTime); });
+        return;
+    }
+
     if (!gameTime_)
     {
         SetError("GameTime not initialized");
         return;
     }
 
+    Step(gameTime_->GetChannel(timeChannel_).GetDeltaTime<float>());
+}
+
+void Effect::Step(float _deltaTime)
+{
+    if (!isActive_ || isPaused_)
+    {
+        return;
+    }
+
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    float deltaTime = gameTime_->GetChannel(timeChannel_).GetDeltaTime<float>() * playbackSpeed_;
+    float deltaTime = _deltaTime * playbackSpeed_;
     elapsedTime_ += deltaTime;
 
     // 開始遅延チェック
@@ -179,7 +201,7 @@ void Effect::Update()
         return;
     }
 
-    UpdateEmitters();
+    UpdateEmitters(deltaTime);
 
     // 完了チェック
     if (IsComplete())
@@ -421,6 +443,14 @@ void Effect::SetName(const std::string& _name)
 void Effect::SetTimeChannel(const std::string& _channel)
 {
     timeChannel_ = _channel;
+
+    // 固定ステップの登録は次のUpdateで新しいチャンネルに登録し直す
+    if (fixedStepId_ != 0)
+    {
+        ParticleSystem::GetInstance()->UnregisterFixedStepCallback(fixedStepId_);
+        fixedStepId_ = 0;
+    }
+
     for (auto& emitter : emitters_)
     {
         if (emitter)
@@ -602,17 +632,13 @@ void Effect::UpdateWorldMatrix()
     worldMatrix_ = MakeAffineMatrix(scale_, rotation_, position_);
 }
 
-void Effect::UpdateEmitters()
+void Effect::UpdateEmitters(float _deltaTime)
 {
-    if (!gameTime_) return;
-
-    float deltaTime = gameTime_->GetChannel(timeChannel_).GetDeltaTime<float>() * playbackSpeed_;
-
     for (auto& emitter : emitters_)
     {
         if (emitter)
         {
-            emitter->Update(deltaTime);
+            emitter->Update(_deltaTime);
         }
     }
 }
@@ -45,6 +45,7 @@ public:
     bool IsComplete() const;
 
     // === 更新・描画 ===
+    // ParticleSystemが固定ステップの場合はステップ毎に進むように登録だけ行う
     void Update();
     void Draw();
     void DrawShadow();
@@ -68,6 +69,7 @@ public:
     // === 設定 (保存系) ===
     void SetName(const std::string& _name);
     void SetTimeChannel(const std::string& _channel);
+    const std::string& GetTimeChannel() const { return timeChannel_; }
     void SetLoop(bool _loop) { isLoop_ = _loop; }
 
     // === 変形・位置 ===
@@ -161,6 +163,7 @@ private:
     float startDelay_ = 0.0f;
     std::string timeChannel_ = "default";
     GameTime* gameTime_ = nullptr;
+    uint32_t fixedStepId_ = 0;     // ParticleSystemの固定ステップに登録したID 0は未登録
 
     // === 変形 ===
     Vector3 position_ = { 0, 0, 0 };
@@ -192,7 +195,9 @@ private:
 
     // === 内部ヘルパー ===
     void UpdateWorldMatrix();
-    void UpdateEmitters();
+    // 再生速度をかける前の経過時間で進める 固定ステップではParticleSystemから呼ばれる
+    void Step(float _deltaTime);
+    void UpdateEmitters(float _deltaTime);
     void SetError(std::string_view _error) const { lastError_ = _error; }
     bool ValidateEmitterName(std::string_view _name) const;
     void RebuildIndexMap();
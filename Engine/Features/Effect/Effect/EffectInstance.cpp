@@ -0,0 +1,145 @@
+#include "EffectInstance.h"
+#include <Features/Effect/Manager/ParticleSystem.h>
+#include <System/Time/GameTime.h>
+
+
+namespace Engine {
+
+EffectInstance::EffectInstance(std::shared_ptr<const EffectTemplate> _template, const RandomStream& _random) :
+    template_(std::move(_template)),
+    emitterStates_(template_->GetEmitters().size()),
+    playbackSpeed_(template_->GetPlaybackSpeed()),
+    random_(_random)
+{
+}
+
+EffectInstance::~EffectInstance()
+{
+    if (fixedStepId_ != 0)
+        ParticleSystem::GetInstance()->UnregisterFixedStepCallback(fixedStepId_);
+}
+
+void EffectInstance::Play()
+{
+    elapsedTime_ = 0.0f;
+    isActive_ = true;
+    isPaused_ = false;
+    ResetEmitters(true);
+}
+
+void EffectInstance::Stop()
+{
+    isActive_ = false;
+    isPaused_ = false;
+}
+
+void EffectInstance::Pause()
+{
+    if (isActive_)
+    {
+        isPaused_ = true;
+    }
+}
+
+void EffectInstance::Resume()
+{
+    if (isActive_)
+    {
+        isPaused_ = false;
+    }
+}
+
+void EffectInstance::Reset()
+{
+    elapsedTime_ = 0.0f;
+    ResetEmitters(false);
+}
+
+bool EffectInstance::IsComplete() const
+{
+    if (!isActive_ || template_->IsLoop()) return false;
+
+    // 全エミッターが非アクティブかつ寿命切れの場合完了
+    for (const ParticleEmitterState& state : emitterStates_)
+    {
+        if (state.isActive || state.isAlive)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EffectInstance::Update()
+{
+    if (!isActive_ || isPaused_)
+    {
+        return;
+    }
+
+    // 固定ステップではフレームの経過時間を使わず、ParticleSystemのステップ毎に進める
+    ParticleSystem* particleSystem = ParticleSystem::GetInstance();
+    if (particleSystem->IsFixedTimeStep())
+    {
+        if (fixedStepId_ == 0)
+            fixedStepId_ = particleSystem->RegisterFixedStepCallback(template_->GetTimeChannel(), [this](float _deltaTime) { Update(_deltaTime); });
+        return;
+    }
+
+    Update(GameTime::GetChannel(template_->GetTimeChannel()).GetDeltaTime<float>());
+}
+
+void EffectInstance::Update(float _deltaTime)
+{
+    if (!isActive_ || isPaused_)
+    {
+        return;
+    }
+
+    float deltaTime = _deltaTime * playbackSpeed_;
+    elapsedTime_ += deltaTime;
+
+    // 開始遅延チェック
+    if (elapsedTime_ < template_->GetStartDelay())
+    {
+        return;
+    }
+
+    const std::vector<const ParticleEmitter*>& emitters = template_->GetEmitters();
+    for (size_t index = 0; index < emitters.size(); ++index)
+    {
+        const ParticleEmitter* emitter = emitters[index];
+        ParticleEmitterState& state = emitterStates_[index];
+
+        if (emitter->Advance(state, deltaTime))
+        {
+            // エミッターの位置はエフェクトの位置で上書きされるため使わず、オフセットだけを加える
+            emitter->EmitParticles(emitter->GetEmitCount(), position_ + emitter->GetOffset(), parentTransform_, random_, state.groupHandle);
+        }
+    }
+
+    // 完了チェック
+    if (IsComplete())
+    {
+        isActive_ = false;
+    }
+    else if (template_->IsLoop() && elapsedTime_ >= template_->GetDuration())
+    {
+        // ループ時のリセット
+        elapsedTime_ = 0.0f;
+        ResetEmitters(true);
+    }
+}
+
+void EffectInstance::ResetEmitters(bool _active)
+{
+    for (ParticleEmitterState& state : emitterStates_)
+    {
+        // 解決済みのグループはそのまま使う
+        state.elapsedTime = 0.0f;
+        state.isActive = _active;
+        state.isAlive = true;
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Features/Effect/Effect/EffectTemplate.h>
+#include <Features/Effect/Emitter/ParticleEmitter.h>
+#include <Features/Model/Transform/WorldTransform.h>
+#include <Math/Random/RandomStream.h>
+#include <Math/Vector/Vector3.h>
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+
+namespace Engine {
+
+/// <summary>
+/// 共有しているEffectTemplateを再生する
+/// 設定はテンプレートから読むだけで、自身は位置・タイマー・再生速度・乱数の状態だけを持つ
+/// EffectTemplateManager::Spawnで作る
+/// </summary>
+class EffectInstance
+{
+public:
+    EffectInstance(std::shared_ptr<const EffectTemplate> _template, const RandomStream& _random);
+    ~EffectInstance();
+
+    // 固定ステップの登録にthisを使うのでコピーしない
+    EffectInstance(const EffectInstance&) = delete;
+    EffectInstance& operator=(const EffectInstance&) = delete;
+
+    // === 再生制御 ===
+    void Play();
+    void Stop();
+    void Pause();
+    void Resume();
+    void Reset();
+
+    // === 状態確認 ===
+    bool IsPlaying() const { return isActive_ && !isPaused_; }
+    bool IsPaused() const { return isPaused_; }
+    bool IsActive() const { return isActive_; }
+    bool IsComplete() const;
+
+    // === 更新 ===
+    // テンプレートの時間チャンネルの経過時間で進める
+    // ParticleSystemが固定ステップの場合はステップ毎に進むように登録だけ行う
+    void Update();
+    // 再生速度をかける前の経過時間で進める
+    void Update(float _deltaTime);
+
+    // === 変形・位置 ===
+    // エミッターの位置はこの位置からのオフセットとして扱う
+    void SetPosition(const Vector3& _position) { position_ = _position; }
+    const Vector3& GetPosition() const { return position_; }
+    void SetParentTransform(const WorldTransform* _parentTransform) { parentTransform_ = _parentTransform; }
+
+    // === タイミング制御 ===
+    void SetPlaybackSpeed(float _speed) { playbackSpeed_ = (std::max)(0.0f, _speed); }
+    float GetPlaybackSpeed() const { return playbackSpeed_; }
+    float GetElapsedTime() const { return elapsedTime_; }
+
+    // 乱数のシードを設定する 同じシードなら同じパーティクルが発生する
+    void SetRandomSeed(uint64_t _seed) { random_.Seed(_seed); }
+
+    const EffectTemplate& GetTemplate() const { return *template_; }
+
+private:
+    std::shared_ptr<const EffectTemplate> template_;
+
+    // エミッター毎の再生状態（テンプレートのエミッターと同じ並び）
+    std::vector<ParticleEmitterState> emitterStates_;
+
+    // === 変形 ===
+    Vector3 position_ = { 0, 0, 0 };
+    const WorldTransform* parentTransform_ = nullptr;
+
+    // === タイミング ===
+    float elapsedTime_ = 0.0f;
+    float playbackSpeed_ = 1.0f;
+    bool isActive_ = false;
+    bool isPaused_ = false;
+    uint32_t fixedStepId_ = 0;     // ParticleSystemの固定ステップに登録したID 0は未登録
+
+    // === 乱数 ===
+    RandomStream random_;
+
+    // エミッターの状態を最初に戻し、_activeで有効にするかを決める
+    void ResetEmitters(bool _active);
+};
+
+} // namespace Engine
@@ -0,0 +1,18 @@
+#include "EffectTemplate.h"
+
+
+namespace Engine {
+
+EffectTemplate::EffectTemplate(std::unique_ptr<Effect> _source) :
+    source_(std::move(_source))
+{
+    // 再生のたびにリストを辿らないように並べておく
+    for (ParticleEmitter* emitter : source_->GetEmitters())
+    {
+        emitters_.push_back(emitter);
+    }
+
+    duration_ = source_->GetDuration();
+}
+
+} // namespace Engine
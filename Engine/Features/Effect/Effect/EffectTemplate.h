@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Features/Effect/Effect/Effect.h>
+#include <Features/Effect/Emitter/ParticleEmitter.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+
+
+namespace Engine {
+
+/// <summary>
+/// 読み込み済みのエフェクトの設定
+/// 再生には使わず、EffectInstanceから読むだけなので複数のインスタンスで共有できる
+/// EffectTemplateManagerから取得する
+/// </summary>
+class EffectTemplate
+{
+public:
+    // 読み込み済みのEffectを受け取る 以降は書き換えない
+    explicit EffectTemplate(std::unique_ptr<Effect> _source);
+    ~EffectTemplate() = default;
+
+    EffectTemplate(const EffectTemplate&) = delete;
+    EffectTemplate& operator=(const EffectTemplate&) = delete;
+
+    const std::string& GetName() const { return source_->GetName(); }
+    const std::string& GetTimeChannel() const { return source_->GetTimeChannel(); }
+    bool IsLoop() const { return source_->IsLoop(); }
+    float GetPlaybackSpeed() const { return source_->GetPlaybackSpeed(); }
+    float GetStartDelay() const { return source_->GetStartDelay(); }
+    float GetDuration() const { return duration_; }
+
+    const std::vector<const ParticleEmitter*>& GetEmitters() const { return emitters_; }
+
+private:
+    std::unique_ptr<Effect> source_;
+    std::vector<const ParticleEmitter*> emitters_;
+    float duration_ = 0.0f;
+};
+
+} // namespace Engine
@@ -5,6 +5,7 @@
 #include <Debug/ImguITools.h>
 #include <algorithm>
 #include <cstring>
+#include <random>
 
 
 namespace Engine {
@@ -13,6 +14,8 @@ int ParticleEmitter::s_nextID_ = 0;
 
 #endif // _DEBUG
 
+ParticleEmitter::EmitScratch ParticleEmitter::scratch_;
+
 
 namespace
 {
@@ -108,9 +111,12 @@ bool ParticleEmitter::Initialize(const std::string& _name)
 
     ClearError();
     name_ = _name;
-    isActive_ = false;
-    isAlive_ = true;
-    elapsedTime_ = 0.0f;
+    state_ = ParticleEmitterState();
+
+    // シードが指定されなければ毎回違う列にする
+    random_.Seed(std::random_device{}());
+
+    isGroupDirty_ = true;
 
     try
     {
@@ -135,77 +141,118 @@ bool ParticleEmitter::Initialize(const std::string& _name)
 
 void ParticleEmitter::Update(float _deltaTime)
 {
-    if (!isActive_ || !isAlive_) return;
+    if (Advance(state_, _deltaTime))
+        GenerateParticles();
+}
+
+bool ParticleEmitter::Advance(ParticleEmitterState& _state, float _deltaTime) const
+{
+    if (!_state.isActive || !_state.isAlive) return false;
 
     // エミッターの時間を更新
-    elapsedTime_ += _deltaTime;
+    _state.elapsedTime += _deltaTime;
 
     // 遅延時間を超えてないとき
-    if (elapsedTime_ < delayTime_) return;
+    if (_state.elapsedTime < delayTime_) return false;
 
-    // 時間ごとにパーティクルを発生させる
-    if (elapsedTime_ >= delayTime_)
+    // ループしているとき
+    if (isLoop_)
     {
-        // ループしているとき
-        if (isLoop_)
+        // 一定時間ごとにパーティクルを発生させる
+        if (_state.elapsedTime >= delayTime_ + lifeTime)
         {
-            // 一定時間ごとにパーティクルを発生させる
-            if (elapsedTime_ >= delayTime_ + lifeTime)
-            {
-                elapsedTime_ = 0.0f;
-            }
+            _state.elapsedTime = 0.0f;
         }
-        else
+    }
+    else
+    {
+        // ループしていないとき
+        if (_state.elapsedTime >= delayTime_ + lifeTime)
         {
-            // ループしていないとき
-            if (elapsedTime_ >= delayTime_ + lifeTime)
-            {
-                isActive_ = false;
-                isAlive_ = false;
-                return;
-            }
+            _state.isActive = false;
+            _state.isAlive = false;
+            return false;
         }
-        GenerateParticles();
     }
+
+    // 時間ごとにパーティクルを発生させる
+    return true;
 }
 
 void ParticleEmitter::Reset()
 {
-    elapsedTime_ = 0.0f;
-    isActive_ = false;
-    isAlive_ = true;
+    state_.elapsedTime = 0.0f;
+    state_.isActive = false;
+    state_.isAlive = true;
 }
 
 void ParticleEmitter::GenerateParticles()
 {
-    if (!ValidateSettings()) return;
+    if (useModelName_ == "")
+        useModelName_ = "cube/cube.obj";
+
+    // 設定が変わっていればグループを解決し直す
+    if (isGroupDirty_)
+    {
+        state_.groupHandle = ParticleGroupHandle();
+        isGroupDirty_ = false;
+    }
+
+    EmitParticles(emitCount_, position_ + offset_, parentTransform_, random_, state_.groupHandle);
+}
 
-    std::vector<std::unique_ptr<Particle>> particles(emitCount_);
+void ParticleEmitter::EmitParticles(uint32_t _count, const Vector3& _position, const WorldTransform* _parentTransform,
+    RandomStream& _random, ParticleGroupHandle& _groupHandle) const
+{
+    if (_count == 0) return;
+
+    // EffectInstanceからも呼ばれるので、設定の確認はここで行う
+    if (!ValidateSettings()) return;
 
     Quaternion q = Quaternion::EulerToQuaternion(rotationEuler_);
     Matrix4x4 emitterTransform = MakeAffineMatrix(
         Vector3(1.0f, 1.0f, 1.0f), // スケール
         q, // 回転
-        position_ // 平行移動
+        _position // 平行移動
     );
 
     Quaternion parentRotation = q;
-    if (parentTransform_)
+    if (_parentTransform)
     {
         // 親のワールドトランスフォームを考慮
-        emitterTransform *= parentTransform_->matWorld_;
-        parentRotation = parentRotation * parentTransform_->quaternion_;
+        emitterTransform *= _parentTransform->matWorld_;
+        parentRotation = parentRotation * _parentTransform->quaternion_;
     }
 
-    for (uint32_t i = 0; i < emitCount_; ++i)
+    // 属性毎にまとめて乱数を求める
+    uint32_t count = _count;
+    scratch_.Resize(count);
+    initParams_.colorRGB.Fill(std::span(scratch_.colorRGB), _random);
+    initParams_.colorA.Fill(std::span(scratch_.colorA), _random);
+    initParams_.lifeTime.Fill(std::span(scratch_.lifeTime), _random);
+    initParams_.size.Fill(std::span(scratch_.size), _random);
+    initParams_.rotation.Fill(std::span(scratch_.rotation), _random);
+    initParams_.rotationSpeed.Fill(std::span(scratch_.rotationSpeed), _random);
+    initParams_.speed.Fill(std::span(scratch_.speed), _random);
+    initParams_.direction.Fill(std::span(scratch_.direction), _random);
+    if (shape_ == EmitterShape::Box)
     {
-        ParticleInitParam initParam;
+        initParams_.boxInnerSize.Fill(std::span(scratch_.innerSize), _random);
+    }
+    else if (shape_ == EmitterShape::Sphere)
+    {
+        initParams_.sphereOffset.Fill(std::span(scratch_.sphereOffset), _random);
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ParticleInitParam& initParam = scratch_.params[i];
+        initParam = ParticleInitParam();
 
         initParam.isBillboard = initParams_.billboard;
 
-        initParam.color;
-        Vector3 rgb = initParams_.colorRGB.GetValue();
-        float alpha = initParams_.colorA.GetValue();
+        Vector3 rgb = scratch_.colorRGB[i];
+        float alpha = scratch_.colorA[i];
 
         initParam.color = Vector4(rgb.x, rgb.y, rgb.z, alpha);
 
@@ -213,18 +260,18 @@ void ParticleEmitter::GenerateParticles()
 
         if (!initParam.isInfiniteLife)
         {
-            initParam.lifeTime = initParams_.lifeTime.GetValue();
+            initParam.lifeTime = scratch_.lifeTime[i];
         }
 
-        Vector3 emitterWorldPos = position_;
+        Vector3 emitterWorldPos = _position;
 
         switch (shape_)
         {
             case EmitterShape::Box:
             {
-                Vector3 randomPos = RandomGenerator::GetInstance()->GetRandValue({ 0,0,0 }, boxSize_);
+                Vector3 randomPos = _random.GetRandValue({ 0,0,0 }, boxSize_);
                 randomPos -= boxSize_ / 2.0f; // 中心を基準にする
-                Vector3 inner = initParams_.boxInnerSize.GetValue();
+                Vector3 inner = scratch_.innerSize[i];
 
                 // X軸: 内径より内側なら外側に押し出す
                 if (std::abs(randomPos.x) < inner.x)
@@ -244,11 +291,11 @@ void ParticleEmitter::GenerateParticles()
             }
             case EmitterShape::Sphere:
             {
-                float sphereOffset = RandomGenerator::GetInstance()->GetRandValue(initParams_.sphereOffset.GetValue(), sphereRadius_);
+                float sphereOffset = _random.GetRandValue(scratch_.sphereOffset[i], sphereRadius_);
 
-                float rad = RandomGenerator::GetInstance()->GetUniformAngle();
+                float rad = _random.GetUniformAngle();
                 initParam.position.x = std::cosf(rad) * sphereOffset;
-                initParam.position.y = RandomGenerator::GetInstance()->GetRandValue(-sphereOffset, sphereOffset);
+                initParam.position.y = _random.GetRandValue(-sphereOffset, sphereOffset);
                 initParam.position.z = std::sinf(rad) * sphereOffset;
                 break;
             }
@@ -260,7 +307,7 @@ void ParticleEmitter::GenerateParticles()
         if (initParams_.directionType == ParticleDirectionType::Random ||
             initParams_.directionType == ParticleDirectionType::Fixed)
         {
-            initParam.direction = initParams_.direction.GetValue();
+            initParam.direction = scratch_.direction[i];
         }
         else if (initParams_.directionType == ParticleDirectionType::Outward)
         {
@@ -280,28 +327,49 @@ void ParticleEmitter::GenerateParticles()
         initParam.direction = TransformNormal(initParam.direction, emitterTransform);
 
         // 回転設定を追加 eulerはベクトルではないのでTransformNormalは不適切 quaternionなどに変換して親の回転を反映させる必要がある
-        initParam.rotate = Vector3::QuaternionToEuler(Quaternion::EulerToQuaternion(initParams_.rotation.GetValue()) * parentRotation);
-        initParam.rotationSpeed = initParams_.rotationSpeed.GetValue();
-        initParam.size = initParams_.size.GetValue();
-        initParam.speed = initParams_.speed.GetValue();
-
-        auto p = std::make_unique<Particle>();
-        particles[i] = std::move(p);
-        particles[i]->Initialize(initParam);
+        initParam.rotate = Vector3::QuaternionToEuler(Quaternion::EulerToQuaternion(scratch_.rotation[i]) * parentRotation);
+        initParam.rotationSpeed = scratch_.rotationSpeed[i];
+        initParam.size = scratch_.size[i];
+        initParam.speed = scratch_.speed[i];
     }
 
+    ParticleSystem* particleSystem = ParticleSystem::GetInstance();
+
+    // ClearParticles()でグループが破棄された場合も解決し直す
+    if (!particleSystem->IsValidGroup(_groupHandle))
+        ResolveGroup(_groupHandle);
+
+    particleSystem->Emit(_groupHandle, std::span<const ParticleInitParam>(scratch_.params.data(), count));
+}
+
+void ParticleEmitter::ResolveGroup(ParticleGroupHandle& _groupHandle) const
+{
     ParticleRenderSettings settings;
     settings.blendMode = blendMode_;
     settings.cullBack = cullBack_;
 
-    if (useModelName_ == "")
-        useModelName_ = "cube/cube.obj";
+    const std::string& modelName = useModelName_.empty() ? std::string("cube/cube.obj") : useModelName_;
 
     uint32_t textureHandle = TextureManager::GetInstance()->Load(initParams_.textureName);
 
     // groupnameには仮でエミッターの名前を入れている
-    ParticleSystem::GetInstance()->AddParticles(name_, useModelName_, std::move(particles), settings, textureHandle, initParams_.modifiers);
+    _groupHandle = ParticleSystem::GetInstance()->ResolveGroup(name_, modelName, settings, textureHandle, initParams_.modifiers);
+    ParticleSystem::GetInstance()->SetTimeChannel(_groupHandle, timeChannel_);
+}
 
+void ParticleEmitter::EmitScratch::Resize(uint32_t _count)
+{
+    colorRGB.resize(_count);
+    size.resize(_count);
+    rotation.resize(_count);
+    rotationSpeed.resize(_count);
+    direction.resize(_count);
+    innerSize.resize(_count);
+    colorA.resize(_count);
+    lifeTime.resize(_count);
+    speed.resize(_count);
+    sphereOffset.resize(_count);
+    params.resize(_count);
 }
 
 void ParticleEmitter::EmitSingle()
@@ -325,6 +393,7 @@ void ParticleEmitter::SetName(const std::string& _name)
     if (!_name.empty())
     {
         name_ = _name;
+        isGroupDirty_ = true;
         ClearError();
 #ifdef _DEBUG
         strncpy_s(nameBuf_, sizeof(nameBuf_), name_.c_str(), _TRUNCATE);
@@ -339,18 +408,21 @@ void ParticleEmitter::SetName(const std::string& _name)
 void ParticleEmitter::SetModelName(const std::string& _modelName)
 {
     useModelName_ = _modelName;
+    isGroupDirty_ = true;
     ClearError();
 }
 
 void ParticleEmitter::SetTextureName(const std::string& _textureName)
 {
     initParams_.textureName = _textureName;
+    isGroupDirty_ = true;
     ClearError();
 }
 
 void ParticleEmitter::SetTimeChannel(const std::string& _channel)
 {
     timeChannel_ = _channel;
+    isGroupDirty_ = true;
 }
 
 bool ParticleEmitter::HasModifier(std::string_view _modifierName) const
@@ -391,6 +463,7 @@ void ParticleEmitter::LoadTexture(std::string_view _texturePath)
     {
         TextureManager::GetInstance()->Load(std::string(_texturePath));
         initParams_.textureName = _texturePath;
+        isGroupDirty_ = true;
         ClearError();
     }
     catch (const std::exception& e)
@@ -407,6 +480,7 @@ void ParticleEmitter::LoadModel(std::string_view _modelPath)
         if (model)
         {
             useModelName_ = _modelPath;
+            isGroupDirty_ = true;
             ClearError();
         }
         else
@@ -425,6 +499,7 @@ void ParticleEmitter::AddModifier(const std::string& _modifierName)
     if (!_modifierName.empty() && !HasModifier(_modifierName))
     {
         initParams_.modifiers.push_back(_modifierName);
+        isGroupDirty_ = true;
         ClearError();
     }
     else if (_modifierName.empty())
@@ -448,6 +523,7 @@ bool ParticleEmitter::RemoveModifier(std::string_view _modifierName)
     if (it != initParams_.modifiers.end())
     {
         initParams_.modifiers.erase(it);
+        isGroupDirty_ = true;
         ClearError();
         return true;
     }
@@ -550,6 +626,9 @@ void ParticleEmitter::ShowDebugWindow()
 
         ShowEmitterSettings();
         ShowParticleInitParams();
+
+        // 描画設定などを直接書き換えるので、次に発生させるときにグループを解決し直す
+        isGroupDirty_ = true;
     }
     ImGui::PopID();
 }
@@ -614,13 +693,10 @@ void ParticleEmitter::ShowEmitterSettings()
             ImGui::TreePop();
         }
 
-        if (parentTransform_ != nullptr)
+        if (ImGui::TreeNode("Emitter Offset"))
         {
-            if (ImGui::TreeNode("Emitter Offset"))
-            {
-                ImGui::DragFloat3("Offset", &offset_.x, 0.01f);
-                ImGui::TreePop();
-            }
+            ImGui::DragFloat3("Offset", &offset_.x, 0.01f);
+            ImGui::TreePop();
         }
     }
     ImGui::PopID();
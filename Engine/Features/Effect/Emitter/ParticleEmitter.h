@@ -1,10 +1,12 @@
 #pragma once
 
 #include <Math/Random/RandomGenerator.h>
+#include <Math/Random/RandomStream.h>
 #include <Features/Effect/ParticleInitParam.h>
 #include <Features/Model/Transform/WorldTransform.h>
 #include <Core/DXCommon/PSOManager/PSOManager.h>
 #include <Features/Json/JsonBinder.h>
+#include <Features/Effect/Manager/ParticleSystem.h>
 
 #include <string>
 #include <string_view>
@@ -12,7 +14,9 @@
 #include <memory>
 #include <cstdint>
 #include <functional>
+#include <span>
 #include <vector>
+#include <algorithm>
 
 // Range構造体 - テンプレート化
 
@@ -36,6 +40,23 @@ struct Range {
         return value;
     }
 
+    // 指定した乱数列から値を取得する
+    T GetValue(RandomStream& _random) const {
+        if (isRandom) {
+            return _random.GetRandValue(minV, maxV);
+        }
+        return value;
+    }
+
+    // _outを全て埋める ランダムの場合は乱数列からまとめて生成する
+    void Fill(std::span<T> _out, RandomStream& _random) const {
+        if (isRandom) {
+            _random.Fill(_out, minV, maxV);
+            return;
+        }
+        std::fill(_out.begin(), _out.end(), value);
+    }
+
     void SetValue(T _newValue) { value = _newValue; }
     void SetRange(T _minValue, T _maxValue) {
         minV = _minValue;
@@ -99,6 +120,18 @@ struct ParticleInitParamsForGenerator
     std::vector<std::string> modifiers;
 };
 
+/// <summary>
+/// エミッターの再生状態
+/// 設定を共有して複数箇所で再生する場合は、再生するもの毎にこれを持つ
+/// </summary>
+struct ParticleEmitterState
+{
+    float elapsedTime = 0.0f;
+    bool isActive = false;
+    bool isAlive = true;
+    ParticleGroupHandle groupHandle;    // 発生先のグループ（未解決なら無効）
+};
+
 class ParticleEmitter
 {
 public:
@@ -115,11 +148,26 @@ public:
     void EmitSingle();
     void EmitBurst(uint32_t _count);
 
+    // === 共有して再生する場合（設定は読むだけで、状態は呼び出し側が持つ） ===
+
+    // 再生状態を進める 今回パーティクルを発生させる場合はtrue
+    bool Advance(ParticleEmitterState& _state, float _deltaTime) const;
+
+    /// <summary>
+    /// このエミッターの設定でパーティクルを発生させる
+    /// </summary>
+    /// <param name="_position">エミッターの位置</param>
+    /// <param name="_parentTransform">親の変換（無ければnullptr）</param>
+    /// <param name="_random">使用する乱数列</param>
+    /// <param name="_groupHandle">発生先のグループ 無効なら解決して書き換える</param>
+    void EmitParticles(uint32_t _count, const Vector3& _position, const WorldTransform* _parentTransform,
+        RandomStream& _random, ParticleGroupHandle& _groupHandle) const;
+
     // === 状態管理 ===
-    void SetActive(bool _active) { isActive_ = _active; }
-    bool IsActive() const { return isActive_; }
-    void SetAlive(bool _alive) { isAlive_ = _alive; }
-    bool IsAlive() const { return isAlive_; }
+    void SetActive(bool _active) { state_.isActive = _active; }
+    bool IsActive() const { return state_.isActive; }
+    void SetAlive(bool _alive) { state_.isAlive = _alive; }
+    bool IsAlive() const { return state_.isAlive; }
 
     // === 設定系 (保存するため const std::string&) ===
     void SetName(const std::string& _name);
@@ -127,6 +175,10 @@ public:
     void SetTextureName(const std::string& _textureName);
     void SetTimeChannel(const std::string& _channel);
 
+    // 乱数のシードを設定する 同じシードなら同じパーティクルが発生する
+    // Initializeでランダムなシードが設定されるので、その後に呼ぶこと
+    void SetRandomSeed(uint64_t _seed) { random_.Seed(_seed); }
+
     // === 検索・比較系 (一時的なため std::string_view) ===
     bool HasModifier(std::string_view _modifierName) const;
 
@@ -141,7 +193,8 @@ public:
     const std::string& GetTextureName() const { return initParams_.textureName; }
     float GetDelayTime() const { return delayTime_; }
     float GetDuration() const { return lifeTime; }
-    float GetElapsedTime() const { return elapsedTime_; }
+    float GetElapsedTime() const { return state_.elapsedTime; }
+    uint32_t GetEmitCount() const { return emitCount_; }
 
     // === 変形・位置系 ===
     void SetParentTransform(WorldTransform* _parentTransform) { parentTransform_ = _parentTransform; }
@@ -151,13 +204,14 @@ public:
     void SetScale(const Vector3& _scale) { scale_ = _scale; }
 
     const Vector3& GetPosition() const { return position_; }
+    const Vector3& GetOffset() const { return offset_; }
     const Quaternion& GetRotation() const { return rotation_; }
     const Vector3& GetScale() const { return scale_; }
 
     // === モディファイア管理 ===
     void AddModifier(const std::string& _modifierName);  // 保存
     bool RemoveModifier(std::string_view _modifierName); // 検索
-    void ClearModifiers() { initParams_.modifiers.clear(); }
+    void ClearModifiers() { initParams_.modifiers.clear(); isGroupDirty_ = true; }
     const std::vector<std::string>& GetModifiers() const { return initParams_.modifiers; }
 
     // === デバッグ・エラー ===
@@ -172,8 +226,6 @@ public:
 private:
     // === コア設定 ===
     std::string name_ = "Emitter";
-    bool isActive_ = false;
-    bool isAlive_ = true;
 
     // === 親子関係 ===
     WorldTransform* parentTransform_ = nullptr;
@@ -201,7 +253,6 @@ private:
 
     // === タイミング ===
     bool isLoop_ = false;
-    float elapsedTime_ = 0.0f;
     float delayTime_ = 0.0f;
     float lifeTime = 0.0f;
     std::string timeChannel_ = "default";
@@ -209,6 +260,27 @@ private:
     // === パーティクル初期値 ===
     ParticleInitParamsForGenerator initParams_;
 
+    // === 再生状態 ===
+    ParticleEmitterState state_;
+
+    // 名前やモデル、描画設定が変わったらstate_.groupHandleを解決し直す
+    bool isGroupDirty_ = true;
+
+    // === 乱数 ===
+    RandomStream random_;
+
+    // 発生時に属性毎にまとめて乱数を求めるための作業領域
+    // 発生はメインスレッドでのみ行うため、全エミッターで使い回す
+    struct EmitScratch
+    {
+        std::vector<Vector3> colorRGB, size, rotation, rotationSpeed, direction, innerSize;
+        std::vector<float> colorA, lifeTime, speed, sphereOffset;
+        std::vector<ParticleInitParam> params;
+
+        void Resize(uint32_t _count);
+    };
+    static EmitScratch scratch_;
+
     // === データ管理 ===
     std::unique_ptr<JsonBinder> jsonBinder_ = nullptr;
 
@@ -232,6 +304,7 @@ private:
     void SetError(std::string_view _error) const { lastError_ = _error; }
     void ClearError() const { lastError_.clear(); }
     bool ValidateSettings() const;
+    void ResolveGroup(ParticleGroupHandle& _groupHandle) const;
 
 #ifdef _DEBUG
     // === ImGuiヘルパー ===
@@ -0,0 +1,88 @@
+#include "EffectTemplateManager.h"
+
+#include <algorithm>
+#include <random>
+
+
+namespace Engine {
+
+EffectTemplateManager* EffectTemplateManager::GetInstance()
+{
+    static EffectTemplateManager instance;
+    return &instance;
+}
+
+EffectTemplateManager::EffectTemplateManager()
+{
+    // 起動毎に違う列にする 再現が必要ならインスタンスのSetRandomSeedを使う
+    seedSource_.Seed(std::random_device{}());
+}
+
+std::shared_ptr<const EffectTemplate> EffectTemplateManager::Load(const std::string& _name)
+{
+    auto it = templates_.find(_name);
+    if (it != templates_.end())
+        return it->second;
+
+    return Reload(_name);
+}
+
+std::shared_ptr<const EffectTemplate> EffectTemplateManager::Find(const std::string& _name) const
+{
+    auto it = templates_.find(_name);
+    if (it != templates_.end())
+        return it->second;
+
+    return nullptr;
+}
+
+std::shared_ptr<const EffectTemplate> EffectTemplateManager::Reload(const std::string& _name)
+{
+    std::unique_ptr<Effect> effect = Effect::Create(_name);
+    if (effect == nullptr)
+        return nullptr;
+
+    auto effectTemplate = std::make_shared<const EffectTemplate>(std::move(effect));
+    templates_[_name] = effectTemplate;
+    return effectTemplate;
+}
+
+std::unique_ptr<EffectInstance> EffectTemplateManager::Spawn(const std::string& _name)
+{
+    return Spawn(Load(_name));
+}
+
+std::unique_ptr<EffectInstance> EffectTemplateManager::Spawn(std::shared_ptr<const EffectTemplate> _template)
+{
+    if (_template == nullptr)
+        return nullptr;
+
+    return std::make_unique<EffectInstance>(std::move(_template), seedSource_.Split());
+}
+
+EffectInstance* EffectTemplateManager::Play(const std::string& _name, const Vector3& _position, const WorldTransform* _parentTransform)
+{
+    std::unique_ptr<EffectInstance> instance = Spawn(_name);
+    if (instance == nullptr)
+        return nullptr;
+
+    instance->SetPosition(_position);
+    instance->SetParentTransform(_parentTransform);
+    instance->Play();
+
+    playingInstances_.push_back(std::move(instance));
+    return playingInstances_.back().get();
+}
+
+void EffectTemplateManager::Update()
+{
+    for (std::unique_ptr<EffectInstance>& instance : playingInstances_)
+    {
+        instance->Update();
+    }
+
+    // 完了したもの、Stopされたものを破棄する
+    std::erase_if(playingInstances_, [](const std::unique_ptr<EffectInstance>& _instance) { return !_instance->IsActive(); });
+}
+
+} // namespace Engine
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Features/Effect/Effect/EffectTemplate.h>
+#include <Features/Effect/Effect/EffectInstance.h>
+#include <Math/Random/RandomStream.h>
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+namespace Engine {
+
+/// <summary>
+/// エフェクトの設定を名前毎に一度だけ読み込んで保持する
+/// 同じエフェクトを何度再生しても、ファイルを読むのは最初の1回だけになる
+/// </summary>
+class EffectTemplateManager
+{
+public:
+    static EffectTemplateManager* GetInstance();
+
+    /// <summary>
+    /// 読み込み済みならそれを返し、無ければファイルから読み込む
+    /// </summary>
+    /// <returns>読み込めなかった場合はnullptr</returns>
+    std::shared_ptr<const EffectTemplate> Load(const std::string& _name);
+
+    // 読み込み済みのものを返す 無ければnullptr（ファイルは読まない）
+    std::shared_ptr<const EffectTemplate> Find(const std::string& _name) const;
+
+    // ファイルから読み込み直す 既に再生中のインスタンスは古い設定のまま再生を続ける
+    std::shared_ptr<const EffectTemplate> Reload(const std::string& _name);
+
+    /// <summary>
+    /// テンプレートを再生するインスタンスを作る
+    /// 未読み込みの場合のみファイルを読む
+    /// </summary>
+    /// <returns>読み込めなかった場合はnullptr</returns>
+    std::unique_ptr<EffectInstance> Spawn(const std::string& _name);
+    std::unique_ptr<EffectInstance> Spawn(std::shared_ptr<const EffectTemplate> _template);
+
+    /// <summary>
+    /// インスタンスを作って再生し、完了するまでこのクラスで保持して更新する
+    /// 返したポインタは完了するかStopされた後のUpdateで破棄されるので、持ち続けないこと
+    /// </summary>
+    /// <param name="_position">再生する位置 エミッターの位置はここからのオフセットになる</param>
+    /// <param name="_parentTransform">親の変換（無ければnullptr）</param>
+    /// <returns>読み込めなかった場合はnullptr</returns>
+    EffectInstance* Play(const std::string& _name, const Vector3& _position, const WorldTransform* _parentTransform = nullptr);
+
+    // Playで再生したインスタンスを更新し、終わったものを破棄する ParticleSystem::Updateから呼ばれる
+    void Update();
+
+    // Playで再生したインスタンスを全て破棄する
+    void StopAll() { playingInstances_.clear(); }
+
+    size_t GetPlayingCount() const { return playingInstances_.size(); }
+
+    // 保持しているテンプレートを全て破棄する 再生中のインスタンスは参照している分を保持し続ける
+    void Clear() { templates_.clear(); }
+
+    size_t GetTemplateCount() const { return templates_.size(); }
+
+private:
+    EffectTemplateManager();
+    ~EffectTemplateManager() = default;
+    EffectTemplateManager(const EffectTemplateManager&) = delete;
+    EffectTemplateManager& operator=(const EffectTemplateManager&) = delete;
+
+    std::unordered_map<std::string, std::shared_ptr<const EffectTemplate>> templates_;
+
+    // Playで再生中のインスタンス
+    std::vector<std::unique_ptr<EffectInstance>> playingInstances_;
+
+    // インスタンス毎の乱数列はここから分ける
+    RandomStream seedSource_;
+};
+
+} // namespace Engine
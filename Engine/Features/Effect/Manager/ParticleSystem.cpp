@@ -5,9 +5,15 @@
 #include <Features/Camera/Camera/Camera.h>
 #include <Math/Matrix/MatrixFunction.h>
 #include <Features/Effect/Emitter/ParticleEmitter.h>
+#include <Features/Effect/Manager/EffectTemplateManager.h>
 #include <Features/Model/Manager/ModelManager.h>
+#include <Features/Effect/Benchmark/ParticleBenchmark.h>
+#include <Debug/ImGuiDebugManager.h>
+#include <System/Job/JobSystem.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 // 静的メンバ変数の初期化
 
@@ -36,6 +42,10 @@ void ParticleSystem::Initialize()
     auto rootsig = PSOManager::GetInstance()->GetRootSignature(PSOFlags::Type::Particle);
     assert(rootsig.has_value());
     rootSignature_ = rootsig.value();
+
+#ifdef _DEBUG
+    ImGuiDebugManager::GetInstance()->RegisterMenuItem("ParticleSystem", [this](bool* _open) { ImGui(_open); });
+#endif // _DEBUG
 }
 
 void ParticleSystem::Update(float _deltaTime)
@@ -46,73 +56,254 @@ void ParticleSystem::Update(float _deltaTime)
         return;
     }
 
-    for (auto& [groupName, particleList] : particles_)
+    // 共有テンプレートで再生中のエフェクトを進める 今回発生した分もこのフレームで更新する
+    EffectTemplateManager::GetInstance()->Update();
+
+    // ファクトリの呼び出しやカメラの参照はメインスレッドで済ませておく
+    PrepareGroups();
+
+    if (!useFixedTimeStep_)
     {
-        if (particleList.particles.empty())
-            continue;
-        particleList.instanceCount = 0;
+        StepGroups(activeGroups_, _deltaTime, false);
+    }
+    else
+    {
+        // 解除された処理を消す
+        fixedStepListeners_.remove_if([](const FixedStepListener& _listener) { return !_listener.callback; });
+
+        AdvanceTimeChannels();
+
+        uint32_t maxStepCount = 0;
+        for (const TimeChannelClock& clock : timeChannels_)
+            maxStepCount = std::max(maxStepCount, clock.stepCount);
+
+        // 各チャンネルの分だけ進める チャンネル内のグループはまとめて並列に処理する
+        for (uint32_t step = 0; step < maxStepCount; ++step)
+        {
+            // 発生もステップ毎に行う グループが増えると並びが変わるので集め直す
+            DispatchFixedStep(step);
+            PrepareGroups();
 
-        auto& particles = particleList.particles;
+            steppingGroups_.clear();
+            for (ParticleGroup* group : activeGroups_)
+            {
+                if (timeChannels_[group->timeChannelIndex].stepCount > step)
+                    steppingGroups_.push_back(group);
+            }
+
+            StepGroups(steppingGroups_, fixedTimeStep_, true);
+        }
+
+        // 寿命で空になったグループを除く
+        PrepareGroups();
+        for (ParticleGroup* group : activeGroups_)
+        {
+            group->isInterpolated = true;
+            group->interpolation = timeChannels_[group->timeChannelIndex].interpolation;
+        }
+    }
 
+    // インスタンスバッファへの書き込み
+    BuildTasks(activeGroups_);
+    RunParallel(static_cast<uint32_t>(tasks_.size()), [this](uint32_t _begin, uint32_t _end)
+        {
+            for (uint32_t i = _begin; i < _end; ++i)
+                WriteInstances(*tasks_[i].group, tasks_[i].begin, tasks_[i].end);
+        });
 
-        auto billboard = particles.front()->GetBillboard();
+    for (ParticleGroup* group : activeGroups_)
+    {
+        group->instanceCount = group->pool.GetCount();
+    }
+}
+
+void ParticleSystem::PrepareGroups()
+{
+    activeGroups_.clear();
+    for (auto& particleList : groups_)
+    {
+        particleList.instanceCount = 0;
+
+        if (particleList.pool.IsEmpty())
+            continue;
+
+        auto& billboard = particleList.billboard;
 
         Vector3 rot = { 0,0,0 };
             if (billboard[0])                rot.x = camera_->rotate_.x;
             if (billboard[1])                rot.y = camera_->rotate_.y;
             if (billboard[2])                rot.z = camera_->rotate_.z;
 
-        Matrix4x4 billboardMatrix = MakeRotateMatrix(rot);
+        particleList.billboardMatrix = MakeRotateMatrix(rot);
+        particleList.isInterpolated = false;
 
-        if (!particleList.useModifierName.empty())
+        particleList.modifiers.clear();
+        particleList.isSerial = false;
+        for (auto& [name, modifier] : particleList.useModifierName)
         {
-            for (auto& [name, modifier] : particleList.useModifierName)
+            auto it = modifierNames_.find(name);
+            if (it == modifierNames_.end())
+            {
+                CreateModifier(name);
+                it = modifierNames_.find(name);
+            }
+            if (it != modifierNames_.end())
             {
-                auto it = modifierNames_.find(name);
-                if (it == modifierNames_.end())
-                {
-                    CreateModifier(name);
-                    it = modifierNames_.find(name);
-                }
-                std::list<Particle*> raw_particles;
-                for (auto& smart_ptr : particles)
-                {
-                    raw_particles.push_back(smart_ptr.get());
-                }
-                it->second->Apply(raw_particles, _deltaTime);
+                particleList.modifiers.push_back(it->second.get());
+                if (!it->second->IsThreadSafe())
+                    particleList.isSerial = true;
             }
         }
 
-        for (auto it = particles.begin(); it != particles.end();)
+        activeGroups_.push_back(&particleList);
+    }
+}
+
+void ParticleSystem::StepGroups(const std::vector<ParticleGroup*>& _groups, float _deltaTime, bool _savePrevious)
+{
+    // モディファイアの適用と移動 大きなグループは分割する
+    parallelGroups_.clear();
+    for (ParticleGroup* group : _groups)
+    {
+        if (!group->isSerial)
+            parallelGroups_.push_back(group);
+    }
+
+    BuildTasks(parallelGroups_);
+    RunParallel(static_cast<uint32_t>(tasks_.size()), [this, _deltaTime, _savePrevious](uint32_t _begin, uint32_t _end)
         {
-            // group上限より大きいとき強制退場
-            if (particleList.instanceCount >= maxInstancesPerGroup)
-                break;
+            for (uint32_t i = _begin; i < _end; ++i)
+                SimulateRange(*tasks_[i].group, tasks_[i].begin, tasks_[i].end, _deltaTime, _savePrevious);
+        });
 
-            auto& particle = *it;
+    // スレッドセーフでないモディファイアは別のグループと共有されていることもあるので、グループ全体をここで順に処理する
+    for (ParticleGroup* group : _groups)
+    {
+        if (group->isSerial)
+            SimulateRange(*group, 0, group->pool.GetCount(), _deltaTime, _savePrevious);
+    }
 
-            if (!particle->IsAlive())
-            {
-                it = particles.erase(it);
-                continue;
-            }
-            particle->Update(_deltaTime);
+    // 寿命が尽きたものを詰める 並びが変わるのでグループ単位で行う
+    RunParallel(static_cast<uint32_t>(_groups.size()), [&_groups](uint32_t _begin, uint32_t _end)
+        {
+            for (uint32_t i = _begin; i < _end; ++i)
+                _groups[i]->pool.RemoveExpired();
+        });
+}
 
-            Matrix4x4 affineMatrix =
-                MakeScaleMatrix(particle->GetScale()) *
-                MakeRotateMatrix(particle->GetRotation()) *
-                billboardMatrix*
-                MakeTranslateMatrix(particle->GetPosition());
+void ParticleSystem::AdvanceTimeChannels()
+{
+    for (TimeChannelClock& clock : timeChannels_)
+    {
+        clock.accumulator += GameTime::GetChannel(clock.name).GetDeltaTime<double>();
+
+        uint32_t stepCount = static_cast<uint32_t>(clock.accumulator / fixedTimeStep_);
+        if (stepCount > maxStepsPerFrame_)
+        {
+            // 追いつけない分は切り捨てる
+            stepCount = maxStepsPerFrame_;
+            clock.accumulator = std::fmod(clock.accumulator, static_cast<double>(fixedTimeStep_));
+        }
+        else
+        {
+            clock.accumulator -= fixedTimeStep_ * static_cast<double>(stepCount);
+        }
+
+        clock.stepCount = stepCount;
+        clock.interpolation = std::clamp(static_cast<float>(clock.accumulator / fixedTimeStep_), 0.0f, 1.0f);
+    }
+}
+
+void ParticleSystem::DispatchFixedStep(uint32_t _step)
+{
+    for (FixedStepListener& listener : fixedStepListeners_)
+    {
+        if (listener.callback && timeChannels_[listener.timeChannelIndex].stepCount > _step)
+            listener.callback(fixedTimeStep_);
+    }
+}
+
+uint32_t ParticleSystem::RegisterFixedStepCallback(const std::string& _channel, FixedStepCallback _callback)
+{
+    if (!_callback)
+        return 0;
+
+    FixedStepListener& listener = fixedStepListeners_.emplace_back();
+    listener.id = nextFixedStepListenerId_++;
+    listener.timeChannelIndex = FindOrAddTimeChannel(_channel);
+    listener.callback = std::move(_callback);
+    return listener.id;
+}
+
+void ParticleSystem::UnregisterFixedStepCallback(uint32_t _id)
+{
+    // 呼び出し中の処理を壊さないように空にするだけにする
+    for (FixedStepListener& listener : fixedStepListeners_)
+    {
+        if (listener.id == _id)
+        {
+            listener.callback = nullptr;
+            return;
+        }
+    }
+}
+
+uint32_t ParticleSystem::FindOrAddTimeChannel(const std::string& _name)
+{
+    for (uint32_t index = 0; index < timeChannels_.size(); ++index)
+    {
+        if (timeChannels_[index].name == _name)
+            return index;
+    }
+
+    TimeChannelClock& clock = timeChannels_.emplace_back();
+    clock.name = _name;
+    return static_cast<uint32_t>(timeChannels_.size() - 1);
+}
+
+void ParticleSystem::SimulateRange(ParticleGroup& _group, uint32_t _begin, uint32_t _end, float _deltaTime, bool _savePrevious)
+{
+    if (_savePrevious)
+        _group.pool.SavePrevious(_begin, _end);
 
-            particleList.mappedInstanceBuffer[particleList.instanceCount].worldMatrix = affineMatrix;
-            particleList.mappedInstanceBuffer[particleList.instanceCount].color = particle->GetColor();
+    ParticleSpan span = _group.pool.GetSpan(_begin, _end - _begin);
+    for (ParticleModifier* modifier : _group.modifiers)
+    {
+        modifier->Apply(span, _deltaTime);
+    }
 
-            particleList.instanceCount++;
-            ++it;
+    _group.pool.Integrate(_deltaTime, _begin, _end);
+}
+
+void ParticleSystem::WriteInstances(ParticleGroup& _group, uint32_t _begin, uint32_t _end)
+{
+    if (_group.isInterpolated)
+        ParticleInstanceBuilder::BuildRangeInterpolated(_group.pool, _group.billboardMatrix, _group.interpolation, _begin, _end, _group.mappedInstanceBuffer);
+    else
+        ParticleInstanceBuilder::BuildRange(_group.pool, _group.billboardMatrix, _begin, _end, _group.mappedInstanceBuffer);
+}
+
+void ParticleSystem::BuildTasks(const std::vector<ParticleGroup*>& _groups)
+{
+    tasks_.clear();
+    for (ParticleGroup* group : _groups)
+    {
+        uint32_t count = group->pool.GetCount();
+        for (uint32_t begin = 0; begin < count; begin += kParticleChunkSize)
+        {
+            tasks_.push_back({ group, begin, std::min(begin + kParticleChunkSize, count) });
         }
     }
 }
 
+void ParticleSystem::RunParallel(uint32_t _count, const std::function<void(uint32_t, uint32_t)>& _func)
+{
+    if (enableParallelUpdate_)
+        JobSystem::GetInstance()->ParallelFor(_count, 1, _func);
+    else
+        _func(0, _count);
+}
+
 void ParticleSystem::DrawParticles()
 {
     auto cmdList = DXCommon::GetInstance()->GetCommandList();
@@ -121,7 +312,7 @@ void ParticleSystem::DrawParticles()
     cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     cmdList->SetGraphicsRootSignature(rootSignature_);
 
-    for (auto& [key, particleList] : particles_)
+    for (auto& particleList : groups_)
     {
         if (particleList.instanceCount == 0)
             continue;
@@ -157,153 +348,195 @@ void ParticleSystem::SetModifierFactory(std::unique_ptr<IParticleMoifierFactory>
 
 void ParticleSystem::AddParticle(const std::string& _groupName, const std::string& _useModelName, std::unique_ptr<Particle> _particle, ParticleRenderSettings _settings, uint32_t _textureHandle, std::vector<std::string> _modifiers)
 {
+    ParticleGroupHandle handle = ResolveGroup(_groupName, _useModelName, _settings, _textureHandle, _modifiers);
+
+    EmitParticle(groups_[handle.index], *_particle);
+}
+
+void ParticleSystem::AddParticles(const std::string& _groupName, const std::string& _useModelName, std::vector<std::unique_ptr<Particle>> _particles, ParticleRenderSettings _settings, uint32_t _textureHandle, std::vector<std::string> _modifiers)
+{
+    ParticleGroupHandle handle = ResolveGroup(_groupName, _useModelName, _settings, _textureHandle, _modifiers);
 
-    ParticleKey key;
-    key.modelName = _useModelName;
-    key.settings = _settings;
+    ParticleGroup& group = groups_[handle.index];
+    for (auto& particle : _particles)
+    {
+        EmitParticle(group, *particle);
+    }
+}
 
-    auto it = particles_.find(_groupName);
-    if (it == particles_.end())
+ParticleGroupHandle ParticleSystem::ResolveGroup(const std::string& _groupName, const std::string& _useModelName, ParticleRenderSettings _settings, uint32_t _textureHandle, const std::vector<std::string>& _modifiers)
+{
+    auto it = groupIndices_.find(_groupName);
+
+    // モデルは新規作成時か異なる場合のみ検索する
+    Model* model = nullptr;
+    if (it == groupIndices_.end() ||
+        groups_[it->second].model == nullptr ||
+        groups_[it->second].key.modelName != _useModelName)
     {
-        ParticleGroup& group = particles_[_groupName];
-        group.key = key;
+        model = ModelManager::GetInstance()->FindSameModel(_useModelName);
+        if (model == nullptr)
+            throw std::runtime_error("Modelname '" + _useModelName + "'  が無効です。");
+    }
+
+    if (it == groupIndices_.end())
+    {
+        it = groupIndices_.emplace(_groupName, static_cast<uint32_t>(groups_.size())).first;
+
+        ParticleGroup& group = groups_.emplace_back();
+        group.name = _groupName;
         group.srvIndex = srvManager_->Allocate();
         group.instanceCount = 0;
-        group.particles.push_back(std::move(_particle));
+        group.pool.Initialize(maxInstancesPerGroup);
+        group.timeChannelIndex = FindOrAddTimeChannel("default");
 
         group.instanceBuffer = DXCommon::GetInstance()->CreateBufferResource(sizeof(ParticleForGPU) * maxInstancesPerGroup);
         group.instanceBuffer->Map(0, nullptr, reinterpret_cast<void**>(&group.mappedInstanceBuffer));
 
         srvManager_->CreateSRVForStructureBuffer(group.srvIndex, group.instanceBuffer.Get(), maxInstancesPerGroup, sizeof(ParticleForGPU));
-
-        group.model = ModelManager::GetInstance()->FindSameModel(_useModelName);
-
-        PSOFlags psoFlags = _settings.GetPSOFlags();
-        psoFlags = psoFlags | PSOFlags::Type::Particle | PSOFlags::DepthMode::Comb_mZero_fLessEqual;
-
-        // PSOFlagsが未登録の場合は登録する
-        if (!psoMap_.contains(psoFlags))
-            psoMap_[psoFlags] = PSOManager::GetInstance()->GetPipeLineStateObject(psoFlags).value();
-
-        group.psoIndex = psoFlags;
-
-        group.textureHandle = _textureHandle;
-
-        // モディファイアの登録
-        for (const std::string& name : _modifiers)
-        {
-            group.useModifierName[name] = 1;
-        }
     }
-    else
-    {
-        PSOFlags psoFlags = _settings.GetPSOFlags();
-        psoFlags = psoFlags | PSOFlags::Type::Particle | PSOFlags::DepthMode::Comb_mZero_fLessEqual;
 
-        // PSOFlagsが未登録の場合は登録する
-        if (!psoMap_.contains(psoFlags))
-            psoMap_[psoFlags] = PSOManager::GetInstance()->GetPipeLineStateObject(psoFlags).value();
+    ParticleGroup& group = groups_[it->second];
+    if (model != nullptr)
+        group.model = model;
 
-        it->second.psoIndex = psoFlags;
-
-        it->second.particles.push_back(std::move(_particle));
-    }
+    group.key.modelName = _useModelName;
+    group.key.settings = _settings;
+    group.psoIndex = ResolvePSO(_settings);
+    group.textureHandle = _textureHandle;
 
     // モディファイアの登録
     for (const std::string& name : _modifiers)
     {
-        particles_[_groupName].useModifierName[name] = 1;
-        //particles_[key].useModifierName[name] = 1;
+        group.useModifierName[name] = 1;
     }
+
+    return { it->second, generation_ };
 }
 
-void ParticleSystem::AddParticles(const std::string& _groupName, const std::string& _useModelName, std::vector<std::unique_ptr<Particle>> _particles, ParticleRenderSettings _settings, uint32_t _textureHandle, std::vector<std::string> _modifiers)
+const ParticlePool* ParticleSystem::FindGroupPool(const std::string& _groupName) const
 {
+    auto it = groupIndices_.find(_groupName);
+    if (it == groupIndices_.end())
+        return nullptr;
 
-    ParticleKey key;
-    key.modelName = _useModelName;
-    key.settings = _settings;
+    return &groups_[it->second].pool;
+}
 
-    auto it = particles_.find(_groupName);
-    if (it == particles_.end())
-    {
-        ParticleGroup& group = particles_[_groupName];
-        group.key = key;
+bool ParticleSystem::IsValidGroup(ParticleGroupHandle _handle) const
+{
+    return _handle.generation == generation_ && _handle.index < groups_.size();
+}
 
-        group.srvIndex = srvManager_->Allocate();
-        group.instanceCount = 0;
+uint32_t ParticleSystem::Emit(ParticleGroupHandle _handle, std::span<const ParticleInitParam> _params)
+{
+    if (!IsValidGroup(_handle) || _params.empty())
+        return 0;
 
-        for (auto& particle : _particles)
-        {
-            group.particles.push_back(std::move(particle));
-        }
+    ParticleGroup& group = groups_[_handle.index];
 
-        group.instanceBuffer = DXCommon::GetInstance()->CreateBufferResource(sizeof(ParticleForGPU) * maxInstancesPerGroup);
-        group.instanceBuffer->Map(0, nullptr, reinterpret_cast<void**>(&group.mappedInstanceBuffer));
+    // ビルボードの設定はグループの先頭のものを使う
+    if (group.pool.IsEmpty())
+        group.billboard = _params.front().isBillboard;
 
-        srvManager_->CreateSRVForStructureBuffer(group.srvIndex, group.instanceBuffer.Get(), maxInstancesPerGroup, sizeof(ParticleForGPU));
+    return group.pool.Emit(_params);
+}
 
-        group.model = ModelManager::GetInstance()->FindSameModel(_useModelName);
-        if (group.model == nullptr)
-            throw std::runtime_error("Modelname '" + _useModelName + "'  が無効です。");
+void ParticleSystem::SetTimeChannel(ParticleGroupHandle _handle, const std::string& _channel)
+{
+    if (!IsValidGroup(_handle))
+        return;
 
-        PSOFlags psoFlags = _settings.GetPSOFlags();
-        psoFlags = psoFlags | PSOFlags::Type::Particle | PSOFlags::DepthMode::Comb_mZero_fLessEqual;
+    groups_[_handle.index].timeChannelIndex = FindOrAddTimeChannel(_channel);
+}
 
-        // PSOFlagsが未登録の場合は登録する
-        if (!psoMap_.contains(psoFlags))
-            psoMap_[psoFlags] = PSOManager::GetInstance()->GetPipeLineStateObject(psoFlags).value();
+void ParticleSystem::SetFixedTimeStep(bool _enable, float _step, uint32_t _maxStepsPerFrame)
+{
+    useFixedTimeStep_ = _enable;
+    fixedTimeStep_ = std::max(_step, 1.0e-4f);
+    maxStepsPerFrame_ = std::max(_maxStepsPerFrame, 1u);
 
-        group.psoIndex = psoFlags;
-        group.textureHandle = _textureHandle;
-    }
-    else
+    // 切り替えた時点から数え直す
+    for (TimeChannelClock& clock : timeChannels_)
     {
-        auto& group = it->second;
+        clock.accumulator = 0.0;
+        clock.stepCount = 0;
+    }
+}
 
-        // パーティクルだけを追加
-        for (auto& particle : _particles)
-        {
-            group.particles.push_back(std::move(particle));
-        }
-        group.textureHandle = _textureHandle;
+void ParticleSystem::ClearParticles()
+{
+    groups_.clear();
+    groupIndices_.clear();
+    ++generation_;
+}
 
-        PSOFlags psoFlags = _settings.GetPSOFlags();
-        psoFlags = psoFlags | PSOFlags::Type::Particle | PSOFlags::DepthMode::Comb_mZero_fLessEqual;
+void ParticleSystem::ClearParticles(const std::string& _groupName)
+{
+    auto it = groupIndices_.find(_groupName);
+    if (it != groupIndices_.end())
+        groups_[it->second].pool.Clear();
+}
+
+void ParticleSystem::ImGui([[maybe_unused]] bool* _open)
+{
+#ifdef _DEBUG
+    ImGui::Begin("ParticleSystem", _open);
 
-        // PSOFlagsが未登録の場合は登録する
-        if (!psoMap_.contains(psoFlags))
-            psoMap_[psoFlags] = PSOManager::GetInstance()->GetPipeLineStateObject(psoFlags).value();
+    ImGui::PushID(this);
 
-        group.psoIndex = psoFlags;
+    // グループの更新を並列に行うか
+    ImGui::Checkbox("Parallel Update", &enableParallelUpdate_);
+    ImGui::SameLine();
+    ImGui::Text("(%u threads)", JobSystem::GetInstance()->GetConcurrency());
 
-        // モデルが異なる場合のみ更新
-        if (group.model == nullptr || group.key.modelName != _useModelName)
+    // 固定ステップでの更新
+    bool useFixedTimeStep = useFixedTimeStep_;
+    if (ImGui::Checkbox("Fixed Time Step", &useFixedTimeStep))
+        SetFixedTimeStep(useFixedTimeStep, fixedTimeStep_, maxStepsPerFrame_);
+    if (useFixedTimeStep_)
+    {
+        for (const TimeChannelClock& clock : timeChannels_)
         {
-            group.model = ModelManager::GetInstance()->FindSameModel(_useModelName);
-            if (group.model == nullptr)
-                throw std::runtime_error("Modelname '" + _useModelName + "'  が無効です。");
+            ImGui::Text("%s: %u steps, alpha %.2f", clock.name.c_str(), clock.stepCount, clock.interpolation);
         }
     }
 
-    // モディファイアの登録
-    for (const std::string& name : _modifiers)
+    // グループ毎のパーティクル数
+    for (auto& group : groups_)
     {
-        particles_[_groupName].useModifierName[name] = 1;
-        //particles_[key].useModifierName[name] = 1;
+        ImGui::Text("%s: %u / %u", group.name.c_str(), group.pool.GetCount(), group.pool.GetCapacity());
     }
-}
 
-void ParticleSystem::ClearParticles()
-{
-    particles_.clear();
-}
+    // モディファイアのベンチマーク（旧方式 vs ParticleSpan）
+    if (ImGui::Button("Run Modifier Benchmark"))
+    {
+        ParticleBenchmark::RunModifierSuite();
+    }
 
-void ParticleSystem::ClearParticles(const std::string& _groupName)
-{
-    auto it = particles_.find(_groupName);
-    if (it != particles_.end())
-        it->second.particles.clear();
+    // インスタンス行列生成のベンチマーク（行列積 vs 展開）
+    if (ImGui::Button("Run InstanceBuild Benchmark"))
+    {
+        ParticleBenchmark::RunInstanceBuildSuite();
+    }
+
+    // 発生時の乱数生成のベンチマーク（RandomGenerator vs RandomStream）
+    if (ImGui::Button("Run Random Benchmark"))
+    {
+        ParticleBenchmark::RunRandomSuite();
+    }
+
+    // 固定ステップで2つのフレームレートの結果が一致するか（再生中のパーティクルは消える）
+    ImGui::InputText("Effect", fixedStepCheckEffectName_, sizeof(fixedStepCheckEffectName_));
+    if (ImGui::Button("Check Fixed Step Determinism"))
+    {
+        ParticleBenchmark::RunFixedStepSuite(fixedStepCheckEffectName_);
+    }
+
+    ImGui::PopID();
+
+    ImGui::End();
+#endif // _DEBUG
 }
 
 void ParticleSystem::CreateModifier(const std::string& _name)
@@ -324,4 +557,25 @@ void ParticleSystem::CreateModifier(const std::string& _name)
     }
 }
 
+void ParticleSystem::EmitParticle(ParticleGroup& _group, const Particle& _particle)
+{
+    // ビルボードの設定はグループの先頭のものを使う
+    if (_group.pool.IsEmpty())
+        _group.billboard = _particle.GetBillboard();
+
+    _group.pool.Emit(_particle);
+}
+
+PSOFlags ParticleSystem::ResolvePSO(const ParticleRenderSettings& _settings)
+{
+    PSOFlags psoFlags = _settings.GetPSOFlags();
+    psoFlags = psoFlags | PSOFlags::Type::Particle | PSOFlags::DepthMode::Comb_mZero_fLessEqual;
+
+    // PSOFlagsが未登録の場合は登録する
+    if (!psoMap_.contains(psoFlags))
+        psoMap_[psoFlags] = PSOManager::GetInstance()->GetPipeLineStateObject(psoFlags).value();
+
+    return psoFlags;
+}
+
 } // namespace Engine
@@ -1,6 +1,8 @@
 #pragma once
 #include <Features/Model/Model.h>
 #include <Features/Effect/Particle/Particle.h>
+#include <Features/Effect/Particle/ParticlePool.h>
+#include <Features/Effect/Particle/ParticleInstanceBuilder.h>
 #include <Features/Effect/Modifier/ParticleModifier.h>
 #include <Features/Effect/Modifier/IPaticleMoifierFactory.h>
 #include <System/Time/GameTime.h>
@@ -8,9 +10,14 @@
 #include <Features/Camera/Camera/Camera.h>
 
 #include <map>
+#include <array>
 #include <list>
 #include <string>
 #include <memory>
+#include <functional>
+#include <vector>
+#include <span>
+#include <unordered_map>
 
 
 #include <d3d12.h>
@@ -58,6 +65,17 @@ struct ParticleRenderSettings
     }
 };
 
+/// <summary>
+/// パーティクルグループを指すハンドル
+/// ParticleSystem::ResolveGroupで取得し、発生のたびに名前で検索しないようにする
+/// ClearParticles()で全グループを破棄すると無効になる
+/// </summary>
+struct ParticleGroupHandle
+{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
 class SRVManager;
 class ParticleSystem
 {
@@ -77,12 +95,62 @@ public:
     void AddParticle(const std::string& _groupName,const std::string& _useModelName,std::unique_ptr<Particle> _particle, ParticleRenderSettings _settings, uint32_t _textureHandle, std::vector<std::string> _modifiers);
     void AddParticles(const std::string& _groupName,const std::string& _useModelName, std::vector<std::unique_ptr<Particle>> _particles, ParticleRenderSettings _settings, uint32_t _textureHandle, std::vector<std::string> _modifiers);
 
+    /// <summary>
+    /// グループのハンドルを取得する 無ければ作成する
+    /// 既にある場合はモデル・描画設定・テクスチャを置き換え、モディファイアを追加する
+    /// 名前の検索やPSOの解決はここで行うので、毎回呼ばずにハンドルを保持して使うこと
+    /// </summary>
+    ParticleGroupHandle ResolveGroup(const std::string& _groupName, const std::string& _useModelName, ParticleRenderSettings _settings, uint32_t _textureHandle, const std::vector<std::string>& _modifiers);
+
+    // ハンドルが今あるグループを指しているか
+    bool IsValidGroup(ParticleGroupHandle _handle) const;
+
+    /// <summary>
+    /// グループの空きに初期値を直接書き込んで発生させる
+    /// 上限を超えた分は発生させない
+    /// </summary>
+    /// <returns>発生させた数</returns>
+    uint32_t Emit(ParticleGroupHandle _handle, std::span<const ParticleInitParam> _params);
+
+    // グループが使う時間チャンネルを設定する（既定は"default"） 固定ステップで更新する場合に使う
+    void SetTimeChannel(ParticleGroupHandle _handle, const std::string& _channel);
+
+    /// <summary>
+    /// 固定ステップでの更新を設定する
+    /// 有効な場合はUpdateの_deltaTimeを使わず、グループの時間チャンネルの経過時間を_stepずつ進める
+    /// 1フレームで進めるのはチャンネル毎に_maxStepsPerFrame回までで、それ以上の遅れは切り捨てる
+    /// 描画する位置と回転は直前のステップとの間を補間する
+    /// </summary>
+    void SetFixedTimeStep(bool _enable, float _step = 1.0f / 60.0f, uint32_t _maxStepsPerFrame = 4);
+    bool IsFixedTimeStep() const { return useFixedTimeStep_; }
+    float GetFixedTimeStep() const { return fixedTimeStep_; }
+    uint32_t GetMaxStepsPerFrame() const { return maxStepsPerFrame_; }
+
+    /// <summary>
+    /// 固定ステップの更新中に、_channelのステップ毎に呼ぶ処理を登録する
+    /// エミッターの発生をステップと交互に行い、フレームレートによらず同じ結果にするために使う
+    /// 固定ステップが無効の間は呼ばない
+    /// </summary>
+    /// <param name="_channel">時間チャンネル</param>
+    /// <param name="_callback">void(float _deltaTime) _deltaTimeは固定ステップの長さ</param>
+    /// <returns>解除に使うID 0は無効</returns>
+    using FixedStepCallback = std::function<void(float)>;
+    uint32_t RegisterFixedStepCallback(const std::string& _channel, FixedStepCallback _callback);
+    // 登録を解除する 呼び出し中の処理から解除してもよい
+    void UnregisterFixedStepCallback(uint32_t _id);
+
+    // グループのパーティクルを取得する 無ければnullptr
+    const ParticlePool* FindGroupPool(const std::string& _groupName) const;
+
 
     void ClearParticles();
     void ClearParticles(const std::string& _groupName);
 
     void SetCamera(Camera* _camera) { camera_ = _camera; }
 
+    // デバッグUI
+    void ImGui(bool* _open);
+
 private:
 
     // モディファイアをファクトリから生成する
@@ -112,27 +180,97 @@ private:
         }
     };
 
-    struct ParticleForGPU
-    {
-        Matrix4x4 worldMatrix;
-        Vector4 color;
-    };
-
     struct ParticleGroup
     {
+        std::string name;
         ParticleKey key;
         Model* model = nullptr;
-        std::list <std::unique_ptr<Particle>> particles;
+        ParticlePool pool;                              // 生存中のパーティクル（SoA）
+        std::array<bool, 3> billboard = {};             // グループ共通のビルボード設定
         uint32_t srvIndex = 0;
         uint32_t instanceCount = 0;
         PSOFlags psoIndex = {};
         uint32_t textureHandle = 0;
+        uint32_t timeChannelIndex = 0;                  // timeChannels_の添え字
         std::map<std::string, uint32_t> useModifierName;
         Microsoft::WRL::ComPtr<ID3D12Resource> instanceBuffer;
         ParticleForGPU* mappedInstanceBuffer = nullptr;
+
+        // 更新中だけ使う（メインスレッドで求めてからジョブに渡す）
+        Matrix4x4 billboardMatrix = {};
+        std::vector<ParticleModifier*> modifiers;
+        bool isSerial = false;                          // スレッドセーフでないモディファイアがあり、分割せずに処理するか
+        bool isInterpolated = false;                    // 前回のステップとの間を補間して描画するか
+        float interpolation = 1.0f;
+    };
+
+    // 固定ステップで更新する時間チャンネル毎の状態
+    struct TimeChannelClock
+    {
+        std::string name;
+        double accumulator = 0.0;       // まだ進めていない時間
+        uint32_t stepCount = 0;         // このフレームで進めるステップ数
+        float interpolation = 1.0f;     // 描画時の補間係数
     };
 
-    std::unordered_map<std::string, ParticleGroup> particles_;
+    // 固定ステップ毎に呼ぶ処理
+    struct FixedStepListener
+    {
+        uint32_t id = 0;
+        uint32_t timeChannelIndex = 0;
+        FixedStepCallback callback;     // 解除されたものは空にして、呼び出しの外で消す
+    };
+
+    // グループの一部の範囲を処理するジョブ
+    struct ParticleTask
+    {
+        ParticleGroup* group = nullptr;
+        uint32_t begin = 0;
+        uint32_t end = 0;
+    };
+
+    // パーティクルをグループのプールに追加する 上限を超えた分は追加しない
+    static void EmitParticle(ParticleGroup& _group, const Particle& _particle);
+
+    // 描画設定からPSOを求める 未登録なら登録する
+    PSOFlags ResolvePSO(const ParticleRenderSettings& _settings);
+
+    // [_begin, _end)にモディファイアを適用して移動させる _savePreviousなら先に補間用に保存する
+    static void SimulateRange(ParticleGroup& _group, uint32_t _begin, uint32_t _end, float _deltaTime, bool _savePrevious);
+
+    // [_begin, _end)をインスタンスバッファに書き込む
+    static void WriteInstances(ParticleGroup& _group, uint32_t _begin, uint32_t _end);
+
+    // モディファイアとビルボード行列を求め、更新対象のグループを集める
+    void PrepareGroups();
+
+    // _groupsを_deltaTimeだけ進め、寿命が尽きたものを削除する
+    // スレッドセーフでないモディファイアを使うグループは、分割せずにメインスレッドで順に進める
+    void StepGroups(const std::vector<ParticleGroup*>& _groups, float _deltaTime, bool _savePrevious);
+
+    // 時間チャンネル毎に今回進めるステップ数と補間係数を求める
+    void AdvanceTimeChannels();
+
+    // _step番目のステップを進めるチャンネルに登録された処理を呼ぶ
+    void DispatchFixedStep(uint32_t _step);
+
+    // 時間チャンネルの添え字を取得する 無ければ追加する
+    uint32_t FindOrAddTimeChannel(const std::string& _name);
+
+    // _groupsをkParticleChunkSize毎に区切ったジョブを作る
+    void BuildTasks(const std::vector<ParticleGroup*>& _groups);
+
+    // _count個の処理を並列（無効なら順番）に実行する
+    void RunParallel(uint32_t _count, const std::function<void(uint32_t, uint32_t)>& _func);
+
+    // 1ジョブで処理するパーティクル数 SIMDで4要素ずつ処理するため4の倍数にする
+    static constexpr uint32_t kParticleChunkSize = 1024;
+
+    // グループはハンドルの添え字で参照する 名前からの検索はgroupIndices_で行う
+    std::vector<ParticleGroup> groups_;
+    std::unordered_map<std::string, uint32_t> groupIndices_;
+    // ClearParticles()で全グループを破棄するたびに進め、古いハンドルを無効にする
+    uint32_t generation_ = 0;
 
     std::map<PSOFlags, ID3D12PipelineState*> psoMap_;
     ID3D12RootSignature* rootSignature_;
@@ -145,6 +283,29 @@ private:
 
     std::map<std::string, std::unique_ptr<ParticleModifier>> modifierNames_;
 
+    // 更新対象のグループとジョブ（毎フレーム使い回す）
+    std::vector<ParticleGroup*> activeGroups_;
+    std::vector<ParticleGroup*> steppingGroups_;
+    std::vector<ParticleGroup*> parallelGroups_;    // StepGroupsで分割して並列に処理するもの
+    std::vector<ParticleTask> tasks_;
+
+    // === 固定ステップ ===
+    bool useFixedTimeStep_ = false;
+    float fixedTimeStep_ = 1.0f / 60.0f;
+    uint32_t maxStepsPerFrame_ = 4;
+    std::vector<TimeChannelClock> timeChannels_;
+    // 呼び出し中に登録・解除されても要素が動かないようにlistで持つ
+    std::list<FixedStepListener> fixedStepListeners_;
+    uint32_t nextFixedStepListenerId_ = 1;
+
+    // グループの更新をJobSystemで並列に行うか
+    // チャンクの区切りはパーティクル数だけで決まるため、どちらでも結果は同じになる
+    bool enableParallelUpdate_ = true;
+
+#ifdef _DEBUG
+    char fixedStepCheckEffectName_[128] = {};
+#endif // _DEBUG
+
 
 };
 
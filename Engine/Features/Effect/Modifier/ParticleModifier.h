@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Features/Effect/Particle/Particle.h>
+#include <Features/Effect/Particle/ParticlePool.h>
 
 
 namespace Engine {
@@ -13,14 +14,33 @@ public:
 
     virtual void Initialize() {};
 
-    virtual void Apply(Particle* _particle, float _deltaTime) = 0;
-    virtual void Apply(std::list<Particle*> _particles, float _deltaTime) {
-        for (auto& particle : _particles)
+    // 1つのパーティクルに適用する
+    virtual void Apply([[maybe_unused]] Particle* _particle, [[maybe_unused]] float _deltaTime) {};
+
+    /// <summary>
+    /// グループの連続した範囲にまとめて適用する
+    /// 既定では1つずつParticleに読み出してApply(Particle*)を呼び、書き戻す
+    /// 属性の配列を直接処理するようにオーバーライドすること
+    /// IsThreadSafeがtrueなら、大きなグループは分割され別々のスレッドから同時に呼ばれる
+    /// falseならグループ全体を1つの範囲として、メインスレッドで順に呼ばれる
+    /// </summary>
+    virtual void Apply(const ParticleSpan& _particles, float _deltaTime) {
+        Particle particle;
+        for (uint32_t index = 0; index < _particles.count; ++index)
         {
-            Apply(particle, _deltaTime);
+            _particles.Load(index, particle);
+            Apply(&particle, _deltaTime);
+            _particles.Store(index, particle);
         }
     }
 
+    /// <summary>
+    /// 別々のスレッドから同時にApplyを呼んでよいか
+    /// 各パーティクルの結果を範囲内の要素だけで決め、モディファイア自身の状態を書き換えない場合にtrueを返すようオーバーライドする
+    /// 既定ではApply内で状態を持つモディファイアのためにfalse
+    /// </summary>
+    virtual bool IsThreadSafe() const { return false; }
+
 private:
 
 
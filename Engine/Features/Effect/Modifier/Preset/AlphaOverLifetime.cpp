@@ -1,27 +1,27 @@
 #include "AlphaOverLifetime.h"
 
+#include <algorithm>
+
 
 namespace Engine {
 
 Easing::EasingFunc AlphaOverLifetime::easingType_ = Easing::EasingFunc::EaseOutExpo;
 
-void AlphaOverLifetime::Apply(Particle* _particle, [[maybe_unused]] float _deltaTime)
+void AlphaOverLifetime::Apply(const ParticleSpan& _particles, [[maybe_unused]] float _deltaTime)
 {
-    if (_particle == nullptr)
-        return;
-
-    // アルファ値を時間に応じて変化させる
-    float alpha = 1.0f - (_particle->GetCurrentTime() / _particle->GetLifeTime());
-
-    // イージング関数を適用
-    alpha = Easing::Func(easingType_)(alpha);
+    // イージング関数は全パーティクル共通なので1回だけ取得する
+    auto easing = Easing::Func(easingType_);
 
-    alpha = std::clamp(alpha, 0.0f, 1.0f);
+    for (uint32_t index = 0; index < _particles.count; ++index)
+    {
+        // アルファ値を時間に応じて変化させる
+        float alpha = 1.0f - (_particles.currentTime[index] / _particles.lifeTime[index]);
 
-    Vector4 color = _particle->GetColor();
-    color.w = alpha;
+        // イージング関数を適用
+        alpha = easing(alpha);
 
-    _particle->SetColor(color);
+        _particles.color.w[index] = std::clamp(alpha, 0.0f, 1.0f);
+    }
 }
 
 } // namespace Engine
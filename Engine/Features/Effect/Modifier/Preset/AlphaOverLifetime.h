@@ -14,9 +14,12 @@ public:
     AlphaOverLifetime() = default;
     ~AlphaOverLifetime() = default;
 
-    void Apply(Particle* _particle, [[maybe_unused]] float _deltaTime) override;
+    void Apply(const ParticleSpan& _particles, [[maybe_unused]] float _deltaTime) override;
+
+    bool IsThreadSafe() const override { return true; }
 
     static void SetEasingType(Easing::EasingFunc _easingType) { easingType_ = _easingType; }
+    static Easing::EasingFunc GetEasingType() { return easingType_; }
 
 private:
 
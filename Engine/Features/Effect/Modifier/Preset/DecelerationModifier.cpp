@@ -5,14 +5,15 @@ namespace Engine {
 
 float DecelerationModifier::deceleration_ = 2.0f; // 初期値
 
-void DecelerationModifier::Apply(Particle* _particle, float _deltaTime)
+void DecelerationModifier::Apply(const ParticleSpan& _particles, float _deltaTime)
 {
-    if (_particle == nullptr)
-        return;
     // 減速率を適用
-    float speed = _particle->GetSpeed();
-    speed *= (1.0f - deceleration_ * _deltaTime);
-    _particle->SetSpeed(speed);
+    float rate = 1.0f - deceleration_ * _deltaTime;
+
+    for (float& speed : _particles.speed)
+    {
+        speed *= rate;
+    }
 }
 
 } // namespace Engine
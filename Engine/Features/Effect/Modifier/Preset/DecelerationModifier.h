@@ -11,9 +11,12 @@ public:
     DecelerationModifier() = default;
     ~DecelerationModifier() override = default;
 
-    void Apply(Particle* _particle, float _deltaTime) override;
+    void Apply(const ParticleSpan& _particles, float _deltaTime) override;
+
+    bool IsThreadSafe() const override { return true; }
 
     static void SetDeceleration(float _deceleration) { deceleration_ = _deceleration; }
+    static float GetDeceleration() { return deceleration_; }
 
 private:
 
@@ -1,23 +1,30 @@
 #include "RotationBasedMovementModifier.h"
 
-#include <Math/Vector/VectorFunction.h>
+#include <cmath>
 
 
 namespace Engine {
 
-void RotationBasedMovementModifier::Apply(Particle* particle, [[maybe_unused]] float deltaTime)
+void RotationBasedMovementModifier::Apply(const ParticleSpan& _particles, [[maybe_unused]] float _deltaTime)
 {
-
-    if (!particle) return;
-
-    Vector3 rotation = particle->GetRotation();
-
-    Vector3 upVector = Vector3(0, 1, 0);// 上方向
-
-    Vector3 rotVector = Transform(upVector, MakeRotateMatrix(rotation));
-
-    particle->SetDirection(rotVector.Normalize());
-
+    for (uint32_t index = 0; index < _particles.count; ++index)
+    {
+        float sinX = std::sin(_particles.rotation.x[index]);
+        float cosX = std::cos(_particles.rotation.x[index]);
+        float sinY = std::sin(_particles.rotation.y[index]);
+        float cosY = std::cos(_particles.rotation.y[index]);
+        float sinZ = std::sin(_particles.rotation.z[index]);
+        float cosZ = std::cos(_particles.rotation.z[index]);
+
+        // 上方向(0,1,0)をMakeRotateMatrix(rotation)で変換した結果
+        // 回転行列の2行目だけを展開して求める
+        Vector3 rotVector(
+            cosX * -sinZ + sinX * (sinY * cosZ),
+            cosX * cosZ + sinX * (sinY * sinZ),
+            sinX * cosY);
+
+        _particles.direction.Set(index, rotVector.Normalize());
+    }
 }
 
 } // namespace Engine
@@ -12,7 +12,9 @@ public:
     RotationBasedMovementModifier() = default;
     ~RotationBasedMovementModifier() override = default;
 
-    void Apply(Particle* particle, float deltaTime) override;
+    void Apply(const ParticleSpan& _particles, [[maybe_unused]] float _deltaTime) override;
+
+    bool IsThreadSafe() const override { return true; }
 
 };
 
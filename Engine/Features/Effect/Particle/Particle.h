@@ -27,6 +27,7 @@ public:
 
 
     float GetCurrentTime() const { return currentTime_; }
+    void SetCurrentTime(float _currentTime) { currentTime_ = _currentTime; }
 
     Vector3 GetPosition() const { return translate_; }
     void SetPosition(const Vector3& _pos) { translate_ = _pos; }
@@ -34,6 +35,9 @@ public:
     Vector3 GetRotation() const { return rotation_; }
     void SetRotation(const Vector3& _rot) { rotation_ = _rot; }
 
+    Vector3 GetRotationSpeed() const { return rotationSpeed_; }
+    void SetRotationSpeed(const Vector3& _rotationSpeed) { rotationSpeed_ = _rotationSpeed; }
+
     Vector3 GetScale() const { return scale_; }
     void SetScale(const Vector3& _scale) { scale_ = _scale; }
 
@@ -0,0 +1,209 @@
+#include "ParticleInstanceBuilder.h"
+
+#include <immintrin.h>
+#include <cmath>
+
+
+namespace Engine {
+
+namespace {
+
+constexpr uint32_t kLaneCount = 4;
+
+inline __m128 Load(const std::vector<float>& _lanes, uint32_t _index)
+{
+    return _mm_loadu_ps(_lanes.data() + _index);
+}
+
+inline __m128 Negate(__m128 _v)
+{
+    return _mm_xor_ps(_v, _mm_set1_ps(-0.0f));
+}
+
+// _previous + (_current - _previous) * _alpha
+inline __m128 Interpolate(__m128 _previous, __m128 _current, __m128 _alpha)
+{
+    return _mm_add_ps(_previous, _mm_mul_ps(_mm_sub_ps(_current, _previous), _alpha));
+}
+
+inline float Interpolate(float _previous, float _current, float _alpha)
+{
+    return _previous + (_current - _previous) * _alpha;
+}
+
+inline Vector3 Interpolate(const Vector3& _previous, const Vector3& _current, float _alpha)
+{
+    return Vector3(Interpolate(_previous.x, _current.x, _alpha), Interpolate(_previous.y, _current.y, _alpha), Interpolate(_previous.z, _current.z, _alpha));
+}
+
+// (_x * _b0 + _y * _b1) + _z * _b2
+inline __m128 Dot3(__m128 _x, __m128 _y, __m128 _z, float _b0, float _b1, float _b2)
+{
+    __m128 result = _mm_add_ps(_mm_mul_ps(_x, _mm_set1_ps(_b0)), _mm_mul_ps(_y, _mm_set1_ps(_b1)));
+    return _mm_add_ps(result, _mm_mul_ps(_z, _mm_set1_ps(_b2)));
+}
+
+} // namespace
+
+void ParticleInstanceBuilder::Build(const Vector3& _scale, const Vector3& _rotation, const Vector3& _translate, const Vector4& _color,
+    const Matrix4x4& _billboardMatrix, ParticleForGPU& _out)
+{
+    float sinX = std::sin(_rotation.x);
+    float cosX = std::cos(_rotation.x);
+    float sinY = std::sin(_rotation.y);
+    float cosY = std::cos(_rotation.y);
+    float sinZ = std::sin(_rotation.z);
+    float cosZ = std::cos(_rotation.z);
+
+    // MakeRotateMatrix = X * (Y * Z)
+    float rotate[3][3] = {
+        { cosY * cosZ, cosY * sinZ, -sinY },
+        { cosX * -sinZ + sinX * (sinY * cosZ), cosX * cosZ + sinX * (sinY * sinZ), sinX * cosY },
+        { -sinX * -sinZ + cosX * (sinY * cosZ), -sinX * cosZ + cosX * (sinY * sinZ), cosX * cosY },
+    };
+
+    const float scale[3] = { _scale.x, _scale.y, _scale.z };
+    const auto& billboard = _billboardMatrix.m;
+
+    for (int32_t row = 0; row < 3; ++row)
+    {
+        // スケールをかけた回転の行 * ビルボード行列
+        float x = scale[row] * rotate[row][0];
+        float y = scale[row] * rotate[row][1];
+        float z = scale[row] * rotate[row][2];
+
+        for (int32_t column = 0; column < 3; ++column)
+        {
+            _out.worldMatrix.m[row][column] = x * billboard[0][column] + y * billboard[1][column] + z * billboard[2][column];
+        }
+        _out.worldMatrix.m[row][3] = 0.0f;
+    }
+
+    _out.worldMatrix.m[3][0] = _translate.x;
+    _out.worldMatrix.m[3][1] = _translate.y;
+    _out.worldMatrix.m[3][2] = _translate.z;
+    _out.worldMatrix.m[3][3] = 1.0f;
+
+    _out.color = _color;
+}
+
+void ParticleInstanceBuilder::BuildRange(const ParticlePool& _pool, const Matrix4x4& _billboardMatrix, uint32_t _begin, uint32_t _end, ParticleForGPU* _out)
+{
+    BuildRangeImpl<false>(_pool, _billboardMatrix, 1.0f, _begin, _end, _out);
+}
+
+void ParticleInstanceBuilder::BuildRangeInterpolated(const ParticlePool& _pool, const Matrix4x4& _billboardMatrix, float _alpha, uint32_t _begin, uint32_t _end, ParticleForGPU* _out)
+{
+    BuildRangeImpl<true>(_pool, _billboardMatrix, _alpha, _begin, _end, _out);
+}
+
+template<bool kInterpolate>
+void ParticleInstanceBuilder::BuildRangeImpl(const ParticlePool& _pool, const Matrix4x4& _billboardMatrix, float _alpha, uint32_t _begin, uint32_t _end, ParticleForGPU* _out)
+{
+    const ParticlePool::Lanes3& position = _pool.GetPosition();
+    const ParticlePool::Lanes3& rotation = _pool.GetRotation();
+    const ParticlePool::Lanes3& previousPosition = _pool.GetPreviousPosition();
+    const ParticlePool::Lanes3& previousRotation = _pool.GetPreviousRotation();
+    const ParticlePool::Lanes3& scale = _pool.GetScale();
+    const ParticlePool::Lanes4& color = _pool.GetColor();
+    const auto& billboard = _billboardMatrix.m;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 alpha = _mm_set1_ps(_alpha);
+
+    uint32_t index = _begin;
+    for (; index + kLaneCount <= _end; index += kLaneCount)
+    {
+        // 三角関数はスカラー版と同じ結果にするため1つずつ求める
+        alignas(16) float sinX[kLaneCount], cosX[kLaneCount];
+        alignas(16) float sinY[kLaneCount], cosY[kLaneCount];
+        alignas(16) float sinZ[kLaneCount], cosZ[kLaneCount];
+        for (uint32_t lane = 0; lane < kLaneCount; ++lane)
+        {
+            Vector3 rotate = rotation.Get(index + lane);
+            if constexpr (kInterpolate)
+                rotate = Interpolate(previousRotation.Get(index + lane), rotate, _alpha);
+
+            sinX[lane] = std::sin(rotate.x);
+            cosX[lane] = std::cos(rotate.x);
+            sinY[lane] = std::sin(rotate.y);
+            cosY[lane] = std::cos(rotate.y);
+            sinZ[lane] = std::sin(rotate.z);
+            cosZ[lane] = std::cos(rotate.z);
+        }
+
+        __m128 sx = _mm_load_ps(sinX), cx = _mm_load_ps(cosX);
+        __m128 sy = _mm_load_ps(sinY), cy = _mm_load_ps(cosY);
+        __m128 sz = _mm_load_ps(sinZ), cz = _mm_load_ps(cosZ);
+
+        __m128 sycz = _mm_mul_ps(sy, cz);
+        __m128 sysz = _mm_mul_ps(sy, sz);
+
+        // 回転行列の各行
+        __m128 rotate[3][3] = {
+            { _mm_mul_ps(cy, cz), _mm_mul_ps(cy, sz), Negate(sy) },
+            { _mm_add_ps(_mm_mul_ps(cx, Negate(sz)), _mm_mul_ps(sx, sycz)), _mm_add_ps(_mm_mul_ps(cx, cz), _mm_mul_ps(sx, sysz)), _mm_mul_ps(sx, cy) },
+            { _mm_add_ps(_mm_mul_ps(Negate(sx), Negate(sz)), _mm_mul_ps(cx, sycz)), _mm_add_ps(_mm_mul_ps(Negate(sx), cz), _mm_mul_ps(cx, sysz)), _mm_mul_ps(cx, cy) },
+        };
+
+        const __m128 scales[3] = { Load(scale.x, index), Load(scale.y, index), Load(scale.z, index) };
+
+        // 行毎に4つ分を求め、転置してインスタンス毎の行にする
+        __m128 rows[4][kLaneCount];
+        for (int32_t row = 0; row < 3; ++row)
+        {
+            __m128 x = _mm_mul_ps(scales[row], rotate[row][0]);
+            __m128 y = _mm_mul_ps(scales[row], rotate[row][1]);
+            __m128 z = _mm_mul_ps(scales[row], rotate[row][2]);
+
+            __m128 m0 = Dot3(x, y, z, billboard[0][0], billboard[1][0], billboard[2][0]);
+            __m128 m1 = Dot3(x, y, z, billboard[0][1], billboard[1][1], billboard[2][1]);
+            __m128 m2 = Dot3(x, y, z, billboard[0][2], billboard[1][2], billboard[2][2]);
+            __m128 m3 = zero;
+            _MM_TRANSPOSE4_PS(m0, m1, m2, m3);
+            rows[row][0] = m0; rows[row][1] = m1; rows[row][2] = m2; rows[row][3] = m3;
+        }
+
+        __m128 tx = Load(position.x, index), ty = Load(position.y, index), tz = Load(position.z, index), tw = one;
+        if constexpr (kInterpolate)
+        {
+            tx = Interpolate(Load(previousPosition.x, index), tx, alpha);
+            ty = Interpolate(Load(previousPosition.y, index), ty, alpha);
+            tz = Interpolate(Load(previousPosition.z, index), tz, alpha);
+        }
+        _MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+        rows[3][0] = tx; rows[3][1] = ty; rows[3][2] = tz; rows[3][3] = tw;
+
+        __m128 cr = Load(color.x, index), cg = Load(color.y, index), cb = Load(color.z, index), ca = Load(color.w, index);
+        _MM_TRANSPOSE4_PS(cr, cg, cb, ca);
+        const __m128 colors[kLaneCount] = { cr, cg, cb, ca };
+
+        // インスタンス毎に先頭から順に書き込む
+        for (uint32_t lane = 0; lane < kLaneCount; ++lane)
+        {
+            ParticleForGPU& out = _out[index + lane];
+            _mm_storeu_ps(out.worldMatrix.m[0], rows[0][lane]);
+            _mm_storeu_ps(out.worldMatrix.m[1], rows[1][lane]);
+            _mm_storeu_ps(out.worldMatrix.m[2], rows[2][lane]);
+            _mm_storeu_ps(out.worldMatrix.m[3], rows[3][lane]);
+            _mm_storeu_ps(&out.color.x, colors[lane]);
+        }
+    }
+
+    // 端数
+    for (; index < _end; ++index)
+    {
+        Vector3 rotate = rotation.Get(index);
+        Vector3 translate = position.Get(index);
+        if constexpr (kInterpolate)
+        {
+            rotate = Interpolate(previousRotation.Get(index), rotate, _alpha);
+            translate = Interpolate(previousPosition.Get(index), translate, _alpha);
+        }
+
+        Build(scale.Get(index), rotate, translate, color.Get(index), _billboardMatrix, _out[index]);
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Features/Effect/Particle/ParticlePool.h>
+#include <Math/Vector/Vector3.h>
+#include <Math/Vector/Vector4.h>
+#include <Math/Matrix/Matrix4x4.h>
+
+#include <cstdint>
+
+
+namespace Engine {
+
+// インスタンスバッファ1要素分（シェーダーの構造体と同じ並び）
+struct ParticleForGPU
+{
+    Matrix4x4 worldMatrix;
+    Vector4 color;
+};
+
+/// <summary>
+/// パーティクルのインスタンス行列を作る
+/// MakeScaleMatrix * MakeRotateMatrix * ビルボード行列 * MakeTranslateMatrix を
+/// 値が0になる要素を省いて展開したもの
+/// 演算の順序は行列の積と揃えてあるので、結果は積で求めた場合と同じになる
+/// </summary>
+class ParticleInstanceBuilder
+{
+public:
+    /// <summary>
+    /// 1つ分のインスタンスを作る
+    /// </summary>
+    /// <param name="_billboardMatrix">グループ共通のビルボード行列（回転のみ）</param>
+    static void Build(const Vector3& _scale, const Vector3& _rotation, const Vector3& _translate, const Vector4& _color,
+        const Matrix4x4& _billboardMatrix, ParticleForGPU& _out);
+
+    /// <summary>
+    /// プールの[_begin, _end)のインスタンスを4つずつSSEで作り、_out[_begin]から書き込む
+    /// </summary>
+    static void BuildRange(const ParticlePool& _pool, const Matrix4x4& _billboardMatrix, uint32_t _begin, uint32_t _end, ParticleForGPU* _out);
+
+    /// <summary>
+    /// BuildRangeと同じだが、位置と回転は保存した前回の値との間を補間する
+    /// </summary>
+    /// <param name="_alpha">0で前回の値、1で現在の値</param>
+    static void BuildRangeInterpolated(const ParticlePool& _pool, const Matrix4x4& _billboardMatrix, float _alpha, uint32_t _begin, uint32_t _end, ParticleForGPU* _out);
+
+private:
+    template<bool kInterpolate>
+    static void BuildRangeImpl(const ParticlePool& _pool, const Matrix4x4& _billboardMatrix, float _alpha, uint32_t _begin, uint32_t _end, ParticleForGPU* _out);
+};
+
+} // namespace Engine
@@ -0,0 +1,330 @@
+#include "ParticlePool.h"
+
+#include <immintrin.h>
+#include <algorithm>
+#include <limits>
+
+
+namespace Engine {
+
+namespace {
+
+constexpr uint32_t kLaneCount = 4;
+
+// 4の倍数に切り上げる
+uint32_t AlignLaneCount(uint32_t _count)
+{
+    return (_count + kLaneCount - 1) / kLaneCount * kLaneCount;
+}
+
+float CalculateKillTime(float _lifeTime, bool _isInfiniteLife)
+{
+    return _isInfiniteLife ? std::numeric_limits<float>::infinity() : _lifeTime;
+}
+
+// _value += _speed * _deltaTime
+inline void Advance(float* _value, const float* _speed, __m128 _deltaTime)
+{
+    __m128 value = _mm_loadu_ps(_value);
+    __m128 speed = _mm_loadu_ps(_speed);
+    _mm_storeu_ps(_value, _mm_add_ps(value, _mm_mul_ps(speed, _deltaTime)));
+}
+
+// _position += (_direction * _speed + _acceleration * _deltaTime) * _deltaTime
+// Particle::Updateと同じ順序で計算する
+inline void Move(float* _position, const float* _direction, const float* _acceleration, __m128 _speed, __m128 _deltaTime)
+{
+    __m128 velocity = _mm_mul_ps(_mm_loadu_ps(_direction), _speed);
+    velocity = _mm_add_ps(velocity, _mm_mul_ps(_mm_loadu_ps(_acceleration), _deltaTime));
+
+    __m128 position = _mm_loadu_ps(_position);
+    _mm_storeu_ps(_position, _mm_add_ps(position, _mm_mul_ps(velocity, _deltaTime)));
+}
+
+} // namespace
+
+void ParticleSpan::Load(uint32_t _index, Particle& _particle) const
+{
+    _particle.SetPosition(position.Get(_index));
+    _particle.SetDirection(direction.Get(_index));
+    _particle.SetAcceleration(acceleration.Get(_index));
+    _particle.SetRotation(rotation.Get(_index));
+    _particle.SetRotationSpeed(rotationSpeed.Get(_index));
+    _particle.SetScale(scale.Get(_index));
+    _particle.SetColor(color.Get(_index));
+    _particle.SetSpeed(speed[_index]);
+    _particle.SetCurrentTime(currentTime[_index]);
+    _particle.SetLifeTime(lifeTime[_index]);
+}
+
+void ParticleSpan::Store(uint32_t _index, const Particle& _particle) const
+{
+    position.Set(_index, _particle.GetPosition());
+    direction.Set(_index, _particle.GetDirection().Normalize());
+    acceleration.Set(_index, _particle.GetAcceleration());
+    rotation.Set(_index, _particle.GetRotation());
+    rotationSpeed.Set(_index, _particle.GetRotationSpeed());
+    scale.Set(_index, _particle.GetScale());
+    color.Set(_index, _particle.GetColor());
+    speed[_index] = _particle.GetSpeed();
+}
+
+void ParticlePool::Initialize(uint32_t _capacity)
+{
+    count_ = 0;
+    capacity_ = _capacity;
+
+    // SIMDで4要素ずつ読み書きできるように確保しておく
+    uint32_t size = AlignLaneCount(_capacity);
+
+    Resize(position_, size);
+    Resize(direction_, size);
+    Resize(acceleration_, size);
+    Resize(rotation_, size);
+    Resize(rotationSpeed_, size);
+    Resize(scale_, size);
+    Resize(color_, size);
+    Resize(previousPosition_, size);
+    Resize(previousRotation_, size);
+    speed_.assign(size, 0.0f);
+    currentTime_.assign(size, 0.0f);
+    lifeTime_.assign(size, 0.0f);
+    killTime_.assign(size, 0.0f);
+    isInfiniteLife_.assign(size, 0);
+}
+
+bool ParticlePool::Emit(const ParticleInitParam& _param)
+{
+    uint32_t index = 0;
+    if (!Allocate(index))
+        return false;
+
+    Write(index, _param);
+    return true;
+}
+
+bool ParticlePool::Emit(const Particle& _particle)
+{
+    uint32_t index = 0;
+    if (!Allocate(index))
+        return false;
+
+    Store(index, _particle);
+    previousPosition_.Set(index, position_.Get(index));
+    previousRotation_.Set(index, rotation_.Get(index));
+    return true;
+}
+
+uint32_t ParticlePool::Emit(std::span<const ParticleInitParam> _params)
+{
+    uint32_t count = std::min(static_cast<uint32_t>(_params.size()), capacity_ - count_);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Write(count_ + i, _params[i]);
+    }
+    count_ += count;
+
+    return count;
+}
+
+void ParticlePool::Update(float _deltaTime)
+{
+    Integrate(_deltaTime);
+    RemoveExpired();
+}
+
+void ParticlePool::Integrate(float _deltaTime, uint32_t _begin, uint32_t _end)
+{
+    __m128 deltaTime = _mm_set1_ps(_deltaTime);
+
+    // 確保した領域は4の倍数なので、末尾の無効な要素もまとめて計算してしまう
+    uint32_t end = AlignLaneCount(_end);
+    for (uint32_t index = _begin; index < end; index += kLaneCount)
+    {
+        __m128 currentTime = _mm_loadu_ps(&currentTime_[index]);
+        _mm_storeu_ps(&currentTime_[index], _mm_add_ps(currentTime, deltaTime));
+
+        __m128 speed = _mm_loadu_ps(&speed_[index]);
+
+        Move(&position_.x[index], &direction_.x[index], &acceleration_.x[index], speed, deltaTime);
+        Move(&position_.y[index], &direction_.y[index], &acceleration_.y[index], speed, deltaTime);
+        Move(&position_.z[index], &direction_.z[index], &acceleration_.z[index], speed, deltaTime);
+
+        Advance(&rotation_.x[index], &rotationSpeed_.x[index], deltaTime);
+        Advance(&rotation_.y[index], &rotationSpeed_.y[index], deltaTime);
+        Advance(&rotation_.z[index], &rotationSpeed_.z[index], deltaTime);
+    }
+}
+
+void ParticlePool::RemoveExpired()
+{
+    uint32_t index = 0;
+    while (index < count_)
+    {
+        // 4要素とも生きていればまとめて飛ばす
+        if (index + kLaneCount <= count_)
+        {
+            __m128 currentTime = _mm_loadu_ps(&currentTime_[index]);
+            __m128 killTime = _mm_loadu_ps(&killTime_[index]);
+            if (_mm_movemask_ps(_mm_cmpge_ps(currentTime, killTime)) == 0)
+            {
+                index += kLaneCount;
+                continue;
+            }
+        }
+
+        // 末尾と入れ替えた要素も判定するため、削除した場合は進めない
+        if (currentTime_[index] >= killTime_[index])
+            SwapRemove(index);
+        else
+            ++index;
+    }
+}
+
+void ParticlePool::SwapRemove(uint32_t _index)
+{
+    uint32_t last = --count_;
+    if (_index == last)
+        return;
+
+    position_.Set(_index, position_.Get(last));
+    direction_.Set(_index, direction_.Get(last));
+    acceleration_.Set(_index, acceleration_.Get(last));
+    rotation_.Set(_index, rotation_.Get(last));
+    rotationSpeed_.Set(_index, rotationSpeed_.Get(last));
+    scale_.Set(_index, scale_.Get(last));
+    color_.Set(_index, color_.Get(last));
+    speed_[_index] = speed_[last];
+    currentTime_[_index] = currentTime_[last];
+    lifeTime_[_index] = lifeTime_[last];
+    killTime_[_index] = killTime_[last];
+    isInfiniteLife_[_index] = isInfiniteLife_[last];
+    previousPosition_.Set(_index, previousPosition_.Get(last));
+    previousRotation_.Set(_index, previousRotation_.Get(last));
+}
+
+void ParticlePool::SavePrevious(uint32_t _begin, uint32_t _end)
+{
+    std::copy(position_.x.begin() + _begin, position_.x.begin() + _end, previousPosition_.x.begin() + _begin);
+    std::copy(position_.y.begin() + _begin, position_.y.begin() + _end, previousPosition_.y.begin() + _begin);
+    std::copy(position_.z.begin() + _begin, position_.z.begin() + _end, previousPosition_.z.begin() + _begin);
+    std::copy(rotation_.x.begin() + _begin, rotation_.x.begin() + _end, previousRotation_.x.begin() + _begin);
+    std::copy(rotation_.y.begin() + _begin, rotation_.y.begin() + _end, previousRotation_.y.begin() + _begin);
+    std::copy(rotation_.z.begin() + _begin, rotation_.z.begin() + _end, previousRotation_.z.begin() + _begin);
+}
+
+void ParticlePool::Load(uint32_t _index, Particle& _particle) const
+{
+    _particle.SetPosition(position_.Get(_index));
+    _particle.SetDirection(direction_.Get(_index));
+    _particle.SetAcceleration(acceleration_.Get(_index));
+    _particle.SetRotation(rotation_.Get(_index));
+    _particle.SetRotationSpeed(rotationSpeed_.Get(_index));
+    _particle.SetScale(scale_.Get(_index));
+    _particle.SetColor(color_.Get(_index));
+    _particle.SetSpeed(speed_[_index]);
+    _particle.SetCurrentTime(currentTime_[_index]);
+    _particle.SetLifeTime(lifeTime_[_index]);
+    _particle.SetInfiniteLife(isInfiniteLife_[_index] != 0);
+}
+
+void ParticlePool::Store(uint32_t _index, const Particle& _particle)
+{
+    position_.Set(_index, _particle.GetPosition());
+    // Particle::Updateは毎回正規化しているので、ここで正規化しておく
+    direction_.Set(_index, _particle.GetDirection().Normalize());
+    acceleration_.Set(_index, _particle.GetAcceleration());
+    rotation_.Set(_index, _particle.GetRotation());
+    rotationSpeed_.Set(_index, _particle.GetRotationSpeed());
+    scale_.Set(_index, _particle.GetScale());
+    color_.Set(_index, _particle.GetColor());
+    speed_[_index] = _particle.GetSpeed();
+    currentTime_[_index] = _particle.GetCurrentTime();
+    SetLifeTime(_index, _particle.GetLifeTime(), _particle.IsInfiniteLife());
+}
+
+ParticleSpan ParticlePool::GetSpan(uint32_t _begin, uint32_t _count)
+{
+    ParticleSpan span;
+    span.count = _count;
+    span.position = MakeSpan(position_, _begin, _count);
+    span.direction = MakeSpan(direction_, _begin, _count);
+    span.acceleration = MakeSpan(acceleration_, _begin, _count);
+    span.rotation = MakeSpan(rotation_, _begin, _count);
+    span.rotationSpeed = MakeSpan(rotationSpeed_, _begin, _count);
+    span.scale = MakeSpan(scale_, _begin, _count);
+    span.color = MakeSpan(color_, _begin, _count);
+    span.speed = std::span<float>(speed_.data() + _begin, _count);
+    span.currentTime = std::span<const float>(currentTime_.data() + _begin, _count);
+    span.lifeTime = std::span<const float>(lifeTime_.data() + _begin, _count);
+    return span;
+}
+
+void ParticlePool::SetLifeTime(uint32_t _index, float _lifeTime, bool _isInfiniteLife)
+{
+    lifeTime_[_index] = _lifeTime;
+    isInfiniteLife_[_index] = _isInfiniteLife ? 1 : 0;
+    killTime_[_index] = CalculateKillTime(_lifeTime, _isInfiniteLife);
+}
+
+bool ParticlePool::Allocate(uint32_t& _index)
+{
+    if (count_ >= capacity_)
+        return false;
+
+    _index = count_++;
+    return true;
+}
+
+void ParticlePool::Write(uint32_t _index, const ParticleInitParam& _param)
+{
+    position_.Set(_index, _param.position);
+    direction_.Set(_index, Vector3(_param.direction).Normalize());
+    acceleration_.Set(_index, _param.acceleration);
+    rotation_.Set(_index, _param.rotate);
+    rotationSpeed_.Set(_index, _param.rotationSpeed);
+    scale_.Set(_index, _param.size);
+    color_.Set(_index, _param.color);
+    speed_[_index] = _param.speed;
+    currentTime_[_index] = 0.0f;
+    SetLifeTime(_index, _param.lifeTime, _param.isInfiniteLife);
+    previousPosition_.Set(_index, _param.position);
+    previousRotation_.Set(_index, _param.rotate);
+}
+
+void ParticlePool::Resize(Lanes3& _lanes, uint32_t _size)
+{
+    _lanes.x.assign(_size, 0.0f);
+    _lanes.y.assign(_size, 0.0f);
+    _lanes.z.assign(_size, 0.0f);
+}
+
+void ParticlePool::Resize(Lanes4& _lanes, uint32_t _size)
+{
+    _lanes.x.assign(_size, 0.0f);
+    _lanes.y.assign(_size, 0.0f);
+    _lanes.z.assign(_size, 0.0f);
+    _lanes.w.assign(_size, 0.0f);
+}
+
+ParticleSpan::Lanes3 ParticlePool::MakeSpan(Lanes3& _lanes, uint32_t _begin, uint32_t _count)
+{
+    ParticleSpan::Lanes3 span;
+    span.x = std::span<float>(_lanes.x.data() + _begin, _count);
+    span.y = std::span<float>(_lanes.y.data() + _begin, _count);
+    span.z = std::span<float>(_lanes.z.data() + _begin, _count);
+    return span;
+}
+
+ParticleSpan::Lanes4 ParticlePool::MakeSpan(Lanes4& _lanes, uint32_t _begin, uint32_t _count)
+{
+    ParticleSpan::Lanes4 span;
+    span.x = std::span<float>(_lanes.x.data() + _begin, _count);
+    span.y = std::span<float>(_lanes.y.data() + _begin, _count);
+    span.z = std::span<float>(_lanes.z.data() + _begin, _count);
+    span.w = std::span<float>(_lanes.w.data() + _begin, _count);
+    return span;
+}
+
+} // namespace Engine
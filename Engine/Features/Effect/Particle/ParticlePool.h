@@ -0,0 +1,211 @@
+#pragma once
+
+#include <Features/Effect/Particle/Particle.h>
+#include <Math/Vector/Vector3.h>
+#include <Math/Vector/Vector4.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#ifdef GetCurrentTime
+#undef GetCurrentTime
+#endif
+
+namespace Engine {
+
+/// <summary>
+/// ParticlePoolの連続した範囲の属性を参照するビュー
+/// モディファイアはこれを受け取り、グループのパーティクルをまとめて処理する
+/// 寿命と経過時間は読み取り専用
+/// </summary>
+struct ParticleSpan
+{
+    struct Lanes3
+    {
+        std::span<float> x, y, z;
+
+        Vector3 Get(uint32_t _index) const { return Vector3(x[_index], y[_index], z[_index]); }
+        void Set(uint32_t _index, const Vector3& _v) const { x[_index] = _v.x; y[_index] = _v.y; z[_index] = _v.z; }
+    };
+
+    struct Lanes4
+    {
+        std::span<float> x, y, z, w;
+
+        Vector4 Get(uint32_t _index) const { return Vector4(x[_index], y[_index], z[_index], w[_index]); }
+        void Set(uint32_t _index, const Vector4& _v) const { x[_index] = _v.x; y[_index] = _v.y; z[_index] = _v.z; w[_index] = _v.w; }
+    };
+
+    uint32_t count = 0;
+
+    Lanes3 position;
+    Lanes3 direction;       // 正規化済み
+    Lanes3 acceleration;
+    Lanes3 rotation;
+    Lanes3 rotationSpeed;
+    Lanes3 scale;
+    Lanes4 color;
+    std::span<float> speed;
+    std::span<const float> currentTime;
+    std::span<const float> lifeTime;
+
+    // _index番目の状態をParticleに読み出す
+    void Load(uint32_t _index, Particle& _particle) const;
+    // Particleから書き戻す（寿命と経過時間は書き戻さない）
+    void Store(uint32_t _index, const Particle& _particle) const;
+};
+
+/// <summary>
+/// パーティクルグループの属性を要素毎の配列(SoA)で持つプール
+/// 生存しているパーティクルは常に[0, GetCount())に詰めて並べ、死んだものは末尾と入れ替えて削除する
+/// そのため削除すると並び順が変わる
+/// </summary>
+class ParticlePool
+{
+public:
+    // 3要素の属性
+    struct Lanes3
+    {
+        std::vector<float> x, y, z;
+
+        Vector3 Get(uint32_t _index) const { return Vector3(x[_index], y[_index], z[_index]); }
+        void Set(uint32_t _index, const Vector3& _v) { x[_index] = _v.x; y[_index] = _v.y; z[_index] = _v.z; }
+    };
+
+    // 4要素の属性
+    struct Lanes4
+    {
+        std::vector<float> x, y, z, w;
+
+        Vector4 Get(uint32_t _index) const { return Vector4(x[_index], y[_index], z[_index], w[_index]); }
+        void Set(uint32_t _index, const Vector4& _v) { x[_index] = _v.x; y[_index] = _v.y; z[_index] = _v.z; w[_index] = _v.w; }
+    };
+
+public:
+    ParticlePool() = default;
+    ~ParticlePool() = default;
+
+    // 最大数を指定して領域を確保する
+    void Initialize(uint32_t _capacity);
+
+    // パーティクルを追加する 空きがなければfalse
+    bool Emit(const ParticleInitParam& _param);
+
+    // Particleの状態をそのまま追加する 空きがなければfalse
+    bool Emit(const Particle& _particle);
+
+    /// <summary>
+    /// まとめて空きの先頭から書き込む 空きが足りない分は追加しない
+    /// </summary>
+    /// <returns>追加した数</returns>
+    uint32_t Emit(std::span<const ParticleInitParam> _params);
+
+    /// <summary>
+    /// 経過時間を進めて移動・回転を積分し、寿命が尽きたものを削除する
+    /// </summary>
+    void Update(float _deltaTime);
+
+    // 経過時間・位置・回転を進める（寿命の判定はしない）
+    void Integrate(float _deltaTime) { Integrate(_deltaTime, 0, count_); }
+
+    /// <summary>
+    /// [_begin, _end)の経過時間・位置・回転を進める
+    /// 4要素ずつ処理するため、_beginは4の倍数にすること
+    /// 範囲が重ならなければ別々のスレッドから呼んでもよい
+    /// </summary>
+    void Integrate(float _deltaTime, uint32_t _begin, uint32_t _end);
+
+    // 寿命が尽きたものを末尾と入れ替えて削除する
+    void RemoveExpired();
+
+    // [_begin, _end)の位置と回転を補間用に保存する 固定ステップで進める前に呼ぶ
+    void SavePrevious(uint32_t _begin, uint32_t _end);
+
+    // _index番目を末尾と入れ替えて削除する
+    void SwapRemove(uint32_t _index);
+
+    // 全て削除する
+    void Clear() { count_ = 0; }
+
+    // _index番目の状態をParticleに読み出す / Particleから書き戻す
+    void Load(uint32_t _index, Particle& _particle) const;
+    void Store(uint32_t _index, const Particle& _particle);
+
+    // [_begin, _begin + _count)を参照するビューを取得する
+    ParticleSpan GetSpan(uint32_t _begin, uint32_t _count);
+    // 生存している全パーティクルを参照するビューを取得する
+    ParticleSpan GetSpan() { return GetSpan(0, count_); }
+
+    uint32_t GetCount() const { return count_; }
+    uint32_t GetCapacity() const { return capacity_; }
+    bool IsEmpty() const { return count_ == 0; }
+
+    // === 属性 [0, GetCount())が有効 ===
+    Lanes3& GetPosition() { return position_; }
+    Lanes3& GetDirection() { return direction_; }       // 正規化済み
+    Lanes3& GetAcceleration() { return acceleration_; }
+    Lanes3& GetRotation() { return rotation_; }
+    Lanes3& GetRotationSpeed() { return rotationSpeed_; }
+    Lanes3& GetScale() { return scale_; }
+    Lanes4& GetColor() { return color_; }
+    std::vector<float>& GetSpeed() { return speed_; }
+    std::vector<float>& GetCurrentTime() { return currentTime_; }
+
+    const Lanes3& GetPosition() const { return position_; }
+    const Lanes3& GetDirection() const { return direction_; }
+    const Lanes3& GetAcceleration() const { return acceleration_; }
+    const Lanes3& GetRotation() const { return rotation_; }
+    const Lanes3& GetRotationSpeed() const { return rotationSpeed_; }
+    const Lanes3& GetScale() const { return scale_; }
+    const Lanes4& GetColor() const { return color_; }
+    const std::vector<float>& GetSpeed() const { return speed_; }
+    const std::vector<float>& GetCurrentTime() const { return currentTime_; }
+    const std::vector<float>& GetLifeTime() const { return lifeTime_; }
+
+    // SavePreviousで保存した位置と回転（発生直後は現在の値と同じ）
+    const Lanes3& GetPreviousPosition() const { return previousPosition_; }
+    const Lanes3& GetPreviousRotation() const { return previousRotation_; }
+
+    // 寿命が無限かどうか
+    bool IsInfiniteLife(uint32_t _index) const { return isInfiniteLife_[_index] != 0; }
+
+    // 寿命を設定する（削除する時間も更新するため、寿命は直接書き換えずにこちらを使う）
+    void SetLifeTime(uint32_t _index, float _lifeTime, bool _isInfiniteLife);
+
+private:
+    // 空きの先頭に書き込む領域を確保する
+    bool Allocate(uint32_t& _index);
+
+    // _index番目に初期値を書き込む
+    void Write(uint32_t _index, const ParticleInitParam& _param);
+
+    static void Resize(Lanes3& _lanes, uint32_t _size);
+    static void Resize(Lanes4& _lanes, uint32_t _size);
+
+    static ParticleSpan::Lanes3 MakeSpan(Lanes3& _lanes, uint32_t _begin, uint32_t _count);
+    static ParticleSpan::Lanes4 MakeSpan(Lanes4& _lanes, uint32_t _begin, uint32_t _count);
+
+private:
+    uint32_t count_ = 0;
+    uint32_t capacity_ = 0;
+
+    Lanes3 position_;
+    Lanes3 direction_;
+    Lanes3 acceleration_;
+    Lanes3 rotation_;
+    Lanes3 rotationSpeed_;
+    Lanes3 scale_;
+    Lanes4 color_;
+    std::vector<float> speed_;
+    std::vector<float> currentTime_;
+    std::vector<float> lifeTime_;
+    std::vector<float> killTime_;           // この時間を超えたら削除（寿命が無限の場合は無限大）
+    std::vector<uint8_t> isInfiniteLife_;
+
+    // 描画時の補間用
+    Lanes3 previousPosition_;
+    Lanes3 previousRotation_;
+};
+
+} // namespace Engine
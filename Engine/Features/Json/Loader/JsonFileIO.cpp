@@ -1,4 +1,5 @@
 #include <Features/Json/Loader/JsonFileIO.h>
+#include <Features/Json/Pack/ParameterPack.h>
 #include <Utility/StringUtils/StringUitls.h>
 #include <Debug/Debug.h>
 
@@ -25,6 +26,11 @@ json JsonFileIO::Load(const std::string& _filepath, const std::string& _director
     if (StringUtils::GetExtension(filepath).empty())
         filepath += ".json";
 
+    // パックを開いていればパックから読む
+    json packed;
+    if (ParameterPack::GetInstance()->Load(filepath, packed))
+        return packed;
+
     Debug::Log("JsonFileIO::Load filepath: " + filepath + "\n");
 
     std::ifstream inputFile(filepath);
@@ -0,0 +1,417 @@
+#include "ParameterPack.h"
+
+#include <Debug/Debug.h>
+#include <Debug/ImGuiDebugManager.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+
+namespace Engine {
+
+ParameterPack* ParameterPack::GetInstance()
+{
+    static ParameterPack instance;
+    return &instance;
+}
+
+ParameterPack::~ParameterPack()
+{
+    Close();
+}
+
+void ParameterPack::Initialize(const std::string& _packPath)
+{
+    packPath_ = _packPath;
+
+    // リリースビルドでもパックを作れるように起動引数で受け付ける
+    if (IsBuildRequested())
+        Build(kDefaultSourceDirectory, packPath_, &lastReport_);
+
+#ifdef _DEBUG
+    // デバッグビルドでは編集中のJSONを読む
+    ImGuiDebugManager::GetInstance()->RegisterMenuItem("ParameterPack", [this](bool* _open) { ImGui(_open); });
+#else
+    // パックが無ければJSONから読む
+    Open(packPath_);
+#endif // _DEBUG
+}
+
+void ParameterPack::Finalize()
+{
+    Close();
+}
+
+bool ParameterPack::Open(const std::string& _packPath)
+{
+    Close();
+
+    file_ = CreateFileA(_packPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        Debug::Log("ParameterPack::Open not found: " + _packPath + "\n");
+        return false;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header)))
+    {
+        Debug::Log("ParameterPack::Open invalid file: " + _packPath + "\n");
+        Close();
+        return false;
+    }
+
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_)
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+
+    if (!data_)
+    {
+        Debug::Log("ParameterPack::Open cant map: " + _packPath + "\n");
+        Close();
+        return false;
+    }
+
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+
+    if (!Validate())
+    {
+        Debug::Log("ParameterPack::Open invalid file: " + _packPath + "\n");
+        Close();
+        return false;
+    }
+
+    const Header* header = reinterpret_cast<const Header*>(data_);
+    entries_ = reinterpret_cast<const IndexEntry*>(data_ + header->indexOffset);
+    entryCount_ = header->entryCount;
+    packPath_ = _packPath;
+
+    Debug::Log(std::format("ParameterPack::Open {} ({} files)\n", _packPath, entryCount_));
+    return true;
+}
+
+void ParameterPack::Close()
+{
+    if (data_)
+        UnmapViewOfFile(data_);
+    if (mapping_)
+        CloseHandle(mapping_);
+    if (file_ != INVALID_HANDLE_VALUE)
+        CloseHandle(file_);
+
+    file_ = INVALID_HANDLE_VALUE;
+    mapping_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    entries_ = nullptr;
+    entryCount_ = 0;
+}
+
+bool ParameterPack::Load(const std::string& _filepath, json& _out) const
+{
+    const IndexEntry* entry = Find(_filepath);
+    if (!entry)
+        return false;
+
+    // 実行中やパックを作った後に保存されたJSONはJSONから読ませる
+    if (IsStale(*entry, _filepath))
+        return false;
+
+    // 壊れたデータは見つからなかったものとしてJSONから読ませる
+    json data = json::from_msgpack(data_ + entry->dataOffset, data_ + entry->dataOffset + entry->dataSize, true, false);
+    if (data.is_discarded())
+        return false;
+
+    _out = std::move(data);
+    return true;
+}
+
+bool ParameterPack::Contains(const std::string& _filepath) const
+{
+    return Find(_filepath) != nullptr;
+}
+
+std::string ParameterPack::NormalizeKey(const std::string& _filepath)
+{
+    std::string key;
+    key.reserve(_filepath.size());
+
+    for (char c : _filepath)
+    {
+        if (c == '\\')
+            c = '/';
+
+        // 区切りが続く場合は1つにする
+        if (c == '/' && !key.empty() && key.back() == '/')
+            continue;
+
+        key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+
+    while (key.starts_with("./"))
+        key.erase(0, 2);
+
+    return key;
+}
+
+bool ParameterPack::Build(const std::string& _directory, const std::string& _outputPath, ParameterPackBuildReport* _report)
+{
+    namespace fs = std::filesystem;
+
+    ParameterPackBuildReport report = {};
+
+    struct Source
+    {
+        std::string key;
+        uint64_t hash;
+        int64_t writeTime;
+        std::vector<uint8_t> data;
+    };
+    std::vector<Source> sources;
+
+    std::error_code error;
+    for (fs::recursive_directory_iterator it(_directory, error), end; !error && it != end; it.increment(error))
+    {
+        if (!it->is_regular_file() || it->path().extension() != ".json")
+            continue;
+
+        std::ifstream inputFile(it->path());
+        json data = json::parse(inputFile, nullptr, false);
+        if (data.is_discarded())
+        {
+            Debug::Log("ParameterPack::Build cant parse: " + it->path().generic_string() + "\n");
+            ++report.failedCount;
+            continue;
+        }
+
+        Source source;
+        source.key = NormalizeKey(it->path().generic_string());
+        source.hash = HashKey(source.key);
+        source.writeTime = static_cast<int64_t>(it->last_write_time().time_since_epoch().count());
+        source.data = json::to_msgpack(data);
+        sources.push_back(std::move(source));
+
+        report.jsonBytes += static_cast<size_t>(it->file_size());
+    }
+
+    if (error)
+    {
+        Debug::Log("ParameterPack::Build cant read directory: " + _directory + "\n");
+        return false;
+    }
+
+    std::sort(sources.begin(), sources.end(), [](const Source& _a, const Source& _b)
+        {
+            return _a.hash != _b.hash ? _a.hash < _b.hash : _a.key < _b.key;
+        });
+
+    // ヘッダ、索引、キー、データの順に並べる データは8byteにそろえる
+    auto align = [](uint64_t _offset) { return (_offset + 7) & ~uint64_t(7); };
+
+    std::vector<IndexEntry> entries(sources.size());
+    uint64_t offset = sizeof(Header) + sizeof(IndexEntry) * entries.size();
+    for (size_t index = 0; index < sources.size(); ++index)
+    {
+        entries[index] = {};
+        entries[index].keyHash = sources[index].hash;
+        entries[index].keyOffset = offset;
+        entries[index].keyLength = static_cast<uint32_t>(sources[index].key.size());
+        entries[index].sourceWriteTime = sources[index].writeTime;
+        offset += sources[index].key.size();
+    }
+    for (size_t index = 0; index < sources.size(); ++index)
+    {
+        offset = align(offset);
+        entries[index].dataOffset = offset;
+        entries[index].dataSize = sources[index].data.size();
+        offset += sources[index].data.size();
+    }
+
+    Header header = {};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.indexOffset = sizeof(Header);
+    header.fileSize = offset;
+
+    fs::path outputPath(_outputPath);
+    if (outputPath.has_parent_path())
+        fs::create_directories(outputPath.parent_path(), error);
+
+    std::ofstream outputFile(_outputPath, std::ios::binary | std::ios::trunc);
+    if (!outputFile.is_open())
+    {
+        Debug::Log("ParameterPack::Build cant open: " + _outputPath + "\n");
+        return false;
+    }
+
+    outputFile.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    outputFile.write(reinterpret_cast<const char*>(entries.data()), sizeof(IndexEntry) * entries.size());
+
+    uint64_t written = sizeof(Header) + sizeof(IndexEntry) * entries.size();
+    for (const Source& source : sources)
+    {
+        outputFile.write(source.key.data(), source.key.size());
+        written += source.key.size();
+    }
+
+    const char padding[8] = {};
+    for (size_t index = 0; index < sources.size(); ++index)
+    {
+        outputFile.write(padding, entries[index].dataOffset - written);
+        outputFile.write(reinterpret_cast<const char*>(sources[index].data.data()), sources[index].data.size());
+        written = entries[index].dataOffset + entries[index].dataSize;
+    }
+    outputFile.close();
+
+    if (!outputFile)
+    {
+        Debug::Log("ParameterPack::Build cant write: " + _outputPath + "\n");
+        return false;
+    }
+
+    report.fileCount = header.entryCount;
+    report.packBytes = static_cast<size_t>(header.fileSize);
+    if (_report)
+        *_report = report;
+
+    Debug::Log(std::format("ParameterPack::Build {} files ({} failed) {} -> {} bytes: {}\n",
+        report.fileCount, report.failedCount, report.jsonBytes, report.packBytes, _outputPath));
+    return true;
+}
+
+void ParameterPack::ImGui([[maybe_unused]] bool* _open)
+{
+#ifdef _DEBUG
+    ImGui::Begin("ParameterPack", _open);
+
+    ImGui::Text("Pack: %s", packPath_.c_str());
+    ImGui::Text("State: %s (%u files)", IsOpen() ? "open" : "closed", entryCount_);
+
+    // 編集したJSONからパックを作り直す
+    if (ImGui::Button("Build Parameter Pack"))
+    {
+        bool wasOpen = IsOpen();
+        Close();
+        Build(kDefaultSourceDirectory, packPath_, &lastReport_);
+        if (wasOpen)
+            Open(packPath_);
+    }
+    ImGui::Text("Last Build: %u files (%u failed) %zu -> %zu bytes",
+        lastReport_.fileCount, lastReport_.failedCount, lastReport_.jsonBytes, lastReport_.packBytes);
+
+    // パックとJSONの読み込み時間を比べる
+    if (ImGui::Button("Open Pack"))
+        Open(packPath_);
+    ImGui::SameLine();
+    if (ImGui::Button("Close Pack"))
+        Close();
+
+    if (IsOpen() && ImGui::Button("Compare Load Time"))
+    {
+        double packMs = 0.0;
+        double jsonMs = 0.0;
+        for (uint32_t index = 0; index < entryCount_; ++index)
+        {
+            const IndexEntry& entry = entries_[index];
+            std::string key(reinterpret_cast<const char*>(data_ + entry.keyOffset), entry.keyLength);
+
+            json data;
+            auto start = std::chrono::high_resolution_clock::now();
+            Load(key, data);
+            auto middle = std::chrono::high_resolution_clock::now();
+            std::ifstream inputFile(key);
+            data = json::parse(inputFile, nullptr, false);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            packMs += std::chrono::duration<double, std::milli>(middle - start).count();
+            jsonMs += std::chrono::duration<double, std::milli>(end - middle).count();
+        }
+        Debug::Log(std::format("[ParameterPack] {} files pack: {:.3f} ms json: {:.3f} ms\n", entryCount_, packMs, jsonMs));
+    }
+
+    ImGui::End();
+#endif // _DEBUG
+}
+
+uint64_t ParameterPack::HashKey(const std::string& _key)
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : _key)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool ParameterPack::IsStale(const IndexEntry& _entry, const std::string& _filepath)
+{
+    std::error_code error;
+    std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(_filepath, error);
+    if (error)
+        return false;
+
+    return static_cast<int64_t>(writeTime.time_since_epoch().count()) != _entry.sourceWriteTime;
+}
+
+bool ParameterPack::IsBuildRequested()
+{
+    std::wstring_view commandLine = GetCommandLineW();
+    return commandLine.find(kBuildOption) != std::wstring_view::npos;
+}
+
+const ParameterPack::IndexEntry* ParameterPack::Find(const std::string& _filepath) const
+{
+    if (!IsOpen() || entryCount_ == 0)
+        return nullptr;
+
+    std::string key = NormalizeKey(_filepath);
+    uint64_t hash = HashKey(key);
+
+    const IndexEntry* begin = entries_;
+    const IndexEntry* end = entries_ + entryCount_;
+    const IndexEntry* it = std::lower_bound(begin, end, hash, [](const IndexEntry& _entry, uint64_t _hash) { return _entry.keyHash < _hash; });
+
+    // ハッシュが同じものはキーで見分ける
+    for (; it != end && it->keyHash == hash; ++it)
+    {
+        std::string_view entryKey(reinterpret_cast<const char*>(data_ + it->keyOffset), it->keyLength);
+        if (entryKey == key)
+            return it;
+    }
+    return nullptr;
+}
+
+bool ParameterPack::Validate() const
+{
+    const Header* header = reinterpret_cast<const Header*>(data_);
+    if (header->magic != kMagic || header->version != kVersion || header->fileSize != size_)
+        return false;
+
+    if (header->indexOffset % alignof(IndexEntry) != 0 || header->indexOffset > size_ ||
+        header->entryCount > (size_ - header->indexOffset) / sizeof(IndexEntry))
+        return false;
+
+    const IndexEntry* entries = reinterpret_cast<const IndexEntry*>(data_ + header->indexOffset);
+    for (uint32_t index = 0; index < header->entryCount; ++index)
+    {
+        const IndexEntry& entry = entries[index];
+        if (entry.keyOffset > size_ || entry.keyLength > size_ - entry.keyOffset)
+            return false;
+        if (entry.dataOffset > size_ || entry.dataSize > size_ - entry.dataOffset)
+            return false;
+        if (index > 0 && entries[index - 1].keyHash > entry.keyHash)
+            return false;
+    }
+    return true;
+}
+
+} // namespace Engine
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <Features/Json/Loader/JsonFileIO.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <windows.h>
+
+
+namespace Engine {
+
+// パックを作ったときの結果
+struct ParameterPackBuildReport
+{
+    uint32_t fileCount = 0;         // パックにまとめたファイル数
+    uint32_t failedCount = 0;       // 読み込めなかったファイル数
+    size_t jsonBytes = 0;           // 元のJSONファイルの合計サイズ
+    size_t packBytes = 0;           // パックのサイズ
+};
+
+/// <summary>
+/// JSONのパラメーターファイルをまとめたバイナリのパック
+/// 各ファイルをMessagePackにしたものと、パスのハッシュで並べた索引を1つのファイルに持つ
+/// ファイルはメモリにマップして使い、読み込むときは索引を二分探索するだけで全体は解析しない
+/// 編集はJSONで行い、パックはJSONのディレクトリから作る
+/// リリースビルドではパックを開き、JsonFileIO::Loadはパックにあるファイルをパックから読む
+/// 索引には元のJSONの更新日時を持ち、JSONがパックを作った後に保存されていればJSONを読ませる
+/// 起動引数にkBuildOptionを付けるとビルドの構成に関係なくパックを作り直してから開く
+/// </summary>
+class ParameterPack
+{
+public:
+    static constexpr const char* kDefaultPackPath = "Resources/ParameterPack.bin";
+    static constexpr const char* kDefaultSourceDirectory = "Resources/";
+    static constexpr const wchar_t* kBuildOption = L"--build-parameter-pack";
+
+    static ParameterPack* GetInstance();
+
+    /// <summary>
+    /// リリースビルドではパックを開く デバッグビルドではパックを作るメニューを登録する
+    /// 起動引数にkBuildOptionがあれば先にパックを作る
+    /// </summary>
+    /// <param name="_packPath">パックのパス</param>
+    void Initialize(const std::string& _packPath = kDefaultPackPath);
+    void Finalize();
+
+    bool Open(const std::string& _packPath);
+    void Close();
+    bool IsOpen() const { return data_ != nullptr; }
+
+    /// <summary>
+    /// パックからJSONを読み込む
+    /// </summary>
+    /// <param name="_filepath">JSONファイルのパス JsonFileIO::Loadと同じもの</param>
+    /// <param name="_out">読み込んだJSONの書き込み先</param>
+    /// <returns>パックにあり、元のJSONがパックを作った後に変わっていないか</returns>
+    bool Load(const std::string& _filepath, json& _out) const;
+    bool Contains(const std::string& _filepath) const;
+
+    uint32_t GetEntryCount() const { return entryCount_; }
+
+    // 索引のキー 区切りを'/'に、英字を小文字にそろえる
+    static std::string NormalizeKey(const std::string& _filepath);
+
+    /// <summary>
+    /// ディレクトリ以下のJSONファイルをすべてパックにまとめる
+    /// </summary>
+    /// <param name="_directory">JSONファイルを探すディレクトリ キーはこのパスを含む</param>
+    /// <param name="_outputPath">パックの書き込み先</param>
+    /// <param name="_report">結果の書き込み先 不要ならnullptr</param>
+    /// <returns>書き込めたか</returns>
+    static bool Build(const std::string& _directory, const std::string& _outputPath, ParameterPackBuildReport* _report = nullptr);
+
+    void ImGui(bool* _open);
+
+private:
+    static constexpr uint32_t kMagic = 0x4B505050;  // "PPPK"
+    static constexpr uint32_t kVersion = 2;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t indexOffset;       // IndexEntryの配列の位置
+        uint64_t fileSize;
+    };
+
+    // keyHash、キーの順に並べる
+    struct IndexEntry
+    {
+        uint64_t keyHash;
+        uint64_t keyOffset;
+        uint32_t keyLength;
+        uint32_t reserved;
+        uint64_t dataOffset;        // MessagePackの位置
+        uint64_t dataSize;
+        int64_t sourceWriteTime;    // 元のJSONの更新日時 (file_time_typeのカウント)
+    };
+
+    static uint64_t HashKey(const std::string& _key);
+
+    // キーの項目を探す 無ければnullptr
+    const IndexEntry* Find(const std::string& _filepath) const;
+
+    // 元のJSONがパックを作った後に保存されたか JSONが無い場合はパックを使う
+    static bool IsStale(const IndexEntry& _entry, const std::string& _filepath);
+
+    // 起動引数でパックを作るよう指定されたか
+    static bool IsBuildRequested();
+
+    // 開いたファイルの範囲に収まっているか調べる
+    bool Validate() const;
+
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+
+    const IndexEntry* entries_ = nullptr;
+    uint32_t entryCount_ = 0;
+
+    std::string packPath_ = kDefaultPackPath;
+    ParameterPackBuildReport lastReport_ = {};
+
+private:
+    ParameterPack() = default;
+    ~ParameterPack();
+
+public:
+    ParameterPack(const ParameterPack&) = delete;
+    ParameterPack& operator=(const ParameterPack&) = delete;
+    ParameterPack(ParameterPack&&) = delete;
+    ParameterPack& operator=(ParameterPack&&) = delete;
+};
+
+} // namespace Engine
@@ -0,0 +1,495 @@
+#include "AnimationBenchmark.h"
+
+#include <Features/Model/Animation/ModelAnimation.h>
+#include <Features/Model/Animation/Joint/Joint.h>
+#include <Features/Model/Animation/Node/Node.h>
+#include <Features/Model/Animation/SkinningCPU.h>
+#include <System/Job/JobSystem.h>
+#include <Math/Matrix/MatrixFunction.h>
+#include <Math/Random/RandomStream.h>
+#include <Math/MyLib.h>
+#include <Debug/Debug.h>
+
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace Engine {
+
+namespace {
+
+constexpr float kDeltaTime = 1.0f / 60.0f;
+constexpr float kClipDuration = 1.0f;
+constexpr uint32_t kKeyframeCount = 31;
+
+// 旧方式の比較用 補間方法を文字列で持つ
+struct LegacyNodeAnimation
+{
+    ModelAnimation::AnimationCurve<Vector3> translate;
+    ModelAnimation::AnimationCurve<Quaternion> rotation;
+    ModelAnimation::AnimationCurve<Vector3> scale;
+    std::string interpolation;
+};
+
+// 旧ModelAnimation::CalculateValue_Linearと同じく、先頭から区間を探す
+template <typename T, typename Interpolate>
+T CalculateValueLegacy_Linear(const ModelAnimation::AnimationCurve<T>& _curve, float _time, Interpolate _interpolate)
+{
+    if (_curve.keyframes.size() == 1 || _time <= _curve.keyframes[0].time)
+    {
+        return _curve.keyframes[0].value;
+    }
+
+    for (size_t index = 0; index < _curve.keyframes.size() - 1; ++index)
+    {
+        size_t nextIndex = index + 1;
+        if (_curve.keyframes[index].time <= _time && _time <= _curve.keyframes[nextIndex].time)
+        {
+            float t = (_time - _curve.keyframes[index].time) / (_curve.keyframes[nextIndex].time - _curve.keyframes[index].time);
+            return _interpolate(_curve.keyframes[index].value, _curve.keyframes[nextIndex].value, t);
+        }
+    }
+
+    return (*_curve.keyframes.rbegin()).value;
+}
+
+// 旧ModelAnimation::CalculateValue_Stepと同じく、末尾から探す
+template <typename T>
+T CalculateValueLegacy_Step(const ModelAnimation::AnimationCurve<T>& _curve, float _time)
+{
+    if (_curve.keyframes.size() == 1 || _time <= _curve.keyframes[0].time)
+    {
+        return _curve.keyframes[0].value;
+    }
+
+    int32_t index = static_cast<int32_t>(_curve.keyframes.size() - 1);
+    for (; index >= 0; index--)
+    {
+        if (_time >= _curve.keyframes[index].time)
+        {
+            return _curve.keyframes[index].value;
+        }
+    }
+
+    return (*_curve.keyframes.rbegin()).value;
+}
+
+QuaternionTransform EvaluateLegacy_Linear(const LegacyNodeAnimation& _nodeAnimation, float _time)
+{
+    QuaternionTransform transform = {};
+    transform.translate = CalculateValueLegacy_Linear(_nodeAnimation.translate, _time, [](const Vector3& _a, const Vector3& _b, float _t) { return Lerp(_a, _b, _t); });
+    transform.rotation = CalculateValueLegacy_Linear(_nodeAnimation.rotation, _time, [](const Quaternion& _a, const Quaternion& _b, float _t) { return Slerp(_a, _b, _t); });
+    transform.scale = CalculateValueLegacy_Linear(_nodeAnimation.scale, _time, [](const Vector3& _a, const Vector3& _b, float _t) { return Lerp(_a, _b, _t); });
+    return transform;
+}
+
+// 旧ModelAnimation::Updateと同じく、ジョイント毎に名前で探して補間方法を文字列で比べる
+void UpdateLegacy(const std::map<std::string, LegacyNodeAnimation>& _nodeAnimations, std::vector<Joint>& _joints, float _time)
+{
+    for (Joint& joint : _joints)
+    {
+        if (auto it = _nodeAnimations.find(joint.name_); it != _nodeAnimations.end())
+        {
+            const LegacyNodeAnimation& nodeAnimation = it->second;
+            QuaternionTransform transform = {};
+
+            if (nodeAnimation.interpolation == "LINEAR")
+            {
+                transform = EvaluateLegacy_Linear(nodeAnimation, _time);
+            }
+            else if (nodeAnimation.interpolation == "STEP")
+            {
+                transform.translate = CalculateValueLegacy_Step(nodeAnimation.translate, _time);
+                transform.rotation = CalculateValueLegacy_Step(nodeAnimation.rotation, _time);
+                transform.scale = CalculateValueLegacy_Step(nodeAnimation.scale, _time);
+            }
+            else if (nodeAnimation.interpolation == "CUBICSPLINE")
+            {
+                transform = EvaluateLegacy_Linear(nodeAnimation, _time);
+            }
+
+            joint.SetTransform(transform);
+        }
+    }
+}
+
+// _index番目のノードとその子孫を二分木で作る
+Node CreateNode(uint32_t _index, uint32_t _nodeCount)
+{
+    Node node;
+    node.name_ = std::format("Joint_{}", _index);
+    node.transform_ = { Vector3(0.0f, 1.0f, 0.0f), Quaternion(0.0f, 0.0f, 0.0f, 1.0f), Vector3(1.0f, 1.0f, 1.0f) };
+
+    for (uint32_t child = _index * 2 + 1; child <= _index * 2 + 2 && child < _nodeCount; ++child)
+    {
+        node.children_.push_back(CreateNode(child, _nodeCount));
+    }
+    return node;
+}
+
+// 全ジョイントを動かすクリップを作る
+ModelAnimation::Animation CreateClip(uint32_t _jointCount, uint32_t _keyframeCount, float _duration, RandomStream& _random)
+{
+    ModelAnimation::Animation animation = {};
+    animation.duration = _duration;
+
+    for (uint32_t index = 0; index < _jointCount; ++index)
+    {
+        ModelAnimation::NodeAnimation nodeAnimation = {};
+        for (uint32_t key = 0; key < _keyframeCount; ++key)
+        {
+            float time = _duration * static_cast<float>(key) / static_cast<float>(_keyframeCount - 1);
+            Vector4 rotation = _random.GetRandValue(Vector4(-1.0f, -1.0f, -1.0f, -1.0f), Vector4(1.0f, 1.0f, 1.0f, 1.0f));
+
+            nodeAnimation.translate.keyframes.push_back({ time, _random.GetRandValue(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f)) });
+            nodeAnimation.rotation.keyframes.push_back({ time, Quaternion(rotation.x, rotation.y, rotation.z, rotation.w).Normalize() });
+            nodeAnimation.scale.keyframes.push_back({ time, _random.GetRandValue(Vector3(0.5f, 0.5f, 0.5f), Vector3(1.5f, 1.5f, 1.5f)) });
+        }
+
+        animation.channelIndices.emplace(std::format("Joint_{}", index), static_cast<uint32_t>(animation.channels.size()));
+        animation.channels.push_back(std::move(nodeAnimation));
+    }
+    return animation;
+}
+
+// 旧方式の比較用の表を作る
+std::map<std::string, LegacyNodeAnimation> CreateLegacyClip(const ModelAnimation::Animation& _clip)
+{
+    std::map<std::string, LegacyNodeAnimation> legacyClip;
+    for (const auto& [name, channelIndex] : _clip.channelIndices)
+    {
+        const ModelAnimation::NodeAnimation& channel = _clip.channels[channelIndex];
+        legacyClip[name] = { channel.translate, channel.rotation, channel.scale, "LINEAR" };
+    }
+    return legacyClip;
+}
+
+bool IsEqual(const QuaternionTransform& _a, const QuaternionTransform& _b)
+{
+    return _a.translate.x == _b.translate.x && _a.translate.y == _b.translate.y && _a.translate.z == _b.translate.z &&
+        _a.rotation.x == _b.rotation.x && _a.rotation.y == _b.rotation.y && _a.rotation.z == _b.rotation.z && _a.rotation.w == _b.rotation.w &&
+        _a.scale.x == _b.scale.x && _a.scale.y == _b.scale.y && _a.scale.z == _b.scale.z;
+}
+
+bool IsEqual(const VertexData& _a, const VertexData& _b)
+{
+    return _a.position.x == _b.position.x && _a.position.y == _b.position.y && _a.position.z == _b.position.z && _a.position.w == _b.position.w &&
+        _a.normal.x == _b.normal.x && _a.normal.y == _b.normal.y && _a.normal.z == _b.normal.z;
+}
+
+double ElapsedMs(std::chrono::high_resolution_clock::time_point _start)
+{
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - _start).count();
+}
+
+} // namespace
+
+ChannelBindingBenchmarkResult AnimationBenchmark::RunChannelBinding(uint32_t _characterCount, uint32_t _jointCount, uint32_t _frameCount)
+{
+    ChannelBindingBenchmarkResult result;
+    result.characterCount = _characterCount;
+    result.jointCount = _jointCount;
+    result.frameCount = _frameCount;
+
+    if (_characterCount == 0 || _jointCount == 0 || _frameCount == 0)
+        return result;
+
+    RandomStream random(0x2545F491u);
+
+    Node root = CreateNode(0, _jointCount);
+    std::vector<Joint> skeleton;
+    Joint::CreateJoint(root, {}, skeleton);
+
+    ModelAnimation::Animation clip = CreateClip(_jointCount, kKeyframeCount, kClipDuration, random);
+
+    // 旧方式は同じクリップを名前の表と文字列の補間方法で持つ
+    std::map<std::string, LegacyNodeAnimation> legacyClip = CreateLegacyClip(clip);
+
+    // 旧方式
+    std::vector<std::vector<Joint>> legacyJoints(_characterCount, skeleton);
+    {
+        std::vector<float> timers(_characterCount, 0.0f);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            for (uint32_t character = 0; character < _characterCount; ++character)
+            {
+                timers[character] += kDeltaTime;
+                timers[character] = std::fmod(timers[character], clip.duration);
+                UpdateLegacy(legacyClip, legacyJoints[character], timers[character]);
+            }
+        }
+        result.legacyMs = ElapsedMs(start) / _frameCount;
+    }
+
+    // 結び付けた方式
+    std::vector<std::vector<Joint>> boundJoints(_characterCount, skeleton);
+    {
+        // クリップは全キャラクターで共有する
+        auto sharedClip = std::make_shared<const ModelAnimation::Animation>(clip);
+
+        std::vector<ModelAnimation> animations(_characterCount);
+        for (uint32_t character = 0; character < _characterCount; ++character)
+        {
+            animations[character].Initialize();
+            animations[character].SetAnimation(sharedClip);
+            animations[character].SetLoop(true);
+            animations[character].Bind(boundJoints[character]);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            for (uint32_t character = 0; character < _characterCount; ++character)
+            {
+                animations[character].Update(boundJoints[character], kDeltaTime);
+            }
+        }
+        result.boundMs = ElapsedMs(start) / _frameCount;
+    }
+
+    result.isResultEqual = true;
+    for (uint32_t character = 0; character < _characterCount && result.isResultEqual; ++character)
+    {
+        for (uint32_t index = 0; index < _jointCount; ++index)
+        {
+            if (!IsEqual(legacyJoints[character][index].GetTransform(), boundJoints[character][index].GetTransform()))
+            {
+                result.isResultEqual = false;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+KeyframeSamplingBenchmarkResult AnimationBenchmark::RunKeyframeSampling(uint32_t _channelCount, uint32_t _keyframeCount, uint32_t _frameCount)
+{
+    KeyframeSamplingBenchmarkResult result;
+    result.channelCount = _channelCount;
+    result.keyframeCount = _keyframeCount;
+    result.frameCount = _frameCount;
+
+    if (_channelCount == 0 || _keyframeCount < 2 || _frameCount == 0)
+        return result;
+
+    RandomStream random(0x9E3779B9u);
+
+    // 60fpsで収録したクリップとみなす
+    float duration = static_cast<float>(_keyframeCount - 1) / 60.0f;
+
+    Node root = CreateNode(0, _channelCount);
+    std::vector<Joint> joints;
+    Joint::CreateJoint(root, {}, joints);
+
+    ModelAnimation::Animation clip = CreateClip(_channelCount, _keyframeCount, duration, random);
+    std::map<std::string, LegacyNodeAnimation> legacyClip = CreateLegacyClip(clip);
+
+    // 同じ時刻列を使う 途中でシークと尺を超えるループを含める
+    std::vector<float> times(_frameCount);
+    {
+        float time = 0.0f;
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            time += kDeltaTime;
+            if (frame == _frameCount / 2)
+                time = duration * 0.25f;
+            times[frame] = std::fmod(time, duration);
+        }
+    }
+
+    // 旧方式 チャンネル毎に先頭から探す
+    std::vector<QuaternionTransform> legacyPose(_channelCount);
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            for (uint32_t index = 0; index < _channelCount; ++index)
+            {
+                legacyPose[index] = EvaluateLegacy_Linear(legacyClip.at(joints[index].name_), times[frame]);
+            }
+        }
+        result.legacyMs = ElapsedMs(start) / _frameCount;
+    }
+
+    // 前回の区間から探す
+    std::vector<QuaternionTransform> cursorPose(_channelCount);
+    {
+        ModelAnimation animation;
+        animation.Initialize();
+        animation.SetAnimation(std::make_shared<const ModelAnimation::Animation>(clip));
+        animation.Bind(joints);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            animation.Sample(times[frame], cursorPose);
+        }
+        result.cursorMs = ElapsedMs(start) / _frameCount;
+    }
+
+    result.isResultEqual = true;
+    for (uint32_t index = 0; index < _channelCount; ++index)
+    {
+        if (!IsEqual(legacyPose[index], cursorPose[index]))
+        {
+            result.isResultEqual = false;
+            break;
+        }
+    }
+
+    return result;
+}
+
+void AnimationBenchmark::RunKeyframeSamplingSuite()
+{
+    for (uint32_t keyframeCount : { 30u, 300u, 3000u })
+    {
+        KeyframeSamplingBenchmarkResult result = RunKeyframeSampling(60, keyframeCount);
+        Debug::Log(std::format("[KeyframeSampling] channels: {} keys: {} legacy: {:.3f} ms cursor: {:.3f} ms ({})\n",
+            result.channelCount, result.keyframeCount, result.legacyMs, result.cursorMs, result.isResultEqual ? "match" : "MISMATCH"));
+    }
+}
+
+CpuSkinningBenchmarkResult AnimationBenchmark::RunCpuSkinning(uint32_t _vertexCount, uint32_t _jointCount, uint32_t _frameCount)
+{
+    CpuSkinningBenchmarkResult result;
+    result.vertexCount = _vertexCount;
+    result.jointCount = _jointCount;
+    result.frameCount = _frameCount;
+    result.threadCount = JobSystem::GetInstance()->GetConcurrency();
+    result.isAVXSupported = SkinningCPU::IsAVXSupported();
+
+    if (_vertexCount == 0 || _jointCount == 0 || _frameCount == 0)
+        return result;
+
+    RandomStream random(0x68E31DA4u);
+
+    // ジョイント毎の行列
+    std::vector<WellForGPU> palette(_jointCount);
+    for (WellForGPU& well : palette)
+    {
+        Vector4 rotation = random.GetRandValue(Vector4(-1.0f, -1.0f, -1.0f, -1.0f), Vector4(1.0f, 1.0f, 1.0f, 1.0f));
+        well.skeletonSpaceMatrix = MakeAffineMatrix(
+            random.GetRandValue(Vector3(0.8f, 0.8f, 0.8f), Vector3(1.2f, 1.2f, 1.2f)),
+            Quaternion(rotation.x, rotation.y, rotation.z, rotation.w).Normalize(),
+            random.GetRandValue(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f)));
+        well.skeletonSpaceInverseTransposeMatrix = Transpose(Inverse(well.skeletonSpaceMatrix));
+    }
+
+    // 4ジョイントの影響を受ける頂点
+    std::vector<VertexData> vertices(_vertexCount);
+    std::vector<VertexInfluenceData> influences(_vertexCount);
+    for (uint32_t index = 0; index < _vertexCount; ++index)
+    {
+        Vector3 position = random.GetRandValue(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f));
+        vertices[index].position = Vector4(position.x, position.y, position.z, 1.0f);
+        vertices[index].normal = random.GetRandValue(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f)).Normalize();
+
+        float total = 0.0f;
+        for (uint32_t i = 0; i < influenceNum_; ++i)
+        {
+            influences[index].weights[i] = random.GetRandValue(0.0f, 1.0f);
+            influences[index].jointIndices[i] = static_cast<uint32_t>(random.GetRandValue(0, static_cast<int>(_jointCount) - 1));
+            total += influences[index].weights[i];
+        }
+        for (float& weight : influences[index].weights)
+        {
+            weight /= total;
+        }
+    }
+
+    SkinningCPU skinning;
+
+    auto measure = [&](SkinningCPU::Kernel _kernel, bool _isParallel, std::vector<VertexData>& _output)
+        {
+            skinning.SetKernel(_kernel);
+            skinning.SetParallel(_isParallel);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (uint32_t frame = 0; frame < _frameCount; ++frame)
+            {
+                skinning.Execute(vertices, influences, palette, _output);
+            }
+            return ElapsedMs(start) / _frameCount;
+        };
+
+    std::vector<VertexData> scalarOutput(_vertexCount);
+    std::vector<VertexData> sseOutput(_vertexCount);
+    std::vector<VertexData> avxOutput(_vertexCount);
+    std::vector<VertexData> parallelOutput(_vertexCount);
+
+    result.scalarMs = measure(SkinningCPU::Kernel::Scalar, false, scalarOutput);
+    result.sseMs = measure(SkinningCPU::Kernel::SSE, false, sseOutput);
+    if (result.isAVXSupported)
+        result.avxMs = measure(SkinningCPU::Kernel::AVX, false, avxOutput);
+    else
+        avxOutput = sseOutput;
+    result.parallelMs = measure(SkinningCPU::Kernel::Auto, true, parallelOutput);
+
+    // 16頂点に1つの位置だけを求める
+    std::vector<uint32_t> subsetIndices;
+    for (uint32_t index = 0; index < _vertexCount; index += 16)
+    {
+        subsetIndices.push_back(index);
+    }
+    std::vector<Vector3> subsetPositions(subsetIndices.size());
+    {
+        skinning.SetKernel(SkinningCPU::Kernel::Auto);
+        skinning.SetParallel(true);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            skinning.ExecuteSubset(vertices, influences, palette, subsetIndices, subsetPositions);
+        }
+        result.subsetMs = ElapsedMs(start) / _frameCount;
+    }
+
+    result.isResultEqual = true;
+    for (uint32_t index = 0; index < _vertexCount; ++index)
+    {
+        if (!IsEqual(scalarOutput[index], sseOutput[index]) || !IsEqual(scalarOutput[index], avxOutput[index]) || !IsEqual(scalarOutput[index], parallelOutput[index]))
+        {
+            result.isResultEqual = false;
+            break;
+        }
+    }
+    for (size_t index = 0; index < subsetIndices.size() && result.isResultEqual; ++index)
+    {
+        const Vector4& expected = scalarOutput[subsetIndices[index]].position;
+        const Vector3& position = subsetPositions[index];
+        result.isResultEqual = expected.x == position.x && expected.y == position.y && expected.z == position.z;
+    }
+
+    return result;
+}
+
+void AnimationBenchmark::RunCpuSkinningSuite()
+{
+    for (uint32_t vertexCount : { 10000u, 100000u })
+    {
+        CpuSkinningBenchmarkResult result = RunCpuSkinning(vertexCount, 60);
+        Debug::Log(std::format("[CpuSkinning] vertices: {} joints: {} scalar: {:.3f} ms SSE: {:.3f} ms AVX: {} parallel({} threads): {:.3f} ms subset(1/16): {:.3f} ms ({})\n",
+            result.vertexCount, result.jointCount, result.scalarMs, result.sseMs,
+            result.isAVXSupported ? std::format("{:.3f} ms", result.avxMs) : std::string("unsupported"),
+            result.threadCount, result.parallelMs, result.subsetMs, result.isResultEqual ? "match" : "MISMATCH"));
+    }
+}
+
+void AnimationBenchmark::RunChannelBindingSuite()
+{
+    ChannelBindingBenchmarkResult result = RunChannelBinding(100, 60);
+    Debug::Log(std::format("[ChannelBinding] characters: {} joints: {} legacy: {:.3f} ms bound: {:.3f} ms ({})\n",
+        result.characterCount, result.jointCount, result.legacyMs, result.boundMs, result.isResultEqual ? "match" : "MISMATCH"));
+}
+
+} // namespace Engine
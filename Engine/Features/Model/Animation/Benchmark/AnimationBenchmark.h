@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace Engine {
+
+// チャンネルの結び付けのベンチマーク結果
+struct ChannelBindingBenchmarkResult
+{
+    uint32_t characterCount = 0;    // キャラクターの数
+    uint32_t jointCount = 0;        // 1キャラクターのジョイント数
+    uint32_t frameCount = 0;        // 計測したフレーム数
+    double legacyMs = 0.0;          // ジョイント毎に名前でチャンネルを探し、補間方法を文字列で比べる方式の1フレーム平均(ms)
+    double boundMs = 0.0;           // Bindで作ったジョイントとチャンネルの表をたどる方式の1フレーム平均(ms)
+    bool isResultEqual = false;     // 最後のフレームのジョイントの姿勢が全て一致したか
+};
+
+// キーフレームのサンプリングのベンチマーク結果
+struct KeyframeSamplingBenchmarkResult
+{
+    uint32_t channelCount = 0;      // チャンネルの数
+    uint32_t keyframeCount = 0;     // 1カーブのキーフレーム数
+    uint32_t frameCount = 0;        // 計測したフレーム数
+    double legacyMs = 0.0;          // 毎回先頭から区間を探す方式の1フレーム平均(ms)
+    double cursorMs = 0.0;          // 前回の区間から探し、外れたら二分探索する方式の1フレーム平均(ms)
+    bool isResultEqual = false;     // 最後のフレームの姿勢が全て一致したか
+};
+
+// CPUスキニングのベンチマーク結果
+struct CpuSkinningBenchmarkResult
+{
+    uint32_t vertexCount = 0;       // 頂点数
+    uint32_t jointCount = 0;        // ジョイント数
+    uint32_t frameCount = 0;        // 計測したフレーム数
+    uint32_t threadCount = 0;       // 並列に処理したスレッド数
+    bool isAVXSupported = false;    // AVXのカーネルを計測したか
+    double scalarMs = 0.0;          // スカラーのカーネル 1スレッドの1フレーム平均(ms)
+    double sseMs = 0.0;             // SSEのカーネル 1スレッドの1フレーム平均(ms)
+    double avxMs = 0.0;             // AVXのカーネル 1スレッドの1フレーム平均(ms)
+    double parallelMs = 0.0;        // 最速のカーネルを並列に処理したときの1フレーム平均(ms)
+    double subsetMs = 0.0;          // 1/16の頂点の位置だけを並列に処理したときの1フレーム平均(ms)
+    bool isResultEqual = false;     // 全カーネル・並列処理・一部の頂点の結果が一致したか
+};
+
+// アニメーションまわりの処理時間を計測する
+class AnimationBenchmark
+{
+public:
+    /// <summary>
+    /// 全ジョイントをアニメーションするクリップを、旧方式と結び付けた方式で再生して比較する
+    /// </summary>
+    /// <param name="_characterCount">キャラクターの数</param>
+    /// <param name="_jointCount">1キャラクターのジョイント数</param>
+    /// <param name="_frameCount">計測するフレーム数</param>
+    static ChannelBindingBenchmarkResult RunChannelBinding(uint32_t _characterCount, uint32_t _jointCount, uint32_t _frameCount = 60);
+
+    // 100キャラクター × 60ジョイントで計測してログに出力する
+    static void RunChannelBindingSuite();
+
+    /// <summary>
+    /// 長いクリップのサンプリングを、先頭から探す方式と前回の区間から探す方式で比較する
+    /// 途中でシークとループを含む
+    /// </summary>
+    /// <param name="_channelCount">チャンネルの数</param>
+    /// <param name="_keyframeCount">1カーブのキーフレーム数</param>
+    /// <param name="_frameCount">計測するフレーム数</param>
+    static KeyframeSamplingBenchmarkResult RunKeyframeSampling(uint32_t _channelCount, uint32_t _keyframeCount, uint32_t _frameCount = 600);
+
+    // 60チャンネルでキーフレーム数30, 300, 3000を計測してログに出力する
+    static void RunKeyframeSamplingSuite();
+
+    /// <summary>
+    /// 4ジョイントの影響を受ける頂点をCPUでスキニングし、カーネルと並列処理を比較する
+    /// </summary>
+    /// <param name="_vertexCount">頂点数</param>
+    /// <param name="_jointCount">ジョイント数</param>
+    /// <param name="_frameCount">計測するフレーム数</param>
+    static CpuSkinningBenchmarkResult RunCpuSkinning(uint32_t _vertexCount, uint32_t _jointCount, uint32_t _frameCount = 30);
+
+    // 60ジョイントで頂点数1万, 10万を計測してログに出力する
+    static void RunCpuSkinningSuite();
+};
+
+} // namespace Engine
@@ -0,0 +1,458 @@
+#include "AnimationBlendTree.h"
+
+#include <Features/Model/Animation/Joint/Joint.h>
+#include <Features/Model/Animation/Clip/CompressedAnimationClip.h>
+#include <Math/MyLib.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+namespace Engine {
+
+void AnimationBlendTree::Initialize(const std::vector<Joint>& _joints)
+{
+    jointNames_.clear();
+    parents_.clear();
+    referencePose_.clear();
+    for (const Joint& joint : _joints)
+    {
+        jointNames_.push_back(joint.name_);
+        parents_.push_back(joint.GetParentIndex());
+        referencePose_.push_back(joint.GetIdleTransform());
+    }
+
+    clips_.clear();
+    nodes_.clear();
+    layers_.clear();
+
+    jointMask_.clear();
+    evaluatedJointCount_ = static_cast<uint32_t>(referencePose_.size());
+
+    resultPose_ = referencePose_;
+    isPoseAllocated_ = false;
+}
+
+uint32_t AnimationBlendTree::AddClip(std::shared_ptr<const ModelAnimation::Animation> _animation, std::shared_ptr<const CompressedAnimationClip> _compressedClip, bool _loop, float _speed)
+{
+    assert(_animation || _compressedClip);
+
+    ClipState clip = {};
+    clip.animation = std::move(_animation);
+    clip.compressedClip = std::move(_compressedClip);
+    clip.loop = _loop;
+    clip.speed = _speed;
+
+    // 名前での結び付けは追加するときにのみ行う
+    const std::map<std::string, uint32_t>& channelIndices = clip.animation ? clip.animation->channelIndices : clip.compressedClip->GetChannelIndices();
+    for (uint32_t jointIndex = 0; jointIndex < jointNames_.size(); ++jointIndex)
+    {
+        auto it = channelIndices.find(jointNames_[jointIndex]);
+        if (it != channelIndices.end())
+        {
+            clip.bindings.push_back({ jointIndex, it->second });
+        }
+    }
+    clip.cursors.assign(clip.bindings.size(), ModelAnimation::KeyframeCursor{});
+
+    clips_.push_back(std::move(clip));
+
+    Node node = {};
+    node.type = NodeType::Clip;
+    node.clipIndex = static_cast<uint32_t>(clips_.size() - 1);
+    return AddNode(std::move(node));
+}
+
+uint32_t AnimationBlendTree::AddBlend(const std::vector<uint32_t>& _children, const std::vector<float>& _weights)
+{
+    assert(_weights.empty() || _weights.size() == _children.size());
+
+    Node node = {};
+    node.type = NodeType::Blend;
+    node.children = _children;
+    node.weights = _weights.empty() ? std::vector<float>(_children.size(), 1.0f) : _weights;
+    return AddNode(std::move(node));
+}
+
+uint32_t AnimationBlendTree::AddBlendSpace1D(const std::vector<uint32_t>& _children, const std::vector<float>& _positions)
+{
+    assert(!_children.empty() && _positions.size() == _children.size());
+
+    Node node = {};
+    node.type = NodeType::BlendSpace1D;
+    node.children = _children;
+    node.weights.assign(_children.size(), 0.0f);
+    node.positions1D = _positions;
+    return AddNode(std::move(node));
+}
+
+uint32_t AnimationBlendTree::AddBlendSpace2D(const std::vector<uint32_t>& _children, const std::vector<Vector2>& _positions)
+{
+    assert(!_children.empty() && _positions.size() == _children.size());
+
+    Node node = {};
+    node.type = NodeType::BlendSpace2D;
+    node.children = _children;
+    node.weights.assign(_children.size(), 0.0f);
+    node.positions2D = _positions;
+    return AddNode(std::move(node));
+}
+
+void AnimationBlendTree::SetBlendWeight(uint32_t _node, uint32_t _childSlot, float _weight)
+{
+    assert(_node < nodes_.size() && nodes_[_node].type == NodeType::Blend);
+    assert(_childSlot < nodes_[_node].weights.size());
+    nodes_[_node].weights[_childSlot] = _weight;
+}
+
+void AnimationBlendTree::SetBlendSpaceParameter(uint32_t _node, float _parameter)
+{
+    assert(_node < nodes_.size() && nodes_[_node].type == NodeType::BlendSpace1D);
+    nodes_[_node].parameter = Vector2(_parameter, 0.0f);
+}
+
+void AnimationBlendTree::SetBlendSpaceParameter(uint32_t _node, const Vector2& _parameter)
+{
+    assert(_node < nodes_.size() && nodes_[_node].type == NodeType::BlendSpace2D);
+    nodes_[_node].parameter = _parameter;
+}
+
+void AnimationBlendTree::SetClipTime(uint32_t _node, float _time)
+{
+    assert(_node < nodes_.size() && nodes_[_node].type == NodeType::Clip);
+    clips_[nodes_[_node].clipIndex].time = _time;
+}
+
+void AnimationBlendTree::SetClipSpeed(uint32_t _node, float _speed)
+{
+    assert(_node < nodes_.size() && nodes_[_node].type == NodeType::Clip);
+    clips_[nodes_[_node].clipIndex].speed = _speed;
+}
+
+float AnimationBlendTree::GetClipTime(uint32_t _node) const
+{
+    assert(_node < nodes_.size() && nodes_[_node].type == NodeType::Clip);
+    return clips_[nodes_[_node].clipIndex].time;
+}
+
+uint32_t AnimationBlendTree::AddLayer(uint32_t _root, LayerBlendMode _mode, float _weight)
+{
+    assert(_root < nodes_.size());
+
+    Layer layer = {};
+    layer.root = _root;
+    layer.mode = _mode;
+    layer.weight = _weight;
+    layers_.push_back(std::move(layer));
+
+    isPoseAllocated_ = false;
+    return static_cast<uint32_t>(layers_.size() - 1);
+}
+
+void AnimationBlendTree::SetLayerWeight(uint32_t _layer, float _weight)
+{
+    assert(_layer < layers_.size());
+    layers_[_layer].weight = _weight;
+}
+
+void AnimationBlendTree::SetLayerMask(uint32_t _layer, std::vector<float> _mask)
+{
+    assert(_layer < layers_.size());
+    assert(_mask.empty() || _mask.size() == jointNames_.size());
+    layers_[_layer].mask = std::move(_mask);
+}
+
+std::vector<float> AnimationBlendTree::CreateMask(const std::string& _rootJointName) const
+{
+    std::vector<float> mask(jointNames_.size(), 0.0f);
+
+    // 親は子より前に並んでいるので、前から親が含まれていれば含める
+    for (size_t index = 0; index < jointNames_.size(); ++index)
+    {
+        int32_t parent = parents_[index];
+        if (jointNames_[index] == _rootJointName || (parent >= 0 && mask[parent] > 0.0f))
+            mask[index] = 1.0f;
+    }
+    return mask;
+}
+
+void AnimationBlendTree::Update(float _deltaTime)
+{
+    for (ClipState& clip : clips_)
+    {
+        float duration = clip.animation ? clip.animation->duration : clip.compressedClip->GetDuration();
+
+        clip.time += _deltaTime * clip.speed;
+        if (clip.loop && duration > 0.0f)
+        {
+            clip.time = std::fmod(clip.time, duration);
+            if (clip.time < 0.0f)
+                clip.time += duration;
+        }
+        else
+        {
+            clip.time = std::clamp(clip.time, 0.0f, std::max(duration, 0.0f));
+        }
+    }
+}
+
+std::span<const QuaternionTransform> AnimationBlendTree::Evaluate()
+{
+    if (!isPoseAllocated_)
+        AllocatePoses();
+
+    if (layers_.empty())
+    {
+        std::copy(referencePose_.begin(), referencePose_.end(), resultPose_.begin());
+        return resultPose_;
+    }
+
+    // 基本のレイヤー
+    std::span<QuaternionTransform> basePose = EvaluateNode(layers_[0].root, 0);
+    std::copy(basePose.begin(), basePose.end(), resultPose_.begin());
+
+    for (size_t layerIndex = 1; layerIndex < layers_.size(); ++layerIndex)
+    {
+        const Layer& layer = layers_[layerIndex];
+        if (layer.weight <= 0.0f)
+            continue;
+
+        std::span<QuaternionTransform> layerPose = EvaluateNode(layer.root, 0);
+
+        for (size_t index = 0; index < resultPose_.size(); ++index)
+        {
+            float weight = layer.weight * (layer.mask.empty() ? 1.0f : layer.mask[index]);
+            if (weight <= 0.0f)
+                continue;
+
+            QuaternionTransform& result = resultPose_[index];
+            const QuaternionTransform& pose = layerPose[index];
+
+            if (layer.mode == LayerBlendMode::Override)
+            {
+                result.translate = Lerp(result.translate, pose.translate, weight);
+                result.rotation = Slerp(result.rotation, pose.rotation, weight);
+                result.scale = Lerp(result.scale, pose.scale, weight);
+            }
+            else
+            {
+                // 基準の姿勢からの差分を重みの分だけ加える
+                const QuaternionTransform& reference = referencePose_[index];
+
+                result.translate += (pose.translate - reference.translate) * weight;
+
+                Quaternion deltaRotation = reference.rotation.Inverse() * pose.rotation;
+                result.rotation = (result.rotation * Slerp(Quaternion::Identity(), deltaRotation, weight)).Normalize();
+
+                Vector3 ratio(
+                    reference.scale.x != 0.0f ? pose.scale.x / reference.scale.x : 1.0f,
+                    reference.scale.y != 0.0f ? pose.scale.y / reference.scale.y : 1.0f,
+                    reference.scale.z != 0.0f ? pose.scale.z / reference.scale.z : 1.0f);
+                result.scale *= Lerp(Vector3(1.0f, 1.0f, 1.0f), ratio, weight);
+            }
+        }
+    }
+
+    return resultPose_;
+}
+
+void AnimationBlendTree::Apply(std::vector<Joint>& _joints)
+{
+    std::span<const QuaternionTransform> pose = Evaluate();
+
+    size_t count = std::min(_joints.size(), pose.size());
+    for (size_t index = 0; index < count; ++index)
+    {
+        _joints[index].SetTransform(pose[index]);
+    }
+}
+
+void AnimationBlendTree::SetJointMask(std::vector<uint8_t> _mask)
+{
+    jointMask_ = std::move(_mask);
+
+    evaluatedJointCount_ = static_cast<uint32_t>(referencePose_.size());
+    if (!jointMask_.empty())
+        evaluatedJointCount_ = static_cast<uint32_t>(std::count_if(jointMask_.begin(), jointMask_.end(), [](uint8_t _value) { return _value != 0; }));
+}
+
+uint32_t AnimationBlendTree::AddNode(Node&& _node)
+{
+    // 子は先に追加されていること（循環しない）
+    for (uint32_t child : _node.children)
+    {
+        assert(child < nodes_.size());
+    }
+
+    nodes_.push_back(std::move(_node));
+    isPoseAllocated_ = false;
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+std::span<QuaternionTransform> AnimationBlendTree::EvaluateNode(uint32_t _node, uint32_t _depth)
+{
+    std::span<QuaternionTransform> out = scratchPoses_[_depth];
+    Node& node = nodes_[_node];
+
+    if (node.type == NodeType::Clip)
+    {
+        EvaluateClip(clips_[node.clipIndex], out);
+        return out;
+    }
+
+    if (node.type == NodeType::BlendSpace1D || node.type == NodeType::BlendSpace2D)
+        UpdateBlendSpaceWeights(node);
+
+    float totalWeight = 0.0f;
+    for (float weight : node.weights)
+    {
+        totalWeight += std::max(weight, 0.0f);
+    }
+
+    if (totalWeight <= 0.0f)
+    {
+        std::copy(referencePose_.begin(), referencePose_.end(), out.begin());
+        return out;
+    }
+
+    // 重みが0の子は求めない 回転は向きを揃えて足し、最後に正規化する
+    bool isFirst = true;
+    for (size_t slot = 0; slot < node.children.size(); ++slot)
+    {
+        if (node.weights[slot] <= 0.0f)
+            continue;
+
+        float weight = node.weights[slot] / totalWeight;
+        std::span<QuaternionTransform> childPose = EvaluateNode(node.children[slot], _depth + 1);
+
+        for (size_t index = 0; index < out.size(); ++index)
+        {
+            const QuaternionTransform& child = childPose[index];
+            QuaternionTransform& result = out[index];
+
+            if (isFirst)
+            {
+                result.translate = child.translate * weight;
+                result.rotation = child.rotation * weight;
+                result.scale = child.scale * weight;
+                continue;
+            }
+
+            Quaternion rotation = result.rotation.Dot(child.rotation) < 0.0f ? -child.rotation : child.rotation;
+            result.translate += child.translate * weight;
+            result.rotation = result.rotation + rotation * weight;
+            result.scale += child.scale * weight;
+        }
+        isFirst = false;
+    }
+
+    for (QuaternionTransform& result : out)
+    {
+        result.rotation = result.rotation.Normalize();
+    }
+
+    return out;
+}
+
+void AnimationBlendTree::EvaluateClip(ClipState& _clip, std::span<QuaternionTransform> _out)
+{
+    // アニメーションしないジョイントは基準の姿勢
+    std::copy(referencePose_.begin(), referencePose_.end(), _out.begin());
+
+    // カーソルはサンプリングで更新する マスクで外したジョイントは基準の姿勢のまま
+    for (size_t index = 0; index < _clip.bindings.size(); ++index)
+    {
+        const ChannelBinding& binding = _clip.bindings[index];
+        if (binding.jointIndex < jointMask_.size() && !jointMask_[binding.jointIndex])
+            continue;
+
+        if (_clip.compressedClip)
+            _out[binding.jointIndex] = _clip.compressedClip->Sample(binding.channelIndex, _clip.time, _clip.cursors[index]);
+        else
+            _out[binding.jointIndex] = ModelAnimation::Evaluate(_clip.animation->channels[binding.channelIndex], _clip.time, _clip.cursors[index]);
+    }
+}
+
+void AnimationBlendTree::UpdateBlendSpaceWeights(Node& _node)
+{
+    std::fill(_node.weights.begin(), _node.weights.end(), 0.0f);
+    size_t count = _node.children.size();
+
+    if (_node.type == NodeType::BlendSpace1D)
+    {
+        // パラメーター以下で最も近い位置と、より大きい中で最も近い位置の2つを線形に合成する
+        float parameter = _node.parameter.x;
+        size_t lower = count;
+        size_t upper = count;
+        for (size_t slot = 0; slot < count; ++slot)
+        {
+            float position = _node.positions1D[slot];
+            if (position <= parameter && (lower == count || position > _node.positions1D[lower]))
+                lower = slot;
+            if (position > parameter && (upper == count || position < _node.positions1D[upper]))
+                upper = slot;
+        }
+
+        if (lower == count)
+            _node.weights[upper] = 1.0f;
+        else if (upper == count)
+            _node.weights[lower] = 1.0f;
+        else
+        {
+            float t = (parameter - _node.positions1D[lower]) / (_node.positions1D[upper] - _node.positions1D[lower]);
+            _node.weights[lower] = 1.0f - t;
+            _node.weights[upper] = t;
+        }
+        return;
+    }
+
+    // 勾配帯補間 各点について、他の点へ向かう方向にパラメーターが進んだ分だけ重みを下げる
+    const Vector2& parameter = _node.parameter;
+    for (size_t slot = 0; slot < count; ++slot)
+    {
+        const Vector2& position = _node.positions2D[slot];
+        float weight = 1.0f;
+        for (size_t other = 0; other < count; ++other)
+        {
+            if (other == slot)
+                continue;
+
+            Vector2 direction = _node.positions2D[other] - position;
+            float lengthSquared = direction.Dot(direction);
+            if (lengthSquared <= 0.0f)
+                continue;
+
+            float h = 1.0f - (parameter - position).Dot(direction) / lengthSquared;
+            weight = std::min(weight, std::clamp(h, 0.0f, 1.0f));
+        }
+        _node.weights[slot] = weight;
+    }
+}
+
+void AnimationBlendTree::AllocatePoses()
+{
+    uint32_t maxDepth = 0;
+    for (const Layer& layer : layers_)
+    {
+        maxDepth = std::max(maxDepth, GetDepth(layer.root));
+    }
+
+    scratchPoses_.assign(maxDepth + 1, std::vector<QuaternionTransform>(referencePose_.size()));
+    resultPose_.resize(referencePose_.size());
+    isPoseAllocated_ = true;
+}
+
+uint32_t AnimationBlendTree::GetDepth(uint32_t _node) const
+{
+    const Node& node = nodes_[_node];
+
+    uint32_t depth = 0;
+    for (uint32_t child : node.children)
+    {
+        depth = std::max(depth, GetDepth(child) + 1);
+    }
+    return depth;
+}
+
+} // namespace Engine
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <Features/Model/Animation/ModelAnimation.h>
+#include <Math/Vector/Vector2.h>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+
+namespace Engine {
+
+class Joint;
+class CompressedAnimationClip;
+
+/// <summary>
+/// 複数のクリップを重み付きで合成するブレンドツリー
+/// ノード（クリップ・N個の重み付きブレンド・1D/2Dブレンドスペース）を組み、
+/// 基本のレイヤーの上に上書き・加算のレイヤーをジョイント毎のマスク付きで重ねる
+/// 姿勢はジョイントの添え字毎の配列で、バッファは構成を変えたときにのみ確保する
+/// </summary>
+class AnimationBlendTree
+{
+public:
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    // レイヤーの重ね方
+    enum class LayerBlendMode
+    {
+        Override,   // 下のレイヤーの姿勢を重みとマスクに応じて置き換える
+        Additive,   // 基準の姿勢からの差分を下のレイヤーの姿勢に加える
+    };
+
+    AnimationBlendTree() = default;
+    ~AnimationBlendTree() = default;
+
+    /// <summary>
+    /// スケルトンに合わせて初期化する ジョイントのアイドルの姿勢を基準の姿勢とする
+    /// ノードとレイヤーは全て破棄する
+    /// </summary>
+    void Initialize(const std::vector<Joint>& _joints);
+
+    // === ノード ===
+
+    /// <summary>
+    /// クリップのノードを追加する
+    /// </summary>
+    /// <param name="_animation">クリップ</param>
+    /// <param name="_compressedClip">圧縮したクリップ あればサンプリングはこちらから行う</param>
+    /// <param name="_loop">ループするか</param>
+    /// <param name="_speed">再生速度</param>
+    /// <returns>ノードの添え字</returns>
+    uint32_t AddClip(std::shared_ptr<const ModelAnimation::Animation> _animation, std::shared_ptr<const CompressedAnimationClip> _compressedClip = nullptr,
+        bool _loop = true, float _speed = 1.0f);
+
+    // 子ノードを重み付きで合成するノードを追加する 重みは合計で割って使う
+    uint32_t AddBlend(const std::vector<uint32_t>& _children, const std::vector<float>& _weights = {});
+
+    // 子ノードを1次元の位置に置き、パラメーターに近い2つを合成するノードを追加する
+    uint32_t AddBlendSpace1D(const std::vector<uint32_t>& _children, const std::vector<float>& _positions);
+
+    // 子ノードを2次元の位置に置き、パラメーターからの勾配帯補間で合成するノードを追加する
+    uint32_t AddBlendSpace2D(const std::vector<uint32_t>& _children, const std::vector<Vector2>& _positions);
+
+    void SetBlendWeight(uint32_t _node, uint32_t _childSlot, float _weight);
+    void SetBlendSpaceParameter(uint32_t _node, float _parameter);
+    void SetBlendSpaceParameter(uint32_t _node, const Vector2& _parameter);
+
+    // クリップのノードの再生位置・速度
+    void SetClipTime(uint32_t _node, float _time);
+    void SetClipSpeed(uint32_t _node, float _speed);
+    float GetClipTime(uint32_t _node) const;
+
+    // === レイヤー ===
+
+    /// <summary>
+    /// レイヤーを追加する 最初のレイヤーは基本のレイヤーとなり、重ね方・重み・マスクは使わない
+    /// </summary>
+    /// <param name="_root">レイヤーの姿勢を求めるノード</param>
+    /// <param name="_mode">重ね方</param>
+    /// <param name="_weight">重み</param>
+    /// <returns>レイヤーの添え字</returns>
+    uint32_t AddLayer(uint32_t _root, LayerBlendMode _mode = LayerBlendMode::Override, float _weight = 1.0f);
+
+    void SetLayerWeight(uint32_t _layer, float _weight);
+
+    // ジョイント毎の重み(0~1) 空ならすべて1
+    void SetLayerMask(uint32_t _layer, std::vector<float> _mask);
+
+    // _rootJointNameのジョイントとその子孫を1、それ以外を0としたマスクを作る
+    std::vector<float> CreateMask(const std::string& _rootJointName) const;
+
+    // === 更新 ===
+
+    // 全クリップの再生位置を進める
+    void Update(float _deltaTime);
+
+    // 全レイヤーを合成した姿勢を求める 戻り値はジョイントの添え字毎の姿勢
+    std::span<const QuaternionTransform> Evaluate();
+
+    // 合成した姿勢をジョイントに設定する
+    void Apply(std::vector<Joint>& _joints);
+
+    /// <summary>
+    /// 求めるジョイントを絞る 0のジョイントはサンプリングせず、基準の姿勢になる
+    /// 空ならすべてのジョイントを求める
+    /// </summary>
+    void SetJointMask(std::vector<uint8_t> _mask);
+    // サンプリングするジョイントの数
+    uint32_t GetEvaluatedJointCount() const { return evaluatedJointCount_; }
+
+    uint32_t GetJointCount() const { return static_cast<uint32_t>(referencePose_.size()); }
+    bool HasLayer() const { return !layers_.empty(); }
+
+private:
+    enum class NodeType
+    {
+        Clip,
+        Blend,
+        BlendSpace1D,
+        BlendSpace2D,
+    };
+
+    struct ChannelBinding
+    {
+        uint32_t jointIndex;
+        uint32_t channelIndex;
+    };
+
+    struct ClipState
+    {
+        std::shared_ptr<const ModelAnimation::Animation> animation;
+        std::shared_ptr<const CompressedAnimationClip> compressedClip;
+        std::vector<ChannelBinding> bindings;
+        std::vector<ModelAnimation::KeyframeCursor> cursors;    // bindingsと同じ並び
+        float time = 0.0f;
+        float speed = 1.0f;
+        bool loop = true;
+    };
+
+    struct Node
+    {
+        NodeType type = NodeType::Clip;
+        uint32_t clipIndex = kInvalidIndex;
+        std::vector<uint32_t> children;
+        std::vector<float> weights;             // 子毎の重み ブレンドスペースはEvaluateで求める
+        std::vector<float> positions1D;
+        std::vector<Vector2> positions2D;
+        Vector2 parameter = {};
+    };
+
+    struct Layer
+    {
+        uint32_t root = kInvalidIndex;
+        LayerBlendMode mode = LayerBlendMode::Override;
+        float weight = 1.0f;
+        std::vector<float> mask;
+    };
+
+    uint32_t AddNode(Node&& _node);
+
+    // _nodeの姿勢をscratchPoses_[_depth]に求める 子はより深いバッファを使う
+    std::span<QuaternionTransform> EvaluateNode(uint32_t _node, uint32_t _depth);
+    void EvaluateClip(ClipState& _clip, std::span<QuaternionTransform> _out);
+    void UpdateBlendSpaceWeights(Node& _node);
+
+    // ノードの深さに合わせて作業用のバッファを確保する
+    void AllocatePoses();
+    uint32_t GetDepth(uint32_t _node) const;
+
+    std::vector<std::string> jointNames_;
+    std::vector<int32_t> parents_;
+    std::vector<QuaternionTransform> referencePose_;
+    std::vector<uint8_t> jointMask_;                // 空ならすべてのジョイント
+    uint32_t evaluatedJointCount_ = 0;
+
+    std::vector<ClipState> clips_;
+    std::vector<Node> nodes_;
+    std::vector<Layer> layers_;
+
+    std::vector<std::vector<QuaternionTransform>> scratchPoses_;
+    std::vector<QuaternionTransform> resultPose_;
+    bool isPoseAllocated_ = false;
+};
+
+} // namespace Engine
@@ -0,0 +1,404 @@
+#include "CompressedAnimationClip.h"
+
+#include <Math/MyLib.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+
+namespace Engine {
+
+namespace {
+
+constexpr float kQuantizeMax = 32767.0f;                                // 15bit
+constexpr float kComponentRange = std::numbers::sqrt2_v<float> * 0.5f;  // 最大でない成分の絶対値は1/√2以下
+
+template <typename T>
+using KeyframeVector = std::vector<ModelAnimation::Keyframe<T>>;
+
+float Vector3Error(const Vector3& _a, const Vector3& _b)
+{
+    return (_a - _b).Length();
+}
+
+// 2つの回転の間の角度(度)
+// acosは1付近の精度が低く小さな誤差を測れないので、差の回転の虚部と実部からatan2で求める
+float RotationError(const Quaternion& _a, const Quaternion& _b)
+{
+    Quaternion difference = _a.Normalize().Conjugate() * _b.Normalize();
+    float imaginary = std::sqrt(difference.x * difference.x + difference.y * difference.y + difference.z * difference.z);
+    return 2.0f * std::atan2(imaginary, std::abs(difference.w)) * 180.0f / std::numbers::pi_v<float>;
+}
+
+/// <summary>
+/// 残すキーの添え字を求める
+/// 省いたキーの時刻で、残したキーから求めた値と元の値の差が許容誤差以下になるように残す
+/// </summary>
+/// <param name="_times">キーの時刻</param>
+/// <param name="_values">圧縮後に使う値（量子化した値）</param>
+/// <param name="_reference">元の値</param>
+template <typename T, typename Interpolate, typename Error>
+std::vector<uint32_t> ReduceKeys(const std::vector<float>& _times, const std::vector<T>& _values, const std::vector<T>& _reference,
+    bool _isStep, float _tolerance, Interpolate _interpolate, Error _error)
+{
+    uint32_t count = static_cast<uint32_t>(_times.size());
+    std::vector<uint32_t> kept;
+
+    // 全てのキーが最初の値で表せるなら1つにまとめる
+    bool isConstant = true;
+    for (uint32_t index = 0; index < count && isConstant; ++index)
+    {
+        isConstant = _error(_values[0], _reference[index]) <= _tolerance;
+    }
+    if (isConstant || count == 1)
+    {
+        kept.push_back(0);
+        return kept;
+    }
+
+    kept.push_back(0);
+
+    if (_isStep)
+    {
+        // 直前に残したキーの値のままで良ければ省く
+        for (uint32_t index = 1; index < count; ++index)
+        {
+            if (_error(_values[kept.back()], _reference[index]) > _tolerance)
+                kept.push_back(index);
+        }
+        return kept;
+    }
+
+    // 残したキーから区間を伸ばし、間のキーが補間で表せなくなったら1つ前を残す
+    uint32_t start = 0;
+    for (uint32_t end = 2; end < count; ++end)
+    {
+        bool isValid = _times[end] > _times[start];
+        for (uint32_t index = start + 1; index < end && isValid; ++index)
+        {
+            float t = (_times[index] - _times[start]) / (_times[end] - _times[start]);
+            isValid = _error(_interpolate(_values[start], _values[end], t), _reference[index]) <= _tolerance;
+        }
+
+        if (!isValid)
+        {
+            kept.push_back(end - 1);
+            start = end - 1;
+        }
+    }
+    kept.push_back(count - 1);
+
+    return kept;
+}
+
+// 線形補間の区間[_index, _index + 1]として正しいか ModelAnimationと同じ区間を選ぶ
+bool IsLinearSegment(const std::vector<float>& _times, uint32_t _index, float _time)
+{
+    return _index + 1 < _times.size() &&
+        (_index == 0 || _times[_index] < _time) &&
+        _time <= _times[_index + 1];
+}
+
+bool IsStepKey(const std::vector<float>& _times, uint32_t _index, float _time)
+{
+    return _index < _times.size() &&
+        _times[_index] <= _time &&
+        (_index + 1 == _times.size() || _time < _times[_index + 1]);
+}
+
+// _times[0] < _time <= _times.back()であること
+uint32_t FindLinearSegment(const std::vector<float>& _times, float _time, uint32_t& _cursor)
+{
+    if (IsLinearSegment(_times, _cursor, _time))
+        return _cursor;
+
+    if (IsLinearSegment(_times, _cursor + 1, _time))
+        return ++_cursor;
+
+    auto it = std::lower_bound(_times.begin() + 1, _times.end(), _time);
+    _cursor = static_cast<uint32_t>(std::distance(_times.begin(), it)) - 1;
+    return _cursor;
+}
+
+// _times[0] < _timeであること
+uint32_t FindStepKey(const std::vector<float>& _times, float _time, uint32_t& _cursor)
+{
+    if (IsStepKey(_times, _cursor, _time))
+        return _cursor;
+
+    if (IsStepKey(_times, _cursor + 1, _time))
+        return ++_cursor;
+
+    auto it = std::upper_bound(_times.begin(), _times.end(), _time);
+    _cursor = static_cast<uint32_t>(std::distance(_times.begin(), it)) - 1;
+    return _cursor;
+}
+
+template <typename T>
+size_t GetKeyframeBytes(const KeyframeVector<T>& _keyframes)
+{
+    return _keyframes.size() * sizeof(ModelAnimation::Keyframe<T>);
+}
+
+} // namespace
+
+std::shared_ptr<const CompressedAnimationClip> CompressedAnimationClip::Compress(const ModelAnimation::Animation& _source, const ClipCompressionSettings& _settings, ClipCompressionReport* _report)
+{
+    auto clip = std::make_shared<CompressedAnimationClip>();
+    clip->duration_ = _source.duration;
+    clip->channelIndices_ = _source.channelIndices;
+    clip->channels_.resize(_source.channels.size());
+
+    ClipCompressionReport report = {};
+
+    auto lerp = [](const Vector3& _a, const Vector3& _b, float _t) { return Lerp(_a, _b, _t); };
+    auto slerp = [](const Quaternion& _a, const Quaternion& _b, float _t) { return Slerp(_a, _b, _t); };
+
+    // 位置・スケールのトラック
+    auto compressVector3 = [&](const KeyframeVector<Vector3>& _keyframes, bool _isStep, float _tolerance, const Vector3& _default, Track<Vector3>& _out)
+        {
+            ++report.trackCount;
+            report.sourceKeyCount += static_cast<uint32_t>(_keyframes.size());
+            report.sourceBytes += GetKeyframeBytes(_keyframes);
+
+            if (_keyframes.empty())
+            {
+                _out.times = { 0.0f };
+                _out.values = { _default };
+            }
+            else
+            {
+                std::vector<float> times;
+                std::vector<Vector3> values;
+                for (const auto& keyframe : _keyframes)
+                {
+                    times.push_back(keyframe.time);
+                    values.push_back(keyframe.value);
+                }
+
+                for (uint32_t index : ReduceKeys(times, values, values, _isStep, _tolerance, lerp, Vector3Error))
+                {
+                    _out.times.push_back(times[index]);
+                    _out.values.push_back(values[index]);
+                }
+            }
+
+            if (_out.values.size() == 1)
+                ++report.constantTrackCount;
+        };
+
+    // 回転のトラック 量子化した値でキーを省く
+    auto compressRotation = [&](const KeyframeVector<Quaternion>& _keyframes, bool _isStep, float _tolerance, Track<PackedQuaternion>& _out)
+        {
+            ++report.trackCount;
+            report.sourceKeyCount += static_cast<uint32_t>(_keyframes.size());
+            report.sourceBytes += GetKeyframeBytes(_keyframes);
+
+            if (_keyframes.empty())
+            {
+                _out.times = { 0.0f };
+                _out.values = { Pack(Quaternion::Identity()) };
+            }
+            else
+            {
+                std::vector<float> times;
+                std::vector<PackedQuaternion> packed;
+                std::vector<Quaternion> quantized;
+                std::vector<Quaternion> reference;
+                for (const auto& keyframe : _keyframes)
+                {
+                    times.push_back(keyframe.time);
+                    packed.push_back(Pack(keyframe.value));
+                    quantized.push_back(Unpack(packed.back()));
+                    reference.push_back(keyframe.value);
+                }
+
+                for (uint32_t index : ReduceKeys(times, quantized, reference, _isStep, _tolerance, slerp, RotationError))
+                {
+                    _out.times.push_back(times[index]);
+                    _out.values.push_back(packed[index]);
+                }
+            }
+
+            if (_out.values.size() == 1)
+                ++report.constantTrackCount;
+        };
+
+    for (size_t channelIndex = 0; channelIndex < _source.channels.size(); ++channelIndex)
+    {
+        const ModelAnimation::NodeAnimation& source = _source.channels[channelIndex];
+        Channel& channel = clip->channels_[channelIndex];
+
+        channel.interpolation = source.interpolation;
+        bool isStep = source.interpolation == ModelAnimation::InterpolationType::Step;
+
+        compressVector3(source.translate.keyframes, isStep, _settings.translationTolerance, Vector3(0.0f, 0.0f, 0.0f), channel.translate);
+        compressRotation(source.rotation.keyframes, isStep, _settings.rotationTolerance, channel.rotation);
+        compressVector3(source.scale.keyframes, isStep, _settings.scaleTolerance, Vector3(1.0f, 1.0f, 1.0f), channel.scale);
+
+        report.compressedKeyCount += static_cast<uint32_t>(channel.translate.values.size() + channel.rotation.values.size() + channel.scale.values.size());
+    }
+    report.compressedBytes = clip->GetMemorySize();
+
+    // 元のキーの時刻とその中間で、元のクリップとの誤差を測る
+    if (_report)
+    {
+        for (size_t channelIndex = 0; channelIndex < _source.channels.size(); ++channelIndex)
+        {
+            const ModelAnimation::NodeAnimation& source = _source.channels[channelIndex];
+            if (source.translate.keyframes.empty() || source.rotation.keyframes.empty() || source.scale.keyframes.empty())
+                continue;
+
+            std::vector<float> times;
+            auto addTimes = [&times](const auto& _keyframes)
+                {
+                    for (size_t index = 0; index < _keyframes.size(); ++index)
+                    {
+                        times.push_back(_keyframes[index].time);
+                        if (index + 1 < _keyframes.size())
+                            times.push_back((_keyframes[index].time + _keyframes[index + 1].time) * 0.5f);
+                    }
+                };
+            addTimes(source.translate.keyframes);
+            addTimes(source.rotation.keyframes);
+            addTimes(source.scale.keyframes);
+            std::sort(times.begin(), times.end());
+            times.erase(std::unique(times.begin(), times.end()), times.end());
+
+            ModelAnimation::KeyframeCursor sourceCursor = {};
+            ModelAnimation::KeyframeCursor compressedCursor = {};
+            for (float time : times)
+            {
+                QuaternionTransform expected = ModelAnimation::Evaluate(source, time, sourceCursor);
+                QuaternionTransform actual = clip->Sample(static_cast<uint32_t>(channelIndex), time, compressedCursor);
+
+                report.maxTranslationError = std::max(report.maxTranslationError, Vector3Error(expected.translate, actual.translate));
+                report.maxRotationError = std::max(report.maxRotationError, RotationError(expected.rotation, actual.rotation));
+                report.maxScaleError = std::max(report.maxScaleError, Vector3Error(expected.scale, actual.scale));
+            }
+        }
+
+        *_report = report;
+    }
+
+    return clip;
+}
+
+QuaternionTransform CompressedAnimationClip::Sample(uint32_t _channelIndex, float _time, ModelAnimation::KeyframeCursor& _cursor) const
+{
+    assert(_channelIndex < channels_.size());
+    const Channel& channel = channels_[_channelIndex];
+
+    QuaternionTransform transform = {};
+    transform.translate = SampleVector3(channel.translate, channel.interpolation, _time, _cursor.translate);
+    transform.rotation = SampleRotation(channel.rotation, channel.interpolation, _time, _cursor.rotation);
+    transform.scale = SampleVector3(channel.scale, channel.interpolation, _time, _cursor.scale);
+    return transform;
+}
+
+size_t CompressedAnimationClip::GetMemorySize() const
+{
+    size_t size = 0;
+    for (const Channel& channel : channels_)
+    {
+        size += channel.translate.times.size() * sizeof(float) + channel.translate.values.size() * sizeof(Vector3);
+        size += channel.rotation.times.size() * sizeof(float) + channel.rotation.values.size() * sizeof(PackedQuaternion);
+        size += channel.scale.times.size() * sizeof(float) + channel.scale.values.size() * sizeof(Vector3);
+    }
+    return size;
+}
+
+CompressedAnimationClip::PackedQuaternion CompressedAnimationClip::Pack(const Quaternion& _rotation)
+{
+    Quaternion rotation = _rotation.Normalize();
+    float components[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+    // 絶対値が最大の成分を除く qと-qは同じ回転なので、最大の成分が正になるようにする
+    uint32_t largest = 0;
+    for (uint32_t index = 1; index < 4; ++index)
+    {
+        if (std::abs(components[index]) > std::abs(components[largest]))
+            largest = index;
+    }
+    float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    uint64_t bits = static_cast<uint64_t>(largest) << 45;
+    int32_t shift = 30;
+    for (uint32_t index = 0; index < 4; ++index)
+    {
+        if (index == largest)
+            continue;
+
+        float normalized = std::clamp((components[index] * sign / kComponentRange + 1.0f) * 0.5f, 0.0f, 1.0f);
+        uint64_t quantized = static_cast<uint64_t>(std::lround(normalized * kQuantizeMax));
+        bits |= quantized << shift;
+        shift -= 15;
+    }
+
+    PackedQuaternion packed = {};
+    packed.bits[0] = static_cast<uint16_t>(bits);
+    packed.bits[1] = static_cast<uint16_t>(bits >> 16);
+    packed.bits[2] = static_cast<uint16_t>(bits >> 32);
+    return packed;
+}
+
+Quaternion CompressedAnimationClip::Unpack(const PackedQuaternion& _packed)
+{
+    uint64_t bits = static_cast<uint64_t>(_packed.bits[0]) | (static_cast<uint64_t>(_packed.bits[1]) << 16) | (static_cast<uint64_t>(_packed.bits[2]) << 32);
+    uint32_t largest = static_cast<uint32_t>(bits >> 45) & 0x3;
+
+    float components[4] = {};
+    float sumOfSquares = 0.0f;
+    int32_t shift = 30;
+    for (uint32_t index = 0; index < 4; ++index)
+    {
+        if (index == largest)
+            continue;
+
+        float normalized = static_cast<float>((bits >> shift) & 0x7FFF) / kQuantizeMax;
+        components[index] = (normalized * 2.0f - 1.0f) * kComponentRange;
+        sumOfSquares += components[index] * components[index];
+        shift -= 15;
+    }
+    components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+
+    return Quaternion(components[0], components[1], components[2], components[3]);
+}
+
+Vector3 CompressedAnimationClip::SampleVector3(const Track<Vector3>& _track, ModelAnimation::InterpolationType _interpolation, float _time, uint32_t& _cursor) const
+{
+    const std::vector<float>& times = _track.times;
+    if (times.size() == 1 || _time <= times[0])
+        return _track.values[0];
+
+    if (_interpolation == ModelAnimation::InterpolationType::Step)
+        return _track.values[FindStepKey(times, _time, _cursor)];
+
+    if (_time > times.back())
+        return _track.values.back();
+
+    uint32_t index = FindLinearSegment(times, _time, _cursor);
+    float t = (_time - times[index]) / (times[index + 1] - times[index]);
+    return Lerp(_track.values[index], _track.values[index + 1], t);
+}
+
+Quaternion CompressedAnimationClip::SampleRotation(const Track<PackedQuaternion>& _track, ModelAnimation::InterpolationType _interpolation, float _time, uint32_t& _cursor) const
+{
+    const std::vector<float>& times = _track.times;
+    if (times.size() == 1 || _time <= times[0])
+        return Unpack(_track.values[0]);
+
+    if (_interpolation == ModelAnimation::InterpolationType::Step)
+        return Unpack(_track.values[FindStepKey(times, _time, _cursor)]);
+
+    if (_time > times.back())
+        return Unpack(_track.values.back());
+
+    uint32_t index = FindLinearSegment(times, _time, _cursor);
+    float t = (_time - times[index]) / (times[index + 1] - times[index]);
+    return Slerp(Unpack(_track.values[index]), Unpack(_track.values[index + 1]), t);
+}
+
+} // namespace Engine
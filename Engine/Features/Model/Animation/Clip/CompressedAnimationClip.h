@@ -0,0 +1,102 @@
+#pragma once
+
+#include <Features/Model/Animation/ModelAnimation.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace Engine {
+
+// クリップを圧縮するときの許容誤差
+struct ClipCompressionSettings
+{
+    float translationTolerance = 0.0005f;   // 位置の許容誤差
+    float rotationTolerance = 0.05f;        // 回転の許容誤差(度)
+    float scaleTolerance = 0.0005f;         // スケールの許容誤差
+};
+
+// 圧縮の結果
+struct ClipCompressionReport
+{
+    std::string clipName;                   // クリップの名前
+    uint32_t trackCount = 0;                // トラックの数（チャンネル毎に位置・回転・スケール）
+    uint32_t constantTrackCount = 0;        // 1つの値にまとめたトラックの数
+    uint32_t sourceKeyCount = 0;            // 元のキーフレーム数
+    uint32_t compressedKeyCount = 0;        // 圧縮後のキーフレーム数
+    size_t sourceBytes = 0;                 // 元のキーフレームの容量
+    size_t compressedBytes = 0;             // 圧縮後のキーフレームの容量
+    float maxTranslationError = 0.0f;       // 位置の最大誤差
+    float maxRotationError = 0.0f;          // 回転の最大誤差(度)
+    float maxScaleError = 0.0f;             // スケールの最大誤差
+};
+
+/// <summary>
+/// 圧縮したアニメーションクリップ
+/// 許容誤差内で省けるキーを省き、全キーが許容誤差内のトラックは1つの値にまとめ、
+/// 回転は最大の成分を除いた3成分を15bitずつにして6byteで持つ
+/// 生成後は変更しないので、複数の再生で共有して使う
+/// チャンネルの並びと名前は元のクリップと同じ
+/// </summary>
+class CompressedAnimationClip
+{
+public:
+    CompressedAnimationClip() = default;
+    ~CompressedAnimationClip() = default;
+
+    /// <summary>
+    /// クリップを圧縮する
+    /// </summary>
+    /// <param name="_source">元のクリップ</param>
+    /// <param name="_settings">許容誤差</param>
+    /// <param name="_report">圧縮の結果の書き込み先 不要ならnullptr</param>
+    static std::shared_ptr<const CompressedAnimationClip> Compress(const ModelAnimation::Animation& _source, const ClipCompressionSettings& _settings, ClipCompressionReport* _report = nullptr);
+
+    // チャンネルを時刻_timeでサンプリングする _cursorは前回の区間で、求めた区間に更新される
+    QuaternionTransform Sample(uint32_t _channelIndex, float _time, ModelAnimation::KeyframeCursor& _cursor) const;
+
+    float GetDuration() const { return duration_; }
+    uint32_t GetChannelCount() const { return static_cast<uint32_t>(channels_.size()); }
+    const std::map<std::string, uint32_t>& GetChannelIndices() const { return channelIndices_; }
+
+    // キーフレームの容量
+    size_t GetMemorySize() const;
+
+private:
+    // 最大の成分を除いた3成分を量子化した回転
+    struct PackedQuaternion
+    {
+        uint16_t bits[3];
+    };
+
+    // 要素毎にキーの時刻と値を持つトラック キーが1つなら一定の値
+    template <typename T>
+    struct Track
+    {
+        std::vector<float> times;
+        std::vector<T> values;
+    };
+
+    struct Channel
+    {
+        Track<Vector3> translate;
+        Track<PackedQuaternion> rotation;
+        Track<Vector3> scale;
+        ModelAnimation::InterpolationType interpolation = ModelAnimation::InterpolationType::Linear;
+    };
+
+    static PackedQuaternion Pack(const Quaternion& _rotation);
+    static Quaternion Unpack(const PackedQuaternion& _packed);
+
+    Vector3 SampleVector3(const Track<Vector3>& _track, ModelAnimation::InterpolationType _interpolation, float _time, uint32_t& _cursor) const;
+    Quaternion SampleRotation(const Track<PackedQuaternion>& _track, ModelAnimation::InterpolationType _interpolation, float _time, uint32_t& _cursor) const;
+
+    float duration_ = 0.0f;
+    std::vector<Channel> channels_;
+    std::map<std::string, uint32_t> channelIndices_;
+};
+
+} // namespace Engine
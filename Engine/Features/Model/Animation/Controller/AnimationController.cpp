@@ -1,15 +1,23 @@
 #include "AnimationController.h"
 
 #include <Features/Model/Model.h>
+#include <Math/MyLib.h>
+
+#include <algorithm>
+#include <limits>
 
 
 namespace Engine {
 
+uint32_t AnimationController::instanceCount_ = 0;
+AnimationLODFrameStats AnimationController::lodFrameStats_ = {};
+
 AnimationController::AnimationController(Model* _model) :
     model_(_model),
     skeleton_(),
     currentAnimation_(),
-    skinCluster_()
+    skinCluster_(),
+    lodFramesSinceUpdate_(instanceCount_++ % 4)
 {
 }
 
@@ -43,31 +51,93 @@ void AnimationController::Initialize(ID3D12PipelineState* _computePipeline, ID3D
 
     currentAnimation_ = std::make_unique<ModelAnimation>();
     currentAnimation_->Initialize();
+    currentAnimation_->Bind(skeleton_.GetJoints());
 
 
     skeleton_.Update();
-    skinCluster_.Update(skeleton_.GetJoints());
+    skinCluster_.Update(skeleton_.GetPose());
     if (skinningCS_)
         skinningCS_->Execute();
 }
 
 void AnimationController::Update(float _deltaTime)
 {
-    if (!model_ || !currentAnimation_)
+    if (!model_)
         return;
 
-    currentAnimation_->Update(skeleton_.GetJoints(), _deltaTime);
+    UpdateLODLevel();
+
+    uint32_t jointCount = static_cast<uint32_t>(skeleton_.GetJoints().size());
+    lodStats_.jointCount = jointCount;
+    lodStats_.evaluatedJointCount = 0;
+    ++lodFrameStats_.updateCount;
+    lodFrameStats_.jointCount += jointCount;
+
+    // 間引くフレームは経過時間をためておき、次に求めるときにまとめて進める
+    // 更新を始めるフレームはインスタンス毎にずらしてあるので、同じフレームに集中しない
+    uint32_t interval = lodStats_.updateInterval;
+    lodAccumulatedTime_ += _deltaTime;
+    ++lodFramesSinceUpdate_;
+    if (lodFramesSinceUpdate_ < interval)
+    {
+        if (hasLODPose_)
+        {
+            InterpolateLODPose(static_cast<float>(lodFramesSinceUpdate_) / static_cast<float>(interval));
+            UpdateSkinning();
+        }
+        return;
+    }
+
+    float deltaTime = lodAccumulatedTime_;
+    lodAccumulatedTime_ = 0.0f;
+    lodFramesSinceUpdate_ = 0;
+
+    bool isEvaluated = false;
+    if (blendTree_ && isBlendTreeEnabled_ && blendTree_->HasLayer())
+    {
+        blendTree_->Update(deltaTime);
+        blendTree_->Apply(skeleton_.GetJoints());
+        lodStats_.evaluatedJointCount = blendTree_->GetEvaluatedJointCount();
+        isEvaluated = true;
+    }
+    else
+    {
+        isEvaluated = EvaluateAnimation(deltaTime);
+    }
 
     // アニメーションが終わったらアニメーションを解除
-    if (!currentAnimation_->IsPlaying())
+    if (!isEvaluated)
     {
+        hasLODPose_ = false;
         return;
     }
 
-    skeleton_.Update();
-    skinCluster_.Update(skeleton_.GetJoints());
-    if (skinningCS_)
-        skinningCS_->Execute();
+    ++lodFrameStats_.evaluatedCount;
+    lodFrameStats_.evaluatedJointCount += lodStats_.evaluatedJointCount;
+
+    // 補間するときは、求めた姿勢を終わり、前回求めた姿勢を始まりとする
+    if (interval > 1 && lodSettings_.isInterpolated)
+    {
+        const std::vector<Joint>& joints = skeleton_.GetJoints();
+
+        std::swap(lodFromPose_, lodToPose_);
+        lodToPose_.resize(joints.size());
+        for (size_t index = 0; index < joints.size(); ++index)
+        {
+            lodToPose_[index] = joints[index].GetTransform();
+        }
+        if (!hasLODPose_ || lodFromPose_.size() != lodToPose_.size())
+            lodFromPose_ = lodToPose_;
+
+        hasLODPose_ = true;
+        InterpolateLODPose(0.0f);
+    }
+    else
+    {
+        hasLODPose_ = false;
+    }
+
+    UpdateSkinning();
 }
 
 void AnimationController::SetAnimation(const std::string& _name, bool _loop)
@@ -84,7 +154,7 @@ void AnimationController::SetAnimation(const std::string& _name, bool _loop)
         return;
 
     currentAnimation_->Reset();
-    currentAnimation_->SetAnimation(animation->GetAnimation());
+    currentAnimation_->SetAnimation(animation->GetAnimation(), animation->GetCompressedClip());
     currentAnimation_->SetLoop(_loop);
     currentAnimation_->Update(skeleton_.GetJoints(), 0.0f);
 }
@@ -102,7 +172,7 @@ void AnimationController::ChangeAnimation(const std::string& _name, float _blend
         return;
 
     currentAnimation_->Reset();
-    currentAnimation_->ChangeAnimation(animation->GetAnimation(), _blendTime);
+    currentAnimation_->ChangeAnimation(animation->GetAnimation(), _blendTime, animation->GetCompressedClip());
     currentAnimation_->SetLoop(_loop);
 }
 
@@ -138,6 +208,10 @@ const Matrix4x4* AnimationController::GetSkeletonSpaceMatrix(uint32_t _index) co
 
 bool AnimationController::IsAnimationPlaying() const
 {
+    // ブレンドツリーはSetAnimationを呼ばなくても再生する
+    if (blendTree_ && isBlendTreeEnabled_ && blendTree_->HasLayer())
+        return true;
+
     return currentAnimation_ && currentAnimation_->IsPlaying();
 }
 
@@ -146,12 +220,181 @@ const Matrix4x4* AnimationController::GetSkeletonSpaceMatrix(const std::string&
     return skeleton_.GetSkeletonSpaceMatrix(_name);
 }
 
+AnimationBlendTree* AnimationController::EnableBlendTree()
+{
+    if (!blendTree_)
+    {
+        blendTree_ = std::make_unique<AnimationBlendTree>();
+        blendTree_->Initialize(skeleton_.GetJoints());
+
+        // 既にジョイントを絞っていればツリーにも合わせる
+        if (lodStats_.isReducedJoints)
+            blendTree_->SetJointMask(CreateJointMask(lodMaskDepth_));
+    }
+
+    isBlendTreeEnabled_ = true;
+    return blendTree_.get();
+}
+
+uint32_t AnimationController::AddBlendTreeClip(const std::string& _name, bool _loop, float _speed)
+{
+    if (!model_ || !blendTree_)
+        return AnimationBlendTree::kInvalidIndex;
+
+    auto animation = model_->GetAnimation(_name);
+    if (!animation || (!animation->GetAnimation() && !animation->GetCompressedClip()))
+        return AnimationBlendTree::kInvalidIndex;
+
+    return blendTree_->AddClip(animation->GetAnimation(), animation->GetCompressedClip(), _loop, _speed);
+}
+
+void AnimationController::SetLODDistance(float _distance, bool _isVisible)
+{
+    lodDistance_ = _distance;
+    lodIsVisible_ = _isVisible;
+}
+
+AnimationLODFrameStats AnimationController::TakeLODFrameStats()
+{
+    AnimationLODFrameStats stats = lodFrameStats_;
+    lodFrameStats_ = {};
+    return stats;
+}
+
+void AnimationController::UpdateLODLevel()
+{
+    uint32_t interval = 1;
+    bool isReduced = false;
+
+    if (lodSettings_.isEnabled)
+    {
+        // 画面外は最も遠いものとして扱う
+        float distance = lodIsVisible_ ? lodDistance_ : (std::numeric_limits<float>::max)();
+
+        if (distance >= lodSettings_.quarterRateDistance)
+            interval = 4;
+        else if (distance >= lodSettings_.halfRateDistance)
+            interval = 2;
+
+        isReduced = distance >= lodSettings_.reducedJointDistance;
+    }
+
+    lodStats_.updateInterval = interval;
+    lodStats_.distance = lodDistance_;
+    lodStats_.isVisible = lodIsVisible_;
+
+    if (isReduced == lodStats_.isReducedJoints && (!isReduced || lodMaskDepth_ == lodSettings_.reducedJointDepth))
+        return;
+
+    // 補間用の姿勢は変更前のマスクで求めたものなので使わない
+    hasLODPose_ = false;
+
+    if (isReduced)
+    {
+        std::vector<uint8_t> mask = CreateJointMask(lodSettings_.reducedJointDepth);
+
+        // 求めないジョイントはバインドポーズにする
+        std::vector<Joint>& joints = skeleton_.GetJoints();
+        for (size_t index = 0; index < joints.size(); ++index)
+        {
+            if (!mask[index])
+                joints[index].SetTransform(joints[index].GetIdleTransform());
+        }
+
+        // 単体のアニメーションとブレンドツリーのどちらで動かしても同じマスクを使う
+        if (blendTree_)
+            blendTree_->SetJointMask(mask);
+        if (currentAnimation_)
+            currentAnimation_->SetJointMask(std::move(mask));
+        lodMaskDepth_ = lodSettings_.reducedJointDepth;
+    }
+    else
+    {
+        if (blendTree_)
+            blendTree_->SetJointMask({});
+        if (currentAnimation_)
+            currentAnimation_->SetJointMask({});
+    }
+
+    lodStats_.isReducedJoints = isReduced;
+}
+
+bool AnimationController::EvaluateAnimation(float _deltaTime)
+{
+    if (!currentAnimation_)
+        return false;
+
+    currentAnimation_->Update(skeleton_.GetJoints(), _deltaTime);
+    lodStats_.evaluatedJointCount = currentAnimation_->GetEvaluatedJointCount();
+
+    return currentAnimation_->IsPlaying();
+}
+
+void AnimationController::UpdateSkinning()
+{
+    skeleton_.Update();
+    skinCluster_.Update(skeleton_.GetPose());
+    if (skinningCS_)
+        skinningCS_->Execute();
+}
+
+void AnimationController::InterpolateLODPose(float _t)
+{
+    std::vector<Joint>& joints = skeleton_.GetJoints();
+
+    size_t count = (std::min)({ joints.size(), lodFromPose_.size(), lodToPose_.size() });
+    for (size_t index = 0; index < count; ++index)
+    {
+        const QuaternionTransform& from = lodFromPose_[index];
+        const QuaternionTransform& to = lodToPose_[index];
+
+        QuaternionTransform transform = {};
+        transform.translate = Lerp(from.translate, to.translate, _t);
+        transform.rotation = Slerp(from.rotation, to.rotation, _t);
+        transform.scale = Lerp(from.scale, to.scale, _t);
+        joints[index].SetTransform(transform);
+    }
+}
+
+std::vector<uint8_t> AnimationController::CreateJointMask(uint32_t _depth)
+{
+    const std::vector<Joint>& joints = skeleton_.GetJoints();
+
+    // 親は子より前に並んでいる
+    std::vector<uint32_t> depths(joints.size(), 0);
+    std::vector<uint8_t> mask(joints.size(), 0);
+    for (size_t index = 0; index < joints.size(); ++index)
+    {
+        int32_t parent = joints[index].GetParentIndex();
+        depths[index] = parent < 0 ? 0 : depths[parent] + 1;
+        mask[index] = depths[index] <= _depth ? 1 : 0;
+    }
+    return mask;
+}
+
 void AnimationController::ImGui()
 {
 #ifdef _DEBUG
 
     skeleton_.ImGui();
 
+    if (ImGui::TreeNode("Animation LOD"))
+    {
+        ImGui::Checkbox("Enabled", &lodSettings_.isEnabled);
+        ImGui::DragFloat("Half Rate Distance", &lodSettings_.halfRateDistance, 0.5f, 0.0f, 1000.0f);
+        ImGui::DragFloat("Quarter Rate Distance", &lodSettings_.quarterRateDistance, 0.5f, 0.0f, 1000.0f);
+        ImGui::DragFloat("Reduced Joint Distance", &lodSettings_.reducedJointDistance, 0.5f, 0.0f, 1000.0f);
+        int reducedJointDepth = static_cast<int>(lodSettings_.reducedJointDepth);
+        if (ImGui::DragInt("Reduced Joint Depth", &reducedJointDepth, 0.1f, 0, 64))
+            lodSettings_.reducedJointDepth = static_cast<uint32_t>(reducedJointDepth);
+        ImGui::Checkbox("Interpolate", &lodSettings_.isInterpolated);
+
+        ImGui::Text("Distance: %.1f (%s)", lodStats_.distance, lodStats_.isVisible ? "visible" : "off-screen");
+        ImGui::Text("Update: every %u frame(s)%s", lodStats_.updateInterval, lodStats_.isReducedJoints ? " / reduced joints" : "");
+        ImGui::Text("Evaluated Joints: %u / %u", lodStats_.evaluatedJointCount, lodStats_.jointCount);
+        ImGui::TreePop();
+    }
+
 
 #endif // _DEBUG
 }
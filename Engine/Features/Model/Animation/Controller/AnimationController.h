@@ -6,6 +6,8 @@
 #include <Features/Model/Animation/SkinCluster/SkinCluster.h>
 #include <Features/Model/Animation/Skeleton/Skeleton.h>
 #include <Features/Model/Animation/SkinningCS.h>
+#include <Features/Model/Animation/Blend/AnimationBlendTree.h>
+#include <Features/Model/Animation/LOD/AnimationLOD.h>
 
 #include <memory>
 #include <utility>
@@ -51,15 +53,52 @@ public:
     // margedMeshを取得
     MargedMesh* GetMargedMesh() const { return margedMesh_.get(); }
 
-    // アニメーションが再生中かどうか
+    // アニメーションが再生中かどうか 有効なブレンドツリーにレイヤーがあれば再生中とする
     bool IsAnimationPlaying() const;
 
     const Matrix4x4* GetSkeletonSpaceMatrix(const std::string& _name) const;
 
+    // ブレンドツリーを有効にする 有効な間はSetAnimationで設定したアニメーションより優先する
+    AnimationBlendTree* EnableBlendTree();
+    // ブレンドツリーを無効にする 組んだノードとレイヤーは残る
+    void DisableBlendTree() { isBlendTreeEnabled_ = false; }
+    AnimationBlendTree* GetBlendTree() const { return blendTree_.get(); }
+
+    // モデルが持つアニメーションをブレンドツリーにクリップのノードとして追加する 戻り値はノードの添え字
+    uint32_t AddBlendTreeClip(const std::string& _name, bool _loop = true, float _speed = 1.0f);
+
+    // === LOD ===
+
+    void SetLODSettings(const AnimationLODSettings& _settings) { lodSettings_ = _settings; }
+    const AnimationLODSettings& GetLODSettings() const { return lodSettings_; }
+
+    // カメラからの距離と画面内かを設定する 次のUpdateで更新の頻度と求めるジョイントを決める
+    void SetLODDistance(float _distance, bool _isVisible = true);
+
+    const AnimationLODStats& GetLODStats() const { return lodStats_; }
+
+    // 前回の呼び出しからの全AnimationControllerの集計を取得し、集計をリセットする
+    static AnimationLODFrameStats TakeLODFrameStats();
+
     void ImGui();
     
 private:
 
+    // LODの段階を決め、求めるジョイントを変える
+    void UpdateLODLevel();
+
+    // アニメーションを_deltaTime進めてジョイントに設定する 再生していなければfalse
+    bool EvaluateAnimation(float _deltaTime);
+
+    // スケルトンとパレットを更新してスキニングする
+    void UpdateSkinning();
+
+    // 更新しないフレームの姿勢を補間する
+    void InterpolateLODPose(float _t);
+
+    // ルートからの深さが_depth以下のジョイントを1としたマスク
+    std::vector<uint8_t> CreateJointMask(uint32_t _depth);
+
     Model* model_ = nullptr;
 
     std::unique_ptr<MargedMesh> margedMesh_ = nullptr;
@@ -72,6 +111,23 @@ private:
 
     std::unique_ptr<SkinningCS> skinningCS_ = nullptr;
 
+    std::unique_ptr<AnimationBlendTree> blendTree_ = nullptr;
+    bool isBlendTreeEnabled_ = false;
+
+    AnimationLODSettings lodSettings_ = {};
+    AnimationLODStats lodStats_ = {};
+    float lodDistance_ = 0.0f;
+    bool lodIsVisible_ = true;
+    uint32_t lodFramesSinceUpdate_ = 0;     // 最後にアニメーションを求めてからのフレーム数
+    float lodAccumulatedTime_ = 0.0f;       // 更新しなかったフレームの経過時間
+    std::vector<QuaternionTransform> lodFromPose_;  // 補間の始まりの姿勢
+    std::vector<QuaternionTransform> lodToPose_;    // 補間の終わりの姿勢（最後に求めた姿勢）
+    bool hasLODPose_ = false;
+    uint32_t lodMaskDepth_ = 0;                     // 今のマスクを作ったときの深さ
+
+    static uint32_t instanceCount_;                 // 更新するフレームを散らすのに使う
+    static AnimationLODFrameStats lodFrameStats_;
+
 };
 
 } // namespace Engine
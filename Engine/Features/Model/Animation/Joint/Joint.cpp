@@ -1,6 +1,7 @@
 #include <Features/Model/Animation/Joint/Joint.h>
 
 #include <Features/Model/Animation/Node/Node.h>
+#include <Features/Model/Animation/Skeleton/SkeletonPose.h>
 #include <Math/Matrix/MatrixFunction.h>
 #include <Features/LineDrawer/LineDrawer.h>
 #include <Math/Vector/VectorFunction.h>
@@ -12,23 +13,9 @@ void Joint::Initialize()
 {
 }
 
-void Joint::Update(std::vector<Joint>& _joints)
+void Joint::Draw(const Matrix4x4& _wMat, const SkeletonPose& _pose)
 {
-    localMatrix_ = MakeAffineMatrix(transform_.scale, transform_.rotation, transform_.translate);
-    if (parentIndex_)
-    {
-        SkeletonSpcaceMatrix_ = localMatrix_ * _joints[*parentIndex_].SkeletonSpcaceMatrix_;
-    }
-    else
-    {
-        SkeletonSpcaceMatrix_ = localMatrix_;
-    }
-}
-
-
-void Joint::Draw(const Matrix4x4& _wMat, std::vector <Joint>& _joints)
-{
-    Matrix4x4 wMat = SkeletonSpcaceMatrix_ * _wMat;
+    Matrix4x4 wMat = _pose.GetSkeletonSpaceMatrix(index_) * _wMat;
     static Matrix4x4 sMat = MakeScaleMatrix({ 0.1f,0.1f ,0.1f });
 
     Vector4 color = openTree_ ? Vector4{ 1,0,0,1 } : Vector4{ 1,1,1,1 };
@@ -37,7 +24,7 @@ void Joint::Draw(const Matrix4x4& _wMat, std::vector <Joint>& _joints)
     Vector3 pos = Transform({ 0,0,0 }, wMat);
     for (int32_t childIndex : children_)
     {
-        Vector3 childPos = Transform({ 0,0,0 }, _joints[childIndex].SkeletonSpcaceMatrix_ * _wMat);
+        Vector3 childPos = Transform({ 0,0,0 }, _pose.GetSkeletonSpaceMatrix(childIndex) * _wMat);
         LineDrawer::GetInstance()->RegisterPoint(pos, childPos, color, true);
     }
 }
@@ -46,8 +33,6 @@ int32_t Joint::CreateJoint(const Node& _node, const std::optional<int32_t>& _par
 {
     Joint joint = {};
     joint.name_ = _node.name_;
-    joint.localMatrix_ = _node.GetLocalMatrix();
-    joint.SkeletonSpcaceMatrix_ = MakeIdentity4x4();
     joint.transform_ = _node.transform_;
     joint.idleTransform_ = joint.transform_;
     joint.index_ = static_cast<int32_t>(_joints.size());
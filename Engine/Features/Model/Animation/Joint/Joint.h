@@ -12,6 +12,7 @@
 namespace Engine {
 
 class Node;
+class SkeletonPose;
 class Joint
 {
 public:
@@ -20,16 +21,16 @@ public:
     ~Joint() = default;
 
     void Initialize();
-    void Update(std::vector<Joint>& _joints);
-    void Draw(const Matrix4x4& _wMat, std::vector <Joint>& _joints);
+    void Draw(const Matrix4x4& _wMat, const SkeletonPose& _pose);
     static int32_t CreateJoint(const Node& _node, const std::optional<int32_t>& _parent, std::vector<Joint>& _joints);
 
     void SetTransform(const QuaternionTransform& _transform) { transform_ = _transform; }
-    const Matrix4x4* GetSkeletonSpaceMatrix() const { return (&SkeletonSpcaceMatrix_); }
     QuaternionTransform GetTransform() const { return transform_; }
     QuaternionTransform GetIdleTransform() const { return idleTransform_; }
 
     const std::vector<int32_t>& GetChildren() const { return children_; }
+    // 親の添え字 ルートは-1
+    int32_t GetParentIndex() const { return parentIndex_.value_or(-1); }
 
 #ifdef _DEBUG
     void ImGui(std::unordered_map<std::string, int32_t>& _map, int32_t indent);
@@ -39,8 +40,6 @@ public:
     int32_t index_ = 0;
 private:
     QuaternionTransform transform_ = {};
-    Matrix4x4 localMatrix_ = {};
-    Matrix4x4 SkeletonSpcaceMatrix_ = {};
     std::vector<int32_t> children_ = {};
     std::optional<int32_t> parentIndex_ = {};
 
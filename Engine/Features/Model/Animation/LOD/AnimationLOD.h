@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace Engine {
+
+/// <summary>
+/// アニメーションLODの設定
+/// カメラからの距離で更新の頻度と求めるジョイントを減らす 画面外は最も遠いものとして扱う
+/// </summary>
+struct AnimationLODSettings
+{
+    bool isEnabled = false;
+    float halfRateDistance = 20.0f;         // これ以上離れると2フレームに1回更新する
+    float quarterRateDistance = 40.0f;      // これ以上離れると4フレームに1回更新する
+    float reducedJointDistance = 30.0f;     // これ以上離れるとルートから近いジョイントだけを求める
+    uint32_t reducedJointDepth = 3;         // 求めるジョイントの深さ（ルートが0） より深いジョイントはバインドポーズ
+    bool isInterpolated = true;             // 更新しないフレームは直前の2回の姿勢を補間する（1回分遅れる）
+};
+
+// AnimationController毎のLODの状態
+struct AnimationLODStats
+{
+    uint32_t updateInterval = 1;            // 何フレームに1回更新するか
+    bool isReducedJoints = false;           // 求めるジョイントを減らしているか
+    bool isVisible = true;                  // 画面内か
+    float distance = 0.0f;                  // カメラからの距離
+    uint32_t evaluatedJointCount = 0;       // 直前のUpdateでアニメーションを求めたジョイント数
+    uint32_t jointCount = 0;                // ジョイント数
+};
+
+// 全AnimationControllerの集計
+struct AnimationLODFrameStats
+{
+    uint32_t updateCount = 0;               // Updateを呼んだ数
+    uint32_t evaluatedCount = 0;            // アニメーションを求めた数
+    uint32_t evaluatedJointCount = 0;       // アニメーションを求めたジョイント数
+    uint32_t jointCount = 0;                // Updateを呼んだスケルトンのジョイント数の合計
+};
+
+} // namespace Engine
@@ -1,28 +1,139 @@
 #include <Features/Model/Animation/ModelAnimation.h>
 #include <Math/MyLib.h>
 #include <Features/Model/Animation/Joint/Joint.h>
+#include <Features/Model/Animation/Clip/CompressedAnimationClip.h>
 #include <Features/Json/Loader/JsonFileIO.h>
 #include <Debug/ImGuiManager.h>
 
 #include <assimp/scene.h>
 
+#include <algorithm>
 #include <fstream>
 #include <cassert>
 
 
 namespace Engine {
 
+namespace {
+
+template <typename T>
+using KeyframeVector = std::vector<ModelAnimation::Keyframe<T>>;
+
+// 線形補間の区間[_index, _index + 1]として正しいか
+// 先頭から探した場合と同じく、keyframes[_index + 1].time >= _timeとなる最初の区間のみ正しいとする
+template <typename T>
+bool IsLinearSegment(const KeyframeVector<T>& _keyframes, uint32_t _index, float _time)
+{
+    return _index + 1 < _keyframes.size() &&
+        (_index == 0 || _keyframes[_index].time < _time) &&
+        _time <= _keyframes[_index + 1].time;
+}
+
+// ステップ補間のキーとして正しいか（_time以前で最後のキー）
+template <typename T>
+bool IsStepKey(const KeyframeVector<T>& _keyframes, uint32_t _index, float _time)
+{
+    return _index < _keyframes.size() &&
+        _keyframes[_index].time <= _time &&
+        (_index + 1 == _keyframes.size() || _time < _keyframes[_index + 1].time);
+}
+
+template <typename T, typename Interpolate>
+T SampleLinear(const ModelAnimation::AnimationCurve<T>& _curve, float _time, uint32_t& _cursor, Interpolate _interpolate)
+{
+    const KeyframeVector<T>& keyframes = _curve.keyframes;
+    assert(!keyframes.empty());
+
+    // キーが一つか最初のキーフレームより前
+    if (keyframes.size() == 1 || _time <= keyframes[0].time)
+    {
+        return keyframes[0].value;
+    }
+
+    // 最後のキーフレームより後
+    if (_time > keyframes.back().time)
+    {
+        return keyframes.back().value;
+    }
+
+    // 前回の区間かその次の区間なら探さない 外れていれば（シークやループ）二分探索
+    if (!IsLinearSegment(keyframes, _cursor, _time))
+    {
+        if (IsLinearSegment(keyframes, _cursor + 1, _time))
+        {
+            ++_cursor;
+        }
+        else
+        {
+            auto it = std::lower_bound(keyframes.begin() + 1, keyframes.end(), _time,
+                [](const ModelAnimation::Keyframe<T>& _keyframe, float _t) { return _keyframe.time < _t; });
+            _cursor = static_cast<uint32_t>(std::distance(keyframes.begin(), it)) - 1;
+        }
+    }
+
+    const ModelAnimation::Keyframe<T>& current = keyframes[_cursor];
+    const ModelAnimation::Keyframe<T>& next = keyframes[_cursor + 1];
+    float t = (_time - current.time) / (next.time - current.time);
+    return _interpolate(current.value, next.value, t);
+}
+
+template <typename T>
+T SampleStep(const ModelAnimation::AnimationCurve<T>& _curve, float _time, uint32_t& _cursor)
+{
+    const KeyframeVector<T>& keyframes = _curve.keyframes;
+    assert(!keyframes.empty());
+
+    if (keyframes.size() == 1 || _time <= keyframes[0].time)
+    {
+        return keyframes[0].value;
+    }
+
+    if (!IsStepKey(keyframes, _cursor, _time))
+    {
+        if (IsStepKey(keyframes, _cursor + 1, _time))
+        {
+            ++_cursor;
+        }
+        else
+        {
+            auto it = std::upper_bound(keyframes.begin(), keyframes.end(), _time,
+                [](float _t, const ModelAnimation::Keyframe<T>& _keyframe) { return _t < _keyframe.time; });
+            _cursor = static_cast<uint32_t>(std::distance(keyframes.begin(), it)) - 1;
+        }
+    }
+
+    return keyframes[_cursor].value;
+}
+
+} // namespace
+
 void ModelAnimation::Initialize()
 {
     animetionTimer_ = 0.0f;
     localMatrix_ = MakeIdentity4x4();
 }
 
+void ModelAnimation::Bind(const std::vector<Joint>& _joints)
+{
+    jointNames_.clear();
+    jointNames_.reserve(_joints.size());
+    for (const Joint& joint : _joints)
+    {
+        jointNames_.push_back(joint.name_);
+    }
+
+    RebuildBindings();
+}
+
 void ModelAnimation::Update(std::vector<Joint>& _joints, float _deltaTime)
 {
     isPlaying_ = true;
     animetionTimer_ += _deltaTime;
 
+    // 結び付けていないか、スケルトンが変わっていたら結び付け直す
+    if (jointNames_.size() != _joints.size())
+        Bind(_joints);
+
     if (state_.isBlending)
     {
         state_.blendTime += _deltaTime;
@@ -32,47 +143,29 @@ void ModelAnimation::Update(std::vector<Joint>& _joints, float _deltaTime)
             state_.isBlending = false;
         }
 
-        // ブレンド中の補間処理
-        for (Joint& joint : _joints) {
-            if (auto it = animation_.nodeAnimations.find(joint.name_); it != animation_.nodeAnimations.end()) {
-                const NodeAnimation& nodeAnimation = it->second;
-                QuaternionTransform currentTransform = {};
+        // 新しいアニメーションの姿勢を計算
+        Sample(animetionTimer_, sampledPose_);
 
-                // 新しいアニメーションの姿勢を計算
-                if (nodeAnimation.interpolation == "LINEAR")
-                {
-                    currentTransform.translate = CalculateValue_Linear(nodeAnimation.translate, animetionTimer_);
-                    currentTransform.rotation = CalculateValue_Linear(nodeAnimation.rotation, animetionTimer_);
-                    currentTransform.scale = CalculateValue_Linear(nodeAnimation.scale, animetionTimer_);
-                }
-                else if (nodeAnimation.interpolation == "STEP")
-                {
-                    currentTransform.translate = CalculateValue_Step(nodeAnimation.translate, animetionTimer_);
-                    currentTransform.rotation = CalculateValue_Step(nodeAnimation.rotation, animetionTimer_);
-                    currentTransform.scale = CalculateValue_Step(nodeAnimation.scale, animetionTimer_);
-                }
-                else if (nodeAnimation.interpolation == "CUBICSPLINE")
-                {
-                    currentTransform.translate = CalculateValue_Linear(nodeAnimation.translate, animetionTimer_);
-                    currentTransform.rotation = CalculateValue_Linear(nodeAnimation.rotation, animetionTimer_);
-                    currentTransform.scale = CalculateValue_Linear(nodeAnimation.scale, animetionTimer_);
-                }
-                // 他の補間方法も同様に処理
-
-                // 前のアニメーションの姿勢と新しいアニメーションの姿勢をブレンド
-                if (auto lastPose = state_.lastPose.find(joint.name_); lastPose != state_.lastPose.end()) {
-                    QuaternionTransform blendedTransform;
-                    blendedTransform.translate = Lerp(lastPose->second.translate, currentTransform.translate, blendFactor);
-                    blendedTransform.rotation = Slerp(lastPose->second.rotation, currentTransform.rotation, blendFactor);
-                    blendedTransform.scale = Lerp(lastPose->second.scale, currentTransform.scale, blendFactor);
+        // ブレンド中の補間処理
+        for (const ChannelBinding& binding : bindings_)
+        {
+            Joint& joint = _joints[binding.jointIndex];
+            const QuaternionTransform& currentTransform = sampledPose_[binding.jointIndex];
 
-                    joint.SetTransform(blendedTransform);
-                }
-                else
-                {
-                    joint.SetTransform(currentTransform);
-                }
+            // 前のアニメーションの姿勢と新しいアニメーションの姿勢をブレンド
+            if (binding.jointIndex < state_.hasLastPose.size() && state_.hasLastPose[binding.jointIndex])
+            {
+                const QuaternionTransform& lastPose = state_.lastPose[binding.jointIndex];
+                QuaternionTransform blendedTransform;
+                blendedTransform.translate = Lerp(lastPose.translate, currentTransform.translate, blendFactor);
+                blendedTransform.rotation = Slerp(lastPose.rotation, currentTransform.rotation, blendFactor);
+                blendedTransform.scale = Lerp(lastPose.scale, currentTransform.scale, blendFactor);
 
+                joint.SetTransform(blendedTransform);
+            }
+            else
+            {
+                joint.SetTransform(currentTransform);
             }
         }
     }
@@ -111,45 +204,19 @@ void ModelAnimation::Update(std::vector<Joint>& _joints, float _deltaTime)
         if (!isLoop_)
         {
             // 再生時間がアニメーションの尺を超えたら再生を止める
-            if (animetionTimer_ >= animation_.duration)
+            if (animetionTimer_ >= GetDuration())
             {
-                animetionTimer_ = animation_.duration;
+                animetionTimer_ = GetDuration();
                 isPlaying_ = false;
             }
         }
-        else
-            animetionTimer_ = std::fmod(animetionTimer_, animation_.duration);
+        else if (GetDuration() > 0.0f)
+            animetionTimer_ = std::fmod(animetionTimer_, GetDuration());
 
-        for (Joint& joint : _joints)
+        Sample(animetionTimer_, sampledPose_);
+        for (const ChannelBinding& binding : bindings_)
         {
-            if (auto it = animation_.nodeAnimations.find(joint.name_); it != animation_.nodeAnimations.end())
-            {
-                //TODO : 補間処理
-                //it->second.interpolation ごとに補間関数を作成
-                const NodeAnimation& nodeAnimation = it->second;
-                QuaternionTransform transform = {};
-
-                if (nodeAnimation.interpolation == "LINEAR")
-                {
-                    transform.translate = CalculateValue_Linear(nodeAnimation.translate, animetionTimer_);
-                    transform.rotation = CalculateValue_Linear(nodeAnimation.rotation, animetionTimer_);
-                    transform.scale = CalculateValue_Linear(nodeAnimation.scale, animetionTimer_);
-                }
-                else if (nodeAnimation.interpolation == "STEP")
-                {
-                    transform.translate = CalculateValue_Step(nodeAnimation.translate, animetionTimer_);
-                    transform.rotation = CalculateValue_Step(nodeAnimation.rotation, animetionTimer_);
-                    transform.scale = CalculateValue_Step(nodeAnimation.scale, animetionTimer_);
-                }
-                else if (nodeAnimation.interpolation == "CUBICSPLINE")
-                {
-                    transform.translate = CalculateValue_Linear(nodeAnimation.translate, animetionTimer_);
-                    transform.rotation = CalculateValue_Linear(nodeAnimation.rotation, animetionTimer_);
-                    transform.scale = CalculateValue_Linear(nodeAnimation.scale, animetionTimer_);
-                }
-
-                joint.SetTransform(transform);
-            }
+            _joints[binding.jointIndex].SetTransform(sampledPose_[binding.jointIndex]);
         }
     }
 
@@ -158,23 +225,49 @@ void ModelAnimation::Update(std::vector<Joint>& _joints, float _deltaTime)
 
 }
 
+void ModelAnimation::SetJointMask(std::vector<uint8_t> _mask)
+{
+    if (_mask == jointMask_)
+        return;
+
+    jointMask_ = std::move(_mask);
+    RebuildBindings();
+}
+
+void ModelAnimation::Sample(float _time, std::span<QuaternionTransform> _pose)
+{
+    for (size_t index = 0; index < bindings_.size(); ++index)
+    {
+        const ChannelBinding& binding = bindings_[index];
+        assert(binding.jointIndex < _pose.size());
+        if (compressedClip_)
+            _pose[binding.jointIndex] = compressedClip_->Sample(binding.channelIndex, _time, cursors_[index]);
+        else
+            _pose[binding.jointIndex] = Evaluate(animation_->channels[binding.channelIndex], _time, cursors_[index]);
+    }
+}
+
 void ModelAnimation::Draw()
 {
 }
 
 void ModelAnimation::ReadAnimation(const aiAnimation* _animation)
 {
-    animation_.duration = static_cast<float> (_animation->mDuration / _animation->mTicksPerSecond);
+    auto animation = std::make_shared<Animation>();
+    animation->duration = static_cast<float> (_animation->mDuration / _animation->mTicksPerSecond);
 
     for (uint32_t channelIndex = 0; channelIndex < _animation->mNumChannels; ++channelIndex)
     {
         aiNodeAnim* aiNodeAnimation = _animation->mChannels[channelIndex];
-        NodeAnimation& nodeAnimation = animation_.nodeAnimations[aiNodeAnimation->mNodeName.C_Str()];
 
-        uint32_t samplerIndex = channelToSampler_[channelIndex];
-        std::string interpolation = samplers_[samplerIndex].interpolation;
+        // 同じノードのチャンネルは1つにまとめる
+        auto [it, inserted] = animation->channelIndices.try_emplace(aiNodeAnimation->mNodeName.C_Str(), static_cast<uint32_t>(animation->channels.size()));
+        if (inserted)
+            animation->channels.emplace_back();
+        NodeAnimation& nodeAnimation = animation->channels[it->second];
 
-        nodeAnimation.interpolation = interpolation;
+        uint32_t samplerIndex = channelToSampler_[channelIndex];
+        nodeAnimation.interpolation = ToInterpolationType(samplers_[samplerIndex].interpolation);
 
         for (uint32_t keyframeIndex = 0; keyframeIndex < aiNodeAnimation->mNumPositionKeys; ++keyframeIndex)
         {
@@ -204,6 +297,9 @@ void ModelAnimation::ReadAnimation(const aiAnimation* _animation)
         }
 
     }
+    animation_ = std::move(animation);
+    compressedClip_.reset();
+    RebuildBindings();
     Initialize();
 }
 
@@ -277,21 +373,37 @@ void ModelAnimation::Reset()
     timeToIdle_ = 0.0f;
 }
 
-void ModelAnimation::ChangeAnimation(const Animation& _animation, float _blendTime)
+void ModelAnimation::ChangeAnimation(std::shared_ptr<const Animation> _animation, float _blendTime, std::shared_ptr<const CompressedAnimationClip> _compressedClip)
 {
     // 現在の各ジョイントの姿勢を保存
-    for (const auto& [nodeName, nodeAnim] : animation_.nodeAnimations) {
-        state_.lastPose[nodeName] = QuaternionTransform{
-            CalculateValue_Linear(nodeAnim.translate, animetionTimer_),
-            CalculateValue_Linear(nodeAnim.rotation, animetionTimer_),
-            CalculateValue_Linear(nodeAnim.scale, animetionTimer_)
-        };
+    state_.lastPose.assign(jointNames_.size(), QuaternionTransform{});
+    state_.hasLastPose.assign(jointNames_.size(), 0);
+    for (size_t index = 0; index < bindings_.size(); ++index)
+    {
+        const ChannelBinding& binding = bindings_[index];
+        if (compressedClip_)
+        {
+            KeyframeCursor cursor = cursors_[index];
+            state_.lastPose[binding.jointIndex] = compressedClip_->Sample(binding.channelIndex, animetionTimer_, cursor);
+        }
+        else
+        {
+            const NodeAnimation& nodeAnim = animation_->channels[binding.channelIndex];
+            state_.lastPose[binding.jointIndex] = QuaternionTransform{
+                CalculateValue_Linear(nodeAnim.translate, animetionTimer_),
+                CalculateValue_Linear(nodeAnim.rotation, animetionTimer_),
+                CalculateValue_Linear(nodeAnim.scale, animetionTimer_)
+            };
+        }
+        state_.hasLastPose[binding.jointIndex] = 1;
     }
 
     // 新しいアニメーションに切り替え
-    animation_ = _animation;
+    animation_ = std::move(_animation);
+    compressedClip_ = std::move(_compressedClip);
     animetionTimer_ = 0.0f;
     isPlaying_ = true;
+    RebuildBindings();
 
     // ブレンド情報の設定
     state_.blendTime = 0.0f;
@@ -299,99 +411,122 @@ void ModelAnimation::ChangeAnimation(const Animation& _animation, float _blendTi
     state_.isBlending = true;
 }
 
-void ModelAnimation::SetAnimation(const Animation& _animation)
+void ModelAnimation::SetAnimation(std::shared_ptr<const Animation> _animation, std::shared_ptr<const CompressedAnimationClip> _compressedClip)
 {
-    animation_ = _animation;
+    animation_ = std::move(_animation);
+    compressedClip_ = std::move(_compressedClip);
     animetionTimer_ = 0.0f;
     isPlaying_ = true;
+    RebuildBindings();
 }
 
-
-Vector3 ModelAnimation::CalculateValue_Linear(const AnimationCurve<Vector3>& _curve, float _time)
+void ModelAnimation::RebuildBindings()
 {
-    assert(!_curve.keyframes.empty());
-
-    // キーが一つか最初のキーフレームより前
-    if (_curve.keyframes.size() == 1 || _time <= _curve.keyframes[0].time)
+    bindings_.clear();
+    for (uint32_t jointIndex = 0; jointIndex < jointNames_.size() && animation_; ++jointIndex)
     {
-        return _curve.keyframes[0].value;
-    }
+        if (jointIndex < jointMask_.size() && !jointMask_[jointIndex])
+            continue;
 
-    for (size_t index = 0; index < _curve.keyframes.size() - 1; ++index)
-    {
-        size_t nextIndex = index + 1;
-        if (_curve.keyframes[index].time <= _time && _time <= _curve.keyframes[nextIndex].time)
+        auto it = animation_->channelIndices.find(jointNames_[jointIndex]);
+        if (it != animation_->channelIndices.end())
         {
-            float t = (_time - _curve.keyframes[index].time) / (_curve.keyframes[nextIndex].time - _curve.keyframes[index].time);
-            return Lerp(_curve.keyframes[index].value, _curve.keyframes[nextIndex].value, t);
+            bindings_.push_back({ jointIndex, it->second });
         }
     }
 
-    return (*_curve.keyframes.rbegin()).value;
+    cursors_.assign(bindings_.size(), KeyframeCursor{});
+    sampledPose_.resize(jointNames_.size());
 }
-Quaternion ModelAnimation::CalculateValue_Linear(const AnimationCurve<Quaternion>& _curve, float _time)
+
+ClipCompressionReport ModelAnimation::Compress(const ClipCompressionSettings& _settings)
 {
-    assert(!_curve.keyframes.empty());
+    ClipCompressionReport report = {};
+    if (!animation_)
+        return report;
 
-    // キーが一つか最初のキーフレームより前
-    if (_curve.keyframes.size() == 1 || _time <= _curve.keyframes[0].time)
-    {
-        return _curve.keyframes[0].value;
-    }
+    compressedClip_ = CompressedAnimationClip::Compress(*animation_, _settings, &report);
+    return report;
+}
 
-    for (size_t index = 0; index < _curve.keyframes.size() - 1; ++index)
-    {
-        size_t nextIndex = index + 1;
-        if (_curve.keyframes[index].time <= _time && _time <= _curve.keyframes[nextIndex].time)
-        {
-            float t = (_time - _curve.keyframes[index].time) / (_curve.keyframes[nextIndex].time - _curve.keyframes[index].time);
-            return Slerp(_curve.keyframes[index].value, _curve.keyframes[nextIndex].value, t);
-        }
-    }
+ModelAnimation::InterpolationType ModelAnimation::ToInterpolationType(const std::string& _interpolation)
+{
+    if (_interpolation == "STEP")
+        return InterpolationType::Step;
+    if (_interpolation == "CUBICSPLINE")
+        return InterpolationType::CubicSpline;
 
-    return (*_curve.keyframes.rbegin()).value;
+    return InterpolationType::Linear;
 }
 
-Vector3 ModelAnimation::CalculateValue_Step(const AnimationCurve<Vector3>& _curve, float _time)
+QuaternionTransform ModelAnimation::Evaluate(const NodeAnimation& _nodeAnimation, float _time, KeyframeCursor& _cursor)
 {
-    assert(!_curve.keyframes.empty());
+    QuaternionTransform transform = {};
 
-    if (_curve.keyframes.size() == 1 || _time <= _curve.keyframes[0].time)
+    switch (_nodeAnimation.interpolation)
     {
-        return _curve.keyframes[0].value;
+    case InterpolationType::Step:
+        transform.translate = CalculateValue_Step(_nodeAnimation.translate, _time, _cursor.translate);
+        transform.rotation = CalculateValue_Step(_nodeAnimation.rotation, _time, _cursor.rotation);
+        transform.scale = CalculateValue_Step(_nodeAnimation.scale, _time, _cursor.scale);
+        break;
+
+    // CUBICSPLINEは線形で代用する
+    case InterpolationType::Linear:
+    case InterpolationType::CubicSpline:
+    default:
+        transform.translate = CalculateValue_Linear(_nodeAnimation.translate, _time, _cursor.translate);
+        transform.rotation = CalculateValue_Linear(_nodeAnimation.rotation, _time, _cursor.rotation);
+        transform.scale = CalculateValue_Linear(_nodeAnimation.scale, _time, _cursor.scale);
+        break;
     }
 
-    int32_t index = static_cast<int32_t>(_curve.keyframes.size() - 1);
-    for (; index >= 0; index--)
-    {
-        if (_time >= _curve.keyframes[index].time)
-        {
-            return _curve.keyframes[index].value;
-        }
-    }
+    return transform;
+}
+
+
+Vector3 ModelAnimation::CalculateValue_Linear(const AnimationCurve<Vector3>& _curve, float _time)
+{
+    uint32_t cursor = 0;
+    return CalculateValue_Linear(_curve, _time, cursor);
+}
+
+Quaternion ModelAnimation::CalculateValue_Linear(const AnimationCurve<Quaternion>& _curve, float _time)
+{
+    uint32_t cursor = 0;
+    return CalculateValue_Linear(_curve, _time, cursor);
+}
 
-    return (*_curve.keyframes.rbegin()).value;
+Vector3 ModelAnimation::CalculateValue_Step(const AnimationCurve<Vector3>& _curve, float _time)
+{
+    uint32_t cursor = 0;
+    return CalculateValue_Step(_curve, _time, cursor);
 }
 
 Quaternion ModelAnimation::CalculateValue_Step(const AnimationCurve<Quaternion>& _curve, float _time)
 {
-    assert(!_curve.keyframes.empty());
+    uint32_t cursor = 0;
+    return CalculateValue_Step(_curve, _time, cursor);
+}
 
-    if (_curve.keyframes.size() == 1 || _time <= _curve.keyframes[0].time)
-    {
-        return _curve.keyframes[0].value;
-    }
+Vector3 ModelAnimation::CalculateValue_Linear(const AnimationCurve<Vector3>& _curve, float _time, uint32_t& _cursor)
+{
+    return SampleLinear(_curve, _time, _cursor, [](const Vector3& _a, const Vector3& _b, float _t) { return Lerp(_a, _b, _t); });
+}
 
-    int32_t index = static_cast<int32_t>(_curve.keyframes.size() - 1);
-    for (; index >= 0; index--)
-    {
-        if (_time >= _curve.keyframes[index].time)
-        {
-            return _curve.keyframes[index].value;
-        }
-    }
+Quaternion ModelAnimation::CalculateValue_Linear(const AnimationCurve<Quaternion>& _curve, float _time, uint32_t& _cursor)
+{
+    return SampleLinear(_curve, _time, _cursor, [](const Quaternion& _a, const Quaternion& _b, float _t) { return Slerp(_a, _b, _t); });
+}
 
-    return (*_curve.keyframes.rbegin()).value;
+Vector3 ModelAnimation::CalculateValue_Step(const AnimationCurve<Vector3>& _curve, float _time, uint32_t& _cursor)
+{
+    return SampleStep(_curve, _time, _cursor);
+}
+
+Quaternion ModelAnimation::CalculateValue_Step(const AnimationCurve<Quaternion>& _curve, float _time, uint32_t& _cursor)
+{
+    return SampleStep(_curve, _time, _cursor);
 }
 
 } // namespace Engine
@@ -7,7 +7,10 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <string>
+#include <span>
+#include <cstdint>
 
 
 struct aiAnimation;
@@ -16,9 +19,20 @@ namespace Engine {
 
 
 class Joint;
+class CompressedAnimationClip;
+struct ClipCompressionSettings;
+struct ClipCompressionReport;
 class ModelAnimation
 {
-private:
+public:
+    // キーフレーム間の補間方法
+    enum class InterpolationType
+    {
+        Linear,
+        Step,
+        CubicSpline,
+    };
+
     template <typename T>
     struct Keyframe
     {
@@ -38,12 +52,21 @@ private:
         AnimationCurve<Vector3> translate;
         AnimationCurve<Quaternion> rotation;
         AnimationCurve<Vector3> scale;
-        std::string interpolation;
+        InterpolationType interpolation = InterpolationType::Linear;
     };
     struct Animation
     {
         float duration; //全体の尺
-        std::map<std::string, NodeAnimation> nodeAnimations;
+        std::vector<NodeAnimation> channels;                    // ノード毎のアニメーション
+        std::map<std::string, uint32_t> channelIndices;         // ノード名からchannelsの添え字 結び付けるときのみ使う
+    };
+
+    // 直前に使ったキーフレームの区間 チャンネル毎・再生毎に持つ
+    struct KeyframeCursor
+    {
+        uint32_t translate = 0;
+        uint32_t rotation = 0;
+        uint32_t scale = 0;
     };
 public:
 
@@ -51,7 +74,30 @@ public:
     ~ModelAnimation() = default;
 
     void Initialize();
+
+    /// <summary>
+    /// スケルトンに結び付け、ジョイントの添え字からチャンネルの添え字への表を作る
+    /// 文字列の比較はここでのみ行い、Updateでは表をたどるだけにする
+    /// </summary>
+    void Bind(const std::vector<Joint>& _joints);
+
     void Update(std::vector<Joint>& _joints,float _deltaTime);
+
+    /// <summary>
+    /// 求めるジョイントを絞る 0のジョイントはサンプリングせず、姿勢を書き換えない
+    /// 空ならすべてのジョイントを求める
+    /// </summary>
+    void SetJointMask(std::vector<uint8_t> _mask);
+    // サンプリングするジョイントの数
+    uint32_t GetEvaluatedJointCount() const { return static_cast<uint32_t>(bindings_.size()); }
+
+    /// <summary>
+    /// 結び付けた全チャンネルを時刻_timeでまとめてサンプリングする
+    /// 前回の区間から探すので、通常の再生ではキーフレーム数によらずほぼ定数時間になる
+    /// </summary>
+    /// <param name="_time">時刻</param>
+    /// <param name="_pose">ジョイントの添え字毎の姿勢 アニメーションするジョイントのみ書き込む</param>
+    void Sample(float _time, std::span<QuaternionTransform> _pose);
     void Draw();
 
     void ReadAnimation(const aiAnimation* _animation);
@@ -62,21 +108,47 @@ public:
 
     void SetLoop(bool _loop) { isLoop_ = _loop; }
 
-    void ChangeAnimation(const Animation& _animation,float _blendTime);
-    void SetAnimation(const Animation& _animation);
+    // クリップは共有する _compressedClipがあればサンプリングはそちらから行う
+    void ChangeAnimation(std::shared_ptr<const Animation> _animation, float _blendTime, std::shared_ptr<const CompressedAnimationClip> _compressedClip = nullptr);
+    void SetAnimation(std::shared_ptr<const Animation> _animation, std::shared_ptr<const CompressedAnimationClip> _compressedClip = nullptr);
+
+    const std::shared_ptr<const Animation>& GetAnimation() const { return animation_; }
+    const std::shared_ptr<const CompressedAnimationClip>& GetCompressedClip() const { return compressedClip_; }
 
-    Animation GetAnimation() const { return animation_; }
+    // 読み込んだクリップを圧縮し、以降のサンプリングは圧縮したクリップから行う
+    ClipCompressionReport Compress(const ClipCompressionSettings& _settings);
     
 
     Matrix4x4 GetLocalMatrix() const { return localMatrix_; }
     bool IsPlaying() const { return isPlaying_; }
     bool IsIdle() const { return !toIdle_ && !isPlaying_; }
 
+    static InterpolationType ToInterpolationType(const std::string& _interpolation);
+
+    // 補間方法に応じて時刻_timeの姿勢を求める _cursorは前回の区間で、求めた区間に更新される
+    static QuaternionTransform Evaluate(const NodeAnimation& _nodeAnimation, float _time, KeyframeCursor& _cursor);
+
+    // 区間を二分探索で求める
+    static Vector3 CalculateValue_Linear(const AnimationCurve<Vector3>& _curve, float _time);
+    static Quaternion CalculateValue_Linear(const AnimationCurve<Quaternion>& _curve, float _time);
+
+    static Vector3 CalculateValue_Step(const AnimationCurve<Vector3>& _curve, float _time);
+    static Quaternion CalculateValue_Step(const AnimationCurve<Quaternion>& _curve, float _time);
+
+    // 前回の区間_cursorとその次を先に調べ、外れていれば二分探索で求める
+    static Vector3 CalculateValue_Linear(const AnimationCurve<Vector3>& _curve, float _time, uint32_t& _cursor);
+    static Quaternion CalculateValue_Linear(const AnimationCurve<Quaternion>& _curve, float _time, uint32_t& _cursor);
+
+    static Vector3 CalculateValue_Step(const AnimationCurve<Vector3>& _curve, float _time, uint32_t& _cursor);
+    static Quaternion CalculateValue_Step(const AnimationCurve<Quaternion>& _curve, float _time, uint32_t& _cursor);
+
 private:
     
 
 
-    Animation animation_;
+    std::shared_ptr<const Animation> animation_;
+    std::shared_ptr<const CompressedAnimationClip> compressedClip_;
+    float GetDuration() const { return animation_ ? animation_->duration : 0.0f; }
     Matrix4x4 localMatrix_;
     float animetionTimer_ = 0.0f;
 
@@ -92,6 +164,23 @@ private:
     // チャンネルとサンプラーの対応
     std::map<uint32_t, uint32_t> channelToSampler_;
 
+    // ジョイントとチャンネルの対応
+    struct ChannelBinding
+    {
+        uint32_t jointIndex;
+        uint32_t channelIndex;
+    };
+
+    // 結び付けたスケルトンのジョイント名と、アニメーションするジョイントの表
+    std::vector<std::string> jointNames_;
+    std::vector<uint8_t> jointMask_;                // 空ならすべてのジョイント
+    std::vector<ChannelBinding> bindings_;
+    std::vector<KeyframeCursor> cursors_;           // bindings_と同じ並び
+    std::vector<QuaternionTransform> sampledPose_;  // Sampleの書き込み先
+
+    // jointNames_とanimation_から表を作り直す
+    void RebuildBindings();
+
 
     bool isLoop_ = false;
     bool isPlaying_ = false;
@@ -100,7 +189,8 @@ private:
 
     struct AnimationState
     {
-        std::map<std::string, QuaternionTransform> lastPose;
+        std::vector<QuaternionTransform> lastPose;     // ジョイント毎のブレンド元の姿勢
+        std::vector<uint8_t> hasLastPose;              // ブレンド元の姿勢があるか
         float blendTime = 0.0f;                        // ブレンド経過時間
         float totalBlendTime = 0.0f;                   // ブレンド完了までの時間
         bool isBlending = false;
@@ -109,13 +199,6 @@ private:
 
     AnimationState state_;
 
-
-    Vector3 CalculateValue_Linear(const AnimationCurve<Vector3>& _curve, float _time);
-    Quaternion CalculateValue_Linear(const AnimationCurve<Quaternion>& _curve, float _time);
-
-    Vector3 CalculateValue_Step(const AnimationCurve<Vector3>& _curve, float _time);
-    Quaternion CalculateValue_Step(const AnimationCurve<Quaternion>& _curve, float _time);
-
 };
 
 } // namespace Engine
@@ -6,17 +6,18 @@ namespace Engine {
 
 void Skeleton::Update()
 {
-    for (Joint& joint : joints_)
+    for (const Joint& joint : joints_)
     {
-        joint.Update(joints_);
+        pose_.SetLocalTransform(static_cast<uint32_t>(joint.index_), joint.GetTransform());
     }
+    pose_.Update();
 }
 
 void Skeleton::Draw(const Matrix4x4& _wMat)
 {
     for (Joint& joint : joints_)
     {
-        joint.Draw(_wMat, joints_);
+        joint.Draw(_wMat, pose_);
     }
 }
 
@@ -27,6 +28,15 @@ void Skeleton::CreateSkeleton(const Node& _node)
     {
         jointMap_.emplace(joint.name_, joint.index_);
     }
+
+    // CreateJointは親を先に追加するので、そのままの順でポーズを作れる
+    std::vector<int32_t> parents;
+    parents.reserve(joints_.size());
+    for (const Joint& joint : joints_)
+    {
+        parents.push_back(joint.GetParentIndex());
+    }
+    pose_.Initialize(parents);
 }
 
 const Matrix4x4* Skeleton::GetSkeletonSpaceMatrix(const std::string& _name) const
@@ -34,7 +44,7 @@ const Matrix4x4* Skeleton::GetSkeletonSpaceMatrix(const std::string& _name) cons
     auto it = jointMap_.find(_name);
     if (it != jointMap_.end())
     {
-        return joints_[it->second].GetSkeletonSpaceMatrix();
+        return &pose_.GetSkeletonSpaceMatrix(static_cast<uint32_t>(it->second));
     }
 
     return nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Features/Model/Animation/Joint/Joint.h>
+#include <Features/Model/Animation/Skeleton/SkeletonPose.h>
 #include <vector>
 #include <map>
 #include <string>
@@ -16,13 +17,15 @@ public:
     Skeleton() = default;
     ~Skeleton() = default;
 
+    // ジョイントの姿勢をポーズに移し、変わったジョイントとその子孫の行列を求め直す
     void Update();
     void Draw(const Matrix4x4& _wMat);
 
     void CreateSkeleton(const Node& _node);
     std::vector<Joint>& GetJoints() { return joints_; }
     std::map<std::string, int32_t>& GetJointMap() { return jointMap_; }
-    const Matrix4x4* GetSkeletonSpaceMatrix(uint32_t _index = 0)const { return joints_[_index].GetSkeletonSpaceMatrix(); }
+    const SkeletonPose& GetPose() const { return pose_; }
+    const Matrix4x4* GetSkeletonSpaceMatrix(uint32_t _index = 0)const { return &pose_.GetSkeletonSpaceMatrix(_index); }
     const Matrix4x4* GetSkeletonSpaceMatrix(const std::string& _name) const;
 
 
@@ -37,6 +40,7 @@ private:
     int32_t rootIndex_ = 0;
     std::map<std::string, int32_t> jointMap_ = {};
     std::vector<Joint> joints_ = {};
+    SkeletonPose pose_ = {};
 
 
 };
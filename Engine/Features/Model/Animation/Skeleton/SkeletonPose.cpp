@@ -0,0 +1,193 @@
+#include "SkeletonPose.h"
+
+#include <immintrin.h>
+#include <cstring>
+
+
+namespace Engine {
+
+namespace {
+
+constexpr uint32_t kLaneCount = 4;
+
+uint32_t AlignLaneCount(uint32_t _count)
+{
+    return (_count + kLaneCount - 1) / kLaneCount * kLaneCount;
+}
+
+inline __m128 Load(const std::vector<float>& _lanes, uint32_t _index)
+{
+    return _mm_loadu_ps(_lanes.data() + _index);
+}
+
+// _local * _parent（Matrix4x4::operator*と同じ順で足す）
+inline void Multiply(const Matrix4x4& _local, const Matrix4x4& _parent, Matrix4x4& _out)
+{
+    const __m128 parent0 = _mm_loadu_ps(_parent.m[0]);
+    const __m128 parent1 = _mm_loadu_ps(_parent.m[1]);
+    const __m128 parent2 = _mm_loadu_ps(_parent.m[2]);
+    const __m128 parent3 = _mm_loadu_ps(_parent.m[3]);
+
+    for (int32_t row = 0; row < 4; ++row)
+    {
+        const float* local = _local.m[row];
+        __m128 result = _mm_mul_ps(_mm_set1_ps(local[0]), parent0);
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(local[1]), parent1));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(local[2]), parent2));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(local[3]), parent3));
+        _mm_storeu_ps(_out.m[row], result);
+    }
+}
+
+} // namespace
+
+void SkeletonPose::Initialize(const std::vector<int32_t>& _parents)
+{
+    jointCount_ = static_cast<uint32_t>(_parents.size());
+    parents_ = _parents;
+
+    uint32_t size = AlignLaneCount(jointCount_);
+
+    // 末尾の余りも単位の姿勢にしておく
+    translateX_.assign(size, 0.0f);
+    translateY_.assign(size, 0.0f);
+    translateZ_.assign(size, 0.0f);
+    rotationX_.assign(size, 0.0f);
+    rotationY_.assign(size, 0.0f);
+    rotationZ_.assign(size, 0.0f);
+    rotationW_.assign(size, 1.0f);
+    scaleX_.assign(size, 1.0f);
+    scaleY_.assign(size, 1.0f);
+    scaleZ_.assign(size, 1.0f);
+
+    localMatrices_.assign(size, Matrix4x4::Identity());
+    skeletonSpaceMatrices_.assign(jointCount_, Matrix4x4::Identity());
+
+    isLocalDirty_.assign(size, 1);
+    isChanged_.assign(jointCount_, 0);
+    updatedCount_ = 0;
+}
+
+void SkeletonPose::SetLocalTransform(uint32_t _index, const QuaternionTransform& _transform)
+{
+    const Vector3& translate = _transform.translate;
+    const Quaternion& rotation = _transform.rotation;
+    const Vector3& scale = _transform.scale;
+
+    if (translateX_[_index] == translate.x && translateY_[_index] == translate.y && translateZ_[_index] == translate.z &&
+        rotationX_[_index] == rotation.x && rotationY_[_index] == rotation.y && rotationZ_[_index] == rotation.z && rotationW_[_index] == rotation.w &&
+        scaleX_[_index] == scale.x && scaleY_[_index] == scale.y && scaleZ_[_index] == scale.z)
+    {
+        return;
+    }
+
+    translateX_[_index] = translate.x;
+    translateY_[_index] = translate.y;
+    translateZ_[_index] = translate.z;
+    rotationX_[_index] = rotation.x;
+    rotationY_[_index] = rotation.y;
+    rotationZ_[_index] = rotation.z;
+    rotationW_[_index] = rotation.w;
+    scaleX_[_index] = scale.x;
+    scaleY_[_index] = scale.y;
+    scaleZ_[_index] = scale.z;
+
+    isLocalDirty_[_index] = 1;
+}
+
+QuaternionTransform SkeletonPose::GetLocalTransform(uint32_t _index) const
+{
+    QuaternionTransform transform;
+    transform.translate = Vector3(translateX_[_index], translateY_[_index], translateZ_[_index]);
+    transform.rotation = Quaternion(rotationX_[_index], rotationY_[_index], rotationZ_[_index], rotationW_[_index]);
+    transform.scale = Vector3(scaleX_[_index], scaleY_[_index], scaleZ_[_index]);
+    return transform;
+}
+
+void SkeletonPose::MarkAllDirty()
+{
+    std::fill(isLocalDirty_.begin(), isLocalDirty_.end(), static_cast<uint8_t>(1));
+}
+
+void SkeletonPose::Update()
+{
+    BuildLocalMatrices(0, static_cast<uint32_t>(localMatrices_.size()));
+
+    // 親は子より前にあるので、前から順に求めれば親は求め終わっている
+    updatedCount_ = 0;
+    for (uint32_t index = 0; index < jointCount_; ++index)
+    {
+        int32_t parent = parents_[index];
+
+        bool isChanged = isLocalDirty_[index] != 0 || (parent >= 0 && isChanged_[parent] != 0);
+        isChanged_[index] = isChanged ? 1 : 0;
+        if (!isChanged)
+            continue;
+
+        if (parent >= 0)
+            Multiply(localMatrices_[index], skeletonSpaceMatrices_[parent], skeletonSpaceMatrices_[index]);
+        else
+            skeletonSpaceMatrices_[index] = localMatrices_[index];
+
+        ++updatedCount_;
+    }
+
+    std::fill(isLocalDirty_.begin(), isLocalDirty_.end(), static_cast<uint8_t>(0));
+}
+
+void SkeletonPose::BuildLocalMatrices(uint32_t _begin, uint32_t _end)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    for (uint32_t index = _begin; index < _end; index += kLaneCount)
+    {
+        // 4つとも変更が無ければ飛ばす
+        uint32_t dirty = 0;
+        std::memcpy(&dirty, &isLocalDirty_[index], sizeof(dirty));
+        if (dirty == 0)
+            continue;
+
+        // Quaternion::ToMatrixと同じ式
+        __m128 x = Load(rotationX_, index), y = Load(rotationY_, index), z = Load(rotationZ_, index), w = Load(rotationW_, index);
+        __m128 ww = _mm_mul_ps(w, w), xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        __m128 rotate[3][3] = {
+            { _mm_sub_ps(_mm_sub_ps(_mm_add_ps(ww, xx), yy), zz), _mm_mul_ps(two, _mm_add_ps(xy, wz)), _mm_mul_ps(two, _mm_sub_ps(xz, wy)) },
+            { _mm_mul_ps(two, _mm_sub_ps(xy, wz)), _mm_sub_ps(_mm_add_ps(_mm_sub_ps(ww, xx), yy), zz), _mm_mul_ps(two, _mm_add_ps(yz, wx)) },
+            { _mm_mul_ps(two, _mm_add_ps(xz, wy)), _mm_mul_ps(two, _mm_sub_ps(yz, wx)), _mm_add_ps(_mm_sub_ps(_mm_sub_ps(ww, xx), yy), zz) },
+        };
+
+        // MakeAffineMatrixの積を展開すると、回転の各行にスケールをかけて平行移動を最後の行に置いたものになる
+        const __m128 scales[3] = { Load(scaleX_, index), Load(scaleY_, index), Load(scaleZ_, index) };
+
+        __m128 rows[4][kLaneCount];
+        for (int32_t row = 0; row < 3; ++row)
+        {
+            __m128 m0 = _mm_mul_ps(scales[row], rotate[row][0]);
+            __m128 m1 = _mm_mul_ps(scales[row], rotate[row][1]);
+            __m128 m2 = _mm_mul_ps(scales[row], rotate[row][2]);
+            __m128 m3 = zero;
+            _MM_TRANSPOSE4_PS(m0, m1, m2, m3);
+            rows[row][0] = m0; rows[row][1] = m1; rows[row][2] = m2; rows[row][3] = m3;
+        }
+
+        __m128 tx = Load(translateX_, index), ty = Load(translateY_, index), tz = Load(translateZ_, index), tw = one;
+        _MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+        rows[3][0] = tx; rows[3][1] = ty; rows[3][2] = tz; rows[3][3] = tw;
+
+        for (uint32_t lane = 0; lane < kLaneCount; ++lane)
+        {
+            Matrix4x4& out = localMatrices_[index + lane];
+            _mm_storeu_ps(out.m[0], rows[0][lane]);
+            _mm_storeu_ps(out.m[1], rows[1][lane]);
+            _mm_storeu_ps(out.m[2], rows[2][lane]);
+            _mm_storeu_ps(out.m[3], rows[3][lane]);
+        }
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Math/Matrix/Matrix4x4.h>
+#include <Math/Quaternion/QuaternionTransform.h>
+
+#include <vector>
+#include <cstdint>
+
+
+namespace Engine {
+
+/// <summary>
+/// スケルトンの姿勢を計算するための、ジョイントの属性を要素毎の配列で持つもの
+/// ジョイントは親が必ず子より前に来る順（Skeleton::CreateSkeletonの順）で並べる
+/// ローカルの姿勢が変わったジョイントとその子孫だけ行列を求め直す
+/// </summary>
+class SkeletonPose
+{
+public:
+    SkeletonPose() = default;
+    ~SkeletonPose() = default;
+
+    /// <summary>
+    /// ジョイントの親の並びから初期化する
+    /// </summary>
+    /// <param name="_parents">各ジョイントの親の添え字 ルートは-1 親は子より前にあること</param>
+    void Initialize(const std::vector<int32_t>& _parents);
+
+    // ローカルの姿勢を設定する 値が変わった場合のみ次のUpdateで求め直す
+    void SetLocalTransform(uint32_t _index, const QuaternionTransform& _transform);
+    QuaternionTransform GetLocalTransform(uint32_t _index) const;
+
+    // 全ジョイントを次のUpdateで求め直す
+    void MarkAllDirty();
+
+    /// <summary>
+    /// 変更されたジョイントのローカル行列を4つずつSSEで求め、
+    /// それらと子孫のスケルトン空間の行列を親から順に求め直す
+    /// </summary>
+    void Update();
+
+    uint32_t GetJointCount() const { return jointCount_; }
+    int32_t GetParent(uint32_t _index) const { return parents_[_index]; }
+
+    const Matrix4x4& GetLocalMatrix(uint32_t _index) const { return localMatrices_[_index]; }
+    // スケルトン空間の行列 領域はInitializeでのみ確保するので、ポインタを保持してもよい
+    const Matrix4x4& GetSkeletonSpaceMatrix(uint32_t _index) const { return skeletonSpaceMatrices_[_index]; }
+    const std::vector<Matrix4x4>& GetSkeletonSpaceMatrices() const { return skeletonSpaceMatrices_; }
+
+    // 直前のUpdateで行列が変わったか
+    bool IsChanged(uint32_t _index) const { return isChanged_[_index] != 0; }
+    // 直前のUpdateで求め直したジョイント数
+    uint32_t GetUpdatedCount() const { return updatedCount_; }
+
+private:
+    // [_begin, _end)のうち変更があった4つ組のローカル行列を求める
+    void BuildLocalMatrices(uint32_t _begin, uint32_t _end);
+
+    uint32_t jointCount_ = 0;
+    std::vector<int32_t> parents_;
+
+    // ローカルの姿勢 SIMDで4つずつ読むため要素毎に分け、4の倍数で確保する
+    std::vector<float> translateX_, translateY_, translateZ_;
+    std::vector<float> rotationX_, rotationY_, rotationZ_, rotationW_;
+    std::vector<float> scaleX_, scaleY_, scaleZ_;
+
+    std::vector<Matrix4x4> localMatrices_;
+    std::vector<Matrix4x4> skeletonSpaceMatrices_;
+
+    std::vector<uint8_t> isLocalDirty_;     // ローカルの姿勢が変わった
+    std::vector<uint8_t> isChanged_;        // 直前のUpdateでスケルトン空間の行列が変わった
+    uint32_t updatedCount_ = 0;
+};
+
+} // namespace Engine
@@ -1,5 +1,5 @@
 #include <Features/Model/Animation/SkinCluster/SkinCluster.h>
-#include <Features/Model/Animation/Joint/Joint.h>
+#include <Features/Model/Animation/Skeleton/SkeletonPose.h>
 #include <Core/DXCommon/DXCommon.h>
 #include <Math/Matrix/Matrix4x4.h>
 #include <Core/DXCommon/SRVManager/SRVManager.h>
@@ -15,6 +15,10 @@ namespace Engine {
 
 void SkinCluster::CreateResources(uint32_t _jointsSize, uint32_t _vertexSize, const std::map<std::string, int32_t>& _jointMap)
 {
+    isCPUResource_ = false;
+    cpuPalette_.clear();
+    cpuInfluence_.clear();
+
     paletteResource_ = DXCommon::GetInstance()->CreateBufferResource(sizeof(WellForGPU) * _jointsSize);
     WellForGPU* mappedPalette = nullptr;
     paletteResource_->Map(0, nullptr, reinterpret_cast<void**>(&mappedPalette));
@@ -35,9 +39,28 @@ void SkinCluster::CreateResources(uint32_t _jointsSize, uint32_t _vertexSize, co
     influenceBufferView_.SizeInBytes = UINT(sizeof(VertexInfluenceData) * _vertexSize);
     influenceBufferView_.StrideInBytes = sizeof(VertexInfluenceData);
 
+    BuildInfluences(_jointsSize, _jointMap);
+}
+
+void SkinCluster::CreateCPUResources(uint32_t _jointsSize, uint32_t _vertexSize, const std::map<std::string, int32_t>& _jointMap)
+{
+    // mappedPalette_ / mappedInfluence_はGPUのリソース用 CPUのときはvectorを直接使う
+    isCPUResource_ = true;
+    mappedPalette_ = {};
+    mappedInfluence_ = {};
+
+    cpuPalette_.assign(_jointsSize, WellForGPU{ MakeIdentity4x4(), MakeIdentity4x4() });
+    cpuInfluence_.assign(_vertexSize, VertexInfluenceData{});
+
+    BuildInfluences(_jointsSize, _jointMap);
+}
+
+void SkinCluster::BuildInfluences(uint32_t _jointsSize, const std::map<std::string, int32_t>& _jointMap)
+{
     inverseBindPoseMatrices_.resize(_jointsSize);
     std::generate(inverseBindPoseMatrices_.begin(), inverseBindPoseMatrices_.end(), MakeIdentity4x4);
 
+    std::span<VertexInfluenceData> influences = GetInfluenceSpan();
     for (const auto& jointweight : skinClusterData_)
     {
         auto it = _jointMap.find(jointweight.first);
@@ -48,7 +71,7 @@ void SkinCluster::CreateResources(uint32_t _jointsSize, uint32_t _vertexSize, co
         inverseBindPoseMatrices_[it->second] = jointweight.second.inverseBindPoseMatrix;
         for (const auto& vertexWeight : jointweight.second.vertexWeights)
         {
-            VertexInfluenceData& influenceData = mappedInfluence_[vertexWeight.vertexIndex];
+            VertexInfluenceData& influenceData = influences[vertexWeight.vertexIndex];
             for (uint32_t i = 0; i < influenceNum_; ++i)
             {
                 if (influenceData.weights[i] == 0.0f)
@@ -62,13 +85,17 @@ void SkinCluster::CreateResources(uint32_t _jointsSize, uint32_t _vertexSize, co
     }
 }
 
-void SkinCluster::Update(std::vector<Joint>& _joints)
+void SkinCluster::Update(const SkeletonPose& _pose)
 {
-    for (size_t index = 0; index < _joints.size(); ++index)
+    std::span<WellForGPU> palette = GetPaletteSpan();
+    for (uint32_t index = 0; index < _pose.GetJointCount(); ++index)
     {
+        if (!_pose.IsChanged(index))
+            continue;
+
         assert(index < inverseBindPoseMatrices_.size());
-        mappedPalette_[index].skeletonSpaceMatrix = inverseBindPoseMatrices_[index] * (*_joints[index].GetSkeletonSpaceMatrix());
-        mappedPalette_[index].skeletonSpaceInverseTransposeMatrix = Transpose(Inverse(mappedPalette_[index].skeletonSpaceMatrix));
+        palette[index].skeletonSpaceMatrix = inverseBindPoseMatrices_[index] * _pose.GetSkeletonSpaceMatrix(index);
+        palette[index].skeletonSpaceInverseTransposeMatrix = Transpose(Inverse(palette[index].skeletonSpaceMatrix));
     }
 }
 
@@ -40,7 +40,7 @@ struct WellForGPU
     Matrix4x4 skeletonSpaceInverseTransposeMatrix;
 };
 
-class Joint;
+class SkeletonPose;
 class SkinCluster
 {
 
@@ -49,13 +49,19 @@ public:
     ~SkinCluster() = default;
 
     void CreateResources(uint32_t _jointsSize, uint32_t _vertexSize, const std::map<std::string, int32_t>& _jointMap);
-    void Update(std::vector<Joint>& _joints);
+    // GPUのリソースを作らずにCPUのメモリにインフルエンスとパレットを用意する SkinningCPU用
+    void CreateCPUResources(uint32_t _jointsSize, uint32_t _vertexSize, const std::map<std::string, int32_t>& _jointMap);
+    // 直前のUpdateで行列が変わったジョイントのパレットだけ書き換える
+    void Update(const SkeletonPose& _pose);
     void Draw();
 
     void CreateSkinCluster(aiBone* _bone, uint32_t _meshoffset);
 
-    VertexInfluenceData* GetMappedInfluence() { return mappedInfluence_.data(); }
-    WellForGPU* GetMappedPalette() { return mappedPalette_.data(); }
+    VertexInfluenceData* GetMappedInfluence() { return GetInfluenceSpan().data(); }
+    WellForGPU* GetMappedPalette() { return GetPaletteSpan().data(); }
+
+    std::span<const VertexInfluenceData> GetInfluences() const { return isCPUResource_ ? std::span<const VertexInfluenceData>(cpuInfluence_) : mappedInfluence_; }
+    std::span<const WellForGPU> GetPalette() const { return isCPUResource_ ? std::span<const WellForGPU>(cpuPalette_) : mappedPalette_; }
 
     ID3D12Resource* GetInfluenceResource() { return influenceResource_.Get(); }
     ID3D12Resource* GetPaletteResource() { return paletteResource_.Get(); }
@@ -64,6 +70,13 @@ public:
     void QueueCommand(ID3D12GraphicsCommandList* _commandList)const;
 
 private:
+    // 頂点毎のインフルエンスと逆バインドポーズ行列を設定する
+    void BuildInfluences(uint32_t _jointsSize, const std::map<std::string, int32_t>& _jointMap);
+
+    // 書き込み先 CPUのリソースはコピーしても自分のvectorを指すように、spanには持たずにその都度作る
+    std::span<VertexInfluenceData> GetInfluenceSpan() { return isCPUResource_ ? std::span<VertexInfluenceData>(cpuInfluence_) : mappedInfluence_; }
+    std::span<WellForGPU> GetPaletteSpan() { return isCPUResource_ ? std::span<WellForGPU>(cpuPalette_) : mappedPalette_; }
+
     std::map<std::string, JointWeightData> skinClusterData_ = {};
 
     std::vector<Matrix4x4> inverseBindPoseMatrices_;
@@ -75,6 +88,11 @@ private:
 
     Microsoft::WRL::ComPtr<ID3D12Resource> paletteResource_;
     std::span<WellForGPU> mappedPalette_;
+
+    // CreateCPUResourcesで使う
+    std::vector<VertexInfluenceData> cpuInfluence_;
+    std::vector<WellForGPU> cpuPalette_;
+    bool isCPUResource_ = false;
 };
 
 } // namespace Engine
@@ -0,0 +1,347 @@
+#include "SkinningCPU.h"
+
+#include <System/Job/JobSystem.h>
+
+#include <immintrin.h>
+#include <intrin.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+
+namespace Engine {
+
+namespace {
+
+// 1回のスキニングで使うデータ
+// indicesがあれば指定した頂点だけを、positionsに位置だけ書き込む
+struct SkinningJob
+{
+    const VertexData* input = nullptr;
+    const VertexInfluenceData* influences = nullptr;
+    const WellForGPU* palette = nullptr;
+    const uint32_t* indices = nullptr;
+    VertexData* output = nullptr;
+    Vector3* positions = nullptr;
+};
+
+using SkinRangeFunc = void(*)(const SkinningJob&, uint32_t, uint32_t);
+
+void NormalizeNormal(const float _normal[3], Vector3& _out)
+{
+    float length = std::sqrt(_normal[0] * _normal[0] + _normal[1] * _normal[1] + _normal[2] * _normal[2]);
+    if (length > 0.0f)
+        _out = Vector3(_normal[0] / length, _normal[1] / length, _normal[2] / length);
+    else
+        _out = Vector3(0.0f, 0.0f, 0.0f);
+}
+
+// 求めた位置と法線を書き込む 法線はnullptrなら求めていない
+void WriteResult(const SkinningJob& _job, uint32_t _index, uint32_t _vertexIndex, const float _position[4], const float* _normal)
+{
+    if (_job.output)
+    {
+        VertexData& out = _job.output[_index];
+        out.position = Vector4(_position[0], _position[1], _position[2], 1.0f);
+        out.texcoord = _job.input[_vertexIndex].texcoord;
+        NormalizeNormal(_normal, out.normal);
+    }
+    else
+    {
+        _job.positions[_index] = Vector3(_position[0], _position[1], _position[2]);
+    }
+}
+
+// 位置は行ベクトルとして (x*m0 + z*m2) + (y*m1 + w*m3)、法線は (x*n0 + z*n2) + y*n1 の順で計算する
+// AVXで2行ずつ処理するときの順に合わせている
+
+void SkinRange_Scalar(const SkinningJob& _job, uint32_t _begin, uint32_t _end)
+{
+    bool needNormal = _job.output != nullptr;
+
+    for (uint32_t index = _begin; index < _end; ++index)
+    {
+        uint32_t vertexIndex = _job.indices ? _job.indices[index] : index;
+        const VertexData& vertex = _job.input[vertexIndex];
+        const VertexInfluenceData& influence = _job.influences[vertexIndex];
+
+        // インフルエンスの重みで行列を合成する
+        float m[4][4];
+        float n[3][4];
+        for (uint32_t i = 0; i < influenceNum_; ++i)
+        {
+            const WellForGPU& well = _job.palette[influence.jointIndices[i]];
+            float weight = influence.weights[i];
+            for (uint32_t row = 0; row < 4; ++row)
+            {
+                for (uint32_t column = 0; column < 4; ++column)
+                {
+                    float value = well.skeletonSpaceMatrix.m[row][column] * weight;
+                    m[row][column] = i == 0 ? value : m[row][column] + value;
+
+                    if (needNormal && row < 3)
+                    {
+                        float normalValue = well.skeletonSpaceInverseTransposeMatrix.m[row][column] * weight;
+                        n[row][column] = i == 0 ? normalValue : n[row][column] + normalValue;
+                    }
+                }
+            }
+        }
+
+        const Vector4& p = vertex.position;
+        float position[4];
+        for (uint32_t column = 0; column < 4; ++column)
+        {
+            position[column] = (p.x * m[0][column] + p.z * m[2][column]) + (p.y * m[1][column] + p.w * m[3][column]);
+        }
+
+        float normal[3] = {};
+        if (needNormal)
+        {
+            const Vector3& v = vertex.normal;
+            for (uint32_t column = 0; column < 3; ++column)
+            {
+                normal[column] = (v.x * n[0][column] + v.z * n[2][column]) + v.y * n[1][column];
+            }
+        }
+
+        WriteResult(_job, index, vertexIndex, position, normal);
+    }
+}
+
+void SkinRange_SSE(const SkinningJob& _job, uint32_t _begin, uint32_t _end)
+{
+    bool needNormal = _job.output != nullptr;
+
+    for (uint32_t index = _begin; index < _end; ++index)
+    {
+        uint32_t vertexIndex = _job.indices ? _job.indices[index] : index;
+        const VertexData& vertex = _job.input[vertexIndex];
+        const VertexInfluenceData& influence = _job.influences[vertexIndex];
+
+        __m128 m[4];
+        __m128 n[3];
+        for (uint32_t i = 0; i < influenceNum_; ++i)
+        {
+            const WellForGPU& well = _job.palette[influence.jointIndices[i]];
+            __m128 weight = _mm_set1_ps(influence.weights[i]);
+            for (uint32_t row = 0; row < 4; ++row)
+            {
+                __m128 value = _mm_mul_ps(_mm_loadu_ps(well.skeletonSpaceMatrix.m[row]), weight);
+                m[row] = i == 0 ? value : _mm_add_ps(m[row], value);
+            }
+            if (needNormal)
+            {
+                for (uint32_t row = 0; row < 3; ++row)
+                {
+                    __m128 value = _mm_mul_ps(_mm_loadu_ps(well.skeletonSpaceInverseTransposeMatrix.m[row]), weight);
+                    n[row] = i == 0 ? value : _mm_add_ps(n[row], value);
+                }
+            }
+        }
+
+        const Vector4& p = vertex.position;
+        __m128 xz = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), m[0]), _mm_mul_ps(_mm_set1_ps(p.z), m[2]));
+        __m128 yw = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.y), m[1]), _mm_mul_ps(_mm_set1_ps(p.w), m[3]));
+        alignas(16) float position[4];
+        _mm_store_ps(position, _mm_add_ps(xz, yw));
+
+        alignas(16) float normal[4] = {};
+        if (needNormal)
+        {
+            const Vector3& v = vertex.normal;
+            __m128 nxz = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v.x), n[0]), _mm_mul_ps(_mm_set1_ps(v.z), n[2]));
+            _mm_store_ps(normal, _mm_add_ps(nxz, _mm_mul_ps(_mm_set1_ps(v.y), n[1])));
+        }
+
+        WriteResult(_job, index, vertexIndex, position, normal);
+    }
+}
+
+// 行列の2行を1つの256bitレジスタで扱う
+void SkinRange_AVX(const SkinningJob& _job, uint32_t _begin, uint32_t _end)
+{
+    bool needNormal = _job.output != nullptr;
+
+    for (uint32_t index = _begin; index < _end; ++index)
+    {
+        uint32_t vertexIndex = _job.indices ? _job.indices[index] : index;
+        const VertexData& vertex = _job.input[vertexIndex];
+        const VertexInfluenceData& influence = _job.influences[vertexIndex];
+
+        __m256 m01, m23, n01, n23;
+        for (uint32_t i = 0; i < influenceNum_; ++i)
+        {
+            const WellForGPU& well = _job.palette[influence.jointIndices[i]];
+            __m256 weight = _mm256_set1_ps(influence.weights[i]);
+
+            __m256 value01 = _mm256_mul_ps(_mm256_loadu_ps(well.skeletonSpaceMatrix.m[0]), weight);
+            __m256 value23 = _mm256_mul_ps(_mm256_loadu_ps(well.skeletonSpaceMatrix.m[2]), weight);
+            m01 = i == 0 ? value01 : _mm256_add_ps(m01, value01);
+            m23 = i == 0 ? value23 : _mm256_add_ps(m23, value23);
+
+            if (needNormal)
+            {
+                __m256 normal01 = _mm256_mul_ps(_mm256_loadu_ps(well.skeletonSpaceInverseTransposeMatrix.m[0]), weight);
+                __m256 normal23 = _mm256_mul_ps(_mm256_loadu_ps(well.skeletonSpaceInverseTransposeMatrix.m[2]), weight);
+                n01 = i == 0 ? normal01 : _mm256_add_ps(n01, normal01);
+                n23 = i == 0 ? normal23 : _mm256_add_ps(n23, normal23);
+            }
+        }
+
+        // 下位は x*m0 + z*m2、上位は y*m1 + w*m3
+        const Vector4& p = vertex.position;
+        __m256 xy = _mm256_setr_ps(p.x, p.x, p.x, p.x, p.y, p.y, p.y, p.y);
+        __m256 zw = _mm256_setr_ps(p.z, p.z, p.z, p.z, p.w, p.w, p.w, p.w);
+        __m256 sum = _mm256_add_ps(_mm256_mul_ps(xy, m01), _mm256_mul_ps(zw, m23));
+        alignas(16) float position[4];
+        _mm_store_ps(position, _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1)));
+
+        alignas(16) float normal[4] = {};
+        if (needNormal)
+        {
+            // 4行目は使わないので上位の重みは0
+            const Vector3& v = vertex.normal;
+            __m256 nxy = _mm256_setr_ps(v.x, v.x, v.x, v.x, v.y, v.y, v.y, v.y);
+            __m256 nz = _mm256_setr_ps(v.z, v.z, v.z, v.z, 0.0f, 0.0f, 0.0f, 0.0f);
+            __m256 normalSum = _mm256_add_ps(_mm256_mul_ps(nxy, n01), _mm256_mul_ps(nz, n23));
+            _mm_store_ps(normal, _mm_add_ps(_mm256_castps256_ps128(normalSum), _mm256_extractf128_ps(normalSum, 1)));
+        }
+
+        WriteResult(_job, index, vertexIndex, position, normal);
+    }
+
+    // SSEの命令に切り替わるときの遅延を避ける
+    _mm256_zeroupper();
+}
+
+SkinRangeFunc GetSkinRangeFunc(SkinningCPU::Kernel _kernel)
+{
+    switch (_kernel)
+    {
+    case SkinningCPU::Kernel::AVX:
+        return SkinRange_AVX;
+    case SkinningCPU::Kernel::SSE:
+        return SkinRange_SSE;
+    default:
+        return SkinRange_Scalar;
+    }
+}
+
+} // namespace
+
+void SkinningCPU::Execute(std::span<const VertexData> _input, std::span<const VertexInfluenceData> _influences, std::span<const WellForGPU> _palette, std::span<VertexData> _output) const
+{
+    assert(_influences.size() >= _input.size());
+    assert(_output.size() >= _input.size());
+
+    if (_input.empty() || _palette.empty())
+        return;
+
+    SkinningJob job = {};
+    job.input = _input.data();
+    job.influences = _influences.data();
+    job.palette = _palette.data();
+    job.output = _output.data();
+
+    SkinRangeFunc skinRange = GetSkinRangeFunc(GetResolvedKernel());
+    uint32_t count = static_cast<uint32_t>(_input.size());
+
+    if (isParallel_ && count > batchSize_)
+        JobSystem::GetInstance()->ParallelFor(count, batchSize_, [&](uint32_t _begin, uint32_t _end) { skinRange(job, _begin, _end); });
+    else
+        skinRange(job, 0, count);
+}
+
+void SkinningCPU::ExecuteSubset(std::span<const VertexData> _input, std::span<const VertexInfluenceData> _influences, std::span<const WellForGPU> _palette,
+    std::span<const uint32_t> _vertexIndices, std::span<Vector3> _positions) const
+{
+    assert(_influences.size() >= _input.size());
+    assert(_positions.size() >= _vertexIndices.size());
+
+    if (_vertexIndices.empty() || _palette.empty())
+        return;
+
+    SkinningJob job = {};
+    job.input = _input.data();
+    job.influences = _influences.data();
+    job.palette = _palette.data();
+    job.indices = _vertexIndices.data();
+    job.positions = _positions.data();
+
+    SkinRangeFunc skinRange = GetSkinRangeFunc(GetResolvedKernel());
+    uint32_t count = static_cast<uint32_t>(_vertexIndices.size());
+
+    if (isParallel_ && count > batchSize_)
+        JobSystem::GetInstance()->ParallelFor(count, batchSize_, [&](uint32_t _begin, uint32_t _end) { skinRange(job, _begin, _end); });
+    else
+        skinRange(job, 0, count);
+}
+
+void SkinningCPU::CalculateBounds(std::span<const VertexData> _vertices, Vector3& _min, Vector3& _max)
+{
+    constexpr float kMax = (std::numeric_limits<float>::max)();
+    _min = Vector3(kMax, kMax, kMax);
+    _max = Vector3(-kMax, -kMax, -kMax);
+
+    for (const VertexData& vertex : _vertices)
+    {
+        _min = Vector3((std::min)(_min.x, vertex.position.x), (std::min)(_min.y, vertex.position.y), (std::min)(_min.z, vertex.position.z));
+        _max = Vector3((std::max)(_max.x, vertex.position.x), (std::max)(_max.y, vertex.position.y), (std::max)(_max.z, vertex.position.z));
+    }
+}
+
+void SkinningCPU::CalculateBounds(std::span<const Vector3> _positions, Vector3& _min, Vector3& _max)
+{
+    constexpr float kMax = (std::numeric_limits<float>::max)();
+    _min = Vector3(kMax, kMax, kMax);
+    _max = Vector3(-kMax, -kMax, -kMax);
+
+    for (const Vector3& position : _positions)
+    {
+        _min = Vector3((std::min)(_min.x, position.x), (std::min)(_min.y, position.y), (std::min)(_min.z, position.z));
+        _max = Vector3((std::max)(_max.x, position.x), (std::max)(_max.y, position.y), (std::max)(_max.z, position.z));
+    }
+}
+
+SkinningCPU::Kernel SkinningCPU::GetResolvedKernel() const
+{
+    if (kernel_ == Kernel::Auto)
+        return IsAVXSupported() ? Kernel::AVX : Kernel::SSE;
+
+    // 対応していなければSSEで処理する
+    if (kernel_ == Kernel::AVX && !IsAVXSupported())
+        return Kernel::SSE;
+
+    return kernel_;
+}
+
+void SkinningCPU::SetParallel(bool _isParallel, uint32_t _batchSize)
+{
+    isParallel_ = _isParallel;
+    batchSize_ = (std::max)(_batchSize, 1u);
+}
+
+bool SkinningCPU::IsAVXSupported()
+{
+    static const bool isSupported = []()
+        {
+            int info[4] = {};
+            __cpuid(info, 1);
+
+            // AVXとOSによるYMMレジスタの保存(OSXSAVE)
+            bool hasAVX = (info[2] & (1 << 28)) != 0;
+            bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+            if (!hasAVX || !hasOSXSAVE)
+                return false;
+
+            // XMMとYMMの状態をOSが保存するか
+            return (_xgetbv(0) & 0x6) == 0x6;
+        }();
+
+    return isSupported;
+}
+
+} // namespace Engine
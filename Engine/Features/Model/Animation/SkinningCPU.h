@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Features/Model/Animation/SkinCluster/SkinCluster.h>
+#include <Features/Model/Mesh/Mesh.h>
+
+#include <cstdint>
+#include <span>
+
+
+namespace Engine {
+
+/// <summary>
+/// SkinningCSと同じインフルエンスとパレットを使ってCPUでスキニングする
+/// GPUのない環境でのスキニング後の範囲や当たり判定用
+/// 頂点の範囲をJobSystemで分割して処理する
+/// 行列をインフルエンスの重みで合成してから頂点に掛けるので、SkinningCSとは丸め誤差の分だけ異なる
+/// どのカーネルでも同じ順で計算するので、カーネル間では結果が一致する
+/// </summary>
+class SkinningCPU
+{
+public:
+    enum class Kernel
+    {
+        Auto,   // 使える中で最も速いもの
+        Scalar,
+        SSE,
+        AVX,
+    };
+
+    SkinningCPU() = default;
+    ~SkinningCPU() = default;
+
+    /// <summary>
+    /// 全頂点をスキニングする
+    /// </summary>
+    /// <param name="_input">スキニング前の頂点</param>
+    /// <param name="_influences">頂点毎のインフルエンス</param>
+    /// <param name="_palette">ジョイント毎の行列</param>
+    /// <param name="_output">スキニング後の頂点の書き込み先 _inputと同じ数</param>
+    void Execute(std::span<const VertexData> _input, std::span<const VertexInfluenceData> _influences, std::span<const WellForGPU> _palette, std::span<VertexData> _output) const;
+
+    /// <summary>
+    /// 指定した頂点の位置だけをスキニングする 当たり判定のプロキシ用
+    /// </summary>
+    /// <param name="_vertexIndices">スキニングする頂点の添え字</param>
+    /// <param name="_positions">位置の書き込み先 _vertexIndicesと同じ並び</param>
+    void ExecuteSubset(std::span<const VertexData> _input, std::span<const VertexInfluenceData> _influences, std::span<const WellForGPU> _palette,
+        std::span<const uint32_t> _vertexIndices, std::span<Vector3> _positions) const;
+
+    // スキニング後の位置を囲む範囲を求める
+    static void CalculateBounds(std::span<const VertexData> _vertices, Vector3& _min, Vector3& _max);
+    static void CalculateBounds(std::span<const Vector3> _positions, Vector3& _min, Vector3& _max);
+
+    void SetKernel(Kernel _kernel) { kernel_ = _kernel; }
+    Kernel GetKernel() const { return kernel_; }
+    // Autoを解決した実際に使うカーネル
+    Kernel GetResolvedKernel() const;
+
+    // 並列に処理するか、1回に処理する頂点数
+    void SetParallel(bool _isParallel, uint32_t _batchSize = kDefaultBatchSize);
+    bool IsParallel() const { return isParallel_; }
+    uint32_t GetBatchSize() const { return batchSize_; }
+
+    // CPUとOSがAVXに対応しているか
+    static bool IsAVXSupported();
+
+    static constexpr uint32_t kDefaultBatchSize = 1024;
+
+private:
+    Kernel kernel_ = Kernel::Auto;
+    bool isParallel_ = true;
+    uint32_t batchSize_ = kDefaultBatchSize;
+};
+
+} // namespace Engine
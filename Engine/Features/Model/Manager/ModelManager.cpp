@@ -4,7 +4,10 @@
 #include <Core/DXCommon/DXCommon.h>
 #include <Debug/Debug.h>
 #include <Debug/ImGuiDebugManager.h>
+#include <Features/Model/Animation/Benchmark/AnimationBenchmark.h>
+#include <Features/Model/Animation/Controller/AnimationController.h>
 #include <cassert>
+#include <format>
 
 
 namespace Engine {
@@ -110,6 +113,52 @@ void ModelManager::ImGui([[maybe_unused]]bool* _open)
         ImGui::PopID();
     }
 
+    // アニメーションの圧縮 クリップ毎に削減量と最大誤差をログに出力する
+    if (ImGui::TreeNode("Animation Compression"))
+    {
+        ImGui::DragFloat("Translation Tolerance", &clipCompressionSettings_.translationTolerance, 0.0001f, 0.0f, 1.0f, "%.4f");
+        ImGui::DragFloat("Rotation Tolerance(deg)", &clipCompressionSettings_.rotationTolerance, 0.01f, 0.0f, 10.0f, "%.3f");
+        ImGui::DragFloat("Scale Tolerance", &clipCompressionSettings_.scaleTolerance, 0.0001f, 0.0f, 1.0f, "%.4f");
+
+        if (ImGui::Button("Compress Animations"))
+        {
+            for (const auto& [key, model] : models_)
+            {
+                for (const ClipCompressionReport& report : model->CompressAnimations(clipCompressionSettings_))
+                {
+                    float ratio = report.sourceBytes > 0 ? static_cast<float>(report.compressedBytes) / static_cast<float>(report.sourceBytes) * 100.0f : 0.0f;
+                    Debug::Log(std::format("[ClipCompression] {} keys: {} -> {} constant tracks: {} / {} bytes: {} -> {} ({:.1f}%) max error t: {:.6f} r: {:.4f} deg s: {:.6f}\n",
+                        report.clipName, report.sourceKeyCount, report.compressedKeyCount, report.constantTrackCount, report.trackCount,
+                        report.sourceBytes, report.compressedBytes, ratio, report.maxTranslationError, report.maxRotationError, report.maxScaleError));
+                }
+            }
+        }
+        ImGui::TreePop();
+    }
+
+    // アニメーションLOD 前回表示してからの全AnimationControllerの集計
+    AnimationLODFrameStats lodStats = AnimationController::TakeLODFrameStats();
+    ImGui::Text("Animation LOD: %u updates / %u evaluated, joints %u / %u",
+        lodStats.updateCount, lodStats.evaluatedCount, lodStats.evaluatedJointCount, lodStats.jointCount);
+
+    // チャンネルの結び付けのベンチマーク（名前で探す方式 vs 結び付けた表）
+    if (ImGui::Button("Run ChannelBinding Benchmark"))
+    {
+        AnimationBenchmark::RunChannelBindingSuite();
+    }
+
+    // キーフレームのサンプリングのベンチマーク（先頭から探す方式 vs 前回の区間から探す方式）
+    if (ImGui::Button("Run KeyframeSampling Benchmark"))
+    {
+        AnimationBenchmark::RunKeyframeSamplingSuite();
+    }
+
+    // CPUスキニングのベンチマーク（スカラー vs SSE vs AVX、1スレッド vs 並列）
+    if (ImGui::Button("Run CpuSkinning Benchmark"))
+    {
+        AnimationBenchmark::RunCpuSkinningSuite();
+    }
+
     ImGui::PopID();
     ImGui::End();
 
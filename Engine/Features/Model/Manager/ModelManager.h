@@ -50,6 +50,9 @@ private:
     PSOFlags psoFlags_ = {};
     PSOFlags psoFlagsForAlpha_{};
 
+    // アニメーションの圧縮の許容誤差
+    ClipCompressionSettings clipCompressionSettings_ = {};
+
 
 
 private:
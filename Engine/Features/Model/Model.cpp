@@ -359,6 +359,18 @@ Vector3 Model::GetMax(size_t _index) const
 
 }
 
+std::vector<ClipCompressionReport> Model::CompressAnimations(const ClipCompressionSettings& _settings)
+{
+    std::vector<ClipCompressionReport> reports;
+    for (auto& [name, animation] : animation_)
+    {
+        ClipCompressionReport report = animation->Compress(_settings);
+        report.clipName = name_ + "/" + name;
+        reports.push_back(report);
+    }
+    return reports;
+}
+
 bool Model::HasAnimation() const
 {
     return !animation_.empty();
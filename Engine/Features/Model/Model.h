@@ -8,6 +8,7 @@
 #include <Features/Model/Mesh/Mesh.h>
 #include <Features/Model/Mesh/MargedMesh.h>
 #include <Features/Model/Animation/ModelAnimation.h>
+#include <Features/Model/Animation/Clip/CompressedAnimationClip.h>
 #include <Features/Model/Animation/Node/Node.h>
 #include <Features/Model/Animation/SkinningCS.h>
 #include <Features/Model/Animation/Skeleton/Skeleton.h>
@@ -56,6 +57,9 @@ public:
     const std::vector<std::unique_ptr<Mesh>>& GetMeshes() const { return mesh_; }
     const ModelAnimation* GetAnimation(const std::string& _name) const;
 
+    // 読み込んだアニメーションを全て圧縮する 以降に再生するものは圧縮したクリップを使う
+    std::vector<ClipCompressionReport> CompressAnimations(const ClipCompressionSettings& _settings);
+
 
     UVTransform& GetUVTransform(uint32_t _index = 0) { return material_[_index]->GetUVTransform(); }
 
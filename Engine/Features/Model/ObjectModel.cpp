@@ -8,6 +8,8 @@
 #include <Core/DXCommon/PSOManager/PSOManager.h>
 #include <Debug/Debug.h>
 
+#include <cmath>
+
 
 
 namespace Engine {
@@ -56,6 +58,21 @@ void ObjectModel::Update()
 
     if(model_->HasAnimation())
     {
+        if (uniqueAnimationController_ && lodCamera_)
+        {
+            // 画面外の判定は原点のみで行うので、モデルの大きさの分だけ広めにとる
+            constexpr float kViewMargin = 1.2f;
+
+            Vector3 position = worldTransform_.GetWorldPosition();
+            Matrix4x4 viewProjection = lodCamera_->GetViewProjection();
+            float clipX = position.x * viewProjection.m[0][0] + position.y * viewProjection.m[1][0] + position.z * viewProjection.m[2][0] + viewProjection.m[3][0];
+            float clipY = position.x * viewProjection.m[0][1] + position.y * viewProjection.m[1][1] + position.z * viewProjection.m[2][1] + viewProjection.m[3][1];
+            float clipW = position.x * viewProjection.m[0][3] + position.y * viewProjection.m[1][3] + position.z * viewProjection.m[2][3] + viewProjection.m[3][3];
+            bool isVisible = clipW > 0.0f && std::abs(clipX) <= clipW * kViewMargin && std::abs(clipY) <= clipW * kViewMargin;
+
+            uniqueAnimationController_->SetLODDistance((position - lodCamera_->translate_).Length(), isVisible);
+        }
+
         if (uniqueAnimationController_ &&uniqueAnimationController_->IsAnimationPlaying())
         {
             uniqueAnimationController_->Update(gameTime_->GetChannel(timeChannel).GetDeltaTime<float>());
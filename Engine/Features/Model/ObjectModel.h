@@ -61,6 +61,9 @@ public:
 
     void SetTimeChannel(const std::string& _channelName) { timeChannel = _channelName; }
 
+    // アニメーションLODの距離と画面内の判定に使うカメラ nullptrならLODの距離を更新しない
+    void SetAnimationLODCamera(const Camera* _camera) { lodCamera_ = _camera; }
+
     std::string GetName() const{ return name_; }
 
     std::unique_ptr<AnimationController> GetAnimationController();
@@ -92,6 +95,8 @@ private:
     Model* model_ = nullptr;
     std::string name_ = "";
 
+    const Camera* lodCamera_ = nullptr;
+
 
     std::string timeChannel = "default";
     GameTime* gameTime_ = nullptr;
@@ -3,6 +3,8 @@
 #include <Math/Matrix/MatrixFunction.h>
 #include <Core/DXCommon/DXCommon.h>
 
+#include <cstring>
+
 
 namespace Engine {
 
@@ -16,12 +18,15 @@ void WorldTransform::Initialize()
     transform_ = { 0.0f,0.0f ,0.0f };
 
     matWorld_ = MakeAffineMatrix(scale_, rotate_, transform_);
+    AdvanceVersion();
 }
 
 void WorldTransform::UpdateData(bool _useQuaternion)
 {
     SyncRotataion(_useQuaternion);
 
+    Matrix4x4 previous = matWorld_;
+
     matWorld_ = MakeAffineMatrix(scale_, quaternion_, transform_);
 
     if (parentMatrix_)
@@ -33,6 +38,7 @@ void WorldTransform::UpdateData(bool _useQuaternion)
         matWorld_ *= parent_->matWorld_;
     }
 
+    UpdateVersion(previous);
     TransferData();
 }
 
@@ -73,6 +79,7 @@ void WorldTransform::UpdateData(const std::initializer_list<Matrix4x4>& _mat, bo
 {
     SyncRotataion(_useQuaternion);
 
+    Matrix4x4 previous = matWorld_;
     Matrix4x4 matrix = MakeIdentity4x4();
     for (auto& mat : _mat)
     {
@@ -87,9 +94,30 @@ void WorldTransform::UpdateData(const std::initializer_list<Matrix4x4>& _mat, bo
     {
         matWorld_ *= *parentMatrix_;
     }
+    UpdateVersion(previous);
     TransferData();
 }
 
+void WorldTransform::UpdateVersion(const Matrix4x4& _previous)
+{
+    if (std::memcmp(&_previous, &matWorld_, sizeof(Matrix4x4)) != 0)
+        AdvanceVersion();
+}
+
+void WorldTransform::AdvanceVersion()
+{
+    ++version_;
+    if (versionNotifier_)
+        versionNotifier_->Notify();
+}
+
+std::shared_ptr<ChangeNotifier> WorldTransform::GetVersionNotifier()
+{
+    if (!versionNotifier_)
+        versionNotifier_ = std::make_shared<ChangeNotifier>();
+    return versionNotifier_;
+}
+
 void WorldTransform::TransferData()
 {
     constMap_->World = matWorld_;
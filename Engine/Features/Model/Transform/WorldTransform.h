@@ -3,10 +3,13 @@
 #include <Math/Vector/Vector3.h>
 #include <Math/Matrix/Matrix4x4.h>
 #include <Math/Quaternion/Quaternion.h>
+#include <Utility/ChangeNotifier/ChangeNotifier.h>
 
 #include <d3d12.h>
 #include <wrl.h>
 #include <initializer_list>
+#include <cstdint>
+#include <memory>
 
 
 namespace Engine {
@@ -33,6 +36,15 @@ public:
     void SetParent(const WorldTransform* _parent);
     void SetParent(const Matrix4x4* _parentMatrix);
 
+    // ワールド行列が変わるたびに増える 動いたかどうかの判定に使う
+    uint32_t GetVersion() const { return version_; }
+    // matWorld_を直接書き換えた場合に呼ぶ
+    void MarkDirty() { AdvanceVersion(); }
+
+    // version_が進んだときの通知先 常駐コライダーが動いたものだけを処理するのに使う
+    // 登録側がWorldTransformより長く生きることがあるのでshared_ptrで渡す
+    std::shared_ptr<ChangeNotifier> GetVersionNotifier();
+
 
 
     Vector3 scale_ = { 1.0f,1.0f ,1.0f };
@@ -50,6 +62,14 @@ private:
 
     bool wasUsingQuaternion_ = false; // 前回クォータニオンを使用していたかどうか
 
+    uint32_t version_ = 0;
+    std::shared_ptr<ChangeNotifier> versionNotifier_; // 登録されるまでは作らない
+
+    // 行列が変わっていればversion_を進める
+    void UpdateVersion(const Matrix4x4& _previous);
+    // version_を進めて通知する
+    void AdvanceVersion();
+
     struct DataForGPU
     {
         Matrix4x4 World;
@@ -9,8 +9,10 @@
 #include <Features/Model/Manager/ModelManager.h>
 #include <Features/Event/EventManager.h>
 #include <System/Audio/AudioSystem.h>
+#include <System/Job/JobSystem.h>
 #include <Framework/LayerSystem/LayerSystem.h>
 #include <Settings/EngineSettings.h>
+#include <Features/Json/Pack/ParameterPack.h>
 
 #include <Debug/ImGuiDebugManager.h>
 #include <Features/Model/Primitive/Builder/PrimitiveBuilder.h>
@@ -58,6 +60,9 @@ void Framework::Initialize(const std::wstring& _winTitle)
 #ifdef _DEBUG
     ImGuiDebugManager::GetInstance()->Initialize();
 #endif
+
+    // 以降のJSONの読み込みはリリースビルドではパックから行う
+    ParameterPack::GetInstance()->Initialize();
     imguiManager_ = new ImGuiManager();
     imguiManager_->Initialize();
 
@@ -119,6 +124,7 @@ void Framework::Initialize(const std::wstring& _winTitle)
     sceneManager_ = SceneManager::GetInstance();
 
     Time_MT::GetInstance()->Initialize();
+    JobSystem::GetInstance()->Initialize();
 
     //LayerSystem::Initialize();
 
@@ -166,6 +172,8 @@ void Framework::Finalize()
     LayerSystem::Finalize();
 
     Time_MT::GetInstance()->Finalize();
+    JobSystem::GetInstance()->Finalize();
+    ParameterPack::GetInstance()->Finalize();
     collisionManager_->Finalize();
     textRenderer_->Finalize();
     imguiManager_->Finalize();
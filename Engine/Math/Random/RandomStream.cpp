@@ -0,0 +1,162 @@
+#include <Math/Random/RandomStream.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numbers>
+
+
+namespace Engine {
+
+namespace {
+
+// シードを状態に広げる (splitmix64)
+uint64_t SplitMix64(uint64_t& _x)
+{
+    uint64_t z = (_x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+void RandomStream::Seed(uint64_t _seed)
+{
+    uint64_t x = _seed;
+    uint64_t a = SplitMix64(x);
+    uint64_t b = SplitMix64(x);
+
+    state_[0] = static_cast<uint32_t>(a);
+    state_[1] = static_cast<uint32_t>(a >> 32);
+    state_[2] = static_cast<uint32_t>(b);
+    state_[3] = static_cast<uint32_t>(b >> 32);
+
+    // 状態が全て0だと0しか出なくなる
+    if ((state_[0] | state_[1] | state_[2] | state_[3]) == 0)
+        state_[0] = 1;
+}
+
+RandomStream RandomStream::Split()
+{
+    uint64_t seed = static_cast<uint64_t>(NextUInt()) | (static_cast<uint64_t>(NextUInt()) << 32);
+    return RandomStream(seed);
+}
+
+int RandomStream::GetRandValue(int _min, int _max)
+{
+    if (_min > _max)
+    {
+        int temp = _min;
+        _min = _max;
+        _max = temp;
+    }
+
+    // [0, range)に縮める（乗算による方法 偏りは範囲が2^32に比べて十分小さければ無視できる）
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(_max) - static_cast<int64_t>(_min)) + 1;
+    uint64_t offset = (static_cast<uint64_t>(NextUInt()) * range) >> 32;
+    return static_cast<int>(static_cast<int64_t>(_min) + static_cast<int64_t>(offset));
+}
+
+Vector2 RandomStream::GetRandValue(const Vector2& _min, const Vector2& _max)
+{
+    Vector2 result;
+    result.x = GetRandValue(_min.x, _max.x);
+    result.y = GetRandValue(_min.y, _max.y);
+    return result;
+}
+
+Vector3 RandomStream::GetRandValue(const Vector3& _min, const Vector3& _max)
+{
+    Vector3 result;
+    result.x = GetRandValue(_min.x, _max.x);
+    result.y = GetRandValue(_min.y, _max.y);
+    result.z = GetRandValue(_min.z, _max.z);
+    return result;
+}
+
+Vector4 RandomStream::GetRandValue(const Vector4& _min, const Vector4& _max)
+{
+    Vector4 result;
+    result.x = GetRandValue(_min.x, _max.x);
+    result.y = GetRandValue(_min.y, _max.y);
+    result.z = GetRandValue(_min.z, _max.z);
+    result.w = GetRandValue(_min.w, _max.w);
+    return result;
+}
+
+float RandomStream::GetUniformAngle()
+{
+    return NextFloat() * std::numbers::pi_v<float> * 2.0f;
+}
+
+Vector3 RandomStream::GetOnSphere(float _radius)
+{
+    // zを一様に選ぶと球面上で一様になる
+    float z = NextFloat() * 2.0f - 1.0f;
+    float angle = GetUniformAngle();
+    float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+
+    return Vector3(r * std::cos(angle) * _radius, r * std::sin(angle) * _radius, z * _radius);
+}
+
+void RandomStream::Fill(std::span<float> _out, float _min, float _max)
+{
+    if (_min > _max)
+    {
+        float temp = _min;
+        _min = _max;
+        _max = temp;
+    }
+
+    float width = _max - _min;
+    for (float& value : _out)
+    {
+        value = _min + width * NextFloat();
+    }
+}
+
+void RandomStream::Fill(std::span<Vector3> _out, const Vector3& _min, const Vector3& _max)
+{
+    // 要素毎の下限と幅は先に求めておく
+    Vector3 low(std::min(_min.x, _max.x), std::min(_min.y, _max.y), std::min(_min.z, _max.z));
+    Vector3 width = Vector3(std::max(_min.x, _max.x), std::max(_min.y, _max.y), std::max(_min.z, _max.z)) - low;
+
+    for (Vector3& value : _out)
+    {
+        value.x = low.x + width.x * NextFloat();
+        value.y = low.y + width.y * NextFloat();
+        value.z = low.z + width.z * NextFloat();
+    }
+}
+
+void RandomStream::Fill(std::span<Vector4> _out, const Vector4& _min, const Vector4& _max)
+{
+    Vector4 low(std::min(_min.x, _max.x), std::min(_min.y, _max.y), std::min(_min.z, _max.z), std::min(_min.w, _max.w));
+    Vector4 width(std::max(_min.x, _max.x) - low.x, std::max(_min.y, _max.y) - low.y, std::max(_min.z, _max.z) - low.z, std::max(_min.w, _max.w) - low.w);
+
+    for (Vector4& value : _out)
+    {
+        value.x = low.x + width.x * NextFloat();
+        value.y = low.y + width.y * NextFloat();
+        value.z = low.z + width.z * NextFloat();
+        value.w = low.w + width.w * NextFloat();
+    }
+}
+
+void RandomStream::FillOnSphere(std::span<Vector3> _out, float _radius)
+{
+    for (Vector3& value : _out)
+    {
+        value = GetOnSphere(_radius);
+    }
+}
+
+RandomStream& RandomStream::GetThreadInstance()
+{
+    static std::atomic<uint64_t> threadCounter = 0;
+    thread_local RandomStream instance(kDefaultSeed + threadCounter.fetch_add(1));
+    return instance;
+}
+
+} // namespace Engine
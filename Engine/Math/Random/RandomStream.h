@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Math/Vector/Vector2.h>
+#include <Math/Vector/Vector3.h>
+#include <Math/Vector/Vector4.h>
+
+#include <cstdint>
+#include <span>
+
+
+namespace Engine {
+
+/// <summary>
+/// 状態が小さく高速な乱数列 (xoshiro128**)
+/// RandomGeneratorと違いインスタンス毎に独立しているので、エミッターやスレッド毎に持たせて使う
+/// 同じシードからは同じ列が得られる
+/// スレッドセーフではないため、1つのインスタンスを複数スレッドから同時に使わないこと
+/// </summary>
+class RandomStream
+{
+public:
+    RandomStream() { Seed(kDefaultSeed); }
+    explicit RandomStream(uint64_t _seed) { Seed(_seed); }
+
+    // シードを設定する
+    void Seed(uint64_t _seed);
+
+    // この列から独立した子の列を作る
+    RandomStream Split();
+
+    // 32bitの乱数
+    uint32_t NextUInt()
+    {
+        const uint32_t result = RotateLeft(state_[1] * 5, 7) * 9;
+        const uint32_t t = state_[1] << 9;
+
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = RotateLeft(state_[3], 11);
+
+        return result;
+    }
+
+    // [0, 1)の乱数
+    float NextFloat() { return static_cast<float>(NextUInt() >> 8) * 0x1.0p-24f; }
+
+    // [_min, _max]の整数
+    int GetRandValue(int _min, int _max);
+
+    // [_min, _max)の乱数 _min > _maxの場合は入れ替える
+    float GetRandValue(float _min, float _max)
+    {
+        if (_min > _max)
+        {
+            float temp = _min;
+            _min = _max;
+            _max = temp;
+        }
+        return _min + (_max - _min) * NextFloat();
+    }
+
+    Vector2 GetRandValue(const Vector2& _min, const Vector2& _max);
+    Vector3 GetRandValue(const Vector3& _min, const Vector3& _max);
+    Vector4 GetRandValue(const Vector4& _min, const Vector4& _max);
+
+    // [0, 2π)の角度
+    float GetUniformAngle();
+
+    // 半径_radiusの球面上の一様な点
+    Vector3 GetOnSphere(float _radius = 1.0f);
+
+    // === まとめて生成する ===
+    void Fill(std::span<float> _out, float _min, float _max);
+    void Fill(std::span<Vector3> _out, const Vector3& _min, const Vector3& _max);
+    void Fill(std::span<Vector4> _out, const Vector4& _min, const Vector4& _max);
+    void FillOnSphere(std::span<Vector3> _out, float _radius = 1.0f);
+
+    /// <summary>
+    /// 呼び出したスレッド専用のインスタンスを取得する
+    /// シードはスレッドが初めて呼んだ順番で決まるため、スレッド数が変わると列も変わる
+    /// 再現性が必要な場合はインスタンスを持ってシードを指定すること
+    /// </summary>
+    static RandomStream& GetThreadInstance();
+
+private:
+    static constexpr uint64_t kDefaultSeed = 0x853c49e6748fea9bull;
+
+    static uint32_t RotateLeft(uint32_t _x, int _k) { return (_x << _k) | (_x >> (32 - _k)); }
+
+    uint32_t state_[4] = {};
+};
+
+} // namespace Engine
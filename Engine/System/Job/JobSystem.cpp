@@ -0,0 +1,179 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+
+namespace Engine {
+
+namespace {
+
+// ワーカースレッドかどうか
+thread_local bool tIsWorkerThread = false;
+
+// ParallelForの処理中の呼び出しスレッドかどうか
+thread_local bool tIsDispatching = false;
+
+} // namespace
+
+JobSystem* JobSystem::GetInstance()
+{
+    static JobSystem instance;
+    return &instance;
+}
+
+void JobSystem::Initialize(uint32_t _workerCount)
+{
+    // すでに初期化済みの場合は何もしない
+    if (isRunning_)
+        return;
+
+    if (_workerCount == 0)
+    {
+        uint32_t hardwareCount = std::thread::hardware_concurrency();
+        _workerCount = hardwareCount > 1 ? hardwareCount - 1 : 0;
+    }
+
+    isRunning_ = true;
+    workers_.reserve(_workerCount);
+    for (uint32_t i = 0; i < _workerCount; ++i)
+    {
+        workers_.emplace_back(&JobSystem::WorkerThreadFunc, this);
+    }
+}
+
+void JobSystem::Finalize()
+{
+    if (!isRunning_)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isRunning_ = false;
+    }
+
+    // 待機中のスレッドを解放
+    cv_.notify_all();
+
+    // スレッドの終了を待つ
+    for (auto& worker : workers_)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+void JobSystem::ParallelFor(uint32_t _count, uint32_t _chunkSize, const std::function<void(uint32_t, uint32_t)>& _func)
+{
+    if (_count == 0)
+        return;
+
+    if (_chunkSize == 0)
+        _chunkSize = _count;
+
+    uint32_t chunkCount = GetChunkCount(_count, _chunkSize);
+
+    // 並列化できない場合はその場で順に処理
+    // チャンクの中から呼ばれた場合もdispatchMutex_を取り直さないようにその場で処理する
+    if (workers_.empty() || chunkCount == 1 || IsWorkerThread() || tIsDispatching)
+    {
+        for (uint32_t begin = 0; begin < _count; begin += _chunkSize)
+        {
+            _func(begin, std::min(begin + _chunkSize, _count));
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> dispatchLock(dispatchMutex_);
+    tIsDispatching = true;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &_func;
+        jobCount_ = _count;
+        jobChunkSize_ = _chunkSize;
+        nextChunk_ = 0;
+        remainingChunks_ = chunkCount;
+        ++jobGeneration_;
+    }
+    cv_.notify_all();
+
+    // 呼び出したスレッドも処理する
+    ProcessChunks(&_func, _count, _chunkSize);
+
+    // 全チャンクの完了と、ジョブを参照しているワーカーがいなくなるのを待つ
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [this]() { return remainingChunks_ == 0 && activeWorkers_ == 0; });
+    job_ = nullptr;
+    tIsDispatching = false;
+}
+
+bool JobSystem::IsWorkerThread()
+{
+    return tIsWorkerThread;
+}
+
+void JobSystem::WorkerThreadFunc()
+{
+    tIsWorkerThread = true;
+    uint64_t lastGeneration = 0;
+
+    while (true)
+    {
+        const std::function<void(uint32_t, uint32_t)>* func = nullptr;
+        uint32_t count = 0;
+        uint32_t chunkSize = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&]() { return !isRunning_ || (job_ != nullptr && jobGeneration_ != lastGeneration); });
+
+            if (!isRunning_)
+                break;
+
+            lastGeneration = jobGeneration_;
+            func = job_;
+            count = jobCount_;
+            chunkSize = jobChunkSize_;
+            ++activeWorkers_;
+        }
+
+        ProcessChunks(func, count, chunkSize);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --activeWorkers_;
+        }
+        doneCv_.notify_one();
+    }
+}
+
+void JobSystem::ProcessChunks(const std::function<void(uint32_t, uint32_t)>* _func, uint32_t _count, uint32_t _chunkSize)
+{
+    uint32_t chunkCount = GetChunkCount(_count, _chunkSize);
+
+    while (true)
+    {
+        uint32_t chunk = nextChunk_.fetch_add(1);
+        if (chunk >= chunkCount)
+            break;
+
+        uint32_t begin = chunk * _chunkSize;
+        (*_func)(begin, std::min(begin + _chunkSize, _count));
+
+        if (remainingChunks_.fetch_sub(1) == 1)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            doneCv_.notify_one();
+        }
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    Finalize();
+}
+
+} // namespace Engine
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+namespace Engine {
+
+/// <summary>
+/// 常駐ワーカースレッドで範囲処理を分割実行する
+/// 範囲の分割はチャンクサイズだけで決まるため、結果をチャンク単位で書き分ければ
+/// スレッド数に関係なく同じ結果になる
+/// </summary>
+class JobSystem
+{
+public:
+
+    // singleton instance
+    static JobSystem* GetInstance();
+
+    // 初期化
+    // _workerCount : ワーカースレッド数 0の場合はハードウェアスレッド数-1
+    void Initialize(uint32_t _workerCount = 0);
+
+    // 終了処理
+    void Finalize();
+
+    /// <summary>
+    /// [0, _count)を_chunkSize毎に区切って並列に処理し、全て終わるまで待つ
+    /// 呼び出したスレッドも処理に参加する
+    /// ワーカー内やチャンクの処理中から呼ばれた場合、未初期化の場合はその場で順に処理する
+    /// </summary>
+    /// <param name="_count">要素数</param>
+    /// <param name="_chunkSize">1回の呼び出しで処理する要素数</param>
+    /// <param name="_func">void(uint32_t _begin, uint32_t _end)</param>
+    void ParallelFor(uint32_t _count, uint32_t _chunkSize, const std::function<void(uint32_t, uint32_t)>& _func);
+
+    // チャンク数を取得
+    static uint32_t GetChunkCount(uint32_t _count, uint32_t _chunkSize) { return _chunkSize == 0 ? 0 : (_count + _chunkSize - 1) / _chunkSize; }
+
+    // 呼び出しスレッドを含めた並列数
+    uint32_t GetConcurrency() const { return static_cast<uint32_t>(workers_.size()) + 1; }
+
+    // ワーカースレッドで実行中かどうか
+    static bool IsWorkerThread();
+
+private:
+
+    // ワーカースレッド関数
+    void WorkerThreadFunc();
+
+    // 現在のジョブからチャンクを取り出して処理する
+    void ProcessChunks(const std::function<void(uint32_t, uint32_t)>* _func, uint32_t _count, uint32_t _chunkSize);
+
+private:
+
+    // スレッド関連
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable cv_;        // ワーカーへのジョブ通知
+    std::condition_variable doneCv_;    // 呼び出し元への完了通知
+    std::mutex dispatchMutex_;          // ParallelForの同時呼び出しを直列化
+    bool isRunning_ = false;
+
+    // 実行中のジョブ
+    const std::function<void(uint32_t, uint32_t)>* job_ = nullptr;
+    uint32_t jobCount_ = 0;
+    uint32_t jobChunkSize_ = 0;
+    uint64_t jobGeneration_ = 0;
+    std::atomic<uint32_t> nextChunk_ = 0;
+    std::atomic<uint32_t> remainingChunks_ = 0;
+    uint32_t activeWorkers_ = 0;
+
+private:
+    JobSystem() = default;
+    ~JobSystem();
+
+public:
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+};
+
+} // namespace Engine
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+
+namespace Engine {
+
+/// <summary>
+/// 値が変わったことを登録先に知らせる
+/// 毎フレーム全件を調べずに、変わったものだけを処理したい場合に使う
+/// </summary>
+class ChangeNotifier
+{
+public:
+    using Listener = std::function<void()>;
+
+    /// <summary>
+    /// 通知先を登録する
+    /// </summary>
+    /// <param name="_listener">変わったときに呼ばれる処理</param>
+    /// <returns>解除に使うID（0は無効）</returns>
+    uint32_t Add(Listener _listener)
+    {
+        uint32_t id = nextId_++;
+        listeners_.emplace_back(id, std::move(_listener));
+        return id;
+    }
+
+    // 通知先を解除する 並び順は保たない
+    void Remove(uint32_t _id)
+    {
+        for (auto& entry : listeners_)
+        {
+            if (entry.first != _id)
+                continue;
+
+            entry = std::move(listeners_.back());
+            listeners_.pop_back();
+            return;
+        }
+    }
+
+    // 登録されている全ての通知先を呼ぶ
+    void Notify() const
+    {
+        for (const auto& [id, listener] : listeners_)
+        {
+            listener();
+        }
+    }
+
+    bool IsEmpty() const { return listeners_.empty(); }
+
+private:
+    std::vector<std::pair<uint32_t, Listener>> listeners_;
+    uint32_t nextId_ = 1;
+};
+
+} // namespace Engine